@@ -370,6 +370,442 @@ static inline const uchar *simdFindNonAscii(const uchar *src, const uchar *end,
 }
 #endif
 
+#if !defined(QT_BOOTSTRAPPED) && (QT_COMPILER_SUPPORTS_HERE(AVX2) \
+    || (defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)))
+#  define QUTF8_MULTIBYTE_SIMD
+// Shuffle masks that compact the lanes of a vector of converted characters
+struct QUtf8CompactTables
+{
+    // UTF-8 to UTF-16: keeps the 16-bit lanes whose bit is set in the index
+    uchar utf16[256][16];
+    // UTF-16 to UTF-8: each of the four 32-bit lanes holds a sequence of one
+    // to three bytes; bit i of the index is set if lane i has at least two
+    // bytes, bit i + 4 if it has three
+    uchar utf8[256][16];
+
+    QUtf8CompactTables()
+    {
+        for (int mask = 0; mask < 256; ++mask) {
+            int n = 0;
+            for (int lane = 0; lane < 8; ++lane) {
+                if (mask & (1 << lane)) {
+                    utf16[mask][n++] = 2 * lane;
+                    utf16[mask][n++] = 2 * lane + 1;
+                }
+            }
+            while (n < 16)
+                utf16[mask][n++] = 0x80;
+
+            n = 0;
+            for (int lane = 0; lane < 4; ++lane) {
+                const int length = 1 + ((mask >> lane) & 1) + ((mask >> (lane + 4)) & 1);
+                for (int i = 0; i < length; ++i)
+                    utf8[mask][n++] = 4 * lane + i;
+            }
+            while (n < 16)
+                utf8[mask][n++] = 0x80;
+        }
+    }
+};
+
+static const QUtf8CompactTables &compactTables()
+{
+    static const QUtf8CompactTables tables;
+    return tables;
+}
+
+// Checks the structure of a block of 64 bytes starting at a character
+// boundary: its continuation bytes must be exactly the ones that follow the
+// two- and three-byte lead bytes in it. \a tail has bits 0 and 1 set if the
+// two bytes following the block are continuation bytes. Returns the number of
+// those that belong to the last sequence of the block, or -1 if the block is
+// not valid.
+static inline int validateMultiByteBlock(quint64 continuation, quint64 lead2, quint64 lead3, uint tail)
+{
+    const quint64 expected = (lead2 << 1) | (lead3 << 1) | (lead3 << 2);
+    const uint expectedTail = uint((lead2 | lead3) >> 63) | (uint(lead3 >> 62) & 1)
+            | (uint(lead3 >> 63) << 1);
+    if (continuation != expected || (tail & expectedTail) != expectedTail)
+        return -1;
+    return qPopulationCount(expectedTail);
+}
+
+static inline uint continuationTail(const uchar *src)
+{
+    return uint((src[0] & 0xc0) == 0x80) | (uint((src[1] & 0xc0) == 0x80) << 1);
+}
+#endif
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+// Decodes the characters whose lead bytes are among the 16 bytes at src,
+// which have been validated already
+QT_FUNCTION_TARGET(AVX2)
+static inline void decodeWindowAvx2(ushort *&dst, const uchar *src, uint leads,
+                                    const QUtf8CompactTables &tables)
+{
+    // decode a character at every byte position, assuming it is a lead byte
+    const __m256i byte0 = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+    const __m256i low1 = _mm256_and_si256(
+            _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 1))),
+            _mm256_set1_epi16(0x3f));
+    const __m256i low2 = _mm256_and_si256(
+            _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2))),
+            _mm256_set1_epi16(0x3f));
+    const __m256i two = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(byte0, _mm256_set1_epi16(0x1f)), 6),
+                                        low1);
+    const __m256i three = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(byte0, 12),
+                                                          _mm256_slli_epi16(low1, 6)),
+                                          low2);
+    const __m256i isTwo = _mm256_cmpeq_epi16(_mm256_and_si256(byte0, _mm256_set1_epi16(0xe0)),
+                                             _mm256_set1_epi16(0xc0));
+    const __m256i isThree = _mm256_cmpeq_epi16(_mm256_and_si256(byte0, _mm256_set1_epi16(0xf0)),
+                                               _mm256_set1_epi16(0xe0));
+    __m256i chars = _mm256_blendv_epi8(byte0, two, isTwo);
+    chars = _mm256_blendv_epi8(chars, three, isThree);
+
+    // keep the characters decoded at the lead bytes
+    const __m128i lo = _mm_shuffle_epi8(_mm256_castsi256_si128(chars),
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(tables.utf16[leads & 0xff])));
+    const __m128i hi = _mm_shuffle_epi8(_mm256_extracti128_si256(chars, 1),
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(tables.utf16[leads >> 8])));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), lo);
+    dst += qPopulationCount(leads & 0xff);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), hi);
+    dst += qPopulationCount(leads >> 8);
+}
+
+// Decodes 64 bytes at a time as long as they hold valid sequences of up to
+// three bytes. Returns false if it stopped at a block it cannot handle.
+QT_FUNCTION_TARGET(AVX2)
+static bool decodeMultiByteAvx2(ushort *&dst, const uchar *&src, const uchar *end)
+{
+    const QUtf8CompactTables &tables = compactTables();
+    const __m256i continuationMask = _mm256_set1_epi8(char(0xc0));
+    const __m256i continuationBits = _mm256_set1_epi8(char(0x80));
+    const __m256i bit5 = _mm256_set1_epi8(0x20);
+
+    // the last sequence of a block may end two bytes past it, and the
+    // destination has room for at least one character per byte left
+    while (end - src >= 80) {
+        quint64 continuation = 0;
+        quint64 lead2 = 0;
+        quint64 lead3 = 0;
+        __m256i errors = _mm256_setzero_si256();
+        for (int i = 0; i < 64; i += 32) {
+            const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+            const __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 1));
+
+            // four-byte sequences are left to the scalar code, as are the
+            // lead bytes of overlong sequences and of surrogates
+            const __m256i nextAbove9f = _mm256_cmpeq_epi8(_mm256_and_si256(next, bit5), bit5);
+            errors = _mm256_or_si256(errors, _mm256_cmpeq_epi8(_mm256_max_epu8(bytes, _mm256_set1_epi8(char(0xf0))),
+                                                               bytes));
+            errors = _mm256_or_si256(errors, _mm256_cmpeq_epi8(_mm256_and_si256(bytes, _mm256_set1_epi8(char(0xfe))),
+                                                               _mm256_set1_epi8(char(0xc0))));
+            errors = _mm256_or_si256(errors, _mm256_andnot_si256(nextAbove9f,
+                    _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(char(0xe0)))));
+            errors = _mm256_or_si256(errors, _mm256_and_si256(nextAbove9f,
+                    _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(char(0xed)))));
+
+            continuation |= quint64(uint(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                    _mm256_and_si256(bytes, continuationMask), continuationBits)))) << i;
+            lead2 |= quint64(uint(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                    _mm256_and_si256(bytes, _mm256_set1_epi8(char(0xe0))), continuationMask)))) << i;
+            lead3 |= quint64(uint(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                    _mm256_and_si256(bytes, _mm256_set1_epi8(char(0xf0))), _mm256_set1_epi8(char(0xe0)))))) << i;
+        }
+        if (!_mm256_testz_si256(errors, errors))
+            return false;
+        const int overhang = validateMultiByteBlock(continuation, lead2, lead3, continuationTail(src + 64));
+        if (overhang < 0)
+            return false;
+
+        for (int i = 0; i < 64; i += 16) {
+            const uint leads = ~uint(continuation >> i) & 0xffff;
+            if (leads == 0xffff && !(uint((lead2 | lead3) >> i) & 0xffff)) {
+                // US-ASCII
+                const __m256i chars = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), chars);
+                dst += 16;
+            } else {
+                decodeWindowAvx2(dst, src + i, leads, tables);
+            }
+        }
+        src += 64 + overhang;
+    }
+    return true;
+}
+
+// Encodes 8 characters, none of which is a surrogate
+QT_FUNCTION_TARGET(AVX2)
+static inline void encodeHalfBlockAvx2(uchar *&dst, __m128i in, const QUtf8CompactTables &tables)
+{
+    if (_mm_testz_si128(in, _mm_set1_epi16(short(0xff80)))) {
+        // US-ASCII, common in Latin-script text
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), _mm_packus_epi16(in, in));
+        dst += 8;
+        return;
+    }
+
+    const __m256i c = _mm256_cvtepu16_epi32(in);
+    const __m256i needs2 = _mm256_cmpgt_epi32(c, _mm256_set1_epi32(0x7f));
+    const __m256i needs3 = _mm256_cmpgt_epi32(c, _mm256_set1_epi32(0x7ff));
+    const __m256i continuationBits = _mm256_set1_epi32(0x80);
+    const __m256i low6 = _mm256_or_si256(_mm256_and_si256(c, _mm256_set1_epi32(0x3f)), continuationBits);
+    const __m256i mid6 = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(c, 6), _mm256_set1_epi32(0x3f)),
+                                         continuationBits);
+    const __m256i two = _mm256_or_si256(_mm256_or_si256(_mm256_srli_epi32(c, 6), _mm256_set1_epi32(0xc0)),
+                                        _mm256_slli_epi32(low6, 8));
+    const __m256i three = _mm256_or_si256(_mm256_or_si256(_mm256_srli_epi32(c, 12), _mm256_set1_epi32(0xe0)),
+                                          _mm256_or_si256(_mm256_slli_epi32(mid6, 8),
+                                                          _mm256_slli_epi32(low6, 16)));
+    __m256i bytes = _mm256_blendv_epi8(c, two, needs2);
+    bytes = _mm256_blendv_epi8(bytes, three, needs3);
+
+    const uint mask2 = _mm256_movemask_ps(_mm256_castsi256_ps(needs2));
+    const uint mask3 = _mm256_movemask_ps(_mm256_castsi256_ps(needs3));
+    const uint loKey = (mask2 & 0xf) | ((mask3 & 0xf) << 4);
+    const uint hiKey = (mask2 >> 4) | (mask3 & 0xf0);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                     _mm_shuffle_epi8(_mm256_castsi256_si128(bytes),
+                                      _mm_loadu_si128(reinterpret_cast<const __m128i *>(tables.utf8[loKey]))));
+    dst += 4 + qPopulationCount(loKey);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                     _mm_shuffle_epi8(_mm256_extracti128_si256(bytes, 1),
+                                      _mm_loadu_si128(reinterpret_cast<const __m128i *>(tables.utf8[hiKey]))));
+    dst += 4 + qPopulationCount(hiKey);
+}
+
+// Encodes 16 characters at a time as long as there are no surrogates.
+// Returns false if it stopped at a block it cannot handle.
+QT_FUNCTION_TARGET(AVX2)
+static bool encodeMultiByteAvx2(uchar *&dst, const ushort *&src, const ushort *end)
+{
+    const QUtf8CompactTables &tables = compactTables();
+
+    // each block writes up to 28 bytes, and the destination has room for at
+    // least three bytes per character left; the caller needs at least one
+    // character left over
+    while (end - src > 16) {
+        const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        if (_mm256_testz_si256(in, _mm256_set1_epi16(short(0xff80)))) {
+            // US-ASCII
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                             _mm_packus_epi16(_mm256_castsi256_si128(in), _mm256_extracti128_si256(in, 1)));
+            dst += 16;
+            src += 16;
+            continue;
+        }
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(in, _mm256_set1_epi16(short(0xf800))),
+                                                    _mm256_set1_epi16(short(0xd800)))))
+            return false;
+
+        encodeHalfBlockAvx2(dst, _mm256_castsi256_si128(in), tables);
+        encodeHalfBlockAvx2(dst, _mm256_extracti128_si256(in, 1), tables);
+        src += 16;
+    }
+    return true;
+}
+#elif defined(QUTF8_MULTIBYTE_SIMD) // AArch64
+static inline uint neonMoveMask(uint8x16_t v)
+{
+    const uint8x16_t bits = { 1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7,
+                              1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7 };
+    v = vandq_u8(v, bits);
+    return vaddv_u8(vget_low_u8(v)) | (uint(vaddv_u8(vget_high_u8(v))) << 8);
+}
+
+static inline uint16x8_t neonDecodeMultiByte(uint8x8_t byte0, uint8x8_t byte1, uint8x8_t byte2)
+{
+    // decode a character at every byte position, assuming it is a lead byte
+    const uint16x8_t b0 = vmovl_u8(byte0);
+    const uint16x8_t low1 = vmovl_u8(vand_u8(byte1, vdup_n_u8(0x3f)));
+    const uint16x8_t low2 = vmovl_u8(vand_u8(byte2, vdup_n_u8(0x3f)));
+    const uint16x8_t two = vorrq_u16(vshlq_n_u16(vandq_u16(b0, vdupq_n_u16(0x1f)), 6), low1);
+    const uint16x8_t three = vorrq_u16(vorrq_u16(vshlq_n_u16(b0, 12), vshlq_n_u16(low1, 6)), low2);
+    const uint16x8_t isTwo = vceqq_u16(vandq_u16(b0, vdupq_n_u16(0xe0)), vdupq_n_u16(0xc0));
+    const uint16x8_t isThree = vceqq_u16(vandq_u16(b0, vdupq_n_u16(0xf0)), vdupq_n_u16(0xe0));
+    const uint16x8_t chars = vbslq_u16(isTwo, two, b0);
+    return vbslq_u16(isThree, three, chars);
+}
+
+static bool decodeMultiByteNeon(ushort *&dst, const uchar *&src, const uchar *end)
+{
+    const QUtf8CompactTables &tables = compactTables();
+    const uint8x16_t continuationMask = vdupq_n_u8(0xc0);
+    const uint8x16_t continuationBits = vdupq_n_u8(0x80);
+    const uint8x16_t bit5 = vdupq_n_u8(0x20);
+
+    // the last sequence of a block may end two bytes past it, and the
+    // destination has room for at least one character per byte left
+    while (end - src >= 80) {
+        quint64 continuation = 0;
+        quint64 lead2 = 0;
+        quint64 lead3 = 0;
+        uint8x16_t errors = vdupq_n_u8(0);
+        for (int i = 0; i < 64; i += 16) {
+            const uint8x16_t bytes = vld1q_u8(src + i);
+            const uint8x16_t next = vld1q_u8(src + i + 1);
+
+            // four-byte sequences are left to the scalar code, as are the
+            // lead bytes of overlong sequences and of surrogates
+            const uint8x16_t nextAbove9f = vtstq_u8(next, bit5);
+            errors = vorrq_u8(errors, vcgeq_u8(bytes, vdupq_n_u8(0xf0)));
+            errors = vorrq_u8(errors, vceqq_u8(vandq_u8(bytes, vdupq_n_u8(0xfe)), vdupq_n_u8(0xc0)));
+            errors = vorrq_u8(errors, vbicq_u8(vceqq_u8(bytes, vdupq_n_u8(0xe0)), nextAbove9f));
+            errors = vorrq_u8(errors, vandq_u8(vceqq_u8(bytes, vdupq_n_u8(0xed)), nextAbove9f));
+
+            continuation |= quint64(neonMoveMask(vceqq_u8(vandq_u8(bytes, continuationMask),
+                                                          continuationBits))) << i;
+            lead2 |= quint64(neonMoveMask(vceqq_u8(vandq_u8(bytes, vdupq_n_u8(0xe0)),
+                                                   continuationMask))) << i;
+            lead3 |= quint64(neonMoveMask(vceqq_u8(vandq_u8(bytes, vdupq_n_u8(0xf0)),
+                                                   vdupq_n_u8(0xe0)))) << i;
+        }
+        if (vmaxvq_u8(errors))
+            return false;
+        const int overhang = validateMultiByteBlock(continuation, lead2, lead3, continuationTail(src + 64));
+        if (overhang < 0)
+            return false;
+
+        for (int i = 0; i < 64; i += 16) {
+            const uint8x16_t bytes = vld1q_u8(src + i);
+            const uint leads = ~uint(continuation >> i) & 0xffff;
+            if (leads == 0xffff && !(uint((lead2 | lead3) >> i) & 0xffff)) {
+                // US-ASCII
+                vst1q_u16(dst, vmovl_u8(vget_low_u8(bytes)));
+                vst1q_u16(dst + 8, vmovl_high_u8(bytes));
+                dst += 16;
+                continue;
+            }
+
+            const uint8x16_t next1 = vld1q_u8(src + i + 1);
+            const uint8x16_t next2 = vld1q_u8(src + i + 2);
+            const uint16x8_t lo = neonDecodeMultiByte(vget_low_u8(bytes), vget_low_u8(next1),
+                                                      vget_low_u8(next2));
+            const uint16x8_t hi = neonDecodeMultiByte(vget_high_u8(bytes), vget_high_u8(next1),
+                                                      vget_high_u8(next2));
+
+            // keep the characters decoded at the lead bytes
+            vst1q_u8(reinterpret_cast<uchar *>(dst),
+                     vqtbl1q_u8(vreinterpretq_u8_u16(lo), vld1q_u8(tables.utf16[leads & 0xff])));
+            dst += qPopulationCount(leads & 0xff);
+            vst1q_u8(reinterpret_cast<uchar *>(dst),
+                     vqtbl1q_u8(vreinterpretq_u8_u16(hi), vld1q_u8(tables.utf16[leads >> 8])));
+            dst += qPopulationCount(leads >> 8);
+        }
+        src += 64 + overhang;
+    }
+    return true;
+}
+
+static inline void neonEncodeMultiByte(uchar *&dst, uint16x4_t in, const QUtf8CompactTables &tables)
+{
+    const uint32x4_t c = vmovl_u16(in);
+    const uint32x4_t needs2 = vcgtq_u32(c, vdupq_n_u32(0x7f));
+    const uint32x4_t needs3 = vcgtq_u32(c, vdupq_n_u32(0x7ff));
+    const uint32x4_t continuationBits = vdupq_n_u32(0x80);
+    const uint32x4_t low6 = vorrq_u32(vandq_u32(c, vdupq_n_u32(0x3f)), continuationBits);
+    const uint32x4_t mid6 = vorrq_u32(vandq_u32(vshrq_n_u32(c, 6), vdupq_n_u32(0x3f)), continuationBits);
+    const uint32x4_t two = vorrq_u32(vorrq_u32(vshrq_n_u32(c, 6), vdupq_n_u32(0xc0)), vshlq_n_u32(low6, 8));
+    const uint32x4_t three = vorrq_u32(vorrq_u32(vshrq_n_u32(c, 12), vdupq_n_u32(0xe0)),
+                                       vorrq_u32(vshlq_n_u32(mid6, 8), vshlq_n_u32(low6, 16)));
+    uint32x4_t bytes = vbslq_u32(needs2, two, c);
+    bytes = vbslq_u32(needs3, three, bytes);
+
+    const uint32x4_t laneBits = { 1, 1 << 1, 1 << 2, 1 << 3 };
+    const uint key = vaddvq_u32(vandq_u32(needs2, laneBits))
+            | (vaddvq_u32(vandq_u32(needs3, laneBits)) << 4);
+    vst1q_u8(dst, vqtbl1q_u8(vreinterpretq_u8_u32(bytes), vld1q_u8(tables.utf8[key])));
+    dst += 4 + qPopulationCount(key);
+}
+
+// Encodes 8 characters at a time as long as there are no surrogates.
+// Returns false if it stopped at a block it cannot handle.
+static bool encodeMultiByteNeon(uchar *&dst, const ushort *&src, const ushort *end)
+{
+    const QUtf8CompactTables &tables = compactTables();
+
+    // each block writes up to 28 bytes, and the destination has room for at
+    // least three bytes per character left
+    while (end - src >= 16) {
+        const uint16x8_t in = vld1q_u16(src);
+        if (vmaxvq_u16(in) < 0x80) {
+            // US-ASCII
+            vst1_u8(dst, vmovn_u16(in));
+            dst += 8;
+            src += 8;
+            continue;
+        }
+        if (vmaxvq_u16(vceqq_u16(vandq_u16(in, vdupq_n_u16(0xf800)), vdupq_n_u16(0xd800))))
+            return false;
+
+        neonEncodeMultiByte(dst, vget_low_u16(in), tables);
+        neonEncodeMultiByte(dst, vget_high_u16(in), tables);
+        src += 8;
+    }
+    return true;
+}
+#endif
+
+// Converts runs of characters that need up to three bytes in UTF-8. When the
+// SIMD code stops at something it cannot handle, \a nextAscii is moved past
+// it so that the scalar code deals with it before trying again.
+// The pointers are copied so that the callers' own can stay in registers.
+static inline void simdDecodeMultiByte(ushort *&dst, const uchar *&src, const uchar *end,
+                                       const uchar *&nextAscii)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (!qCpuHasFeature(AVX2))
+        return;
+    ushort *d = dst;
+    const uchar *s = src;
+    if (!decodeMultiByteAvx2(d, s, end))
+        nextAscii = s + 64;
+    dst = d;
+    src = s;
+#elif defined(QUTF8_MULTIBYTE_SIMD)
+    ushort *d = dst;
+    const uchar *s = src;
+    if (!decodeMultiByteNeon(d, s, end))
+        nextAscii = s + 64;
+    dst = d;
+    src = s;
+#else
+    Q_UNUSED(dst);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+    Q_UNUSED(nextAscii);
+#endif
+}
+
+static inline void simdEncodeMultiByte(uchar *&dst, const ushort *&src, const ushort *end,
+                                       const ushort *&nextAscii)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (!qCpuHasFeature(AVX2))
+        return;
+    uchar *d = dst;
+    const ushort *s = src;
+    if (!encodeMultiByteAvx2(d, s, end))
+        nextAscii = s + 16;
+    dst = d;
+    src = s;
+#elif defined(QUTF8_MULTIBYTE_SIMD)
+    uchar *d = dst;
+    const ushort *s = src;
+    if (!encodeMultiByteNeon(d, s, end))
+        nextAscii = s + 8;
+    dst = d;
+    src = s;
+#else
+    Q_UNUSED(dst);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+    Q_UNUSED(nextAscii);
+#endif
+}
+
 QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
 {
     // create a QByteArray with the worst case scenario size
@@ -382,6 +818,7 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
         const ushort *nextAscii = end;
         if (simdEncodeAscii(dst, nextAscii, src, end))
             break;
+        simdEncodeMultiByte(dst, src, end, nextAscii);
 
         do {
             ushort uc = *src++;
@@ -407,8 +844,12 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len, QTextCodec::Conve
             replacement = 0;
         if (!(state->flags & QTextCodec::IgnoreHeader))
             rlen += 3;
-        if (state->remainingChars)
+        if (state->remainingChars) {
             surrogate_high = state->state_data[0];
+            // completing the pair writes four bytes for the first character;
+            // the block converters rely on three bytes per character left
+            rlen += 1;
+        }
     }
 
 
@@ -434,8 +875,11 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len, QTextCodec::Conve
             surrogate_high = -1;
             res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
         } else {
-            if (src >= nextAscii && simdEncodeAscii(cursor, nextAscii, src, end))
-                break;
+            if (src >= nextAscii) {
+                if (simdEncodeAscii(cursor, nextAscii, src, end))
+                    break;
+                simdEncodeMultiByte(cursor, src, end, nextAscii);
+            }
 
             uc = *src++;
             res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
@@ -525,6 +969,7 @@ QChar *QUtf8::convertToUnicode(QChar *buffer, const char *chars, int len) noexce
             nextAscii = end;
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
+            simdDecodeMultiByte(dst, src, end, nextAscii);
 
             do {
                 uchar b = *src++;
@@ -613,8 +1058,13 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
     const uchar *nextAscii = src;
     const uchar *start = src;
     while (res >= 0 && src < end) {
-        if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
-            break;
+        if (src >= nextAscii) {
+            if (simdDecodeAscii(dst, nextAscii, src, end))
+                break;
+            // the first character may be a BOM to skip
+            if (headerdone)
+                simdDecodeMultiByte(dst, src, end, nextAscii);
+        }
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
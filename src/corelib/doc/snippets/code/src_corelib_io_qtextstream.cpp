@@ -137,3 +137,16 @@ stream << '\n' << Qt::flush;
 QTextStream out(&file);
 out.setCodec("UTF-8");
 //! [10]
+
+
+//! [11]
+QFile file("access.log");
+if (file.open(QIODevice::ReadOnly)) {
+    QTextStream in(&file);
+    int errors = 0;
+    for (QStringView line = in.readLineView(); !line.isNull(); line = in.readLineView()) {
+        if (line.contains(QLatin1String(" 500 ")))
+            ++errors;
+    }
+}
+//! [11]
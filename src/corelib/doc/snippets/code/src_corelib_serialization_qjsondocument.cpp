@@ -63,3 +63,14 @@
 //! [1]
     {"Array":[true,999,"string"],"Key":"Value","null":null}
 //! [1]
+
+//! [2]
+    QFile file("index.json");
+    file.open(QIODevice::ReadOnly);
+    const uchar *mapped = file.map(0, file.size());
+    const QByteArray json = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped),
+                                                    int(file.size()));
+
+    // file must not be closed or destroyed while index is in use
+    QJsonDocument index = QJsonDocument::fromRawJson(json);
+//! [2]
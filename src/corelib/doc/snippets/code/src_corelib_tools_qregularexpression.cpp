@@ -364,4 +364,30 @@ QString wildcard = QRegularExpression::wildcardToRegularExpression("*.jpeg");
     ("", "day", "month", "year", "", "name")
 //! [33]
 
+{
+QString subject;
+//! [34]
+QRegularExpression re = QRegularExpression::fromPatterns({ "(\\d+)", "(\\w+)", "\\s+" });
+QRegularExpressionMatchIterator i = re.globalMatch(subject);
+while (i.hasNext()) {
+    QRegularExpressionMatch match = i.next();
+    switch (match.patternIndex()) {
+    case 0: // a number, in match.captured(1)
+    case 1: // a word, in match.captured(1)
+    case 2: // white space
+        break;
+    }
+}
+//! [34]
+}
+
+{
+QStringList patterns;
+QString subject;
+QRegularExpression::PatternOptions options;
+//! [35]
+QRegularExpression::fromPatterns(patterns, options).globalMatch(subject);
+//! [35]
+}
+
 }
@@ -166,6 +166,15 @@ static QT_PREPEND_NAMESPACE(qint64) qt_gettid()
 
 #include <stdio.h>
 
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread) && defined(Q_COMPILER_THREAD_LOCAL)
+#  define QLOGGING_HAVE_ASYNC
+#  include <atomic>
+#  include "qwaitcondition.h"
+#  ifdef Q_OS_UNIX
+#    include <sys/uio.h>
+#  endif
+#endif
+
 QT_BEGIN_NAMESPACE
 
 #if !defined(Q_CC_MSVC)
@@ -1097,6 +1106,17 @@ struct QMessagePattern {
 
     bool fromEnvironment;
     static QBasicMutex mutex;
+
+    // what has to be recorded when a message is logged, rather than when it
+    // is formatted; can be read without locking the mutex
+    enum ContextToken {
+        ThreadIdToken = 0x1,
+        QThreadPtrToken = 0x2,
+        TimeToken = 0x4,
+        BacktraceToken = 0x8,
+        AppNameToken = 0x10
+    };
+    QAtomicInt contextTokens;
 };
 #ifdef QLOGGING_HAVE_BACKTRACE
 Q_DECLARE_TYPEINFO(QMessagePattern::BacktraceParams, Q_MOVABLE_TYPE);
@@ -1269,6 +1289,21 @@ void QMessagePattern::setPattern(const QString &pattern)
     if (!error.isEmpty())
         qt_message_print(error);
 
+    int usedContextTokens = 0;
+    for (int i = 0; tokens[i]; ++i) {
+        if (tokens[i] == threadidTokenC)
+            usedContextTokens |= ThreadIdToken;
+        else if (tokens[i] == qthreadptrTokenC)
+            usedContextTokens |= QThreadPtrToken;
+        else if (tokens[i] == timeTokenC)
+            usedContextTokens |= TimeToken;
+        else if (tokens[i] == backtraceTokenC)
+            usedContextTokens |= BacktraceToken;
+        else if (tokens[i] == appnameTokenC)
+            usedContextTokens |= AppNameToken;
+    }
+    contextTokens.storeRelaxed(usedContextTokens);
+
     literals.reset(new std::unique_ptr<const char[]>[literalsVar.size() + 1]);
     std::move(literalsVar.begin(), literalsVar.end(), &literals[0]);
 }
@@ -1358,6 +1393,22 @@ static QString formatBacktraceForLogMessage(const QMessagePattern::BacktracePara
 
 Q_GLOBAL_STATIC(QMessagePattern, qMessagePattern)
 
+#ifdef QLOGGING_HAVE_ASYNC
+// The thread and time at which a message was logged, recorded by the
+// asynchronous output for the pattern tokens that depend on them
+struct QMessageOrigin
+{
+    QString applicationName;
+    qint64 threadId = 0;
+    QThread *thread = nullptr;
+    qint64 msecsSinceReference = 0;
+    qint64 msecsSinceEpoch = 0;
+};
+
+// set while the asynchronous output formats a message
+static thread_local const QMessageOrigin *currentMessageOrigin = nullptr;
+#endif
+
 /*!
     \relates <QtGlobal>
     \since 5.4
@@ -1392,6 +1443,9 @@ QString qFormatLogMessage(QtMsgType type, const QMessageLogContext &context, con
 #ifdef QLOGGING_HAVE_BACKTRACE
     int backtraceArgsIdx = 0;
 #endif
+#endif
+#ifdef QLOGGING_HAVE_ASYNC
+    const QMessageOrigin *origin = currentMessageOrigin;
 #endif
 
     // we do not convert file, function, line literals to local encoding due to overhead
@@ -1438,13 +1492,26 @@ QString qFormatLogMessage(QtMsgType type, const QMessageLogContext &context, con
         } else if (token == pidTokenC) {
             message.append(QString::number(QCoreApplication::applicationPid()));
         } else if (token == appnameTokenC) {
+#ifdef QLOGGING_HAVE_ASYNC
+            message.append(origin ? origin->applicationName : QCoreApplication::applicationName());
+#else
             message.append(QCoreApplication::applicationName());
+#endif
         } else if (token == threadidTokenC) {
             // print the TID as decimal
+#ifdef QLOGGING_HAVE_ASYNC
+            message.append(QString::number(origin ? origin->threadId : qint64(qt_gettid())));
+#else
             message.append(QString::number(qt_gettid()));
+#endif
         } else if (token == qthreadptrTokenC) {
             message.append(QLatin1String("0x"));
-            message.append(QString::number(qlonglong(QThread::currentThread()->currentThread()), 16));
+#ifdef QLOGGING_HAVE_ASYNC
+            QThread *thread = origin ? origin->thread : QThread::currentThread();
+#else
+            QThread *thread = QThread::currentThread();
+#endif
+            message.append(QString::number(qlonglong(thread), 16));
 #ifdef QLOGGING_HAVE_BACKTRACE
         } else if (token == backtraceTokenC) {
             QMessagePattern::BacktraceParams backtraceParams = pattern->backtraceArgs.at(backtraceArgsIdx);
@@ -1456,6 +1523,10 @@ QString qFormatLogMessage(QtMsgType type, const QMessageLogContext &context, con
             timeArgsIdx++;
             if (timeFormat == QLatin1String("process")) {
                     quint64 ms = pattern->timer.elapsed();
+#ifdef QLOGGING_HAVE_ASYNC
+                    if (origin)
+                        ms = origin->msecsSinceReference - pattern->timer.msecsSinceReference();
+#endif
                     message.append(QString::asprintf("%6d.%03d", uint(ms / 1000), uint(ms % 1000)));
             } else if (timeFormat ==  QLatin1String("boot")) {
                 // just print the milliseconds since the elapsed timer reference
@@ -1463,12 +1534,22 @@ QString qFormatLogMessage(QtMsgType type, const QMessageLogContext &context, con
                 QElapsedTimer now;
                 now.start();
                 uint ms = now.msecsSinceReference();
+#ifdef QLOGGING_HAVE_ASYNC
+                if (origin)
+                    ms = origin->msecsSinceReference;
+#endif
                 message.append(QString::asprintf("%6d.%03d", uint(ms / 1000), uint(ms % 1000)));
 #if QT_CONFIG(datestring)
-            } else if (timeFormat.isEmpty()) {
-                    message.append(QDateTime::currentDateTime().toString(Qt::ISODate));
             } else {
-                message.append(QDateTime::currentDateTime().toString(timeFormat));
+                QDateTime now = QDateTime::currentDateTime();
+#ifdef QLOGGING_HAVE_ASYNC
+                if (origin)
+                    now = QDateTime::fromMSecsSinceEpoch(origin->msecsSinceEpoch);
+#endif
+                if (timeFormat.isEmpty())
+                    message.append(now.toString(Qt::ISODate));
+                else
+                    message.append(now.toString(timeFormat));
 #endif // QT_CONFIG(datestring)
             }
 #endif // !QT_BOOTSTRAPPED
@@ -1752,9 +1833,12 @@ static void stderr_message_handler(QtMsgType type, const QMessageLogContext &con
 
 /*!
     \internal
+
+    Passes the message to the platform's logging system, and returns true if
+    that handled \c stderr output as well.
 */
-static void qDefaultMessageHandler(QtMsgType type, const QMessageLogContext &context,
-                                   const QString &message)
+static bool systemMessageSink(QtMsgType type, const QMessageLogContext &context,
+                              const QString &message)
 {
     bool handledStderr = false;
 
@@ -1781,8 +1865,21 @@ static void qDefaultMessageHandler(QtMsgType type, const QMessageLogContext &con
     handledStderr |= wasm_default_message_handler(type, context, message);
 # endif
 #endif
+    // not every platform has a sink
+    Q_UNUSED(type);
+    Q_UNUSED(context);
+    Q_UNUSED(message);
 
-    if (!handledStderr)
+    return handledStderr;
+}
+
+/*!
+    \internal
+*/
+static void qDefaultMessageHandler(QtMsgType type, const QMessageLogContext &context,
+                                   const QString &message)
+{
+    if (!systemMessageSink(type, context, message))
         stderr_message_handler(type, context, message);
 }
 
@@ -1818,6 +1915,395 @@ static bool grabMessageHandler() { return true; }
 static void ungrabMessageHandler() { }
 #endif // (Q_COMPILER_THREAD_LOCAL)
 
+#ifdef QLOGGING_HAVE_ASYNC
+
+// ------------------------- Asynchronous output ----------------------------
+//
+// With QT_LOGGING_ASYNC set, the messages for the default message handler are
+// written by a thread of their own instead of the threads that log them. Each
+// logging thread appends its messages to a ring that only it writes to, without
+// locking, and drops them (counting how many) while the ring is full. The writer
+// thread takes the messages out in batches, formats them and writes them with
+// as few system calls as it can. Fatal messages, qSetMessagePattern() and the
+// end of the program flush whatever is pending.
+
+struct QAsyncMessage
+{
+    const char *string(int offset) const
+    { return offset < 0 ? nullptr : strings.constData() + offset; }
+
+    QString message;
+    QByteArray strings;     // the strings of the context, each 0-terminated
+    QMessageOrigin origin;
+    quint64 sequence;
+    int line;
+    int file;               // offsets into strings, -1 for null
+    int function;
+    int category;
+    QtMsgType type;
+};
+
+class QAsyncMessageRing
+{
+public:
+    enum { Capacity = 512 };
+
+    // called by the logging thread only
+    bool push(QtMsgType type, const QMessageLogContext &context, const QString &message,
+              const QMessageOrigin &origin, quint64 sequence);
+    // called by whichever thread holds the sink's write mutex
+    void takeAll(std::vector<QAsyncMessage> &batch);
+
+    uint size() const { return tail.loadAcquire() - head.loadAcquire(); }
+
+    QAtomicInteger<uint> head;
+    QAtomicInteger<uint> tail;
+    QAtomicInt dropped;
+    QAtomicInt finished;    // the thread has exited
+    QAsyncMessage messages[Capacity];
+};
+
+static int appendContextString(QByteArray &strings, const char *string)
+{
+    if (!string)
+        return -1;
+    const int offset = strings.size();
+    strings.append(string, int(strlen(string)) + 1);
+    return offset;
+}
+
+bool QAsyncMessageRing::push(QtMsgType type, const QMessageLogContext &context,
+                             const QString &message, const QMessageOrigin &origin,
+                             quint64 sequence)
+{
+    const uint t = tail.loadRelaxed();
+    if (t - head.loadAcquire() == Capacity)
+        return false;
+
+    // the context's strings need not outlive the call, so they are copied
+    QAsyncMessage &m = messages[t % Capacity];
+    m.message = message;
+    m.strings.clear();
+    m.file = appendContextString(m.strings, context.file);
+    m.function = appendContextString(m.strings, context.function);
+    m.category = appendContextString(m.strings, context.category);
+    m.origin = origin;
+    m.sequence = sequence;
+    m.line = context.line;
+    m.type = type;
+    tail.storeRelease(t + 1);
+    return true;
+}
+
+void QAsyncMessageRing::takeAll(std::vector<QAsyncMessage> &batch)
+{
+    const uint h = head.loadRelaxed();
+    const uint t = tail.loadAcquire();
+    for (uint i = h; i != t; ++i)
+        batch.push_back(std::move(messages[i % Capacity]));
+    head.storeRelease(t);
+}
+
+// The state of the current thread; trivially destructible, so that it can be
+// used until the thread is gone.
+static thread_local QAsyncMessageRing *asyncMessageRing = nullptr;
+// set for the writer thread and for threads that are exiting
+static thread_local bool asyncOutputDisabled = false;
+// set while the thread writes out messages
+static thread_local bool asyncOutputWriting = false;
+
+struct QAsyncMessageRingReleaser
+{
+    ~QAsyncMessageRingReleaser()
+    {
+        asyncOutputDisabled = true;
+        if (asyncMessageRing)
+            asyncMessageRing->finished.storeRelease(1);
+    }
+};
+static thread_local QAsyncMessageRingReleaser asyncMessageRingReleaser;
+
+static void writeToStderr(const std::vector<QByteArray> &lines)
+{
+#ifdef Q_OS_UNIX
+    enum { MaxVectors = 64 };
+
+    // write out whatever stdio has buffered first
+    fflush(stderr);
+
+    size_t first = 0;
+    int offset = 0;     // of the part of the first line that is left
+    while (first < lines.size()) {
+        iovec vectors[MaxVectors];
+        int count = 0;
+        for (size_t i = first; i < lines.size() && count < MaxVectors; ++i, ++count) {
+            const int skip = i == first ? offset : 0;
+            vectors[count].iov_base = const_cast<char *>(lines[i].constData()) + skip;
+            vectors[count].iov_len = size_t(lines[i].size() - skip);
+        }
+
+        qint64 written;
+        EINTR_LOOP(written, ::writev(STDERR_FILENO, vectors, count));
+        if (written < 0)
+            return;
+        while (first < lines.size() && written >= lines[first].size() - offset) {
+            written -= lines[first].size() - offset;
+            offset = 0;
+            ++first;
+        }
+        offset += int(written);
+    }
+#else
+    for (const QByteArray &line : lines)
+        fwrite(line.constData(), 1, line.size(), stderr);
+    fflush(stderr);
+#endif
+}
+
+static void writeAsyncMessages(const std::vector<QAsyncMessage> &batch, int dropped)
+{
+    std::vector<QByteArray> lines;
+    lines.reserve(batch.size() + 1);
+    for (const QAsyncMessage &m : batch) {
+        const QMessageLogContext context(m.string(m.file), m.line, m.string(m.function),
+                                         m.string(m.category));
+        currentMessageOrigin = &m.origin;
+        if (systemMessageSink(m.type, context, m.message))
+            continue;
+
+        // as in stderr_message_handler()
+        const QString formattedMessage = qFormatLogMessage(m.type, context, m.message);
+        if (!formattedMessage.isNull())
+            lines.push_back(formattedMessage.toLocal8Bit() + '\n');
+    }
+    currentMessageOrigin = nullptr;
+
+    if (dropped)
+        lines.push_back("QT_LOGGING_ASYNC: " + QByteArray::number(dropped) + " messages were dropped\n");
+    writeToStderr(lines);
+}
+
+class QAsyncMessageSink : public QThread
+{
+public:
+    QAsyncMessageSink();
+    ~QAsyncMessageSink();
+
+    bool post(QtMsgType type, const QMessageLogContext &context, const QString &message);
+    bool writePending();
+
+protected:
+    void run() override;
+
+private:
+    QAsyncMessageRing *threadRing();
+    bool hasPending() const;
+
+    enum { BatchInterval = 10 };    // ms
+
+    QMutex mutex;           // protects rings and quit
+    QWaitCondition wakeUp;
+    std::vector<QAsyncMessageRing *> rings;
+    bool quit = false;
+    QAtomicInt sleeping;
+
+    QMutex writeMutex;      // held while taking messages out of the rings
+    QAtomicInteger<quint64> sequence;
+};
+
+QAsyncMessageSink::QAsyncMessageSink()
+{
+    // the pending messages are formatted when the sink is destroyed, so the
+    // pattern has to be destroyed after it
+    qMessagePattern();
+
+    setObjectName(QStringLiteral("Qt logging"));
+    start();
+}
+
+QAsyncMessageSink::~QAsyncMessageSink()
+{
+    {
+        const auto locker = qt_scoped_lock(mutex);
+        quit = true;
+        wakeUp.wakeOne();
+    }
+    wait();
+    writePending();
+    for (QAsyncMessageRing *ring : rings)
+        delete ring;
+}
+
+QAsyncMessageRing *QAsyncMessageSink::threadRing()
+{
+    if (!asyncMessageRing) {
+        // registers the releaser for this thread
+        static_cast<void>(&asyncMessageRingReleaser);
+        asyncMessageRing = new QAsyncMessageRing;
+        const auto locker = qt_scoped_lock(mutex);
+        rings.push_back(asyncMessageRing);
+    }
+    return asyncMessageRing;
+}
+
+bool QAsyncMessageSink::post(QtMsgType type, const QMessageLogContext &context,
+                             const QString &message)
+{
+    QMessagePattern *pattern = qMessagePattern();
+    if (!pattern)
+        return false;
+
+    // record what the pattern needs to know about this thread now; the
+    // backtrace cannot be taken cheaply enough, so such messages are written
+    // right away
+    const int tokens = pattern->contextTokens.loadRelaxed();
+    if (tokens & QMessagePattern::BacktraceToken)
+        return false;
+    QMessageOrigin origin;
+    if (tokens & QMessagePattern::AppNameToken)
+        origin.applicationName = QCoreApplication::applicationName();
+    if (tokens & QMessagePattern::ThreadIdToken)
+        origin.threadId = qt_gettid();
+    if (tokens & QMessagePattern::QThreadPtrToken)
+        origin.thread = QThread::currentThread();
+    if (tokens & QMessagePattern::TimeToken) {
+        QElapsedTimer now;
+        now.start();
+        origin.msecsSinceReference = now.msecsSinceReference();
+        origin.msecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+    }
+
+    QAsyncMessageRing *ring = threadRing();
+    if (!ring->push(type, context, message, origin, sequence.fetchAndAddRelaxed(1))) {
+        ring->dropped.fetchAndAddRelaxed(1);
+        return true;
+    }
+
+    // wake the writer up if it is idle or if the ring is filling up; pairs
+    // with the fence in run()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.loadRelaxed() || ring->size() == QAsyncMessageRing::Capacity / 2) {
+        const auto locker = qt_scoped_lock(mutex);
+        wakeUp.wakeOne();
+    }
+    return true;
+}
+
+bool QAsyncMessageSink::hasPending() const
+{
+    for (const QAsyncMessageRing *ring : rings) {
+        if (ring->size() || ring->dropped.loadRelaxed() || ring->finished.loadRelaxed())
+            return true;
+    }
+    return false;
+}
+
+/*!
+    \internal
+
+    Writes out the messages that are pending, and returns true if there were any.
+*/
+bool QAsyncMessageSink::writePending()
+{
+    if (asyncOutputWriting)
+        return false;
+    asyncOutputWriting = true;
+    const auto resetWriting = qScopeGuard([] { asyncOutputWriting = false; });
+
+    const auto writeLocker = qt_scoped_lock(writeMutex);
+    std::vector<QAsyncMessage> batch;
+    int dropped = 0;
+    {
+        const auto locker = qt_scoped_lock(mutex);
+        for (auto it = rings.begin(); it != rings.end(); ) {
+            QAsyncMessageRing *ring = *it;
+            // nothing can be added after the thread is done
+            const bool finished = ring->finished.loadAcquire();
+            ring->takeAll(batch);
+            dropped += ring->dropped.fetchAndStoreRelaxed(0);
+            if (finished) {
+                delete ring;
+                it = rings.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    if (batch.empty() && !dropped)
+        return false;
+
+    // each ring is in order, but the threads' messages interleave
+    std::sort(batch.begin(), batch.end(), [](const QAsyncMessage &lhs, const QAsyncMessage &rhs) {
+        return lhs.sequence < rhs.sequence;
+    });
+    writeAsyncMessages(batch, dropped);
+    return true;
+}
+
+void QAsyncMessageSink::run()
+{
+    // messages about writing messages are written right away
+    asyncOutputDisabled = true;
+
+    auto locker = qt_unique_lock(mutex);
+    while (!quit) {
+        locker.unlock();
+        const bool wrote = writePending();
+        locker.lock();
+        if (quit)
+            break;
+
+        if (wrote) {
+            // give the logging threads time to batch up more messages
+            wakeUp.wait(&mutex, BatchInterval);
+        } else {
+            sleeping.storeRelaxed(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!hasPending())
+                wakeUp.wait(&mutex);
+            sleeping.storeRelaxed(0);
+        }
+    }
+}
+
+Q_GLOBAL_STATIC(QAsyncMessageSink, asyncMessageSink)
+
+static bool asyncOutputEnabled()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("QT_LOGGING_ASYNC");
+    return enabled;
+}
+
+/*!
+    \internal
+
+    Queues the message for the default message handler, and returns false if
+    it has to be handled right away instead.
+*/
+static bool postAsyncMessage(QtMsgType type, const QMessageLogContext &context,
+                             const QString &message)
+{
+    if (!asyncOutputEnabled() || asyncOutputDisabled || asyncOutputWriting || type == QtFatalMsg)
+        return false;
+    QAsyncMessageSink *sink = asyncMessageSink();
+    return sink && sink->post(type, context, message);
+}
+
+#endif // QLOGGING_HAVE_ASYNC
+
+/*!
+    \internal
+
+    Writes out the messages that the asynchronous output has not written yet.
+*/
+static void flushAsyncMessages()
+{
+#ifdef QLOGGING_HAVE_ASYNC
+    if (asyncMessageSink.exists() && !asyncMessageSink.isDestroyed())
+        asyncMessageSink->writePending();
+#endif
+}
+
 static void qt_message_print(QtMsgType msgType, const QMessageLogContext &context, const QString &message)
 {
 #ifndef QT_BOOTSTRAPPED
@@ -1840,6 +2326,13 @@ static void qt_message_print(QtMsgType msgType, const QMessageLogContext &contex
         auto newStye = messageHandler.loadAcquire();
         // prefer new message handler over the old one
         if (newStye || !oldStyle) {
+#ifdef QLOGGING_HAVE_ASYNC
+            if (!newStye && postAsyncMessage(msgType, context, message))
+                return;
+#endif
+            // keep the messages of the default handler in order
+            if (!newStye)
+                flushAsyncMessages();
             (newStye ? newStye : qDefaultMessageHandler)(msgType, context, message);
         } else {
             (oldStyle ? oldStyle : qDefaultMsgHandler)(msgType, message.toLocal8Bit().constData());
@@ -1866,6 +2359,8 @@ static void qt_message_print(const QString &message)
 
 static void qt_message_fatal(QtMsgType, const QMessageLogContext &context, const QString &message)
 {
+    flushAsyncMessages();
+
 #if defined(Q_CC_MSVC) && defined(QT_DEBUG) && defined(_DEBUG) && defined(_CRT_ERROR)
     wchar_t contextFileL[256];
     // we probably should let the compiler do this for us, by declaring QMessageLogContext::file to
@@ -2004,6 +2499,15 @@ void qErrnoWarning(int code, const char *msg, ...)
     output under X11 or to the debugger under Windows. If it is a
     fatal message, the application aborts immediately.
 
+    Since Qt 5.15, setting the \c QT_LOGGING_ASYNC environment variable to a
+    non-zero value makes the default message handler format and write the
+    messages in a background thread, so that logging does not hold up the
+    threads that log. Each thread can have a limited number of messages
+    pending; further messages are dropped, and the number of dropped messages
+    is reported. Pending messages are written before a fatal message, when the
+    message pattern changes, and when the application exits. Patterns using
+    \c{%{backtrace}} are always written right away.
+
     Only one message handler can be defined, since this is usually
     done on an application-wide basis to control debug output.
 
@@ -2114,6 +2618,9 @@ QtMsgHandler qInstallMsgHandler(QtMsgHandler h)
 
 void qSetMessagePattern(const QString &pattern)
 {
+    // the messages that are pending were logged with the old pattern
+    flushAsyncMessages();
+
     const auto locker = qt_scoped_lock(QMessagePattern::mutex);
 
     if (!qMessagePattern()->fromEnvironment)
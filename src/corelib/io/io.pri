@@ -81,6 +81,19 @@ SOURCES += \
 
 qtConfig(zstd): QMAKE_USE_PRIVATE += zstd
 
+qtConfig(asyncfile) {
+    HEADERS += \
+        io/qasyncfile.h \
+        io/qasyncfile_p.h
+    SOURCES += \
+        io/qasyncfile.cpp
+
+    qtConfig(io_uring) {
+        SOURCES += io/qasyncfile_uring.cpp
+        HEADERS += io/qasyncfile_uring_p.h
+    }
+}
+
 qtConfig(filesystemwatcher) {
     HEADERS += \
         io/qfilesystemwatcher.h \
@@ -99,6 +112,10 @@ qtConfig(filesystemwatcher) {
     } else:qtConfig(inotify) {
         SOURCES += io/qfilesystemwatcher_inotify.cpp
         HEADERS += io/qfilesystemwatcher_inotify_p.h
+        qtConfig(fanotify) {
+            SOURCES += io/qfilesystemwatcher_fanotify.cpp
+            HEADERS += io/qfilesystemwatcher_fanotify_p.h
+        }
     } else {
         freebsd|darwin|openbsd|netbsd {
             SOURCES += io/qfilesystemwatcher_kqueue.cpp
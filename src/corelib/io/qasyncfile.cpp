@@ -0,0 +1,480 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qasyncfile.h"
+#include "qasyncfile_p.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qthreadpool.h>
+
+#ifdef Q_OS_UNIX
+#  include <QtCore/private/qcore_unix_p.h>
+#  if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+#    define QT_PREAD ::pread64
+#    define QT_PWRITE ::pwrite64
+#  else
+#    define QT_PREAD ::pread
+#    define QT_PWRITE ::pwrite
+#  endif
+#endif
+
+#if QT_CONFIG(io_uring)
+#  include "qasyncfile_uring_p.h"
+#endif
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+Q_GLOBAL_STATIC(QThreadPool, asyncFileThreadPool)
+
+QThreadPoolAsyncFileBackend::QThreadPoolAsyncFileBackend(QAsyncFilePrivate *d)
+    : d(d), pool(asyncFileThreadPool()), running(0)
+{
+}
+
+void QThreadPoolAsyncFileBackend::submit(QAsyncFileRequest *request)
+{
+    {
+        QMutexLocker locker(&mutex);
+        ++running;
+    }
+    pool->start(QRunnable::create([this, request]() { run(request); }));
+}
+
+void QThreadPoolAsyncFileBackend::run(QAsyncFileRequest *request)
+{
+    const bool isRead = request->type == QAsyncFileRequest::Read;
+#ifdef Q_OS_UNIX
+    // positional I/O leaves the file position alone, so requests on the
+    // same file can run at the same time
+    const int fd = d->file.handle();
+    qint64 ret = 0;
+    if (isRead) {
+        EINTR_LOOP(ret, QT_PREAD(fd, request->buffer.data(), size_t(request->size),
+                                 QT_OFF_T(request->offset)));
+    } else {
+        // unlike a read, a short write is not the end
+        while (ret < request->size) {
+            qint64 written;
+            EINTR_LOOP(written, QT_PWRITE(fd, request->buffer.constData() + ret,
+                                          size_t(request->size - ret),
+                                          QT_OFF_T(request->offset + ret)));
+            if (written <= 0) {
+                ret = written < 0 ? -1 : ret;
+                break;
+            }
+            ret += written;
+        }
+    }
+    if (ret < 0) {
+        request->error = isRead ? QFileDevice::ReadError : QFileDevice::WriteError;
+        request->errorString = qt_error_string(errno);
+    } else {
+        request->transferred = ret;
+    }
+#else
+    {
+        QMutexLocker locker(&fileMutex);
+        QFile &file = d->file;
+        qint64 ret = -1;
+        if (file.seek(request->offset)) {
+            ret = isRead
+                    ? file.read(request->buffer.data(), request->size)
+                    : file.write(request->buffer.constData(), request->size);
+        }
+        if (ret < 0) {
+            request->error = isRead ? QFileDevice::ReadError : QFileDevice::WriteError;
+            request->errorString = file.errorString();
+        } else {
+            request->transferred = ret;
+        }
+    }
+#endif
+
+    // the backend may be gone by the time this runs, but not the file,
+    // which is the context of the call
+    QAsyncFilePrivate *const d = this->d;
+    QMetaObject::invokeMethod(d->q_ptr, [d, request]() { d->requestFinished(request); },
+                              Qt::QueuedConnection);
+
+    QMutexLocker locker(&mutex);
+    if (--running == 0)
+        idle.wakeAll();
+}
+
+void QThreadPoolAsyncFileBackend::waitForFinished()
+{
+    {
+        QMutexLocker locker(&mutex);
+        while (running)
+            idle.wait(&mutex);
+    }
+
+    // every job has posted its completion by now, deliver them
+    QCoreApplication::sendPostedEvents(d->q_ptr, QEvent::MetaCall);
+}
+
+QAsyncFilePrivate::QAsyncFilePrivate()
+    : lastRequestId(0), error(QFileDevice::NoError), generation(0), nativeBackend(false),
+      closing(false)
+{
+}
+
+QAsyncFilePrivate::~QAsyncFilePrivate()
+{
+    qDeleteAll(requests);
+}
+
+quint64 QAsyncFilePrivate::submit(QAsyncFileRequest::Type type, qint64 offset,
+                                  const QByteArray &data, qint64 size)
+{
+    QAsyncFileRequest *request = new QAsyncFileRequest;
+    request->id = ++lastRequestId;
+    request->type = type;
+    request->offset = offset;
+    request->buffer = data;
+    request->size = size;
+    request->transferred = 0;
+    request->error = QFileDevice::NoError;
+    if (type == QAsyncFileRequest::Read)
+        request->buffer.resize(int(size));
+
+    requests.insert(request->id, request);
+    backend->submit(request);
+    return request->id;
+}
+
+void QAsyncFilePrivate::requestFinished(QAsyncFileRequest *request)
+{
+    Q_Q(QAsyncFile);
+    QScopedPointer<QAsyncFileRequest> cleanup(request);
+    requests.remove(request->id);
+    if (closing)
+        return;
+
+    if (request->error != QFileDevice::NoError) {
+        setError(request->error, request->errorString);
+        emit q->errorOccurred(request->id, request->error);
+    } else if (request->type == QAsyncFileRequest::Read) {
+        request->buffer.resize(int(request->transferred));
+        emit q->readFinished(request->id, request->buffer);
+    } else {
+        emit q->writeFinished(request->id, request->transferred);
+    }
+}
+
+void QAsyncFilePrivate::setError(QFileDevice::FileError err, const QString &errStr)
+{
+    error = err;
+    errorString = errStr;
+}
+
+/*!
+    \class QAsyncFile
+    \inmodule QtCore
+    \brief The QAsyncFile class provides non-blocking reads and writes on a file.
+    \since 5.15
+    \reentrant
+    \ingroup io
+
+    QAsyncFile submits positioned reads and writes to a file without
+    blocking the calling thread. Each call to read() or write() returns a
+    request identifier right away; the outcome is reported later from the
+    event loop of the thread QAsyncFile lives in, through readFinished(),
+    writeFinished() or errorOccurred().
+
+    \snippet code/src_corelib_io_qasyncfile.cpp 0
+
+    On Linux, requests are handed to the kernel through an io_uring
+    instance whose completions are picked up by the thread's event
+    dispatcher, so no helper threads are involved. Where io_uring is not
+    available, or if the \c QT_NO_IO_URING environment variable is set,
+    requests are executed on an internal thread pool instead.
+
+    Requests on the same file may be executed concurrently and complete
+    in any order. Only the thread pool used on platforms other than Unix
+    executes the requests on one file one at a time, as it has to move the
+    file position for each of them. Use waitForFinished() to block until all of them are
+    done; close() and the destructor do so implicitly, but the destructor
+    does not emit any signals for the requests it waits for.
+
+    \sa QFile, QFileDevice
+*/
+
+/*!
+    \fn void QAsyncFile::readFinished(quint64 requestId, const QByteArray &data)
+
+    This signal is emitted when the read identified by \a requestId
+    completed. \a data holds the bytes that were read, which can be fewer
+    than requested if the end of the file was reached.
+*/
+
+/*!
+    \fn void QAsyncFile::writeFinished(quint64 requestId, qint64 bytesWritten)
+
+    This signal is emitted when the write identified by \a requestId
+    completed, \a bytesWritten being the number of bytes written.
+*/
+
+/*!
+    \fn void QAsyncFile::errorOccurred(quint64 requestId, QFileDevice::FileError error)
+
+    This signal is emitted when the request identified by \a requestId
+    failed with \a error. errorString() describes the failure.
+*/
+
+/*!
+    Constructs a QAsyncFile object with the given \a parent.
+*/
+QAsyncFile::QAsyncFile(QObject *parent)
+    : QObject(*new QAsyncFilePrivate, parent)
+{
+}
+
+/*!
+    Constructs a QAsyncFile object with the given \a parent, to represent
+    the file with the specified \a name.
+*/
+QAsyncFile::QAsyncFile(const QString &name, QObject *parent)
+    : QObject(*new QAsyncFilePrivate, parent)
+{
+    Q_D(QAsyncFile);
+    d->file.setFileName(name);
+}
+
+/*!
+    Destroys the object, waiting for all pending requests to finish
+    without reporting their results, and closes the file.
+*/
+QAsyncFile::~QAsyncFile()
+{
+    Q_D(QAsyncFile);
+    d->closing = true;
+    close();
+}
+
+/*!
+    Returns the name of the file.
+
+    \sa setFileName()
+*/
+QString QAsyncFile::fileName() const
+{
+    Q_D(const QAsyncFile);
+    return d->file.fileName();
+}
+
+/*!
+    Sets the \a name of the file. Do not call this function if the file
+    is already open.
+
+    \sa fileName()
+*/
+void QAsyncFile::setFileName(const QString &name)
+{
+    Q_D(QAsyncFile);
+    if (isOpen()) {
+        qWarning("QAsyncFile::setFileName: File (%ls) is already opened", qUtf16Printable(fileName()));
+        return;
+    }
+    d->file.setFileName(name);
+}
+
+/*!
+    Opens the file using the given \a mode, which is interpreted as for
+    QFile::open(), and returns \c true if successful.
+
+    \sa close(), isOpen()
+*/
+bool QAsyncFile::open(QIODevice::OpenMode mode)
+{
+    Q_D(QAsyncFile);
+    if (isOpen()) {
+        qWarning("QAsyncFile::open: File (%ls) already open", qUtf16Printable(fileName()));
+        return false;
+    }
+
+    d->setError(QFileDevice::NoError, QString());
+    if (!d->file.open(mode | QIODevice::Unbuffered)) {
+        d->setError(d->file.error(), d->file.errorString());
+        return false;
+    }
+
+#if QT_CONFIG(io_uring)
+    if (qEnvironmentVariableIsEmpty("QT_NO_IO_URING"))
+        d->backend.reset(QIoUringAsyncFileBackend::create(d, d->file.handle()));
+#endif
+    d->nativeBackend = d->backend;
+    if (!d->backend)
+        d->backend.reset(new QThreadPoolAsyncFileBackend(d));
+    return true;
+}
+
+/*!
+    Returns \c true if the file is open.
+*/
+bool QAsyncFile::isOpen() const
+{
+    Q_D(const QAsyncFile);
+    return d->file.isOpen();
+}
+
+/*!
+    Returns the mode the file was opened with.
+*/
+QIODevice::OpenMode QAsyncFile::openMode() const
+{
+    Q_D(const QAsyncFile);
+    return d->file.openMode() & ~QIODevice::Unbuffered;
+}
+
+/*!
+    Waits for all pending requests to finish, then closes the file.
+
+    \sa waitForFinished()
+*/
+void QAsyncFile::close()
+{
+    Q_D(QAsyncFile);
+    if (!isOpen())
+        return;
+
+    waitForFinished();
+    if (!isOpen())
+        return; // closed by a slot in the meantime
+    d->backend.reset();
+    ++d->generation;
+    d->file.close();
+}
+
+/*!
+    Returns the current size of the file.
+*/
+qint64 QAsyncFile::size() const
+{
+    // don't touch d->file, it may be busy on the thread pool
+    return QFileInfo(fileName()).size();
+}
+
+/*!
+    Requests reading up to \a maxSize bytes starting at \a offset and
+    returns the identifier of the request, or 0 if it could not be
+    submitted. The data is delivered through readFinished().
+*/
+quint64 QAsyncFile::read(qint64 offset, qint64 maxSize)
+{
+    Q_D(QAsyncFile);
+    if (!(openMode() & QIODevice::ReadOnly)) {
+        qWarning("QAsyncFile::read: File (%ls) not open for reading", qUtf16Printable(fileName()));
+        return 0;
+    }
+    if (offset < 0 || maxSize < 0 || maxSize > std::numeric_limits<int>::max()) {
+        qWarning("QAsyncFile::read: Invalid offset or size");
+        return 0;
+    }
+    return d->submit(QAsyncFileRequest::Read, offset, QByteArray(), maxSize);
+}
+
+/*!
+    Requests writing \a data at \a offset and returns the identifier of
+    the request, or 0 if it could not be submitted. Completion is reported
+    through writeFinished().
+*/
+quint64 QAsyncFile::write(qint64 offset, const QByteArray &data)
+{
+    Q_D(QAsyncFile);
+    if (!(openMode() & QIODevice::WriteOnly)) {
+        qWarning("QAsyncFile::write: File (%ls) not open for writing", qUtf16Printable(fileName()));
+        return 0;
+    }
+    if (offset < 0) {
+        qWarning("QAsyncFile::write: Invalid offset");
+        return 0;
+    }
+    return d->submit(QAsyncFileRequest::Write, offset, data, data.size());
+}
+
+/*!
+    Returns the number of requests that have been submitted but not yet
+    reported as finished.
+*/
+int QAsyncFile::pendingRequests() const
+{
+    Q_D(const QAsyncFile);
+    return d->requests.size();
+}
+
+/*!
+    Blocks until all pending requests have finished, emitting their
+    signals before returning.
+*/
+void QAsyncFile::waitForFinished()
+{
+    Q_D(QAsyncFile);
+    if (d->backend)
+        d->backend->waitForFinished();
+}
+
+/*!
+    Returns the last error that occurred.
+
+    \sa errorString()
+*/
+QFileDevice::FileError QAsyncFile::error() const
+{
+    Q_D(const QAsyncFile);
+    return d->error;
+}
+
+/*!
+    Returns a human-readable description of the last error that occurred.
+
+    \sa error()
+*/
+QString QAsyncFile::errorString() const
+{
+    Q_D(const QAsyncFile);
+    return d->errorString;
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qasyncfile.cpp"
@@ -0,0 +1,148 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QASYNCFILE_P_H
+#define QASYNCFILE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qasyncfile.h"
+
+#include <QtCore/qfile.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qwaitcondition.h>
+#include <private/qobject_p.h>
+
+QT_REQUIRE_CONFIG(asyncfile);
+
+QT_BEGIN_NAMESPACE
+
+class QThreadPool;
+
+struct QAsyncFileRequest
+{
+    enum Type { Read, Write };
+
+    quint64 id;
+    Type type;
+    qint64 offset;
+    QByteArray buffer;  // destination of a read, source of a write
+    qint64 size;        // bytes requested
+    qint64 transferred; // bytes done so far
+    QFileDevice::FileError error;
+    QString errorString;
+};
+
+class QAsyncFileBackend
+{
+public:
+    virtual ~QAsyncFileBackend() {}
+
+    // Queues \a request; the backend hands it back through
+    // QAsyncFilePrivate::requestFinished() in the file's thread.
+    virtual void submit(QAsyncFileRequest *request) = 0;
+
+    // Blocks until every submitted request was handed back.
+    virtual void waitForFinished() = 0;
+};
+
+class QThreadPoolAsyncFileBackend : public QAsyncFileBackend
+{
+public:
+    explicit QThreadPoolAsyncFileBackend(QAsyncFilePrivate *d);
+
+    void submit(QAsyncFileRequest *request) override;
+    void waitForFinished() override;
+
+private:
+    void run(QAsyncFileRequest *request);
+
+    QAsyncFilePrivate *d;
+    QThreadPool *pool;
+
+#ifndef Q_OS_UNIX
+    QMutex fileMutex; // serialises seek() + read()/write() on d->file
+#endif
+
+    QMutex mutex;
+    QWaitCondition idle;
+    int running;
+};
+
+class QAsyncFilePrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QAsyncFile)
+
+public:
+    QAsyncFilePrivate();
+    ~QAsyncFilePrivate();
+
+    quint64 submit(QAsyncFileRequest::Type type, qint64 offset, const QByteArray &data, qint64 size);
+    void requestFinished(QAsyncFileRequest *request);
+    void setError(QFileDevice::FileError err, const QString &errorString);
+
+    QFile file;
+    QScopedPointer<QAsyncFileBackend> backend;
+    QHash<quint64, QAsyncFileRequest *> requests;
+    quint64 lastRequestId;
+
+    QFileDevice::FileError error;
+    QString errorString;
+
+    // incremented whenever close() destroys the backend, so that a backend
+    // delivering completions can tell that a slot closed the file
+    uint generation;
+    bool nativeBackend;
+    bool closing;
+};
+
+QT_END_NAMESPACE
+
+#endif // QASYNCFILE_P_H
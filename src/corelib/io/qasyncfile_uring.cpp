@@ -0,0 +1,313 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qasyncfile_uring_p.h"
+
+#include <QtCore/qpointer.h>
+#include <QtCore/qsocketnotifier.h>
+#include <private/qcore_unix_p.h>
+
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+QT_BEGIN_NAMESPACE
+
+enum { RingEntries = 64 };
+
+static int io_uring_setup(unsigned entries, io_uring_params *p)
+{
+    return int(syscall(__NR_io_uring_setup, entries, p));
+}
+
+static int io_uring_enter(int ringFd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+    int ret;
+    EINTR_LOOP(ret, int(syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags,
+                                nullptr, 0)));
+    return ret;
+}
+
+static int io_uring_register(int ringFd, unsigned opcode, const void *arg, unsigned nrArgs)
+{
+    return int(syscall(__NR_io_uring_register, ringFd, opcode, arg, nrArgs));
+}
+
+static inline unsigned loadAcquire(const unsigned *p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void storeRelease(unsigned *p, unsigned v)
+{
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+QIoUringAsyncFileBackend::QIoUringAsyncFileBackend(QAsyncFilePrivate *d, int fd)
+    : d(d), fd(fd), ringFd(-1), eventFd(-1), notifier(nullptr),
+      sqRing(MAP_FAILED), sqRingSize(0), cqRing(MAP_FAILED), cqRingSize(0),
+      sqes(static_cast<io_uring_sqe *>(MAP_FAILED)), sqesSize(0),
+      sqHead(nullptr), sqTail(nullptr), sqArray(nullptr), sqMask(0),
+      cqHead(nullptr), cqTail(nullptr), cqMask(0), cqes(nullptr), toSubmit(0)
+{
+}
+
+/*!
+    \internal
+
+    Returns a backend submitting requests on \a fd through a private
+    io_uring instance, or \nullptr if the kernel (or a seccomp policy)
+    does not let us set one up.
+*/
+QIoUringAsyncFileBackend *QIoUringAsyncFileBackend::create(QAsyncFilePrivate *d, int fd)
+{
+    QIoUringAsyncFileBackend *backend = new QIoUringAsyncFileBackend(d, fd);
+    if (!backend->init()) {
+        delete backend;
+        return nullptr;
+    }
+    return backend;
+}
+
+QIoUringAsyncFileBackend::~QIoUringAsyncFileBackend()
+{
+    delete notifier;
+    if (sqes != MAP_FAILED)
+        munmap(sqes, sqesSize);
+    if (cqRing != MAP_FAILED && cqRing != sqRing)
+        munmap(cqRing, cqRingSize);
+    if (sqRing != MAP_FAILED)
+        munmap(sqRing, sqRingSize);
+    if (eventFd != -1)
+        qt_safe_close(eventFd);
+    if (ringFd != -1)
+        qt_safe_close(ringFd);
+}
+
+bool QIoUringAsyncFileBackend::init()
+{
+    io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    ringFd = io_uring_setup(RingEntries, &p);
+    if (ringFd == -1)
+        return false;
+
+    sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMmap = p.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap)
+        sqRingSize = cqRingSize = qMax(sqRingSize, cqRingSize);
+
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                  ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED)
+        return false;
+
+    if (singleMmap) {
+        cqRing = sqRing;
+    } else {
+        cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ringFd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED)
+            return false;
+    }
+
+    sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+    sqes = static_cast<io_uring_sqe *>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+                                            MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES));
+    if (sqes == MAP_FAILED)
+        return false;
+
+    char *sq = static_cast<char *>(sqRing);
+    sqHead = reinterpret_cast<unsigned *>(sq + p.sq_off.head);
+    sqTail = reinterpret_cast<unsigned *>(sq + p.sq_off.tail);
+    sqArray = reinterpret_cast<unsigned *>(sq + p.sq_off.array);
+    sqMask = *reinterpret_cast<unsigned *>(sq + p.sq_off.ring_mask);
+
+    char *cq = static_cast<char *>(cqRing);
+    cqHead = reinterpret_cast<unsigned *>(cq + p.cq_off.head);
+    cqTail = reinterpret_cast<unsigned *>(cq + p.cq_off.tail);
+    cqMask = *reinterpret_cast<unsigned *>(cq + p.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe *>(cq + p.cq_off.cqes);
+
+    // completions are signalled through an eventfd, which plugs into the
+    // thread's event dispatcher like any other socket notifier
+    eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventFd == -1)
+        return false;
+    if (io_uring_register(ringFd, IORING_REGISTER_EVENTFD, &eventFd, 1) == -1)
+        return false;
+
+    // never have more requests in flight than the CQ can hold
+    slotTable.resize(int(p.sq_entries));
+    freeSlots.reserve(slotTable.size());
+    for (int i = slotTable.size() - 1; i >= 0; --i)
+        freeSlots.append(i);
+
+    notifier = new QSocketNotifier(eventFd, QSocketNotifier::Read, d->q_ptr);
+    QObject::connect(notifier, &QSocketNotifier::activated, d->q_ptr,
+                     [this]() { reapCompletions(); });
+    return true;
+}
+
+void QIoUringAsyncFileBackend::submit(QAsyncFileRequest *request)
+{
+    enqueue(request);
+    flush();
+}
+
+void QIoUringAsyncFileBackend::enqueue(QAsyncFileRequest *request)
+{
+    if (freeSlots.isEmpty()) {
+        backlog.enqueue(request);
+        return;
+    }
+
+    const int slotIndex = freeSlots.takeLast();
+    Slot &slot = slotTable[slotIndex];
+    slot.request = request;
+    slot.iov.iov_base = request->buffer.data() + request->transferred;
+    slot.iov.iov_len = size_t(request->size - request->transferred);
+
+    const unsigned tail = *sqTail;
+    const unsigned index = tail & sqMask;
+    io_uring_sqe *sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = request->type == QAsyncFileRequest::Read ? IORING_OP_READV : IORING_OP_WRITEV;
+    sqe->fd = fd;
+    sqe->off = quint64(request->offset + request->transferred);
+    sqe->addr = quintptr(&slot.iov);
+    sqe->len = 1;
+    sqe->user_data = quint64(slotIndex);
+    sqArray[index] = index;
+    storeRelease(sqTail, tail + 1);
+    ++toSubmit;
+}
+
+void QIoUringAsyncFileBackend::flush()
+{
+    if (!toSubmit)
+        return;
+
+    const int ret = io_uring_enter(ringFd, toSubmit, 0, 0);
+    if (ret == -1) {
+        // EAGAIN/EBUSY: the SQEs stay queued and go out with the next call
+        qErrnoWarning("QAsyncFile: io_uring_enter failed");
+        return;
+    }
+    toSubmit -= unsigned(ret);
+}
+
+bool QIoUringAsyncFileBackend::reapCompletions()
+{
+    eventfd_t value;
+    eventfd_read(eventFd, &value);
+
+    unsigned head = *cqHead;
+    const unsigned tail = loadAcquire(cqTail);
+    for ( ; head != tail; ++head) {
+        const io_uring_cqe &cqe = cqes[head & cqMask];
+        const int slotIndex = int(cqe.user_data);
+        QAsyncFileRequest *request = slotTable.at(slotIndex).request;
+        slotTable[slotIndex].request = nullptr;
+        freeSlots.append(slotIndex);
+
+        bool done = true;
+        if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+            done = false;
+        } else if (cqe.res < 0) {
+            request->error = request->type == QAsyncFileRequest::Read
+                    ? QFileDevice::ReadError : QFileDevice::WriteError;
+            request->errorString = qt_error_string(-cqe.res);
+        } else {
+            // short transfers happen at end of file, or for whatever
+            // reason the kernel sees fit: keep going until nothing moves
+            request->transferred += cqe.res;
+            done = cqe.res == 0 || request->transferred == request->size;
+        }
+
+        if (done)
+            completed.enqueue(request);
+        else
+            backlog.prepend(request);
+    }
+    storeRelease(cqHead, head);
+
+    while (!backlog.isEmpty() && !freeSlots.isEmpty())
+        enqueue(backlog.dequeue());
+    flush();
+
+    return deliverCompleted();
+}
+
+// Hands the completed requests to the file. A slot may close the file,
+// which destroys this backend, or delete it; returns false if either
+// happened, and then nothing of this object may be touched anymore.
+bool QIoUringAsyncFileBackend::deliverCompleted()
+{
+    QAsyncFilePrivate *const d = this->d;
+    const QPointer<QObject> file = d->q_ptr;
+    const uint generation = d->generation;
+    while (!completed.isEmpty()) {
+        d->requestFinished(completed.dequeue());
+        if (!file || d->generation != generation)
+            return false;
+    }
+    return true;
+}
+
+void QIoUringAsyncFileBackend::waitForFinished()
+{
+    // requests reaped by an outer call that is still delivering go first,
+    // so that close() from a slot reports them before the file goes away
+    if (!deliverCompleted())
+        return;
+    while (freeSlots.size() != slotTable.size() || !backlog.isEmpty()) {
+        flush();
+        if (io_uring_enter(ringFd, 0, 1, IORING_ENTER_GETEVENTS) == -1) {
+            qErrnoWarning("QAsyncFile: io_uring_enter failed");
+            return;
+        }
+        if (!reapCompletions())
+            return;
+    }
+}
+
+QT_END_NAMESPACE
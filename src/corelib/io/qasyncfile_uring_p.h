@@ -0,0 +1,126 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QASYNCFILE_URING_P_H
+#define QASYNCFILE_URING_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qasyncfile_p.h"
+
+#include <QtCore/qvector.h>
+#include <QtCore/qqueue.h>
+
+#include <sys/uio.h>
+
+QT_REQUIRE_CONFIG(io_uring);
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+QT_BEGIN_NAMESPACE
+
+class QSocketNotifier;
+
+class QIoUringAsyncFileBackend : public QAsyncFileBackend
+{
+public:
+    static QIoUringAsyncFileBackend *create(QAsyncFilePrivate *d, int fd);
+    ~QIoUringAsyncFileBackend();
+
+    void submit(QAsyncFileRequest *request) override;
+    void waitForFinished() override;
+
+private:
+    QIoUringAsyncFileBackend(QAsyncFilePrivate *d, int fd);
+    bool init();
+    void enqueue(QAsyncFileRequest *request);
+    void flush();
+    bool reapCompletions();
+    bool deliverCompleted();
+
+    QAsyncFilePrivate *d;
+    int fd;
+    int ringFd;
+    int eventFd;
+    QSocketNotifier *notifier;
+
+    // the kernel-shared submission and completion rings
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    io_uring_sqe *sqes;
+    size_t sqesSize;
+
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned *sqArray;
+    unsigned sqMask;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned cqMask;
+    io_uring_cqe *cqes;
+    unsigned toSubmit;
+
+    // one slot per SQE; the slot index is the SQE's user_data and owns
+    // the iovec the kernel reads from until the request completes
+    struct Slot {
+        QAsyncFileRequest *request;
+        iovec iov;
+    };
+    QVector<Slot> slotTable;
+    QVector<int> freeSlots;
+    QQueue<QAsyncFileRequest *> backlog;
+    // reaped, but not handed to the file yet
+    QQueue<QAsyncFileRequest *> completed;
+};
+
+QT_END_NAMESPACE
+
+#endif // QASYNCFILE_URING_P_H
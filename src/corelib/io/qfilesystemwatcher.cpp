@@ -44,6 +44,7 @@
 #include <qdir.h>
 #include <qfileinfo.h>
 #include <qloggingcategory.h>
+#include <qmetaobject.h>
 #include <qset.h>
 #include <qtimer.h>
 
@@ -88,7 +89,7 @@ QFileSystemWatcherEngine *QFileSystemWatcherPrivate::createNativeEngine(QObject
 }
 
 QFileSystemWatcherPrivate::QFileSystemWatcherPrivate()
-    : native(nullptr), poller(nullptr)
+    : native(nullptr), poller(nullptr), coalescingTimer(nullptr), coalescingInterval(0)
 {
 }
 
@@ -105,6 +106,8 @@ void QFileSystemWatcherPrivate::init()
                          SIGNAL(directoryChanged(QString,bool)),
                          q,
                          SLOT(_q_directoryChanged(QString,bool)));
+        QObject::connect(native, &QFileSystemWatcherEngine::treeChanged,
+                         q, [this] (const QString &p, const QString &dir) { _q_treeChanged(p, dir); });
 #if defined(Q_OS_WIN) && !defined(Q_OS_WINRT)
         QObject::connect(static_cast<QWindowsFileSystemWatcherEngine *>(native),
                          &QWindowsFileSystemWatcherEngine::driveLockForRemoval,
@@ -138,7 +141,6 @@ void QFileSystemWatcherPrivate::initPollerEngine()
 
 void QFileSystemWatcherPrivate::_q_fileChanged(const QString &path, bool removed)
 {
-    Q_Q(QFileSystemWatcher);
     qCDebug(lcWatcher) << "file changed" << path << "removed?" << removed << "watching?" << files.contains(path);
     if (!files.contains(path)) {
         // the path was removed after a change was detected, but before we delivered the signal
@@ -146,12 +148,11 @@ void QFileSystemWatcherPrivate::_q_fileChanged(const QString &path, bool removed
     }
     if (removed)
         files.removeAll(path);
-    emit q->fileChanged(path, QFileSystemWatcher::QPrivateSignal());
+    addPendingChange(path, FileChange);
 }
 
 void QFileSystemWatcherPrivate::_q_directoryChanged(const QString &path, bool removed)
 {
-    Q_Q(QFileSystemWatcher);
     qCDebug(lcWatcher) << "directory changed" << path << "removed?" << removed << "watching?" << directories.contains(path);
     if (!directories.contains(path)) {
         // perhaps the path was removed after a change was detected, but before we delivered the signal
@@ -159,7 +160,90 @@ void QFileSystemWatcherPrivate::_q_directoryChanged(const QString &path, bool re
     }
     if (removed)
         directories.removeAll(path);
-    emit q->directoryChanged(path, QFileSystemWatcher::QPrivateSignal());
+    addPendingChange(path, DirectoryChange);
+}
+
+void QFileSystemWatcherPrivate::_q_treeChanged(const QString &path, const QString &directory)
+{
+    qCDebug(lcWatcher) << "tree entry changed" << path << "in" << directory;
+    if (!directory.isEmpty())
+        addPendingChange(directory, DirectoryChange);
+    addPendingChange(path, 0);
+}
+
+void QFileSystemWatcherPrivate::addPendingChange(const QString &path, int changes)
+{
+    Q_Q(QFileSystemWatcher);
+    if (coalescingInterval == 0) {
+        // report right away; only pathsChanged() collects the changes
+        // detected in one pass of the event loop
+        if (changes & FileChange)
+            emit q->fileChanged(path, QFileSystemWatcher::QPrivateSignal());
+        if (changes & DirectoryChange)
+            emit q->directoryChanged(path, QFileSystemWatcher::QPrivateSignal());
+        static const QMetaMethod pathsChangedSignal =
+                QMetaMethod::fromSignal(&QFileSystemWatcher::pathsChanged);
+        if (!q->isSignalConnected(pathsChangedSignal))
+            return;
+        changes = 0;
+    }
+
+    const auto it = pendingChangeIndex.constFind(path);
+    if (it == pendingChangeIndex.constEnd()) {
+        pendingChangeIndex.insert(path, pendingChanges.size());
+        pendingChanges.append(qMakePair(path, changes));
+    } else {
+        QPair<QString, int> &change = pendingChanges[it.value()];
+        change.second = (change.second & ~Discarded) | changes;
+    }
+
+    if (!coalescingTimer) {
+        coalescingTimer = new QTimer(q);
+        coalescingTimer->setSingleShot(true);
+        QObject::connect(coalescingTimer, &QTimer::timeout,
+                         q, [this] () { deliverPendingChanges(); });
+    }
+    // not restarted by later changes, so that a steady stream of changes
+    // is still reported once per interval
+    if (!coalescingTimer->isActive())
+        coalescingTimer->start(coalescingInterval);
+}
+
+void QFileSystemWatcherPrivate::discardPendingChanges(const QStringList &paths)
+{
+    // the paths are no longer watched, so their pending changes, as well
+    // as those inside directory trees rooted at them, must not be reported
+    if (pendingChanges.isEmpty())
+        return;
+    for (const QString &path : paths) {
+        const QString prefix = path.endsWith(QLatin1Char('/')) ? path : path + QLatin1Char('/');
+        for (QPair<QString, int> &change : pendingChanges) {
+            if (change.first == path || change.first.startsWith(prefix))
+                change.second = Discarded;
+        }
+    }
+}
+
+void QFileSystemWatcherPrivate::deliverPendingChanges()
+{
+    Q_Q(QFileSystemWatcher);
+    const QVector<QPair<QString, int>> changes = std::move(pendingChanges);
+    pendingChanges.clear();
+    pendingChangeIndex.clear();
+
+    QStringList paths;
+    paths.reserve(changes.size());
+    for (const QPair<QString, int> &change : changes) {
+        if (change.second & Discarded)
+            continue;
+        if (change.second & FileChange)
+            emit q->fileChanged(change.first, QFileSystemWatcher::QPrivateSignal());
+        if (change.second & DirectoryChange)
+            emit q->directoryChanged(change.first, QFileSystemWatcher::QPrivateSignal());
+        paths.append(change.first);
+    }
+    if (!paths.isEmpty())
+        emit q->pathsChanged(paths, QFileSystemWatcher::QPrivateSignal());
 }
 
 #if defined(Q_OS_WIN) && !defined(Q_OS_WINRT)
@@ -229,6 +313,15 @@ void  QFileSystemWatcherPrivate::_q_winDriveRemoved(const QString &path)
     they have been renamed or removed from disk, and directories once
     they have been removed from disk.
 
+    A whole directory tree can be watched with addRecursivePath(). New
+    subdirectories are watched as they appear, and changes to the files
+    and directories anywhere in the tree are reported.
+
+    When many changes happen in a short time, for example during a build,
+    set coalescingInterval to collect them: each path is then reported
+    at most once per interval, and the pathsChanged() signal delivers all
+    the paths that changed in one list.
+
     \list
     \li \b Notes:
     \list
@@ -441,10 +534,94 @@ QStringList QFileSystemWatcher::removePaths(const QStringList &paths)
         p = d->native->removePaths(p, &d->files, &d->directories);
     if (d->poller)
         p = d->poller->removePaths(p, &d->files, &d->directories);
+    d->discardPendingChanges(paths);
 
     return p;
 }
 
+/*!
+    \since 5.15
+
+    Adds \a directory and all the directories below it to the file system
+    watcher. Directories that are created in the tree later, or moved into
+    it, are watched as well. Returns \c true if the tree is being watched.
+
+    A change anywhere in the tree emits the directoryChanged() signal with
+    the path of the directory whose entries changed, which may be
+    \a directory itself or one of its subdirectories. The pathsChanged()
+    signal additionally lists the files and directories in the tree that
+    were created, modified, removed or renamed. fileChanged() is not
+    emitted for the files in the tree.
+
+    \a directory is listed by directories() and can be removed with
+    removePath(), which stops watching the whole tree. It is not added if
+    it does not exist, is not a directory, or overlaps a path already
+    being watched.
+
+    On Linux, if the process has the required privileges, a single
+    fanotify mark watches all the trees on a file system, so the size of
+    a tree is not limited by the number of inotify watches. Otherwise one
+    inotify watch is used for each directory in the tree. Set the
+    \c QT_NO_FANOTIFY environment variable to always use inotify.
+
+    \note Recursive watches are currently only supported on Linux; on
+    other platforms this function returns \c false.
+
+    \sa addPath(), removePath(), pathsChanged()
+*/
+bool QFileSystemWatcher::addRecursivePath(const QString &directory)
+{
+    Q_D(QFileSystemWatcher);
+
+    if (directory.isEmpty()) {
+        qWarning("QFileSystemWatcher::addRecursivePath: path is empty");
+        return true;
+    }
+    qCDebug(lcWatcher) << "adding recursively" << directory;
+
+    QStringList p(directory);
+    if (d->native)
+        p = d->native->addRecursivePaths(p, &d->directories);
+    return p.isEmpty();
+}
+
+/*!
+    \property QFileSystemWatcher::coalescingInterval
+    \brief the time in milliseconds during which changes are collected
+    before they are reported
+    \since 5.15
+
+    If the interval is greater than 0, a change starts collecting changes
+    for the given time. After that, fileChanged() and directoryChanged()
+    are emitted once for each path that changed, in the order of their
+    first change, followed by pathsChanged() with all of them. Further
+    changes are collected for the next interval, so a steady stream of
+    changes is still reported once per interval.
+
+    The default is 0: fileChanged() and directoryChanged() are emitted as
+    soon as a change is detected, and pathsChanged() reports the changes
+    detected in the same pass of the event loop.
+
+    \sa pathsChanged()
+*/
+int QFileSystemWatcher::coalescingInterval() const
+{
+    Q_D(const QFileSystemWatcher);
+    return d->coalescingInterval;
+}
+
+void QFileSystemWatcher::setCoalescingInterval(int msecs)
+{
+    Q_D(QFileSystemWatcher);
+    if (msecs < 0) {
+        qWarning("QFileSystemWatcher::setCoalescingInterval: interval cannot be negative");
+        msecs = 0;
+    }
+    d->coalescingInterval = msecs;
+    if (d->coalescingTimer && d->coalescingTimer->isActive())
+        d->coalescingTimer->start(msecs);
+}
+
 /*!
     \fn void QFileSystemWatcher::fileChanged(const QString &path)
 
@@ -473,6 +650,23 @@ QStringList QFileSystemWatcher::removePaths(const QStringList &paths)
     \sa fileChanged()
 */
 
+/*!
+    \fn void QFileSystemWatcher::pathsChanged(const QStringList &paths)
+    \since 5.15
+
+    This signal is emitted with the \a paths of all the watched files and
+    directories that changed since it was last emitted. For directories
+    watched with addRecursivePath(), \a paths also contains the files and
+    directories in the tree that were created, modified, removed or
+    renamed. Each path is listed once, in the order of its first change.
+
+    The signal is emitted at most once per coalescingInterval, or, if the
+    interval is 0, once per pass of the event loop in which changes were
+    detected.
+
+    \sa fileChanged(), directoryChanged(), coalescingInterval
+*/
+
 /*!
     \fn QStringList QFileSystemWatcher::directories() const
 
@@ -53,6 +53,7 @@ class Q_CORE_EXPORT QFileSystemWatcher : public QObject
 {
     Q_OBJECT
     Q_DECLARE_PRIVATE(QFileSystemWatcher)
+    Q_PROPERTY(int coalescingInterval READ coalescingInterval WRITE setCoalescingInterval)
 
 public:
     QFileSystemWatcher(QObject *parent = nullptr);
@@ -63,6 +64,10 @@ public:
     QStringList addPaths(const QStringList &files);
     bool removePath(const QString &file);
     QStringList removePaths(const QStringList &files);
+    bool addRecursivePath(const QString &directory);
+
+    int coalescingInterval() const;
+    void setCoalescingInterval(int msecs);
 
     QStringList files() const;
     QStringList directories() const;
@@ -70,6 +75,7 @@ public:
 Q_SIGNALS:
     void fileChanged(const QString &path, QPrivateSignal);
     void directoryChanged(const QString &path, QPrivateSignal);
+    void pathsChanged(const QStringList &paths, QPrivateSignal);
 
 private:
     Q_PRIVATE_SLOT(d_func(), void _q_fileChanged(const QString &path, bool removed))
@@ -0,0 +1,320 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qfilesystemwatcher_fanotify_p.h"
+
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <private/qcore_unix_p.h>
+
+#include <fcntl.h>
+#include <sys/fanotify.h>
+#include <sys/statfs.h>
+
+QT_BEGIN_NAMESPACE
+
+// With FAN_REPORT_DFID_NAME, every event comes with the file handle of a
+// directory and the name of the entry in it, even for events on files.
+// The mark covers the whole file system, so events outside the trees are
+// dropped once their directory has been mapped to a path.
+enum : quint64 {
+    TreeEventMask = FAN_CREATE | FAN_DELETE | FAN_MOVED_FROM | FAN_MOVED_TO
+                  | FAN_MODIFY | FAN_ATTRIB | FAN_ONDIR,
+    EntriesChangedMask = FAN_CREATE | FAN_DELETE | FAN_MOVED_FROM | FAN_MOVED_TO
+};
+
+enum { DirectoryCacheLimit = 65536 };
+
+static inline QString childPath(const QString &directory, const QString &name)
+{
+    if (directory.endsWith(QLatin1Char('/')))
+        return directory + name;
+    return directory + QLatin1Char('/') + name;
+}
+
+static QByteArray fileSystemId(int fd)
+{
+    struct statfs buf;
+    if (::fstatfs(fd, &buf) != 0)
+        return QByteArray();
+    return QByteArray(reinterpret_cast<const char *>(&buf.f_fsid), sizeof(buf.f_fsid));
+}
+
+// checks that file handles on the file system of \a fd can be opened, which
+// needs CAP_DAC_READ_SEARCH
+static bool canOpenHandles(int fd)
+{
+    alignas(file_handle) char buffer[sizeof(file_handle) + MAX_HANDLE_SZ];
+    file_handle *handle = reinterpret_cast<file_handle *>(buffer);
+    handle->handle_bytes = MAX_HANDLE_SZ;
+    int mountId;
+    if (name_to_handle_at(fd, "", handle, &mountId, AT_EMPTY_PATH) == -1)
+        return false;
+    const int handleFd = open_by_handle_at(fd, handle, O_PATH | O_CLOEXEC);
+    if (handleFd == -1)
+        return false;
+    qt_safe_close(handleFd);
+    return true;
+}
+
+QFanotifyTreeWatcher *QFanotifyTreeWatcher::create(QObject *parent)
+{
+    const int fd = fanotify_init(FAN_CLASS_NOTIF | FAN_CLOEXEC | FAN_NONBLOCK
+                                 | FAN_REPORT_DFID_NAME, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return nullptr;
+    return new QFanotifyTreeWatcher(fd, parent);
+}
+
+QFanotifyTreeWatcher::QFanotifyTreeWatcher(int fd, QObject *parent)
+    : QObject(parent),
+      fanotifyFd(fd),
+      notifier(fd, QSocketNotifier::Read, this)
+{
+    connect(&notifier, &QSocketNotifier::activated, this, &QFanotifyTreeWatcher::readFromFanotify);
+}
+
+QFanotifyTreeWatcher::~QFanotifyTreeWatcher()
+{
+    notifier.setEnabled(false);
+    for (const FileSystem &fileSystem : qAsConst(fileSystems))
+        qt_safe_close(fileSystem.fd);
+    qt_safe_close(fanotifyFd);
+}
+
+bool QFanotifyTreeWatcher::addTree(const QString &path)
+{
+    const QString canonicalPath = QFileInfo(path).canonicalFilePath();
+    if (canonicalPath.isEmpty())
+        return false;
+    const int fd = qt_safe_open(QFile::encodeName(canonicalPath).constData(),
+                                O_RDONLY | O_DIRECTORY);
+    if (fd == -1)
+        return false;
+    const QByteArray fsid = fileSystemId(fd);
+
+    auto fileSystem = fileSystems.find(fsid);
+    if (fileSystem != fileSystems.end()) {
+        qt_safe_close(fd);
+    } else {
+        if (fsid.isEmpty()
+                || fanotify_mark(fanotifyFd, FAN_MARK_ADD | FAN_MARK_FILESYSTEM,
+                                 TreeEventMask, fd, nullptr) == -1) {
+            qt_safe_close(fd);
+            return false;
+        }
+        if (!canOpenHandles(fd)) {
+            fanotify_mark(fanotifyFd, FAN_MARK_REMOVE | FAN_MARK_FILESYSTEM,
+                          TreeEventMask, fd, nullptr);
+            qt_safe_close(fd);
+            return false;
+        }
+        // the directory is kept open for open_by_handle_at()
+        fileSystem = fileSystems.insert(fsid, FileSystem{fd, 0});
+    }
+
+    ++fileSystem->trees;
+    trees.append(Tree{path, canonicalPath, fsid});
+    return true;
+}
+
+bool QFanotifyTreeWatcher::removeTree(const QString &path)
+{
+    for (int i = 0; i < trees.size(); ++i) {
+        if (trees.at(i).path == path) {
+            releaseFileSystem(trees.takeAt(i).fsid);
+            return true;
+        }
+    }
+    return false;
+}
+
+QStringList QFanotifyTreeWatcher::roots() const
+{
+    QStringList result;
+    result.reserve(trees.size());
+    for (const Tree &tree : trees)
+        result.append(tree.path);
+    return result;
+}
+
+void QFanotifyTreeWatcher::releaseFileSystem(const QByteArray &fsid)
+{
+    const auto fileSystem = fileSystems.find(fsid);
+    if (fileSystem == fileSystems.end() || --fileSystem->trees > 0)
+        return;
+    fanotify_mark(fanotifyFd, FAN_MARK_REMOVE | FAN_MARK_FILESYSTEM,
+                  TreeEventMask, fileSystem->fd, nullptr);
+    qt_safe_close(fileSystem->fd);
+    fileSystems.erase(fileSystem);
+    directoryCache.clear();
+}
+
+QString QFanotifyTreeWatcher::directoryForHandle(const QByteArray &fsid, const char *handle, int size)
+{
+    QByteArray key = fsid;
+    key.append(handle, size);
+    const auto cached = directoryCache.constFind(key);
+    if (cached != directoryCache.constEnd())
+        return cached.value();
+
+    const auto fileSystem = fileSystems.constFind(fsid);
+    alignas(file_handle) char buffer[sizeof(file_handle) + MAX_HANDLE_SZ];
+    if (fileSystem == fileSystems.constEnd() || size > int(sizeof(buffer)))
+        return QString();
+    memcpy(buffer, handle, size);
+    const int fd = open_by_handle_at(fileSystem->fd, reinterpret_cast<file_handle *>(buffer),
+                                     O_PATH | O_CLOEXEC);
+    if (fd == -1)
+        return QString(); // e.g. deleted in the meantime
+
+    char target[PATH_MAX];
+    const QByteArray link = "/proc/self/fd/" + QByteArray::number(fd);
+    const ssize_t length = ::readlink(link.constData(), target, sizeof(target));
+    qt_safe_close(fd);
+    if (length <= 0 || length == ssize_t(sizeof(target)) || target[0] != '/')
+        return QString();
+    const QByteArray nativePath(target, int(length));
+    if (nativePath.endsWith(" (deleted)"))
+        return QString();
+
+    if (directoryCache.size() >= DirectoryCacheLimit)
+        directoryCache.clear();
+    const QString directory = QFile::decodeName(nativePath);
+    directoryCache.insert(key, directory);
+    return directory;
+}
+
+void QFanotifyTreeWatcher::readFromFanotify()
+{
+    alignas(fanotify_event_metadata) char buffer[16384];
+    for (;;) {
+        qint64 length = qt_safe_read(fanotifyFd, buffer, sizeof(buffer));
+        if (length <= 0)
+            return;
+
+        auto *event = reinterpret_cast<fanotify_event_metadata *>(buffer);
+        for (; FAN_EVENT_OK(event, length); event = FAN_EVENT_NEXT(event, length)) {
+            if (event->vers != FANOTIFY_METADATA_VERSION)
+                return;
+
+            if (event->mask & FAN_Q_OVERFLOW) {
+                // events were lost, so report the trees as changed to make users rescan them
+                const QVector<Tree> current = trees;
+                for (const Tree &tree : current)
+                    emit treeChanged(tree.path, tree.path);
+                continue;
+            }
+
+            const auto *info = reinterpret_cast<const fanotify_event_info_fid *>(event + 1);
+            if (event->event_len < sizeof(*event) + sizeof(*info)
+                    || (info->hdr.info_type != FAN_EVENT_INFO_TYPE_DFID_NAME
+                        && info->hdr.info_type != FAN_EVENT_INFO_TYPE_DFID)) {
+                continue;
+            }
+            const auto *handle = reinterpret_cast<const file_handle *>(info->handle);
+            const QByteArray fsid(reinterpret_cast<const char *>(&info->fsid), sizeof(info->fsid));
+            const QString directory =
+                    directoryForHandle(fsid, reinterpret_cast<const char *>(handle),
+                                       int(sizeof(file_handle) + handle->handle_bytes));
+            if (directory.isEmpty())
+                continue;
+
+            QString path = directory;
+            if (info->hdr.info_type == FAN_EVENT_INFO_TYPE_DFID_NAME) {
+                const char *name = reinterpret_cast<const char *>(handle->f_handle)
+                        + handle->handle_bytes;
+                if (qstrcmp(name, ".") != 0)
+                    path = childPath(directory, QFile::decodeName(name));
+            }
+            handleEvent(event->mask, path, directory);
+
+            // the cached paths of the directories below it are stale now
+            if ((event->mask & FAN_ONDIR) && (event->mask & FAN_MOVED_FROM))
+                directoryCache.clear();
+        }
+    }
+}
+
+void QFanotifyTreeWatcher::handleEvent(quint64 mask, const QString &canonicalPath,
+                                       const QString &canonicalDirectory)
+{
+    if (mask & (FAN_DELETE | FAN_MOVED_FROM)) {
+        // a tree is gone when its root or a directory above it is
+        const QString prefix = childPath(canonicalPath, QString());
+        QStringList removed;
+        for (int i = trees.size() - 1; i >= 0; --i) {
+            const Tree &tree = trees.at(i);
+            if (tree.canonicalPath == canonicalPath || tree.canonicalPath.startsWith(prefix)) {
+                removed.append(tree.path);
+                releaseFileSystem(trees.takeAt(i).fsid);
+            }
+        }
+        for (const QString &root : qAsConst(removed))
+            emit treeRemoved(root);
+        if (!removed.isEmpty())
+            return;
+    }
+
+    for (const Tree &tree : qAsConst(trees)) {
+        if (canonicalPath == tree.canonicalPath) {
+            if (mask & FAN_ATTRIB)
+                emit treeChanged(tree.path, QString());
+            return;
+        }
+        const QString prefix = childPath(tree.canonicalPath, QString());
+        if (!canonicalPath.startsWith(prefix))
+            continue;
+
+        // report the paths below the root as it was given to addTree()
+        const QString path = childPath(tree.path, canonicalPath.mid(prefix.size()));
+        QString directory;
+        if (mask & EntriesChangedMask) {
+            directory = canonicalDirectory == tree.canonicalPath
+                    ? tree.path
+                    : childPath(tree.path, canonicalDirectory.mid(prefix.size()));
+        }
+        emit treeChanged(path, directory);
+        return;
+    }
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qfilesystemwatcher_fanotify_p.cpp"
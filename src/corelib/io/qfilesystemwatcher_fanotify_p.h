@@ -0,0 +1,118 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFILESYSTEMWATCHER_FANOTIFY_P_H
+#define QFILESYSTEMWATCHER_FANOTIFY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+
+QT_REQUIRE_CONFIG(fanotify);
+
+#include <QtCore/qhash.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qsocketnotifier.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+// Watches directory trees with one fanotify mark per file system. This
+// needs CAP_SYS_ADMIN for the mark and CAP_DAC_READ_SEARCH to map the
+// reported file handles back to paths, so create() and addTree() fail
+// for unprivileged processes, and the inotify engine watches the trees
+// itself.
+class QFanotifyTreeWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    ~QFanotifyTreeWatcher();
+
+    static QFanotifyTreeWatcher *create(QObject *parent);
+
+    bool addTree(const QString &path);
+    bool removeTree(const QString &path);
+    QStringList roots() const;
+
+Q_SIGNALS:
+    void treeChanged(const QString &path, const QString &directory);
+    void treeRemoved(const QString &path);
+
+private Q_SLOTS:
+    void readFromFanotify();
+
+private:
+    QFanotifyTreeWatcher(int fd, QObject *parent);
+
+    struct Tree {
+        QString path;           // as passed to addTree()
+        QString canonicalPath;  // as reported for the file handles
+        QByteArray fsid;
+    };
+    struct FileSystem {
+        int fd;     // a directory on the file system, for open_by_handle_at()
+        int trees;
+    };
+
+    QString directoryForHandle(const QByteArray &fsid, const char *handle, int size);
+    void handleEvent(quint64 mask, const QString &canonicalPath, const QString &canonicalDirectory);
+    void releaseFileSystem(const QByteArray &fsid);
+
+    int fanotifyFd;
+    QSocketNotifier notifier;
+    QVector<Tree> trees;
+    QHash<QByteArray, FileSystem> fileSystems;
+    // file handle (with the fsid) -> directory path
+    QHash<QByteArray, QString> directoryCache;
+};
+
+QT_END_NAMESPACE
+
+#endif // QFILESYSTEMWATCHER_FANOTIFY_P_H
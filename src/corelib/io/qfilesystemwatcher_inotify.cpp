@@ -39,11 +39,15 @@
 
 #include "qfilesystemwatcher.h"
 #include "qfilesystemwatcher_inotify_p.h"
+#if QT_CONFIG(fanotify)
+#include "qfilesystemwatcher_fanotify_p.h"
+#endif
 
 #include "private/qcore_unix_p.h"
 #include "private/qsystemerror_p.h"
 
 #include <qdebug.h>
+#include <qdiriterator.h>
 #include <qfile.h>
 #include <qfileinfo.h>
 #include <qscopeguard.h>
@@ -208,6 +212,9 @@ struct inotify_event {
 #define IN_UNMOUNT              0x00002000
 #define IN_Q_OVERFLOW           0x00004000
 #define IN_IGNORED              0x00008000
+#define IN_ONLYDIR              0x01000000
+#define IN_MASK_ADD             0x20000000
+#define IN_ISDIR                0x40000000
 
 #define IN_CLOSE                (IN_CLOSE_WRITE | IN_CLOSE_NOWRITE)
 #define IN_MOVE                 (IN_MOVED_FROM | IN_MOVED_TO)
@@ -233,6 +240,21 @@ static inline int inotify_init1(int flags)
 
 QT_BEGIN_NAMESPACE
 
+// watches on directories may be shared between addPaths() and trees, so
+// both use IN_MASK_ADD to not take events away from each other
+enum : uint {
+    DirectoryWatchMask = IN_ATTRIB | IN_MOVE | IN_CREATE | IN_DELETE | IN_DELETE_SELF,
+    TreeWatchMask = DirectoryWatchMask | IN_MODIFY | IN_MOVE_SELF | IN_ONLYDIR,
+    TreeOnlyEvents = TreeWatchMask & ~(DirectoryWatchMask | IN_ONLYDIR)
+};
+
+static inline QString childPath(const QString &directory, const QString &name)
+{
+    if (directory.endsWith(QLatin1Char('/')))
+        return directory + name;
+    return directory + QLatin1Char('/') + name;
+}
+
 QInotifyFileSystemWatcherEngine *QInotifyFileSystemWatcherEngine::create(QObject *parent)
 {
     int fd = -1;
@@ -261,6 +283,8 @@ QInotifyFileSystemWatcherEngine::~QInotifyFileSystemWatcherEngine()
     notifier.setEnabled(false);
     for (int id : qAsConst(pathToID))
         inotify_rm_watch(inotifyFd, id < 0 ? -id : id);
+    for (auto it = treeWdToPath.cbegin(), end = treeWdToPath.cend(); it != end; ++it)
+        inotify_rm_watch(inotifyFd, it.key());
 
     ::close(inotifyFd);
 }
@@ -285,13 +309,7 @@ QStringList QInotifyFileSystemWatcherEngine::addPaths(const QStringList &paths,
         int wd = inotify_add_watch(inotifyFd,
                                    QFile::encodeName(path),
                                    (isDir
-                                    ? (0
-                                       | IN_ATTRIB
-                                       | IN_MOVE
-                                       | IN_CREATE
-                                       | IN_DELETE
-                                       | IN_DELETE_SELF
-                                       )
+                                    ? (DirectoryWatchMask | IN_MASK_ADD)
                                     : (0
                                        | IN_ATTRIB
                                        | IN_MODIFY
@@ -327,6 +345,18 @@ QStringList QInotifyFileSystemWatcherEngine::removePaths(const QStringList &path
 {
     QStringList unhandled;
     for (const QString &path : paths) {
+        if (treeRoots.removeOne(path)) {
+            removeTreeWatches(path);
+            directories->removeAll(path);
+            continue;
+        }
+#if QT_CONFIG(fanotify)
+        if (fanotify && fanotify->removeTree(path)) {
+            directories->removeAll(path);
+            continue;
+        }
+#endif
+
         int id = pathToID.take(path);
 
         auto sg = qScopeGuard([&]{ unhandled.push_back(path); });
@@ -344,10 +374,8 @@ QStringList QInotifyFileSystemWatcherEngine::removePaths(const QStringList &path
         idToPath.erase(path_it);
 
         // If there was only one path associated to the given id we should remove the watch
-        if (num_elements == 1) {
-            int wd = id < 0 ? -id : id;
-            inotify_rm_watch(inotifyFd, wd);
-        }
+        if (num_elements == 1)
+            removeWatch(id < 0 ? -id : id);
 
         sg.dismiss();
 
@@ -377,13 +405,24 @@ void QInotifyFileSystemWatcherEngine::readFromInotify()
     QHash<int, inotify_event *> eventForId;
     while (at < end) {
         inotify_event *event = reinterpret_cast<inotify_event *>(at);
+        at += sizeof(inotify_event) + event->len;
 
+        // trees need every event, with the name of the entry
+        if (!treeRoots.isEmpty())
+            handleTreeEvent(event->wd, event->mask, event->len ? event->name : nullptr);
+
+        if (!idToPath.contains(event->wd)) {
+            if (!idToPath.contains(-event->wd))
+                continue;
+            // drop what only a tree sharing the directory watch asked for
+            event->mask &= ~TreeOnlyEvents;
+            if (!(event->mask & ~IN_ISDIR))
+                continue;
+        }
         if (eventForId.contains(event->wd))
             eventForId[event->wd]->mask |= event->mask;
         else
             eventForId.insert(event->wd, event);
-
-        at += sizeof(inotify_event) + event->len;
     }
 
     QHash<int, inotify_event *>::const_iterator it = eventForId.constBegin();
@@ -402,14 +441,13 @@ void QInotifyFileSystemWatcherEngine::readFromInotify()
             if (path.isEmpty())
                 continue;
         }
-
         // qDebug() << "event for path" << path;
 
         if ((event.mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT)) != 0) {
             pathToID.remove(path);
             idToPath.remove(id, getPathFromID(id));
             if (!idToPath.contains(id))
-                inotify_rm_watch(inotifyFd, event.wd);
+                removeWatch(event.wd);
 
             if (id < 0)
                 emit directoryChanged(path, true);
@@ -447,6 +485,186 @@ QString QInotifyFileSystemWatcherEngine::getPathFromID(int id) const
     return i == idToPath.cend() ? QString() : i.value() ;
 }
 
+void QInotifyFileSystemWatcherEngine::removeWatch(int wd)
+{
+    if (!idToPath.contains(wd) && !idToPath.contains(-wd) && !treeWdToPath.contains(wd))
+        inotify_rm_watch(inotifyFd, wd);
+}
+
+QStringList QInotifyFileSystemWatcherEngine::addRecursivePaths(const QStringList &paths,
+                                                               QStringList *directories)
+{
+    QStringList unhandled;
+    for (const QString &path : paths) {
+        if (!QFileInfo(path).isDir() || directories->contains(path) || overlapsTree(path)) {
+            unhandled.push_back(path);
+            continue;
+        }
+#if QT_CONFIG(fanotify)
+        if (QFanotifyTreeWatcher *watcher = fanotifyTreeWatcher()) {
+            if (watcher->addTree(path)) {
+                directories->append(path);
+                continue;
+            }
+        }
+#endif
+        if (!addTreeWatches(path, false)) {
+            unhandled.push_back(path);
+            continue;
+        }
+        treeRoots.append(path);
+        directories->append(path);
+    }
+    return unhandled;
+}
+
+bool QInotifyFileSystemWatcherEngine::overlapsTree(const QString &path) const
+{
+    QStringList roots = treeRoots;
+#if QT_CONFIG(fanotify)
+    if (fanotify)
+        roots += fanotify->roots();
+#endif
+    const QString prefix = childPath(path, QString());
+    for (const QString &root : qAsConst(roots)) {
+        if (root == path || root.startsWith(prefix) || path.startsWith(childPath(root, QString())))
+            return true;
+    }
+    return false;
+}
+
+// Watches \a directory and every directory below it. If \a reportEntries is
+// true, the directory has just appeared in a tree, and everything found in it
+// is reported as changed, since it was created before the watches existed.
+bool QInotifyFileSystemWatcherEngine::addTreeWatches(const QString &directory, bool reportEntries)
+{
+    const auto addWatch = [this](const QString &path) {
+        if (treePathToWd.contains(path))
+            return true;
+        const int wd = inotify_add_watch(inotifyFd, QFile::encodeName(path),
+                                         TreeWatchMask | IN_MASK_ADD);
+        if (wd < 0) {
+            if (errno == ENOSPC) {
+                if (!watchLimitReported) {
+                    watchLimitReported = true;
+                    qWarning("QFileSystemWatcher: the inotify watch limit was reached, not all "
+                             "directories are watched (see /proc/sys/fs/inotify/max_user_watches)");
+                }
+            } else if (errno != ENOENT && errno != ENOTDIR) {
+                qErrnoWarning("inotify_add_watch(%ls) failed:", path.constData());
+            }
+            return false;
+        }
+        // a directory moved within the tree may still be known by its old name
+        const auto old = treeWdToPath.constFind(wd);
+        if (old != treeWdToPath.constEnd())
+            treePathToWd.remove(old.value());
+        treePathToWd.insert(path, wd);
+        treeWdToPath.insert(wd, path);
+        return true;
+    };
+
+    if (!addWatch(directory))
+        return false;
+
+    // each directory is watched before its entries are listed, so entries
+    // created in the meantime are either listed or reported by the watch
+    const QDir::Filters filters = (reportEntries ? QDir::AllEntries : QDir::Dirs)
+            | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System;
+    QDirIterator it(directory, filters, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        const QFileInfo info = it.fileInfo();
+        if (reportEntries)
+            emit treeChanged(path, info.path());
+        if (info.isDir() && !info.isSymLink())
+            addWatch(path);
+    }
+    return true;
+}
+
+void QInotifyFileSystemWatcherEngine::removeTreeWatch(const QString &directory)
+{
+    const auto it = treePathToWd.find(directory);
+    if (it == treePathToWd.end())
+        return;
+    const int wd = it.value();
+    treePathToWd.erase(it);
+    treeWdToPath.remove(wd);
+    removeWatch(wd);
+}
+
+void QInotifyFileSystemWatcherEngine::removeTreeWatches(const QString &directory)
+{
+    const QString prefix = childPath(directory, QString());
+    QStringList below;
+    for (auto it = treePathToWd.cbegin(), end = treePathToWd.cend(); it != end; ++it) {
+        if (it.key().startsWith(prefix))
+            below.push_back(it.key());
+    }
+    removeTreeWatch(directory);
+    for (const QString &path : qAsConst(below))
+        removeTreeWatch(path);
+}
+
+void QInotifyFileSystemWatcherEngine::handleTreeEvent(int wd, uint mask, const char *name)
+{
+    if (mask & IN_Q_OVERFLOW) {
+        // events were lost, so report the trees as changed to make users rescan them
+        for (const QString &root : qAsConst(treeRoots))
+            emit treeChanged(root, root);
+        return;
+    }
+
+    const QString directory = treeWdToPath.value(wd);
+    if (directory.isEmpty())
+        return;
+
+    if (!name) {
+        // an event about the watched directory itself; changes of a
+        // subdirectory are also reported by its parent, with a name
+        if (mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT | IN_IGNORED)) {
+            if (treeRoots.removeOne(directory)) {
+                removeTreeWatches(directory);
+                emit directoryChanged(directory, true);
+            } else if (!(mask & IN_MOVE_SELF)) {
+                // a moved directory is handled with IN_MOVED_FROM in its parent
+                removeTreeWatch(directory);
+            }
+        } else if ((mask & IN_ATTRIB) && treeRoots.contains(directory)) {
+            emit treeChanged(directory, QString());
+        }
+        return;
+    }
+
+    const QString path = childPath(directory, QFile::decodeName(name));
+    emit treeChanged(path, (mask & (IN_CREATE | IN_DELETE | IN_MOVE)) ? directory : QString());
+    if (mask & IN_ISDIR) {
+        if (mask & IN_MOVED_FROM)
+            removeTreeWatches(path);
+        if (mask & (IN_CREATE | IN_MOVED_TO))
+            addTreeWatches(path, true);
+    }
+}
+
+#if QT_CONFIG(fanotify)
+QFanotifyTreeWatcher *QInotifyFileSystemWatcherEngine::fanotifyTreeWatcher()
+{
+    if (!fanotifyChecked) {
+        fanotifyChecked = true;
+        if (!qEnvironmentVariableIsSet("QT_NO_FANOTIFY"))
+            fanotify = QFanotifyTreeWatcher::create(this);
+        if (fanotify) {
+            connect(fanotify, &QFanotifyTreeWatcher::treeChanged,
+                    this, &QFileSystemWatcherEngine::treeChanged);
+            connect(fanotify, &QFanotifyTreeWatcher::treeRemoved,
+                    this, [this] (const QString &root) { emit directoryChanged(root, true); });
+        }
+    }
+    return fanotify;
+}
+#endif
+
 QT_END_NAMESPACE
 
 #include "moc_qfilesystemwatcher_inotify_p.cpp"
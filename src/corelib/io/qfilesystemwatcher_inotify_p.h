@@ -61,6 +61,10 @@ QT_REQUIRE_CONFIG(filesystemwatcher);
 
 QT_BEGIN_NAMESPACE
 
+#if QT_CONFIG(fanotify)
+class QFanotifyTreeWatcher;
+#endif
+
 class QInotifyFileSystemWatcherEngine : public QFileSystemWatcherEngine
 {
     Q_OBJECT
@@ -72,12 +76,23 @@ public:
 
     QStringList addPaths(const QStringList &paths, QStringList *files, QStringList *directories) override;
     QStringList removePaths(const QStringList &paths, QStringList *files, QStringList *directories) override;
+    QStringList addRecursivePaths(const QStringList &paths, QStringList *directories) override;
 
 private Q_SLOTS:
     void readFromInotify();
 
 private:
     QString getPathFromID(int id) const;
+    void removeWatch(int wd);
+
+    bool addTreeWatches(const QString &directory, bool reportEntries);
+    void removeTreeWatch(const QString &directory);
+    void removeTreeWatches(const QString &directory);
+    void handleTreeEvent(int wd, uint mask, const char *name);
+    bool overlapsTree(const QString &path) const;
+#if QT_CONFIG(fanotify)
+    QFanotifyTreeWatcher *fanotifyTreeWatcher();
+#endif
 
 private:
     QInotifyFileSystemWatcherEngine(int fd, QObject *parent);
@@ -85,6 +100,17 @@ private:
     QHash<QString, int> pathToID;
     QMultiHash<int, QString> idToPath;
     QSocketNotifier notifier;
+
+    // recursively watched trees; each directory in them has its own watch,
+    // which may be shared with one added by addPaths()
+    QStringList treeRoots;
+    QHash<QString, int> treePathToWd;
+    QHash<int, QString> treeWdToPath;
+    bool watchLimitReported = false;
+#if QT_CONFIG(fanotify)
+    QFanotifyTreeWatcher *fanotify = nullptr;
+    bool fanotifyChecked = false;
+#endif
 };
 
 
@@ -59,9 +59,12 @@ QT_REQUIRE_CONFIG(filesystemwatcher);
 
 #include <QtCore/qstringlist.h>
 #include <QtCore/qhash.h>
+#include <QtCore/qvector.h>
 
 QT_BEGIN_NAMESPACE
 
+class QTimer;
+
 class QFileSystemWatcherEngine : public QObject
 {
     Q_OBJECT
@@ -84,10 +87,24 @@ public:
     virtual QStringList removePaths(const QStringList &paths,
                                     QStringList *files,
                                     QStringList *directories) = 0;
+    // watches the directory trees rooted at \a paths, including
+    // subdirectories created later, appends the roots it could watch to
+    // \a directories, and returns a list of paths this engine could not
+    // watch; removePaths() removes whole trees given their roots
+    virtual QStringList addRecursivePaths(const QStringList &paths,
+                                          QStringList *directories)
+    {
+        Q_UNUSED(directories);
+        return paths;
+    }
 
 Q_SIGNALS:
     void fileChanged(const QString &path, bool removed);
     void directoryChanged(const QString &path, bool removed);
+    // \a path inside a recursively watched tree changed; \a directory is
+    // the directory whose entries changed, or empty if only the contents
+    // or attributes of \a path did
+    void treeChanged(const QString &path, const QString &directory);
 };
 
 class QFileSystemWatcherPrivate : public QObjectPrivate
@@ -107,6 +124,24 @@ public:
     // private slots
     void _q_fileChanged(const QString &path, bool removed);
     void _q_directoryChanged(const QString &path, bool removed);
+    void _q_treeChanged(const QString &path, const QString &directory);
+
+    // changes are collected here and delivered together by
+    // deliverPendingChanges(); each path records the per-path signals it
+    // still owes
+    enum PendingChange {
+        FileChange = 0x1,
+        DirectoryChange = 0x2,
+        Discarded = 0x4
+    };
+    void addPendingChange(const QString &path, int changes);
+    void discardPendingChanges(const QStringList &paths);
+    void deliverPendingChanges();
+
+    QTimer *coalescingTimer;
+    int coalescingInterval;
+    QVector<QPair<QString, int>> pendingChanges;
+    QHash<QString, int> pendingChangeIndex;
 
 #if defined(Q_OS_WIN) && !defined(Q_OS_WINRT)
     void _q_winDriveLockForRemoval(const QString &);
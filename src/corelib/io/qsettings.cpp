@@ -52,6 +52,7 @@
 #include "qtemporaryfile.h"
 #include "qstandardpaths.h"
 #include <qdatastream.h>
+#include <qendian.h>
 
 #if QT_CONFIG(textcodec)
 #  include "qtextcodec.h"
@@ -104,6 +105,10 @@ using namespace ABI::Windows::Storage;
 #define QSETTINGS_USE_QSTANDARDPATHS
 #endif
 
+#if !defined(QT_BOOTSTRAPPED) && !defined(QT_NO_DATASTREAM)
+#define QSETTINGS_HAVE_INDEXED_FORMAT
+#endif
+
 // ************************************************************************
 // QConfFile
 
@@ -151,7 +156,7 @@ static QBasicMutex settingsGlobalMutex;
 static QSettings::Format globalDefaultFormat = QSettings::NativeFormat;
 
 QConfFile::QConfFile(const QString &fileName, bool _userPerms)
-    : name(fileName), size(0), ref(1), userPerms(_userPerms)
+    : name(fileName), size(0), indexedSize(0), ref(1), userPerms(_userPerms)
 {
     usedHashFunc()->insert(name, this);
 }
@@ -932,7 +937,11 @@ void QConfFileSettingsPrivate::initFormat()
     caseSensitivity = IniCaseSensitivity;
 #endif
 
-    if (format > QSettings::IniFormat) {
+    if (format == QSettings::IndexedFormat) {
+        // the index is sorted by the keys as they are
+        extension = QLatin1String(".qsettings");
+        caseSensitivity = Qt::CaseSensitive;
+    } else if (format > QSettings::IniFormat) {
         const auto locker = qt_scoped_lock(settingsGlobalMutex);
         const CustomFormatVector *customFormatVector = customFormatVectorFunc();
 
@@ -950,7 +959,7 @@ void QConfFileSettingsPrivate::initFormat()
 void QConfFileSettingsPrivate::initAccess()
 {
     if (!confFiles.isEmpty()) {
-        if (format > QSettings::IniFormat) {
+        if (format > QSettings::IniFormat && format != QSettings::IndexedFormat) {
             if (!readFunc)
                 setStatus(QSettings::AccessError);
         }
@@ -1384,7 +1393,7 @@ QString QConfFileSettingsPrivate::fileName() const
 
 bool QConfFileSettingsPrivate::isWritable() const
 {
-    if (format > QSettings::IniFormat && !writeFunc)
+    if (format > QSettings::IniFormat && format != QSettings::IndexedFormat && !writeFunc)
         return false;
 
     if (confFiles.isEmpty())
@@ -1441,6 +1450,8 @@ void QConfFileSettingsPrivate::syncConfFile(QConfFile *confFile)
 
     if (mustReadFile) {
         confFile->unparsedIniSections.clear();
+        confFile->unparsedIndex.reset();
+        confFile->indexedSize = 0;
         confFile->originalKeys.clear();
 
         QFile file(confFile->name);
@@ -1460,6 +1471,11 @@ void QConfFileSettingsPrivate::syncConfFile(QConfFile *confFile)
                 QByteArray data = file.readAll();
                 ok = readPlistFile(data, &confFile->originalKeys);
             } else
+#endif
+#ifdef QSETTINGS_HAVE_INDEXED_FORMAT
+            if (format == QSettings::IndexedFormat) {
+                ok = readIndexedFile(confFile);
+            } else
 #endif
             if (format <= QSettings::IniFormat) {
                 QByteArray data = file.readAll();
@@ -1491,6 +1507,11 @@ void QConfFileSettingsPrivate::syncConfFile(QConfFile *confFile)
         so everything is under control.
     */
     if (!readOnly) {
+#ifdef QSETTINGS_HAVE_INDEXED_FORMAT
+        if (format == QSettings::IndexedFormat && lockFile.isLocked() && appendIndexedJournal(confFile))
+            return;
+#endif
+
         bool ok = false;
         ensureAllSectionsParsed(confFile);
         ParsedSettingsMap mergedKeys = confFile->mergedKeyMap();
@@ -1510,6 +1531,11 @@ void QConfFileSettingsPrivate::syncConfFile(QConfFile *confFile)
         if (format == QSettings::NativeFormat) {
             ok = writePlistFile(sf, mergedKeys);
         } else
+#endif
+#ifdef QSETTINGS_HAVE_INDEXED_FORMAT
+        if (format == QSettings::IndexedFormat) {
+            ok = writeIndexedFile(sf, mergedKeys);
+        } else
 #endif
         if (format <= QSettings::IniFormat) {
             ok = writeIniFile(sf, mergedKeys);
@@ -1538,6 +1564,7 @@ void QConfFileSettingsPrivate::syncConfFile(QConfFile *confFile)
             QFileInfo fileInfo(confFile->name);
             confFile->size = fileInfo.size();
             confFile->timeStamp = fileInfo.lastModified();
+            confFile->indexedSize = (format == QSettings::IndexedFormat) ? confFile->size : 0;
 
             // If we have created the file, apply the file perms
             if (createFile) {
@@ -1906,8 +1933,377 @@ bool QConfFileSettingsPrivate::writeIniFile(QIODevice &device, const ParsedSetti
     return !writeError;
 }
 
+#ifdef QSETTINGS_HAVE_INDEXED_FORMAT
+/*
+    An IndexedFormat file starts with a header and an index of the keys,
+    sorted like QString::operator<(). The keys follow as little-endian
+    UTF-16, then the values streamed with QDataStream. Looking up a key
+    is a binary search in the mapped file, so nothing needs to be parsed
+    when the file is opened.
+
+    Changes are appended to the end of the file as a journal of records,
+    each one protected by a checksum. When the journal gets too big, the
+    file is rewritten with the changes merged into the index.
+*/
+
+namespace {
+struct QSettingsIndexHeader
+{
+    quint32_le magic;
+    quint32_le version;
+    quint32_le streamVersion;
+    quint32_le count;
+    quint32_le indexedSize;     // everything before the journal
+};
+
+struct QSettingsIndexEntry
+{
+    quint32_le keyOffset;
+    quint32_le keySize;         // in UTF-16 code units
+    quint32_le valueOffset;
+    quint32_le valueSize;
+};
+
+enum : quint32 {
+    IndexedFormatMagic = 0x58495351,    // "QSIX"
+    IndexedFormatVersion = 1,
+    IndexedFormatStreamVersion = QDataStream::Qt_5_15
+};
+
+enum JournalOperation : quint8 {
+    JournalRemove,
+    JournalSet
+};
+
+// the journal is merged once it exceeds half the rest of the file, or this
+const qint64 MinimumJournalLimit = 4096;
+}
+
+static void appendUtf16LittleEndian(QByteArray &data, const QString &str)
+{
+    const int pos = data.size();
+    data.resize(pos + str.size() * int(sizeof(ushort)));
+    qToLittleEndian<ushort>(str.utf16(), str.size(), data.data() + pos);
+}
+
+static void appendJournalRecord(QByteArray &journal, JournalOperation operation,
+                                const QString &key, const QVariant &value)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(IndexedFormatStreamVersion);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << quint8(operation) << key;
+    if (operation == JournalSet)
+        out << value;
+
+    const quint32_le payloadSize(payload.size());
+    const quint16_le checksum(qChecksum(payload.constData(), payload.size()));
+    journal.append(reinterpret_cast<const char *>(&payloadSize), sizeof(payloadSize));
+    journal.append(payload);
+    journal.append(reinterpret_cast<const char *>(&checksum), sizeof(checksum));
+}
+
+/*
+    Opens the IndexedFormat file \a fileName and reads the changes recorded
+    in its journal into \a journalKeys. \a journalIntact is set to false if
+    the journal ends with a damaged record, which is then ignored.
+*/
+bool QSettingsIndex::open(const QString &fileName, ParsedSettingsMap *journalKeys,
+                          bool *journalIntact)
+{
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    qint64 fileSize = file.size();
+    data = file.map(0, fileSize);
+    if (!data) {
+        contents = file.readAll();
+        fileSize = contents.size();
+        data = reinterpret_cast<const uchar *>(contents.constData());
+    }
+    // the mapping stays valid until the QFile is destroyed
+    file.close();
+
+    QSettingsIndexHeader header;
+    if (fileSize < qint64(sizeof(header)))
+        return false;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != IndexedFormatMagic || header.version != IndexedFormatVersion
+            || header.streamVersion > quint32(QDataStream::Qt_DefaultCompiledVersion)
+            || header.indexedSize > fileSize
+            || sizeof(header) + quint64(header.count) * sizeof(QSettingsIndexEntry) > header.indexedSize) {
+        return false;
+    }
+    dataSize = header.indexedSize;
+    count = header.count;
+    streamVersion = header.streamVersion;
+
+    *journalIntact = true;
+    const char *record = reinterpret_cast<const char *>(data) + dataSize;
+    const char *end = reinterpret_cast<const char *>(data) + fileSize;
+    while (record != end) {
+        quint32_le payloadSize;
+        quint16_le checksum;
+        if (end - record < qint64(sizeof(payloadSize) + sizeof(checksum))) {
+            *journalIntact = false;
+            break;
+        }
+        memcpy(&payloadSize, record, sizeof(payloadSize));
+        const char *payload = record + sizeof(payloadSize);
+        if (payloadSize > quint64(end - payload) - sizeof(checksum)) {
+            *journalIntact = false;
+            break;
+        }
+        memcpy(&checksum, payload + payloadSize, sizeof(checksum));
+        if (qChecksum(payload, payloadSize) != checksum) {
+            *journalIntact = false;
+            break;
+        }
+
+        QDataStream in(QByteArray::fromRawData(payload, payloadSize));
+        in.setVersion(streamVersion);
+        in.setByteOrder(QDataStream::LittleEndian);
+        quint8 operation;
+        QString key;
+        QVariant value;
+        in >> operation >> key;
+        if (operation == JournalSet)
+            in >> value;
+        if (in.status() != QDataStream::Ok) {
+            *journalIntact = false;
+            break;
+        }
+
+        const QSettingsKey settingsKey(key, Qt::CaseSensitive);
+        if (operation == JournalSet) {
+            journalKeys->insert(settingsKey, value);
+        } else {
+            journalKeys->remove(settingsKey);
+            hiddenKeys.insert(key);
+        }
+        record = payload + payloadSize + sizeof(checksum);
+    }
+    return true;
+}
+
+QStringView QSettingsIndex::keyAt(int i, QString &buffer) const
+{
+    const QSettingsIndexEntry &entry =
+            reinterpret_cast<const QSettingsIndexEntry *>(data + sizeof(QSettingsIndexHeader))[i];
+    if ((entry.keyOffset & 1) || quint64(entry.keyOffset) + 2 * quint64(entry.keySize) > quint64(dataSize))
+        return QStringView();
+    const uchar *key = data + entry.keyOffset;
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    Q_UNUSED(buffer);
+    return QStringView(reinterpret_cast<const QChar *>(key), entry.keySize);
+#else
+    buffer.resize(entry.keySize);
+    qFromLittleEndian<ushort>(key, entry.keySize, buffer.data());
+    return buffer;
+#endif
+}
+
+/*
+    Returns the position of the first key in the index that is not less than
+    \a key, or -1 if the index is damaged.
+*/
+int QSettingsIndex::lowerBound(QStringView key, QString &buffer) const
+{
+    int begin = 0;
+    int end = count;
+    while (begin < end) {
+        const int middle = begin + (end - begin) / 2;
+        const QStringView middleKey = keyAt(middle, buffer);
+        if (middleKey.isNull())
+            return -1;
+        if (middleKey.compare(key) < 0)
+            begin = middle + 1;
+        else
+            end = middle;
+    }
+    return begin;
+}
+
+bool QSettingsIndex::readEntry(int i, QStringView key, ParsedSettingsMap *map) const
+{
+    const QString keyString = key.toString();
+    if (!hiddenKeys.isEmpty() && hiddenKeys.contains(keyString))
+        return true;
+    const QSettingsKey settingsKey(keyString, Qt::CaseSensitive);
+    if (map->contains(settingsKey))
+        return true;
+
+    const QSettingsIndexEntry &entry =
+            reinterpret_cast<const QSettingsIndexEntry *>(data + sizeof(QSettingsIndexHeader))[i];
+    if (quint64(entry.valueOffset) + entry.valueSize > quint64(dataSize))
+        return false;
+    QDataStream in(QByteArray::fromRawData(reinterpret_cast<const char *>(data) + entry.valueOffset,
+                                           entry.valueSize));
+    in.setVersion(streamVersion);
+    in.setByteOrder(QDataStream::LittleEndian);
+    QVariant value;
+    in >> value;
+    if (in.status() != QDataStream::Ok)
+        return false;
+    map->insert(settingsKey, value);
+    return true;
+}
+
+/*
+    Reads \a key into \a map, or all the keys that start with it if it ends
+    with a slash. Keys that are already in \a map are left alone, as they were
+    changed by the journal.
+*/
+bool QSettingsIndex::read(const QSettingsKey &key, ParsedSettingsMap *map) const
+{
+    const QStringView keyView(static_cast<const QString &>(key));
+    const bool isPrefix = keyView.endsWith(QLatin1Char('/'));
+    QString buffer;
+    int i = lowerBound(keyView, buffer);
+    if (i < 0)
+        return false;
+
+    bool ok = true;
+    for (; i < count; ++i) {
+        const QStringView entryKey = keyAt(i, buffer);
+        if (entryKey.isNull())
+            return false;
+        if (isPrefix ? !entryKey.startsWith(keyView) : entryKey != keyView)
+            break;
+        if (!readEntry(i, entryKey, map))
+            ok = false;
+        if (!isPrefix)
+            break;
+    }
+    return ok;
+}
+
+bool QSettingsIndex::readAll(ParsedSettingsMap *map) const
+{
+    QString buffer;
+    bool ok = true;
+    for (int i = 0; i < count; ++i) {
+        const QStringView key = keyAt(i, buffer);
+        if (key.isNull())
+            return false;
+        if (!readEntry(i, key, map))
+            ok = false;
+    }
+    return ok;
+}
+
+bool QConfFileSettingsPrivate::readIndexedFile(QConfFile *confFile)
+{
+    QScopedPointer<QSettingsIndex> index(new QSettingsIndex);
+    bool journalIntact;
+    if (!index->open(confFile->name, &confFile->originalKeys, &journalIntact))
+        return false;
+
+    // a damaged journal is dropped by rewriting the file on the next change
+    confFile->indexedSize = journalIntact ? index->indexedSize() : 0;
+    confFile->unparsedIndex.reset(index.take());
+    return true;
+}
+
+bool QConfFileSettingsPrivate::writeIndexedFile(QIODevice &device, const ParsedSettingsMap &map)
+{
+    const int count = map.size();
+    const quint64 keysOffset = sizeof(QSettingsIndexHeader) + quint64(count) * sizeof(QSettingsIndexEntry);
+
+    QVector<QSettingsIndexEntry> entries(count);
+    QByteArray keys;
+    int i = 0;
+    for (auto it = map.cbegin(); it != map.cend(); ++it, ++i) {
+        entries[i].keyOffset = keysOffset + keys.size();
+        entries[i].keySize = it.key().size();
+        appendUtf16LittleEndian(keys, it.key());
+    }
+
+    const quint64 valuesOffset = keysOffset + keys.size();
+    QByteArray values;
+    QDataStream out(&values, QIODevice::WriteOnly);
+    out.setVersion(IndexedFormatStreamVersion);
+    out.setByteOrder(QDataStream::LittleEndian);
+    i = 0;
+    for (auto it = map.cbegin(); it != map.cend(); ++it, ++i) {
+        const int valueOffset = values.size();
+        out << it.value();
+        entries[i].valueOffset = valuesOffset + valueOffset;
+        entries[i].valueSize = values.size() - valueOffset;
+    }
+    if (out.status() != QDataStream::Ok || valuesOffset + values.size() > quint64(UINT_MAX))
+        return false;
+
+    QSettingsIndexHeader header;
+    header.magic = IndexedFormatMagic;
+    header.version = IndexedFormatVersion;
+    header.streamVersion = IndexedFormatStreamVersion;
+    header.count = count;
+    header.indexedSize = valuesOffset + values.size();
+
+    const qint64 entriesSize = qint64(count) * sizeof(QSettingsIndexEntry);
+    return device.write(reinterpret_cast<const char *>(&header), sizeof(header)) == sizeof(header)
+            && device.write(reinterpret_cast<const char *>(entries.constData()), entriesSize) == entriesSize
+            && device.write(keys) == keys.size()
+            && device.write(values) == values.size();
+}
+
+/*
+    Appends the pending changes of \a confFile to the journal of its file.
+    Returns false if the file has to be rewritten instead.
+*/
+bool QConfFileSettingsPrivate::appendIndexedJournal(QConfFile *confFile)
+{
+    if (confFile->indexedSize == 0)
+        return false;
+
+    QByteArray journal;
+    for (auto it = confFile->removedKeys.cbegin(); it != confFile->removedKeys.cend(); ++it)
+        appendJournalRecord(journal, JournalRemove, it.key(), QVariant());
+    for (auto it = confFile->addedKeys.cbegin(); it != confFile->addedKeys.cend(); ++it)
+        appendJournalRecord(journal, JournalSet, it.key(), it.value());
+
+    const qint64 journalSize = QFileInfo(confFile->name).size() - confFile->indexedSize;
+    if (journalSize < 0
+            || journalSize + journal.size() > qMax(confFile->indexedSize / 2, MinimumJournalLimit)) {
+        return false;
+    }
+
+    // a partially written record is ignored when the file is read, and
+    // replaced when the file is rewritten
+    QFile file(confFile->name);
+    if (!file.open(QIODevice::Append) || file.write(journal) != journal.size() || !file.flush())
+        return false;
+    file.close();
+
+    for (auto it = confFile->removedKeys.cbegin(); it != confFile->removedKeys.cend(); ++it) {
+        confFile->originalKeys.remove(it.key());
+        if (confFile->unparsedIndex)
+            confFile->unparsedIndex->hideKey(it.key());
+    }
+    for (auto it = confFile->addedKeys.cbegin(); it != confFile->addedKeys.cend(); ++it)
+        confFile->originalKeys.insert(it.key(), it.value());
+    confFile->addedKeys.clear();
+    confFile->removedKeys.clear();
+
+    QFileInfo fileInfo(confFile->name);
+    confFile->size = fileInfo.size();
+    confFile->timeStamp = fileInfo.lastModified();
+    return true;
+}
+#endif // QSETTINGS_HAVE_INDEXED_FORMAT
+
 void QConfFileSettingsPrivate::ensureAllSectionsParsed(QConfFile *confFile) const
 {
+#ifdef QSETTINGS_HAVE_INDEXED_FORMAT
+    if (confFile->unparsedIndex) {
+        if (!confFile->unparsedIndex->readAll(&confFile->originalKeys))
+            setStatus(QSettings::FormatError);
+        confFile->unparsedIndex.reset();
+    }
+#endif
+
     UnparsedSettingsMap::const_iterator i = confFile->unparsedIniSections.constBegin();
     const UnparsedSettingsMap::const_iterator end = confFile->unparsedIniSections.constEnd();
 
@@ -1921,6 +2317,15 @@ void QConfFileSettingsPrivate::ensureAllSectionsParsed(QConfFile *confFile) cons
 void QConfFileSettingsPrivate::ensureSectionParsed(QConfFile *confFile,
                                                    const QSettingsKey &key) const
 {
+#ifdef QSETTINGS_HAVE_INDEXED_FORMAT
+    if (confFile->unparsedIndex) {
+        // the index stays, as every lookup only reads what it needs
+        if (!confFile->unparsedIndex->read(key, &confFile->originalKeys))
+            setStatus(QSettings::FormatError);
+        return;
+    }
+#endif
+
     if (confFile->unparsedIniSections.isEmpty())
         return;
 
@@ -2449,6 +2854,15 @@ void QConfFileSettingsPrivate::ensureSectionParsed(QConfFile *confFile,
     \value IniFormat        Store the settings in INI files. Note that type information
                             is not preserved when reading settings from INI files;
                             all values will be returned as QString.
+    \value IndexedFormat    Store the settings in binary files with a sorted
+                            index. The files are mapped into memory, and values
+                            are only read when they are looked up, which keeps
+                            opening large files fast. Changes are appended to
+                            the files, which are compacted from time to time.
+                            Type information is preserved and keys are case
+                            sensitive. The files have the extension \c .qsettings
+                            and are stored in the same locations as INI files.
+                            This enum value was added in Qt 5.15.
 
     \value InvalidFormat    Special value returned by registerFormat().
     \omitvalue CustomFormat1
@@ -90,6 +90,8 @@ public:
         Registry64Format,
 #endif
 
+        IndexedFormat = 4,
+
         InvalidFormat = 16,
         CustomFormat1,
         CustomFormat2,
@@ -52,9 +52,11 @@
 //
 
 #include "QtCore/qdatetime.h"
+#include "QtCore/qfile.h"
 #include "QtCore/qmap.h"
 #include "QtCore/qmutex.h"
 #include "QtCore/qiodevice.h"
+#include "QtCore/qset.h"
 #include "QtCore/qstack.h"
 #include "QtCore/qstringlist.h"
 
@@ -152,6 +154,34 @@ inline QString QSettingsGroup::toString() const
     return result;
 }
 
+/*
+    The part of an IndexedFormat file that hasn't been read into
+    QConfFile::originalKeys yet. The file is mapped into memory and
+    the entries are looked up in its sorted index when they are needed.
+*/
+class QSettingsIndex
+{
+public:
+    bool open(const QString &fileName, ParsedSettingsMap *journalKeys, bool *journalIntact);
+    bool read(const QSettingsKey &key, ParsedSettingsMap *map) const;
+    bool readAll(ParsedSettingsMap *map) const;
+    void hideKey(const QString &key) { hiddenKeys.insert(key); }
+    qint64 indexedSize() const { return dataSize; }
+
+private:
+    int lowerBound(QStringView key, QString &buffer) const;
+    QStringView keyAt(int i, QString &buffer) const;
+    bool readEntry(int i, QStringView key, ParsedSettingsMap *map) const;
+
+    QFile file;
+    QByteArray contents; // used if the file can't be mapped
+    const uchar *data = nullptr;
+    qint64 dataSize = 0;
+    int count = 0;
+    int streamVersion = 0;
+    QSet<QString> hiddenKeys; // removed by the journal
+};
+
 class Q_AUTOTEST_EXPORT QConfFile
 {
 public:
@@ -167,6 +197,8 @@ public:
     QDateTime timeStamp;
     qint64 size;
     UnparsedSettingsMap unparsedIniSections;
+    QScopedPointer<QSettingsIndex> unparsedIndex;
+    qint64 indexedSize;
     ParsedSettingsMap originalKeys;
     ParsedSettingsMap addedKeys;
     ParsedSettingsMap removedKeys;
@@ -292,6 +324,9 @@ private:
     virtual void initAccess();
     void syncConfFile(QConfFile *confFile);
     bool writeIniFile(QIODevice &device, const ParsedSettingsMap &map);
+    bool readIndexedFile(QConfFile *confFile);
+    static bool writeIndexedFile(QIODevice &device, const ParsedSettingsMap &map);
+    bool appendIndexedJournal(QConfFile *confFile);
 #ifdef Q_OS_MAC
     bool readPlistFile(const QByteArray &data, ParsedSettingsMap *map) const;
     bool writePlistFile(QIODevice &file, const ParsedSettingsMap &map) const;
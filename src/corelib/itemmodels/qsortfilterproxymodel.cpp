@@ -43,11 +43,16 @@
 #include <qdebug.h>
 #include <qdatetime.h>
 #include <qpair.h>
+#include <qscopeguard.h>
 #include <qstringlist.h>
 #include <private/qabstractitemmodel_p.h>
 #include <private/qabstractproxymodel_p.h>
+#if QT_CONFIG(icu)
+#include <private/qcollator_p.h>
+#endif
 
 #include <algorithm>
+#include <numeric>
 
 QT_BEGIN_NAMESPACE
 
@@ -305,6 +310,17 @@ public:
     QModelIndexPairList saved_persistent_indexes;
     QList<QPersistentModelIndex> saved_layoutChange_parents;
 
+    // Locale aware collation ranks of the rows sorted by sort_source_rows(),
+    // computed on the first call to the default lessThan() implementation
+    struct SortRanks {
+        QModelIndex source_parent;
+        QVector<int> source_rows;
+        int source_column;
+        bool computed;
+        QVector<int> ranks; // indexed by source row, empty if not rankable
+    };
+    mutable SortRanks *sort_ranks;
+
     QHash<QModelIndex, Mapping *>::const_iterator create_mapping(
         const QModelIndex &source_parent) const;
     QHash<QModelIndex, Mapping *>::const_iterator create_mapping_recursive(
@@ -382,6 +398,9 @@ public:
     int find_source_sort_column() const;
     void sort_source_rows(QVector<int> &source_rows,
                           const QModelIndex &source_parent) const;
+    void compute_sort_ranks() const;
+    bool ranked_less_than(const QModelIndex &source_left, const QModelIndex &source_right,
+                          bool *result) const;
     QVector<QPair<int, QVector<int > > > proxy_intervals_for_source_items_to_add(
         const QVector<int> &proxy_to_source, const QVector<int> &source_items,
         const QModelIndex &source_parent, Qt::Orientation orient) const;
@@ -699,6 +718,13 @@ void QSortFilterProxyModelPrivate::sort_source_rows(
 {
     Q_Q(const QSortFilterProxyModel);
     if (source_sort_column >= 0) {
+        // Locale aware comparisons are expensive, so lessThan() collates
+        // each row once and compares the resulting ranks instead
+        SortRanks ranks = { source_parent, source_rows, source_sort_column, false, {} };
+        SortRanks *const saved_ranks = sort_ranks;
+        sort_ranks = sort_localeaware && source_rows.size() > 1 ? &ranks : nullptr;
+        const auto restore_ranks = qScopeGuard([&] { sort_ranks = saved_ranks; });
+
         if (sort_order == Qt::AscendingOrder) {
             QSortFilterProxyModelLessThan lt(source_sort_column, source_parent, model, q);
             std::stable_sort(source_rows.begin(), source_rows.end(), lt);
@@ -711,6 +737,102 @@ void QSortFilterProxyModelPrivate::sort_source_rows(
     }
 }
 
+/*!
+  \internal
+
+  Ranks the rows being sorted by sort_source_rows() in locale aware
+  collation order. Equal strings share the same rank. The ranks are left
+  empty if some of the values are not compared as strings by lessThan().
+*/
+void QSortFilterProxyModelPrivate::compute_sort_ranks() const
+{
+    Q_ASSERT(sort_ranks && !sort_ranks->computed);
+    sort_ranks->computed = true;
+
+    const QVector<int> &rows = sort_ranks->source_rows;
+    QStringList strings;
+    strings.reserve(rows.size());
+    for (int row : rows) {
+        const QModelIndex index = model->index(row, sort_ranks->source_column,
+                                               sort_ranks->source_parent);
+        const QVariant value = model->data(index, sort_role);
+        switch (value.userType()) {
+        case QMetaType::UnknownType:
+        case QMetaType::Int:
+        case QMetaType::UInt:
+        case QMetaType::LongLong:
+        case QMetaType::ULongLong:
+        case QMetaType::Float:
+        case QMetaType::Double:
+        case QMetaType::QChar:
+        case QMetaType::QDate:
+        case QMetaType::QTime:
+        case QMetaType::QDateTime:
+            return;
+        default:
+            strings.append(value.toString());
+        }
+    }
+
+#if QT_CONFIG(icu)
+    // QString::localeAwareCompare() uses the default QCollator
+    const QVector<int> string_ranks = QCollatorSortKeyTable(QCollator(), strings).ranks();
+#else
+    QVector<int> order(strings.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&strings](int i, int j) {
+        return strings.at(i).localeAwareCompare(strings.at(j)) < 0;
+    });
+    QVector<int> string_ranks(strings.size());
+    int rank = 0;
+    for (int i = 0; i < order.size(); ++i) {
+        if (i > 0 && strings.at(order.at(i - 1)).localeAwareCompare(strings.at(order.at(i))) < 0)
+            ++rank;
+        string_ranks[order.at(i)] = rank;
+    }
+#endif
+
+    const int row_count = *std::max_element(rows.cbegin(), rows.cend()) + 1;
+    sort_ranks->ranks.fill(-1, row_count);
+    for (int i = 0; i < rows.size(); ++i)
+        sort_ranks->ranks[rows.at(i)] = string_ranks.at(i);
+}
+
+/*!
+  \internal
+
+  Compares \a source_left and \a source_right by their precomputed ranks
+  while sort_source_rows() sorts in locale aware order. Returns \c false if
+  the ranks do not apply to the two indexes; otherwise sets \a result to
+  what lessThan() would return for them and returns \c true.
+*/
+bool QSortFilterProxyModelPrivate::ranked_less_than(const QModelIndex &source_left,
+                                                    const QModelIndex &source_right,
+                                                    bool *result) const
+{
+    if (source_left.model() != model || source_right.model() != model
+        || source_left.column() != sort_ranks->source_column
+        || source_right.column() != sort_ranks->source_column) {
+        return false;
+    }
+    if (!sort_ranks->computed)
+        compute_sort_ranks();
+
+    const QVector<int> &ranks = sort_ranks->ranks;
+    const int left_row = source_left.row();
+    const int right_row = source_right.row();
+    if (left_row >= ranks.size() || right_row >= ranks.size()
+        || ranks.at(left_row) < 0 || ranks.at(right_row) < 0) {
+        return false;
+    }
+    if (source_left.parent() != sort_ranks->source_parent
+        || source_right.parent() != sort_ranks->source_parent) {
+        return false;
+    }
+    *result = ranks.at(left_row) < ranks.at(right_row);
+    return true;
+}
+
 /*!
   \internal
 
@@ -2046,6 +2168,7 @@ QSortFilterProxyModel::QSortFilterProxyModel(QObject *parent)
     d->sort_casesensitivity = Qt::CaseSensitive;
     d->sort_role = Qt::DisplayRole;
     d->sort_localeaware = false;
+    d->sort_ranks = nullptr;
     d->filter_column = 0;
     d->filter_role = Qt::DisplayRole;
     d->filter_recursive = false;
@@ -3099,6 +3222,9 @@ void QSortFilterProxyModel::invalidateFilter()
 bool QSortFilterProxyModel::lessThan(const QModelIndex &source_left, const QModelIndex &source_right) const
 {
     Q_D(const QSortFilterProxyModel);
+    bool ranked_result;
+    if (d->sort_ranks && d->ranked_less_than(source_left, source_right, &ranked_result))
+        return ranked_result;
     QVariant l = (source_left.model() ? source_left.model()->data(source_left, d->sort_role) : QVariant());
     QVariant r = (source_right.model() ? source_right.model()->data(source_right, d->sort_role) : QVariant());
     return QAbstractItemModelPrivate::isVariantLessThan(l, r, d->sort_casesensitivity, d->sort_localeaware);
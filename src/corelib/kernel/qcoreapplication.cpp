@@ -351,6 +351,8 @@ bool QCoreApplicationPrivate::is_app_closing = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
+    const auto locker = qt_scoped_lock(currentThreadData->postEventList.mutex);
+    currentThreadData->mergeIncomingPostedEvents();
     return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
 }
 
@@ -503,6 +505,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         const auto locker = qt_scoped_lock(thisThreadData->postEventList.mutex);
+        thisThreadData->mergeIncomingPostedEvents();
         for (int i = 0; i < thisThreadData->postEventList.size(); ++i) {
             const QPostEvent &pe = thisThreadData->postEventList.at(i);
             if (pe.event) {
@@ -1508,6 +1511,36 @@ QCoreApplicationPrivate::QPostEventListLocker QCoreApplicationPrivate::lockThrea
     return locker;
 }
 
+/*!
+    \internal
+
+    Posts \a event to \a receiver without locking the receiving thread's
+    post event list. Returns \c false if the event has to go through the
+    locked path instead, because the lock-free ring is full or the receiver
+    is being destroyed or moved to another thread.
+*/
+bool QCoreApplicationPrivate::postEventLockFree(QObject *receiver, QEvent *event)
+{
+    auto &threadData = QObjectPrivate::get(receiver)->threadData;
+    QThreadData *data = threadData.loadAcquire();
+    if (!data)
+        return false;
+
+    // the receiving thread may process the event as soon as it is pushed
+    Q_TRACE(QCoreApplication_postEvent_event_posted, receiver, event, event->type());
+    event->posted = true;
+    const auto stillOwned = [&]() { return threadData.loadAcquire() == data; };
+    if (!data->postEventList.tryPushIncoming(receiver, event, stillOwned)) {
+        event->posted = false;
+        return false;
+    }
+
+    QAbstractEventDispatcher *dispatcher = data->eventDispatcher.loadAcquire();
+    if (dispatcher)
+        dispatcher->wakeUp();
+    return true;
+}
+
 /*!
     \since 4.3
 
@@ -1543,6 +1576,13 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         return;
     }
 
+    // queued slot invocations are by far the most common posted events and
+    // are never compressed, so they skip the mutex
+    if (priority == Qt::NormalEventPriority && event->type() == QEvent::MetaCall
+        && QCoreApplicationPrivate::postEventLockFree(receiver, event)) {
+        return;
+    }
+
     auto locker = QCoreApplicationPrivate::lockThreadPostEventList(receiver);
     if (!locker.threadData) {
         // posting during destruction? just delete the event to prevent a leak
@@ -1551,6 +1591,8 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
     }
 
     QThreadData *data = locker.threadData;
+    // keep the events posted through the lock-free path ahead of this one
+    data->mergeIncomingPostedEvents();
 
     // if this is one of the compressible events, do compression
     if (receiver->d_func()->postedEvents
@@ -1697,6 +1739,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     auto locker = qt_unique_lock(data->postEventList.mutex);
+    data->mergeIncomingPostedEvents();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -1851,6 +1894,8 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
 {
     auto locker = QCoreApplicationPrivate::lockThreadPostEventList(receiver);
     QThreadData *data = locker.threadData;
+    if (data)
+        data->mergeIncomingPostedEvents();
 
     // the QObject destructor calls this function directly.  this can
     // happen while the event loop is in the middle of posting events,
@@ -1914,6 +1959,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     const auto locker = qt_scoped_lock(data->postEventList.mutex);
+    data->mergeIncomingPostedEvents();
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
@@ -150,6 +150,7 @@ public:
         void unlock() { locker.unlock(); }
     };
     static QPostEventListLocker lockThreadPostEventList(QObject *object);
+    static bool postEventLockFree(QObject *receiver, QEvent *event);
 #endif // QT_NO_QOBJECT
 
     int &argc;
@@ -59,6 +59,10 @@
 #  include <sys/eventfd.h>
 #endif
 
+#if QT_CONFIG(epoll)
+#  include <sys/timerfd.h>
+#endif
+
 // VxWorks doesn't correctly set the _POSIX_... options
 #if defined(Q_OS_VXWORKS)
 #  if defined(_POSIX_MONOTONIC_CLOCK) && (_POSIX_MONOTONIC_CLOCK <= 0)
@@ -223,13 +227,28 @@ int QThreadPipe::check(const pollfd &pfd)
 }
 
 QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
+#if QT_CONFIG(epoll)
+    : epollFd(-1), timerFd(-1), timerFdArmed(false), timerFdDeadline{0, 0}
+#endif
 {
     if (Q_UNLIKELY(threadPipe.init() == false))
         qFatal("QEventDispatcherUNIXPrivate(): Cannot continue without a thread pipe");
+
+#if QT_CONFIG(epoll)
+    if (qEnvironmentVariableIntValue("QT_EVENTDISPATCHER_EPOLL") && !initEpoll())
+        qWarning("QEventDispatcherUNIXPrivate: epoll unavailable, falling back to poll");
+#endif
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
 {
+#if QT_CONFIG(epoll)
+    if (timerFd >= 0)
+        qt_safe_close(timerFd);
+    if (epollFd >= 0)
+        qt_safe_close(epollFd);
+#endif
+
     // cleanup timers
     qDeleteAll(timerList);
 }
@@ -255,38 +274,42 @@ void QEventDispatcherUNIXPrivate::markPendingSocketNotifiers()
         if (pfd.fd < 0 || pfd.revents == 0)
             continue;
 
-        auto it = socketNotifiers.find(pfd.fd);
-        Q_ASSERT(it != socketNotifiers.end());
-
-        const QSocketNotifierSetUNIX &sn_set = it.value();
-
-        static const struct {
-            QSocketNotifier::Type type;
-            short flags;
-        } notifiers[] = {
-            { QSocketNotifier::Read,      POLLIN  | POLLHUP | POLLERR },
-            { QSocketNotifier::Write,     POLLOUT | POLLHUP | POLLERR },
-            { QSocketNotifier::Exception, POLLPRI | POLLHUP | POLLERR }
-        };
+        auto it = socketNotifiers.constFind(pfd.fd);
+        Q_ASSERT(it != socketNotifiers.cend());
 
-        for (const auto &n : notifiers) {
-            QSocketNotifier *notifier = sn_set.notifiers[n.type];
+        markPendingSocketNotifier(pfd.fd, it.value(), pfd.revents);
+    }
 
-            if (!notifier)
-                continue;
+    pollfds.clear();
+}
 
-            if (pfd.revents & POLLNVAL) {
-                qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
-                         it.key(), socketType(n.type));
-                notifier->setEnabled(false);
-            }
+void QEventDispatcherUNIXPrivate::markPendingSocketNotifier(int fd, const QSocketNotifierSetUNIX &sn_set,
+                                                            short revents)
+{
+    static const struct {
+        QSocketNotifier::Type type;
+        short flags;
+    } notifiers[] = {
+        { QSocketNotifier::Read,      POLLIN  | POLLHUP | POLLERR },
+        { QSocketNotifier::Write,     POLLOUT | POLLHUP | POLLERR },
+        { QSocketNotifier::Exception, POLLPRI | POLLHUP | POLLERR }
+    };
+
+    for (const auto &n : notifiers) {
+        QSocketNotifier *notifier = sn_set.notifiers[n.type];
+
+        if (!notifier)
+            continue;
 
-            if (pfd.revents & n.flags)
-                setSocketNotifierPending(notifier);
+        if (revents & POLLNVAL) {
+            qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
+                     fd, socketType(n.type));
+            notifier->setEnabled(false);
         }
-    }
 
-    pollfds.clear();
+        if (revents & n.flags)
+            setSocketNotifierPending(notifier);
+    }
 }
 
 int QEventDispatcherUNIXPrivate::activateSocketNotifiers()
@@ -308,6 +331,170 @@ int QEventDispatcherUNIXPrivate::activateSocketNotifiers()
     return n_activated;
 }
 
+#if QT_CONFIG(epoll)
+// The poll(2) and epoll(7) event bits share their values on Linux, so
+// QSocketNotifierSetUNIX::events() can be handed to epoll_ctl() unchanged.
+Q_STATIC_ASSERT(POLLIN == EPOLLIN && POLLOUT == EPOLLOUT && POLLPRI == EPOLLPRI);
+Q_STATIC_ASSERT(POLLERR == EPOLLERR && POLLHUP == EPOLLHUP);
+
+enum { MinEpollEvents = 64, MaxEpollEvents = 4096 };
+
+bool QEventDispatcherUNIXPrivate::initEpoll()
+{
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd == -1) {
+        perror("QEventDispatcherUNIXPrivate: Unable to create epoll instance");
+        return false;
+    }
+
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd == -1) {
+        perror("QEventDispatcherUNIXPrivate: Unable to create timerfd");
+        qt_safe_close(epollFd);
+        epollFd = -1;
+        return false;
+    }
+
+    for (int fd : { threadPipe.fds[0], timerFd }) {
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+            perror("QEventDispatcherUNIXPrivate: Unable to add descriptor to epoll set");
+            qt_safe_close(timerFd);
+            qt_safe_close(epollFd);
+            timerFd = epollFd = -1;
+            return false;
+        }
+    }
+
+    epollEvents.resize(MinEpollEvents);
+    return true;
+}
+
+void QEventDispatcherUNIXPrivate::updateEpollRegistration(int fd, short oldEvents, short newEvents)
+{
+    if (oldEvents == newEvents)
+        return;
+
+    if (nonPollableFds.contains(fd)) {
+        if (!newEvents)
+            nonPollableFds.removeOne(fd);
+        return;
+    }
+
+    epoll_event ev = {};
+    ev.events = newEvents;
+    ev.data.fd = fd;
+
+    if (!newEvents) {
+        // fails harmlessly if the descriptor was closed already,
+        // which removes it from the epoll set implicitly
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, &ev);
+        return;
+    }
+
+    // The descriptor may have been closed and reused behind our back, in
+    // which case the kernel has already dropped the old registration.
+    int ret = epoll_ctl(epollFd, oldEvents ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &ev);
+    if (ret == -1 && errno == ENOENT)
+        ret = epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    else if (ret == -1 && errno == EEXIST)
+        ret = epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+
+    if (ret == -1) {
+        if (errno == EPERM) {
+            // regular files and the like cannot be epolled, but poll(2)
+            // always reports them as readable and writable: do the same
+            nonPollableFds.append(fd);
+        } else {
+            qErrnoWarning("QSocketNotifier: Unable to watch socket %d", fd);
+        }
+    }
+}
+
+void QEventDispatcherUNIXPrivate::armEpollTimer(const timespec *tm)
+{
+    // only touch the timerfd when the next deadline moves, so that an
+    // idle loop with a steady set of timers doesn't pay a syscall per wakeup
+    itimerspec its = {};
+    if (!tm) {
+        if (!timerFdArmed)
+            return;
+        timerFdArmed = false;
+    } else {
+        const timespec deadline = timerList.currentTime + *tm;
+        if (timerFdArmed && deadline == timerFdDeadline)
+            return;
+        its.it_value = *tm;
+        timerFdArmed = true;
+        timerFdDeadline = deadline;
+    }
+
+    if (timerfd_settime(timerFd, 0, &its, nullptr) == -1)
+        perror("QEventDispatcherUNIXPrivate: Unable to arm timerfd");
+}
+
+int QEventDispatcherUNIXPrivate::processEpollEvents(const timespec *tm)
+{
+    int timeout = -1;
+    if (tm && tm->tv_sec == 0 && tm->tv_nsec == 0)
+        timeout = 0;
+    else
+        armEpollTimer(tm);
+
+    if (!nonPollableFds.isEmpty())
+        timeout = 0;
+
+    int nfds;
+    EINTR_LOOP(nfds, epoll_wait(epollFd, epollEvents.data(), epollEvents.size(), timeout));
+    if (nfds == -1) {
+        perror("epoll_wait");
+        return 0;
+    }
+
+    int nevents = 0;
+    for (int i = 0; i < nfds; ++i) {
+        const epoll_event &ev = epollEvents.at(i);
+        const int fd = ev.data.fd;
+
+        if (fd == threadPipe.fds[0]) {
+            pollfd pfd = qt_make_pollfd(fd, POLLIN);
+            pfd.revents = short(ev.events);
+            nevents += threadPipe.check(pfd);
+        } else if (fd == timerFd) {
+            // the timers themselves are activated by the caller
+            quint64 expirations;
+            qt_safe_read(timerFd, &expirations, sizeof(expirations));
+            timerFdArmed = false;
+        } else {
+            auto it = socketNotifiers.constFind(fd);
+            if (it == socketNotifiers.cend()) {
+                // a duplicate of a closed descriptor keeps the
+                // registration alive, drop it now that nobody wants it
+                epoll_event dummy = {};
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, &dummy);
+                continue;
+            }
+            markPendingSocketNotifier(fd, it.value(), short(ev.events));
+        }
+    }
+
+    for (int fd : qAsConst(nonPollableFds)) {
+        auto it = socketNotifiers.constFind(fd);
+        if (it != socketNotifiers.cend())
+            markPendingSocketNotifier(fd, it.value(), POLLIN | POLLOUT);
+    }
+
+    // level-triggered: whatever didn't fit is reported on the next call,
+    // but grow the buffer so that busy loops need fewer syscalls
+    if (nfds == epollEvents.size() && epollEvents.size() < MaxEpollEvents)
+        epollEvents.resize(epollEvents.size() * 2);
+
+    return nevents + activateSocketNotifiers();
+}
+#endif // QT_CONFIG(epoll)
+
 QEventDispatcherUNIX::QEventDispatcherUNIX(QObject *parent)
     : QAbstractEventDispatcher(*new QEventDispatcherUNIXPrivate, parent)
 { }
@@ -406,12 +593,20 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
 
     Q_D(QEventDispatcherUNIX);
     QSocketNotifierSetUNIX &sn_set = d->socketNotifiers[sockfd];
+#if QT_CONFIG(epoll)
+    const short oldEvents = sn_set.events();
+#endif
 
     if (sn_set.notifiers[type] && sn_set.notifiers[type] != notifier)
         qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
                  Q_FUNC_INFO, sockfd, socketType(type));
 
     sn_set.notifiers[type] = notifier;
+
+#if QT_CONFIG(epoll)
+    if (d->epollFd != -1)
+        d->updateEpollRegistration(sockfd, oldEvents, sn_set.events());
+#endif
 }
 
 void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
@@ -450,8 +645,17 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
         return;
     }
 
+#if QT_CONFIG(epoll)
+    const short oldEvents = sn_set.events();
+#endif
+
     sn_set.notifiers[type] = nullptr;
 
+#if QT_CONFIG(epoll)
+    if (d->epollFd != -1)
+        d->updateEpollRegistration(sockfd, oldEvents, sn_set.events());
+#endif
+
     if (sn_set.isEmpty())
         d->socketNotifiers.erase(i);
 }
@@ -487,29 +691,38 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     if (!canWait || (include_timers && d->timerList.timerWait(wait_tm)))
         tm = &wait_tm;
 
-    d->pollfds.clear();
-    d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
-
-    if (include_notifiers)
-        for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
-            d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
-
-    // This must be last, as it's popped off the end below
-    d->pollfds.append(d->threadPipe.prepare());
-
     int nevents = 0;
 
-    switch (qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm)) {
-    case -1:
-        perror("qt_safe_poll");
-        break;
-    case 0:
-        break;
-    default:
-        nevents += d->threadPipe.check(d->pollfds.takeLast());
+#if QT_CONFIG(epoll)
+    // The epoll set always contains every socket notifier, so fall back
+    // to polling just the thread pipe when they are to be excluded
+    if (d->epollFd != -1 && include_notifiers) {
+        nevents += d->processEpollEvents(tm);
+    } else
+#endif
+    {
+        d->pollfds.clear();
+        d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
+
         if (include_notifiers)
-            nevents += d->activateSocketNotifiers();
-        break;
+            for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
+                d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
+
+        // This must be last, as it's popped off the end below
+        d->pollfds.append(d->threadPipe.prepare());
+
+        switch (qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm)) {
+        case -1:
+            perror("qt_safe_poll");
+            break;
+        case 0:
+            break;
+        default:
+            nevents += d->threadPipe.check(d->pollfds.takeLast());
+            if (include_notifiers)
+                nevents += d->activateSocketNotifiers();
+            break;
+        }
     }
 
     if (include_timers)
@@ -58,6 +58,10 @@
 #include "QtCore/qvarlengtharray.h"
 #include "private/qtimerinfo_unix_p.h"
 
+#if QT_CONFIG(epoll)
+#  include <sys/epoll.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QEventDispatcherUNIXPrivate;
@@ -137,15 +141,34 @@ public:
     int activateTimers();
 
     void markPendingSocketNotifiers();
+    void markPendingSocketNotifier(int fd, const QSocketNotifierSetUNIX &sn_set, short revents);
     int activateSocketNotifiers();
     void setSocketNotifierPending(QSocketNotifier *notifier);
 
+#if QT_CONFIG(epoll)
+    bool initEpoll();
+    void updateEpollRegistration(int fd, short oldEvents, short newEvents);
+    int processEpollEvents(const timespec *tm);
+    void armEpollTimer(const timespec *tm);
+#endif
+
     QThreadPipe threadPipe;
     QVector<pollfd> pollfds;
 
     QHash<int, QSocketNotifierSetUNIX> socketNotifiers;
     QVector<QSocketNotifier *> pendingNotifiers;
 
+#if QT_CONFIG(epoll)
+    // persistent epoll(7) registration, used instead of rebuilding pollfds
+    // on every iteration when QT_EVENTDISPATCHER_EPOLL is set
+    int epollFd;
+    int timerFd;
+    bool timerFdArmed;
+    timespec timerFdDeadline;
+    QVector<int> nonPollableFds; // regular files etc., always ready
+    QVector<epoll_event> epollEvents;
+#endif
+
     QTimerInfoList timerList;
     QAtomicInt interrupt; // bool
 };
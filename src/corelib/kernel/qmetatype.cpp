@@ -42,7 +42,7 @@
 #include "qobjectdefs.h"
 #include "qdatetime.h"
 #include "qbytearray.h"
-#include "qreadwritelock.h"
+#include "qmutex.h"
 #include "qstring.h"
 #include "qstringlist.h"
 #include "qvector.h"
@@ -351,6 +351,9 @@ struct DefinedTypesFilter {
     constructor, a public copy constructor, and a public destructor
     can be registered.
 
+    At most 262144 custom types and typedefs can be registered in a process;
+    registering more is a fatal error.
+
     The following code allocates and destructs an instance of
     \c{MyClass}:
 
@@ -565,47 +568,180 @@ public:
     int alias;
 };
 
-template<typename T, typename Key>
-class QMetaTypeFunctionRegistry
+/*
+    An open addressing hash table from 64-bit keys to pointers that can be
+    read without locking. Writers must be serialized by the owner. Keys are
+    never removed (removing clears the value), and tables are only freed in
+    the destructor after they have been outgrown, so a reader never touches
+    freed memory.
+*/
+template <typename T>
+class QMetaTypeLockFreeMap
 {
+    struct Slot
+    {
+        quint64 key;                // immutable once the slot is in use
+        QAtomicPointer<const T> value;
+        QAtomicInt inUse;
+    };
+
+    struct Table
+    {
+        explicit Table(uint size)
+            : mask(size - 1), used(0), buckets(new Slot[size]), previous(nullptr) {}
+        ~Table() { delete[] buckets; }
+
+        const uint mask;
+        uint used;
+        Slot * const buckets;
+        Table *previous;
+    };
+
+    static uint hash(quint64 key) noexcept
+    {
+        key ^= key >> 31;
+        key *= Q_UINT64_C(0xbf58476d1ce4e5b9);
+        return uint(key >> 32);
+    }
+
 public:
-    ~QMetaTypeFunctionRegistry()
+    QMetaTypeLockFreeMap() = default;
+    QMetaTypeLockFreeMap(const QMetaTypeLockFreeMap &) = delete;
+    QMetaTypeLockFreeMap &operator=(const QMetaTypeLockFreeMap &) = delete;
+
+    ~QMetaTypeLockFreeMap()
+    {
+        Table *t = table.loadRelaxed();
+        while (t) {
+            Table *previous = t->previous;
+            delete t;
+            t = previous;
+        }
+    }
+
+    const T *value(quint64 key) const noexcept
+    {
+        const Table *t = table.loadAcquire();
+        if (!t)
+            return nullptr;
+        for (uint i = hash(key) & t->mask; ; i = (i + 1) & t->mask) {
+            const Slot &slot = t->buckets[i];
+            if (!slot.inUse.loadAcquire())
+                return nullptr;
+            if (slot.key == key)
+                return slot.value.loadAcquire();
+        }
+    }
+
+    // writer side
+    bool insertIfNotContains(quint64 key, const T *value)
+    {
+        Slot *slot = find(key);
+        if (slot) {
+            if (slot->value.loadRelaxed())
+                return false;
+            slot->value.storeRelease(value);
+            return true;
+        }
+
+        Table *t = table.loadRelaxed();
+        if (!t || 2 * (t->used + 1) > t->mask + 1)
+            t = grow();
+        insert(t, key, value);
+        return true;
+    }
+
+    void remove(quint64 key)
+    {
+        if (Slot *slot = find(key))
+            slot->value.storeRelease(nullptr);
+    }
+
+private:
+    Slot *find(quint64 key) const noexcept
+    {
+        const Table *t = table.loadRelaxed();
+        if (!t)
+            return nullptr;
+        for (uint i = hash(key) & t->mask; ; i = (i + 1) & t->mask) {
+            Slot &slot = t->buckets[i];
+            if (!slot.inUse.loadRelaxed())
+                return nullptr;
+            if (slot.key == key)
+                return &slot;
+        }
+    }
+
+    static void insert(Table *t, quint64 key, const T *value) noexcept
     {
-        const QWriteLocker locker(&lock);
-        map.clear();
+        uint i = hash(key) & t->mask;
+        while (t->buckets[i].inUse.loadRelaxed())
+            i = (i + 1) & t->mask;
+        Slot &slot = t->buckets[i];
+        slot.key = key;
+        slot.value.storeRelaxed(value);
+        // makes key and value visible to readers
+        slot.inUse.storeRelease(1);
+        ++t->used;
     }
 
+    Table *grow()
+    {
+        Table *old = table.loadRelaxed();
+        uint size = 16;
+        if (old) {
+            while (size < 4 * (old->used + 1))
+                size *= 2;
+        }
+        Table *t = new Table(size);
+        if (old) {
+            for (uint i = 0; i <= old->mask; ++i) {
+                const Slot &slot = old->buckets[i];
+                if (const T *value = slot.value.loadRelaxed())
+                    insert(t, slot.key, value);
+            }
+        }
+        t->previous = old;
+        table.storeRelease(t);
+        return t;
+    }
+
+    QAtomicPointer<Table> table;
+};
+
+template<typename T, typename Key>
+class QMetaTypeFunctionRegistry
+{
+public:
     bool contains(Key k) const
     {
-        const QReadLocker locker(&lock);
-        return map.contains(k);
+        return map.value(toKey(k)) != nullptr;
     }
 
     bool insertIfNotContains(Key k, const T *f)
     {
-        const QWriteLocker locker(&lock);
-        const T* &fun = map[k];
-        if (fun)
-            return false;
-        fun = f;
-        return true;
+        const QMutexLocker locker(&lock);
+        return map.insertIfNotContains(toKey(k), f);
     }
 
     const T *function(Key k) const
     {
-        const QReadLocker locker(&lock);
-        return map.value(k, nullptr);
+        return map.value(toKey(k));
     }
 
     void remove(int from, int to)
     {
         const Key k(from, to);
-        const QWriteLocker locker(&lock);
-        map.remove(k);
+        const QMutexLocker locker(&lock);
+        map.remove(toKey(k));
     }
 private:
-    mutable QReadWriteLock lock;
-    QHash<Key, const T *> map;
+    static quint64 toKey(int type) { return uint(type); }
+    static quint64 toKey(QPair<int, int> types)
+    { return quint64(uint(types.first)) << 32 | uint(types.second); }
+
+    QMutex lock;
+    QMetaTypeLockFreeMap<T> map;
 };
 
 typedef QMetaTypeFunctionRegistry<QtPrivate::AbstractConverterFunction,QPair<int,int> >
@@ -618,13 +754,210 @@ QMetaTypeDebugStreamRegistry;
 Q_STATIC_ASSERT(std::is_trivial<QMetaTypeInterface>::value);
 Q_STATIC_ASSERT(std::is_standard_layout<QMetaTypeInterface>::value);
 
-Q_DECLARE_TYPEINFO(QCustomTypeInfo, Q_MOVABLE_TYPE);
-Q_GLOBAL_STATIC(QVector<QCustomTypeInfo>, customTypes)
-Q_GLOBAL_STATIC(QReadWriteLock, customTypesLock)
+/*
+    The custom types, indexed by type id - QMetaType::User.
+
+    Lookups by index or by name never lock: entries are stored in pages that
+    are never moved, and an entry is never modified after it was published.
+    Changing a registered type publishes a modified copy, and the replaced
+    entries are kept alive until the registry is destroyed, so that pointers
+    (like the one returned by QMetaType::typeName()) stay valid.
+
+    The page table has a fixed size, which limits the registry to
+    MaxPages * PageSize (262144) entries, typedefs included.
+
+    Writers must hold the mutex.
+*/
+class QCustomTypeRegistry
+{
+    enum { PageShift = 8, PageSize = 1 << PageShift, MaxPages = 1024 };
+
+    struct Page
+    {
+        QAtomicPointer<const QCustomTypeInfo> entries[PageSize];
+    };
+
+    struct NameTable
+    {
+        explicit NameTable(uint size)
+            : mask(size - 1), used(0), buckets(new QAtomicInt[size]), previous(nullptr) {}
+        ~NameTable() { delete[] buckets; }
+
+        const uint mask;
+        uint used;
+        QAtomicInt * const buckets;   // index + 1, or 0 if unused
+        NameTable *previous;
+    };
+
+    static uint hash(const char *typeName, int length) noexcept
+    { return qHashBits(typeName, size_t(length)); }
+
+public:
+    QCustomTypeRegistry() = default;
+    QCustomTypeRegistry(const QCustomTypeRegistry &) = delete;
+    QCustomTypeRegistry &operator=(const QCustomTypeRegistry &) = delete;
+    ~QCustomTypeRegistry();
+
+    int count() const noexcept { return size.loadAcquire(); }
+
+    const QCustomTypeInfo *at(int index) const noexcept
+    {
+        if (uint(index) >= uint(size.loadAcquire()))
+            return nullptr;
+        return pages[index >> PageShift].loadRelaxed()->entries[index & (PageSize - 1)].loadAcquire();
+    }
+
+    // Returns the type id (resolving aliases) registered for typeName
+    int type(const char *typeName, int length) const noexcept
+    {
+        const NameTable *t = names.loadAcquire();
+        if (!t)
+            return QMetaType::UnknownType;
+        for (uint i = hash(typeName, length) & t->mask; ; i = (i + 1) & t->mask) {
+            const int slot = t->buckets[i].loadAcquire();
+            if (!slot)
+                return QMetaType::UnknownType;
+            const QCustomTypeInfo *info = at(slot - 1);
+            if (info && length == info->typeName.size()
+                && !memcmp(typeName, info->typeName.constData(), length)) {
+                return info->alias >= 0 ? info->alias : slot - 1 + QMetaType::User;
+            }
+        }
+    }
+
+    // writer side
+    int firstUnusedIndex() const noexcept;
+    int add(const QCustomTypeInfo &info);
+    void replace(int index, const QCustomTypeInfo &info);
+
+    QMutex mutex;
+
+private:
+    void publish(int index, const QCustomTypeInfo *info);
+    void insertName(NameTable *t, int index) const noexcept;
+    void rebuildNames();
+
+    QAtomicPointer<Page> pages[MaxPages];
+    QAtomicInt size;
+    QAtomicPointer<NameTable> names;
+    QVector<const QCustomTypeInfo *> retired;
+    int unusedCount = 0;
+};
+
+QCustomTypeRegistry::~QCustomTypeRegistry()
+{
+    const int n = size.loadRelaxed();
+    for (int i = 0; i < n; i += PageSize) {
+        Page *page = pages[i >> PageShift].loadRelaxed();
+        for (int j = 0; j < PageSize && i + j < n; ++j)
+            delete page->entries[j].loadRelaxed();
+        delete page;
+    }
+    qDeleteAll(retired);
+    for (NameTable *t = names.loadRelaxed(); t; ) {
+        NameTable *previous = t->previous;
+        delete t;
+        t = previous;
+    }
+}
+
+int QCustomTypeRegistry::firstUnusedIndex() const noexcept
+{
+    if (!unusedCount)
+        return -1;
+    const int n = size.loadRelaxed();
+    for (int i = 0; i < n; ++i) {
+        if (at(i)->typeName.isEmpty())
+            return i;
+    }
+    return -1;
+}
+
+int QCustomTypeRegistry::add(const QCustomTypeInfo &info)
+{
+    const int index = size.loadRelaxed();
+    if (Q_UNLIKELY(index >= MaxPages * PageSize)) {
+        qFatal("QMetaType: Cannot register type %s, the limit of %d custom types "
+               "and typedefs has been reached", info.typeName.constData(),
+               int(MaxPages * PageSize));
+    }
+    if (!(index & (PageSize - 1)))
+        pages[index >> PageShift].storeRelaxed(new Page);
+    pages[index >> PageShift].loadRelaxed()->entries[index & (PageSize - 1)].storeRelaxed(new QCustomTypeInfo(info));
+    // makes the page and the entry visible to readers
+    size.storeRelease(index + 1);
+
+    NameTable *t = names.loadRelaxed();
+    if (!t || 2 * (t->used + 1) > t->mask + 1)
+        rebuildNames();
+    else
+        insertName(t, index);
+    return index;
+}
+
+void QCustomTypeRegistry::replace(int index, const QCustomTypeInfo &info)
+{
+    Q_ASSERT(index < size.loadRelaxed());
+    const QCustomTypeInfo *old = at(index);
+    publish(index, new QCustomTypeInfo(info));
+    retired.append(old);
+
+    if (old->typeName.isEmpty() != info.typeName.isEmpty())
+        unusedCount += info.typeName.isEmpty() ? 1 : -1;
+    if (!info.typeName.isEmpty() && info.typeName != old->typeName) {
+        // the stale slot of a previous name is skipped by readers because
+        // the name does not match anymore; it is dropped on the next rebuild
+        NameTable *t = names.loadRelaxed();
+        if (2 * (t->used + 1) > t->mask + 1)
+            rebuildNames();
+        else
+            insertName(t, index);
+    }
+}
+
+void QCustomTypeRegistry::publish(int index, const QCustomTypeInfo *info)
+{
+    pages[index >> PageShift].loadRelaxed()->entries[index & (PageSize - 1)].storeRelease(info);
+}
+
+void QCustomTypeRegistry::insertName(NameTable *t, int index) const noexcept
+{
+    const QByteArray &typeName = at(index)->typeName;
+    uint i = hash(typeName.constData(), typeName.size()) & t->mask;
+    while (t->buckets[i].loadRelaxed())
+        i = (i + 1) & t->mask;
+    t->buckets[i].storeRelease(index + 1);
+    ++t->used;
+}
+
+void QCustomTypeRegistry::rebuildNames()
+{
+    const int n = size.loadRelaxed();
+    uint tableSize = 64;
+    while (tableSize < 4 * uint(n))
+        tableSize *= 2;
+    NameTable *t = new NameTable(tableSize);
+    for (int i = 0; i < n; ++i) {
+        if (!at(i)->typeName.isEmpty())
+            insertName(t, i);
+    }
+    t->previous = names.loadRelaxed();
+    names.storeRelease(t);
+}
+
+Q_GLOBAL_STATIC(QCustomTypeRegistry, customTypes)
 Q_GLOBAL_STATIC(QMetaTypeConverterRegistry, customTypesConversionRegistry)
 Q_GLOBAL_STATIC(QMetaTypeComparatorRegistry, customTypesComparatorRegistry)
 Q_GLOBAL_STATIC(QMetaTypeDebugStreamRegistry, customTypesDebugStreamRegistry)
 
+static const QCustomTypeInfo *findCustomType(int type) noexcept
+{
+    if (type < QMetaType::User)
+        return nullptr;
+    const QCustomTypeRegistry * const ct = customTypes();
+    return ct ? ct->at(type - QMetaType::User) : nullptr;
+}
+
 /*!
     \fn bool QMetaType::registerConverter()
     \since 5.2
@@ -863,13 +1196,17 @@ void QMetaType::registerStreamOperators(int idx, SaveOperator saveOp,
 {
     if (idx < User)
         return; //builtin types should not be registered;
-    QVector<QCustomTypeInfo> *ct = customTypes();
+    QCustomTypeRegistry *ct = customTypes();
     if (!ct)
         return;
-    QWriteLocker locker(customTypesLock());
-    QCustomTypeInfo &inf = (*ct)[idx - User];
+    const QMutexLocker locker(&ct->mutex);
+    const QCustomTypeInfo *old = ct->at(idx - User);
+    if (!old)
+        return;
+    QCustomTypeInfo inf = *old;
     inf.saveOp = saveOp;
     inf.loadOp = loadOp;
+    ct->replace(idx - User, inf);
 }
 #endif // QT_NO_DATASTREAM
 
@@ -968,11 +1305,8 @@ const char *QMetaType::typeName(int typeId)
         return nullptr; // It can happen when someone cast int to QVariant::Type, we should not crash...
     }
 
-    const QVector<QCustomTypeInfo> * const ct = customTypes();
-    QReadLocker locker(customTypesLock());
-    return ct && uint(ct->count()) > type - QMetaType::User && !ct->at(type - QMetaType::User).typeName.isEmpty()
-            ? ct->at(type - QMetaType::User).typeName.constData()
-            : nullptr;
+    const QCustomTypeInfo * const info = findCustomType(typeId);
+    return info && !info->typeName.isEmpty() ? info->typeName.constData() : nullptr;
 
 #undef QT_METATYPE_TYPEID_TYPENAME_CONVERTER
 }
@@ -1006,30 +1340,14 @@ static inline int qMetaTypeStaticType(const char *typeName, int length)
 
 /*
     Similar to QMetaType::type(), but only looks in the custom set of
-    types, and doesn't lock the mutex.
-    The extra \a firstInvalidIndex parameter is an easy way to avoid
-    iterating over customTypes() a second time in registerNormalizedType().
+    types. Doesn't lock.
 */
-static int qMetaTypeCustomType_unlocked(const char *typeName, int length, int *firstInvalidIndex = nullptr)
+static int qMetaTypeCustomType(const char *typeName, int length)
 {
-    const QVector<QCustomTypeInfo> * const ct = customTypes();
+    const QCustomTypeRegistry * const ct = customTypes();
     if (!ct)
         return QMetaType::UnknownType;
-
-    if (firstInvalidIndex)
-        *firstInvalidIndex = -1;
-    for (int v = 0; v < ct->count(); ++v) {
-        const QCustomTypeInfo &customInfo = ct->at(v);
-        if ((length == customInfo.typeName.size())
-            && !memcmp(typeName, customInfo.typeName.constData(), length)) {
-            if (customInfo.alias >= 0)
-                return customInfo.alias;
-            return v + QMetaType::User;
-        }
-        if (firstInvalidIndex && (*firstInvalidIndex < 0) && customInfo.typeName.isEmpty())
-            *firstInvalidIndex = v;
-    }
-    return QMetaType::UnknownType;
+    return ct->type(typeName, length);
 }
 
 /*!
@@ -1059,21 +1377,25 @@ int QMetaType::registerType(const char *typeName, Deleter deleter,
  */
 bool QMetaType::unregisterType(int type)
 {
-    QWriteLocker locker(customTypesLock());
-    QVector<QCustomTypeInfo> *ct = customTypes();
+    QCustomTypeRegistry *ct = customTypes();
+    const QMutexLocker locker(&ct->mutex);
 
     // check if user type
-    if ((type < User) || ((type - User) >= ct->size()))
+    if ((type < User) || ((type - User) >= ct->count()))
         return false;
 
     // only types without Q_DECLARE_METATYPE can be unregistered
-    if (ct->data()[type - User].flags & WasDeclaredAsMetaType)
+    if (ct->at(type - User)->flags & WasDeclaredAsMetaType)
         return false;
 
     // invalidate type and all its alias entries
     for (int v = 0; v < ct->count(); ++v) {
-        if (((v + User) == type) || (ct->at(v).alias == type))
-            ct->data()[v].typeName.clear();
+        const QCustomTypeInfo *info = ct->at(v);
+        if ((((v + User) == type) || (info->alias == type)) && !info->typeName.isEmpty()) {
+            QCustomTypeInfo inf = *info;
+            inf.typeName.clear();
+            ct->replace(v, inf);
+        }
     }
     return true;
 }
@@ -1135,7 +1457,7 @@ static int registerNormalizedType(const NS(QByteArray) &normalizedTypeName,
                                   QMetaType::TypedConstructor typedConstructor,
                                   int size, QMetaType::TypeFlags flags, const QMetaObject *metaObject)
 {
-    QVector<QCustomTypeInfo> *ct = customTypes();
+    QCustomTypeRegistry *ct = customTypes();
     if (!ct || normalizedTypeName.isEmpty() || (!destructor && !typedDestructor) || (!constructor && !typedConstructor))
         return -1;
 
@@ -1145,11 +1467,8 @@ static int registerNormalizedType(const NS(QByteArray) &normalizedTypeName,
     int previousSize = 0;
     QMetaType::TypeFlags::Int previousFlags = 0;
     if (idx == QMetaType::UnknownType) {
-        QWriteLocker locker(customTypesLock());
-        int posInVector = -1;
-        idx = qMetaTypeCustomType_unlocked(normalizedTypeName.constData(),
-                                           normalizedTypeName.size(),
-                                           &posInVector);
+        const QMutexLocker locker(&ct->mutex);
+        idx = ct->type(normalizedTypeName.constData(), normalizedTypeName.size());
         if (idx == QMetaType::UnknownType) {
             QCustomTypeInfo inf;
             inf.typeName = normalizedTypeName;
@@ -1165,28 +1484,30 @@ static int registerNormalizedType(const NS(QByteArray) &normalizedTypeName,
             inf.size = size;
             inf.flags = flags;
             inf.metaObject = metaObject;
+            const int posInVector = ct->firstUnusedIndex();
             if (posInVector == -1) {
-                idx = ct->size() + QMetaType::User;
-                ct->append(inf);
+                idx = ct->add(inf) + QMetaType::User;
             } else {
                 idx = posInVector + QMetaType::User;
-                ct->data()[posInVector] = inf;
+                ct->replace(posInVector, inf);
             }
             return idx;
         }
 
         if (idx >= QMetaType::User) {
-            previousSize = ct->at(idx - QMetaType::User).size;
-            previousFlags = ct->at(idx - QMetaType::User).flags;
+            const QCustomTypeInfo *previous = ct->at(idx - QMetaType::User);
+            previousSize = previous->size;
+            previousFlags = previous->flags;
 
             // Set new/additional flags in case of old library/app.
             // Ensures that older code works in conjunction with new Qt releases
             // requiring the new flags.
             if (flags != previousFlags) {
-                QCustomTypeInfo &inf = ct->data()[idx - QMetaType::User];
+                QCustomTypeInfo inf = *previous;
                 inf.flags |= flags;
                 if (metaObject)
                     inf.metaObject = metaObject;
+                ct->replace(idx - QMetaType::User, inf);
             }
         }
     }
@@ -1305,7 +1626,7 @@ int QMetaType::registerTypedef(const char* typeName, int aliasId)
 */
 int QMetaType::registerNormalizedTypedef(const NS(QByteArray) &normalizedTypeName, int aliasId)
 {
-    QVector<QCustomTypeInfo> *ct = customTypes();
+    QCustomTypeRegistry *ct = customTypes();
     if (!ct || normalizedTypeName.isEmpty())
         return -1;
 
@@ -1313,20 +1634,19 @@ int QMetaType::registerNormalizedTypedef(const NS(QByteArray) &normalizedTypeNam
                                   normalizedTypeName.size());
 
     if (idx == UnknownType) {
-        QWriteLocker locker(customTypesLock());
-        int posInVector = -1;
-        idx = qMetaTypeCustomType_unlocked(normalizedTypeName.constData(),
-                                               normalizedTypeName.size(),
-                                               &posInVector);
+        const QMutexLocker locker(&ct->mutex);
+        idx = ct->type(normalizedTypeName.constData(), normalizedTypeName.size());
 
         if (idx == UnknownType) {
             QCustomTypeInfo inf;
             inf.typeName = normalizedTypeName;
             inf.alias = aliasId;
-            if (posInVector == -1)
-                ct->append(inf);
-            else
-                ct->data()[posInVector] = inf;
+            const int posInVector = ct->firstUnusedIndex();
+            if (posInVector == -1) {
+                ct->add(inf);
+            } else {
+                ct->replace(posInVector, inf);
+            }
             return aliasId;
         }
     }
@@ -1356,9 +1676,8 @@ bool QMetaType::isRegistered(int type)
         return true;
     }
 
-    QReadLocker locker(customTypesLock());
-    const QVector<QCustomTypeInfo> * const ct = customTypes();
-    return ((type >= User) && (ct && ct->count() > type - User) && !ct->at(type - User).typeName.isEmpty());
+    const QCustomTypeInfo * const info = findCustomType(type);
+    return info && !info->typeName.isEmpty();
 }
 
 template <bool tryNormalizedType>
@@ -1368,16 +1687,15 @@ static inline int qMetaTypeTypeImpl(const char *typeName, int length)
         return QMetaType::UnknownType;
     int type = qMetaTypeStaticType(typeName, length);
     if (type == QMetaType::UnknownType) {
-        QReadLocker locker(customTypesLock());
-        type = qMetaTypeCustomType_unlocked(typeName, length);
+        type = qMetaTypeCustomType(typeName, length);
 #ifndef QT_NO_QOBJECT
         if ((type == QMetaType::UnknownType) && tryNormalizedType) {
             const NS(QByteArray) normalizedTypeName = QMetaObject::normalizedType(typeName);
             type = qMetaTypeStaticType(normalizedTypeName.constData(),
                                        normalizedTypeName.size());
             if (type == QMetaType::UnknownType) {
-                type = qMetaTypeCustomType_unlocked(normalizedTypeName.constData(),
-                                                    normalizedTypeName.size());
+                type = qMetaTypeCustomType(normalizedTypeName.constData(),
+                                           normalizedTypeName.size());
             }
         }
 #endif
@@ -1525,14 +1843,10 @@ public:
     }
     bool delegate(const QMetaTypeSwitcher::NotBuiltinType *data)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        if (!ct)
+        const QCustomTypeInfo * const info = findCustomType(m_type);
+        if (!info)
             return false;
-        QMetaType::SaveOperator saveOp = nullptr;
-        {
-            QReadLocker locker(customTypesLock());
-            saveOp = ct->at(m_type - QMetaType::User).saveOp;
-        }
+        const QMetaType::SaveOperator saveOp = info->saveOp;
         if (!saveOp)
             return false;
         saveOp(stream, data);
@@ -1576,14 +1890,10 @@ public:
     }
     bool delegate(const QMetaTypeSwitcher::NotBuiltinType *data)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        if (!ct)
+        const QCustomTypeInfo * const info = findCustomType(m_type);
+        if (!info)
             return false;
-        QMetaType::LoadOperator loadOp = nullptr;
-        {
-            QReadLocker locker(customTypesLock());
-            loadOp = ct->at(m_type - QMetaType::User).loadOp;
-        }
+        const QMetaType::LoadOperator loadOp = info->loadOp;
         if (!loadOp)
             return false;
         loadOp(stream, const_cast<QMetaTypeSwitcher::NotBuiltinType*>(data));
@@ -1705,17 +2015,11 @@ public:
 private:
     static void *customTypeConstructor(const int type, void *where, const void *copy)
     {
-        QMetaType::Constructor ctor;
-        QMetaType::TypedConstructor tctor;
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        {
-            QReadLocker locker(customTypesLock());
-            if (Q_UNLIKELY(type < QMetaType::User || !ct || ct->count() <= type - QMetaType::User))
-                return nullptr;
-            const auto &typeInfo = ct->at(type - QMetaType::User);
-            ctor = typeInfo.constructor;
-            tctor = typeInfo.typedConstructor;
-        }
+        const QCustomTypeInfo * const typeInfo = findCustomType(type);
+        if (Q_UNLIKELY(!typeInfo))
+            return nullptr;
+        const QMetaType::Constructor ctor = typeInfo->constructor;
+        const QMetaType::TypedConstructor tctor = typeInfo->typedConstructor;
         Q_ASSERT_X((ctor || tctor) , "void *QMetaType::construct(int type, void *where, const void *copy)", "The type was not properly registered");
         if (Q_UNLIKELY(tctor))
             return tctor(type, where, copy);
@@ -1803,17 +2107,11 @@ public:
 private:
     static void customTypeDestructor(const int type, void *where)
     {
-        QMetaType::Destructor dtor;
-        QMetaType::TypedDestructor tdtor;
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        {
-            QReadLocker locker(customTypesLock());
-            if (Q_UNLIKELY(type < QMetaType::User || !ct || ct->count() <= type - QMetaType::User))
-                return;
-            const auto &typeInfo = ct->at(type - QMetaType::User);
-            dtor = typeInfo.destructor;
-            tdtor = typeInfo.typedDestructor;
-        }
+        const QCustomTypeInfo * const typeInfo = findCustomType(type);
+        if (Q_UNLIKELY(!typeInfo))
+            return;
+        const QMetaType::Destructor dtor = typeInfo->destructor;
+        const QMetaType::TypedDestructor tdtor = typeInfo->typedDestructor;
         Q_ASSERT_X((dtor || tdtor), "void QMetaType::destruct(int type, void *where)", "The type was not properly registered");
         if (Q_UNLIKELY(tdtor))
             return tdtor(type, where);
@@ -1877,11 +2175,8 @@ public:
 private:
     static int customTypeSizeOf(const int type)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        QReadLocker locker(customTypesLock());
-        if (Q_UNLIKELY(type < QMetaType::User || !ct || ct->count() <= type - QMetaType::User))
-            return 0;
-        return ct->at(type - QMetaType::User).size;
+        const QCustomTypeInfo * const info = findCustomType(type);
+        return Q_LIKELY(info) ? info->size : 0;
     }
 
     const int m_type;
@@ -1945,13 +2240,8 @@ private:
     const int m_type;
     static quint32 customTypeFlags(const int type)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        if (Q_UNLIKELY(!ct || type < QMetaType::User))
-            return 0;
-        QReadLocker locker(customTypesLock());
-        if (Q_UNLIKELY(ct->count() <= type - QMetaType::User))
-            return 0;
-        return ct->at(type - QMetaType::User).flags;
+        const QCustomTypeInfo * const info = findCustomType(type);
+        return Q_LIKELY(info) ? info->flags : 0;
     }
 };
 }  // namespace
@@ -2009,13 +2299,8 @@ private:
     const int m_type;
     static const QMetaObject *customMetaObject(const int type)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        if (Q_UNLIKELY(!ct || type < QMetaType::User))
-            return nullptr;
-        QReadLocker locker(customTypesLock());
-        if (Q_UNLIKELY(ct->count() <= type - QMetaType::User))
-            return nullptr;
-        return ct->at(type - QMetaType::User).metaObject;
+        const QCustomTypeInfo * const info = findCustomType(type);
+        return Q_LIKELY(info) ? info->metaObject : nullptr;
     }
 };
 }  // namespace
@@ -2213,12 +2498,8 @@ public:
 private:
     void customTypeInfo(const uint type)
     {
-        const QVector<QCustomTypeInfo> * const ct = customTypes();
-        if (Q_UNLIKELY(!ct))
-            return;
-        QReadLocker locker(customTypesLock());
-        if (Q_LIKELY(uint(ct->count()) > type - QMetaType::User))
-            info = ct->at(type - QMetaType::User);
+        if (const QCustomTypeInfo * const customInfo = findCustomType(int(type)))
+            info = *customInfo;
     }
 
     const uint m_type;
@@ -70,6 +70,7 @@
 #include <private/qhooks_p.h>
 #include <qtcore_tracepoints_p.h>
 
+#include <cstddef>
 #include <new>
 
 #include <ctype.h>
@@ -184,6 +185,118 @@ QMetaObject *QObjectData::dynamicMetaObject() const
     return metaObject->toDynamicMetaObject(q_ptr);
 }
 
+static thread_local QObjectArena *currentObjectArena = nullptr;
+// the number of scopes with an arena in all threads; while there are none,
+// creating and deleting objects does not need to look at the thread locals
+static QBasicAtomicInt activeObjectArenaScopes = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+namespace {
+// The private most recently allocated from an arena on this thread, until
+// the QObject constructor has run
+struct PendingArenaAllocation
+{
+    QObjectArena *arena = nullptr;
+    char *begin = nullptr;
+    char *end = nullptr;
+};
+}
+static thread_local PendingArenaAllocation pendingArenaAllocation;
+
+/*!
+    \internal
+    \class QObjectArena
+    \inmodule QtCore
+
+    QObjectArena hands out the memory for the private data of QObjects that
+    are created while the arena is made current with QObjectArena::Scope,
+    and for their extra data. Blocks are carved out of large chunks and are
+    never freed individually: deleting such an object runs its destructors
+    as usual, but the memory is only returned once the arena itself and
+    every object allocated from it are gone. This makes building and tearing
+    down large object trees considerably cheaper, at the price of not
+    reusing the memory of objects deleted early.
+
+    The arena is reference counted; hold it in a
+    QExplicitlySharedDataPointer:
+
+    \code
+    QExplicitlySharedDataPointer<QObjectArena> arena(new QObjectArena);
+    {
+        QObjectArena::Scope scope(arena.data());
+        // build the tree
+    }
+    \endcode
+*/
+
+QObjectArena::QObjectArena() = default;
+
+QObjectArena::~QObjectArena()
+{
+    for (char *chunk : qAsConst(chunks))
+        ::free(chunk);
+}
+
+/*!
+    \internal
+    Returns the arena current in this thread, or \nullptr.
+*/
+QObjectArena *QObjectArena::current()
+{
+    return currentObjectArena;
+}
+
+/*!
+    \internal
+    Returns \a size bytes from the arena, which stays alive until the block
+    is handed back with release(). This function is thread-safe.
+*/
+void *QObjectArena::allocate(size_t size)
+{
+    const size_t alignment = alignof(std::max_align_t);
+    size = (size + alignment - 1) & ~(alignment - 1);
+
+    QBasicMutexLocker locker(&mutex);
+    if (size > size_t(chunkEnd - next)) {
+        const size_t chunkSize = qMax(size, size_t(ChunkSize));
+        char *chunk = static_cast<char *>(::malloc(chunkSize));
+        Q_CHECK_PTR(chunk);
+        chunks.append(chunk);
+        ref.ref();
+        if (chunkSize > size_t(ChunkSize))
+            return chunk;   // oversized block, keep filling the current chunk
+        next = chunk;
+        chunkEnd = chunk + chunkSize;
+    } else {
+        ref.ref();
+    }
+    char *ptr = next;
+    next += size;
+    return ptr;
+}
+
+/*!
+    \internal
+    \class QObjectArena::Scope
+    \inmodule QtCore
+
+    Makes an arena current in this thread for the lifetime of the scope.
+    Scopes nest; passing \nullptr disables arena allocation.
+*/
+QObjectArena::Scope::Scope(QObjectArena *arena)
+    : previous(currentObjectArena)
+{
+    if (arena)
+        activeObjectArenaScopes.ref();
+    currentObjectArena = arena;
+}
+
+QObjectArena::Scope::~Scope()
+{
+    if (currentObjectArena)
+        activeObjectArenaScopes.deref();
+    currentObjectArena = previous;
+}
+
 QObjectPrivate::QObjectPrivate(int version)
     : threadData(nullptr), currentChildBeingDeleted(nullptr)
 {
@@ -203,6 +316,14 @@ QObjectPrivate::QObjectPrivate(int version)
     metaObject = nullptr;
     isWindow = false;
     deleteLaterCalled = false;
+
+    // claim the block if operator new has just carved it out of an arena
+    arena = nullptr;
+    if (activeObjectArenaScopes.loadRelaxed()) {
+        const char *self = reinterpret_cast<const char *>(this);
+        if (self >= pendingArenaAllocation.begin && self < pendingArenaAllocation.end)
+            arena = pendingArenaAllocation.arena;
+    }
 }
 
 QObjectPrivate::~QObjectPrivate()
@@ -222,7 +343,7 @@ QObjectPrivate::~QObjectPrivate()
         }
     }
 
-    if (postedEvents)
+    if (postedEvents || thisThreadData->postEventList.hasIncoming())
         QCoreApplication::removePostedEvents(q_ptr, 0);
 
     thisThreadData->deref();
@@ -233,7 +354,39 @@ QObjectPrivate::~QObjectPrivate()
     if (extraData)
         qDeleteAll(extraData->userData);
 #endif
-    delete extraData;
+    if (!arena) {
+        delete extraData;
+    } else if (extraData) {
+        extraData->~ExtraData();
+        arena->release();
+    }
+}
+
+void *QObjectPrivate::operator new(size_t size)
+{
+    if (!activeObjectArenaScopes.loadRelaxed())
+        return ::operator new(size);
+    QObjectArena *arena = currentObjectArena;
+    if (!arena)
+        return ::operator new(size);
+
+    char *ptr = static_cast<char *>(arena->allocate(size));
+    pendingArenaAllocation = { arena, ptr, ptr + size };
+    return ptr;
+}
+
+void QObjectPrivate::operator delete(void *ptr)
+{
+    // Privates living in an arena are destroyed in place by ~QObject, so the
+    // only arena block that can get here is one whose constructor threw,
+    // inside the scope that made the arena current.
+    if (ptr && activeObjectArenaScopes.loadRelaxed() && ptr == pendingArenaAllocation.begin) {
+        QObjectArena *arena = pendingArenaAllocation.arena;
+        pendingArenaAllocation = PendingArenaAllocation();
+        arena->release();
+        return;
+    }
+    ::operator delete(ptr);
 }
 
 /*!
@@ -621,6 +774,194 @@ void QMetaCallEvent::placeMetaCall(QObject *object)
     }
 }
 
+/*!
+    \internal
+ */
+QObjectPrivate::BatchedCallQueue::~BatchedCallQueue()
+{
+    discardPending();
+    for (char *chunk : qAsConst(spareChunks))
+        free(chunk);
+}
+
+/*!
+    \internal
+
+    Returns storage for \a size bytes from the pending batch, suitably
+    aligned for any argument type. Must be called with the mutex locked.
+ */
+void *QObjectPrivate::BatchedCallQueue::allocate(int size)
+{
+    constexpr int alignment = int(alignof(std::max_align_t));
+    size = (size + alignment - 1) & ~(alignment - 1);
+
+    if (size > ChunkSize / 4) {
+        char *block = static_cast<char *>(malloc(size));
+        Q_CHECK_PTR(block);
+        pending.largeBlocks.append(block);
+        return block;
+    }
+    if (pending.chunkUsed + size > ChunkSize) {
+        char *chunk = spareChunks.isEmpty() ? static_cast<char *>(malloc(ChunkSize))
+                                            : spareChunks.takeLast();
+        Q_CHECK_PTR(chunk);
+        pending.chunks.append(chunk);
+        pending.chunkUsed = 0;
+    }
+    void *result = pending.chunks.constLast() + pending.chunkUsed;
+    pending.chunkUsed += size;
+    return result;
+}
+
+/*!
+    \internal
+
+    Copies \a argv into the pending batch and queues \a call. Returns \c true
+    if this is the first call of the batch, in which case the caller has to
+    post a QBatchedMetaCallEvent for it.
+ */
+bool QObjectPrivate::BatchedCallQueue::append(const BatchedCall &call, const int *argumentTypes,
+                                              int nargs, void **argv)
+{
+    QBasicMutexLocker locker(&mutex);
+
+    void **args = static_cast<void **>(allocate(nargs * int(sizeof(void *) + sizeof(int))));
+    int *types = reinterpret_cast<int *>(args + nargs);
+    types[0] = 0; // return type
+    args[0] = nullptr; // return value
+    for (int n = 1; n < nargs; ++n) {
+        types[n] = argumentTypes[n - 1];
+        args[n] = QMetaType::construct(types[n], allocate(QMetaType::sizeOf(types[n])), argv[n]);
+    }
+
+    pending.calls.append(call);
+    pending.calls.last().args = args;
+    pending.calls.last().nargs = nargs;
+
+    if (eventPosted)
+        return false;
+    eventPosted = true;
+    return true;
+}
+
+static void destroyBatchedCall(const QObjectPrivate::BatchedCall &call)
+{
+    const int *types = reinterpret_cast<const int *>(call.args + call.nargs);
+    for (int n = 1; n < call.nargs; ++n) {
+        if (call.args[n])
+            QMetaType::destruct(types[n], call.args[n]);
+    }
+    if (call.slotObj)
+        call.slotObj->destroyIfLastRef();
+}
+
+/*!
+    \internal
+
+    Returns the storage of a delivered \a batch to the queue.
+ */
+void QObjectPrivate::BatchedCallQueue::release(Batch &batch)
+{
+    for (char *block : qAsConst(batch.largeBlocks))
+        free(block);
+
+    QBasicMutexLocker locker(&mutex);
+    for (char *chunk : qAsConst(batch.chunks)) {
+        if (spareChunks.size() < MaxSpareChunks)
+            spareChunks.append(chunk);
+        else
+            free(chunk);
+    }
+    // keep the capacity of the call list for the next batch
+    if (pending.calls.isEmpty() && pending.calls.capacity() < batch.calls.capacity()) {
+        batch.calls.clear();
+        pending.calls.swap(batch.calls);
+    }
+}
+
+/*!
+    \internal
+
+    Invokes all pending calls on \a object, the receiver, in the order they
+    were queued. Stops when a call deletes the receiver.
+ */
+void QObjectPrivate::BatchedCallQueue::deliver(QObject *object)
+{
+    Batch batch;
+    {
+        QBasicMutexLocker locker(&mutex);
+        qSwap(batch, pending);
+        eventPosted = false;
+    }
+
+    bool receiverDeleted = false;
+    for (const BatchedCall &call : qAsConst(batch.calls)) {
+        if (!receiverDeleted) {
+            QObjectPrivate::Sender currentSender(object, const_cast<QObject *>(call.sender),
+                                                 call.signalId);
+            if (call.slotObj) {
+                call.slotObj->call(object, call.args);
+            } else if (call.callFunction && call.method_offset <= object->metaObject()->methodOffset()) {
+                call.callFunction(object, QMetaObject::InvokeMetaMethod, call.method_relative, call.args);
+            } else {
+                QMetaObject::metacall(object, QMetaObject::InvokeMetaMethod,
+                                      call.method_offset + call.method_relative, call.args);
+            }
+            receiverDeleted = !currentSender.receiver;
+        }
+        destroyBatchedCall(call);
+    }
+    release(batch);
+}
+
+/*!
+    \internal
+
+    Drops the pending calls, for instance because their event was removed.
+ */
+void QObjectPrivate::BatchedCallQueue::discardPending()
+{
+    Batch batch;
+    {
+        QBasicMutexLocker locker(&mutex);
+        qSwap(batch, pending);
+        eventPosted = false;
+    }
+    for (const BatchedCall &call : qAsConst(batch.calls))
+        destroyBatchedCall(call);
+    release(batch);
+}
+
+/*!
+    \internal
+
+    Delivers the batch of queued calls pending in \a queue; takes over a
+    reference to it.
+ */
+QBatchedMetaCallEvent::QBatchedMetaCallEvent(QObjectPrivate::BatchedCallQueue *queue)
+    : QAbstractMetaCallEvent(nullptr, -1), queue(queue), delivered(false)
+{
+}
+
+/*!
+    \internal
+ */
+QBatchedMetaCallEvent::~QBatchedMetaCallEvent()
+{
+    if (!delivered)
+        queue->discardPending();
+    queue->deref();
+}
+
+/*!
+    \internal
+ */
+void QBatchedMetaCallEvent::placeMetaCall(QObject *object)
+{
+    delivered = true;
+    queue->deliver(object);
+}
+
 /*!
     \class QSignalBlocker
     \brief Exception-safe wrapper around QObject::blockSignals().
@@ -937,6 +1278,8 @@ QObject::QObject(QObjectPrivate &dd, QObject *parent)
             QT_RETHROW;
         }
     }
+    if (d->arena)   // constructed, ~QObject takes care of the block from now on
+        pendingArenaAllocation = PendingArenaAllocation();
 #if QT_VERSION < 0x60000
     qt_addObject(this);
 #endif
@@ -1073,6 +1416,10 @@ QObject::~QObject()
         // invalidate all connections on the object and make sure
         // activate() will skip them
         cd->currentConnectionId.storeRelaxed(0);
+
+        // no more batched calls may be posted to this object
+        if (cd->batchedCalls)
+            cd->batchedCalls->receiver = nullptr;
     }
     if (cd && !cd->ref.deref())
         delete cd;
@@ -1091,6 +1438,13 @@ QObject::~QObject()
 
     if (d->parent)        // remove it from parent object
         d->setParent_helper(nullptr);
+
+    if (QObjectArena *arena = d->arena) {
+        // destroy the private in place, its memory goes away with the arena
+        QObjectData *data = d_ptr.take();
+        data->~QObjectData();
+        arena->release();
+    }
 }
 
 QObjectPrivate::Connection::~Connection()
@@ -1232,8 +1586,7 @@ QString QObject::objectName() const
 void QObject::setObjectName(const QString &name)
 {
     Q_D(QObject);
-    if (!d->extraData)
-        d->extraData = new QObjectPrivate::ExtraData;
+    d->ensureExtraData();
 
     if (d->extraData->objectName != name) {
         d->extraData->objectName = name;
@@ -1580,9 +1933,16 @@ void QObject::moveToThread(QThread *targetThread)
     // keep currentData alive (since we've got it locked)
     currentData->ref();
 
+    // close the lock-free path of QCoreApplication::postEvent() while the
+    // objects move, so that every event posted so far is in the list and
+    // moves along with its receiver
+    currentData->postEventList.closeIncoming();
+    currentData->mergeIncomingPostedEvents();
+
     // move the object
     d_func()->setThreadData_helper(currentData, targetData);
 
+    currentData->postEventList.reopenIncoming();
     locker.unlock();
 
     // now currentData can commit suicide if it wants to
@@ -1735,8 +2095,7 @@ int QObject::startTimer(int interval, Qt::TimerType timerType)
         return 0;
     }
     int timerId = thisThreadData->eventDispatcher.loadRelaxed()->registerTimer(interval, timerType, this);
-    if (!d->extraData)
-        d->extraData = new QObjectPrivate::ExtraData;
+    d->ensureExtraData();
     d->extraData->runningTimers.append(timerId);
     return timerId;
 }
@@ -2223,8 +2582,7 @@ void QObject::installEventFilter(QObject *obj)
         return;
     }
 
-    if (!d->extraData)
-        d->extraData = new QObjectPrivate::ExtraData;
+    d->ensureExtraData();
 
     // clean up unused items in the list
     d->extraData->eventFilters.removeAll((QObject*)nullptr);
@@ -2881,7 +3239,7 @@ QMetaObject::Connection QObject::connect(const QObject *sender, const char *sign
     }
 
     int *types = nullptr;
-    if ((type == Qt::QueuedConnection)
+    if (((type & ~Qt::BatchedConnection) == Qt::QueuedConnection)
             && !(types = queuedConnectionTypes(signalTypes.constData(), signalTypes.size()))) {
         return QMetaObject::Connection(nullptr);
     }
@@ -2962,7 +3320,7 @@ QMetaObject::Connection QObject::connect(const QObject *sender, const QMetaMetho
     }
 
     int *types = nullptr;
-    if ((type == Qt::QueuedConnection)
+    if (((type & ~Qt::BatchedConnection) == Qt::QueuedConnection)
             && !(types = queuedConnectionTypes(signal.parameterTypes())))
         return QMetaObject::Connection(nullptr);
 
@@ -3416,7 +3774,7 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
                 c2 = c2->nextConnectionList.loadRelaxed();
             }
         }
-        type &= Qt::UniqueConnection - 1;
+        type &= ~Qt::UniqueConnection;
     }
 
     std::unique_ptr<QObjectPrivate::Connection> c{new QObjectPrivate::Connection};
@@ -3428,7 +3786,8 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     c->receiverThreadData.storeRelaxed(td);
     c->method_relative = method_index;
     c->method_offset = method_offset;
-    c->connectionType = type;
+    c->connectionType = type & ~Qt::BatchedConnection;
+    c->isBatched = (type & Qt::BatchedConnection) != 0;
     c->isSlotObject = false;
     c->argumentTypes.storeRelaxed(types);
     c->callFunction = callFunction;
@@ -3702,7 +4061,7 @@ void QMetaObject::connectSlotsByName(QObject *o)
 
     \a signal must be in the signal index range (see QObjectPrivate::signalIndex()).
 */
-static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connection *c, void **argv)
+static const int *queuedArgumentTypes(QObject *sender, int signal, QObjectPrivate::Connection *c)
 {
     const int *argumentTypes = c->argumentTypes.loadRelaxed();
     if (!argumentTypes) {
@@ -3717,6 +4076,19 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
         }
     }
     if (argumentTypes == &DIRECT_CONNECTION_ONLY) // cannot activate
+        return nullptr;
+    return argumentTypes;
+}
+
+/*!
+    \internal
+
+    \a signal must be in the signal index range (see QObjectPrivate::signalIndex()).
+*/
+static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connection *c, void **argv)
+{
+    const int *argumentTypes = queuedArgumentTypes(sender, signal, c);
+    if (!argumentTypes)
         return;
     int nargs = 1; // include return type
     while (argumentTypes[nargs-1])
@@ -3762,6 +4134,62 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
     QCoreApplication::postEvent(c->receiver.loadRelaxed(), ev);
 }
 
+/*!
+    \internal
+
+    Queues the call for a Qt::BatchedConnection \a c in its receiver's
+    BatchedCallQueue. Only the first call of a batch posts an event.
+
+    \a signal must be in the signal index range (see QObjectPrivate::signalIndex()).
+*/
+static void batched_activate(QObject *sender, int signal, QObjectPrivate::Connection *c, void **argv)
+{
+    const int *argumentTypes = queuedArgumentTypes(sender, signal, c);
+    if (!argumentTypes)
+        return;
+    int nargs = 1; // include return type
+    while (argumentTypes[nargs-1])
+        ++nargs;
+
+    QBasicMutexLocker locker(signalSlotLock(c->receiver.loadRelaxed()));
+    QObject *receiver = c->receiver.loadRelaxed();
+    if (!receiver) {
+        // the connection has been disconnected before we got the lock
+        return;
+    }
+    QObjectPrivate::ConnectionData *cd = QObjectPrivate::get(receiver)->connections.loadRelaxed();
+    if (!cd->batchedCalls)
+        cd->batchedCalls = new QObjectPrivate::BatchedCallQueue(receiver);
+    QObjectPrivate::BatchedCallQueue *queue = cd->batchedCalls;
+    queue->ref.ref();
+
+    QObjectPrivate::BatchedCall call;
+    call.slotObj = nullptr;
+    call.callFunction = nullptr;
+    if (c->isSlotObject) {
+        call.slotObj = c->slotObj;
+        call.slotObj->ref();
+    } else {
+        call.callFunction = c->callFunction;
+    }
+    call.sender = sender;
+    call.signalId = signal;
+    call.method_offset = c->method_offset;
+    call.method_relative = c->method_relative;
+    locker.unlock();
+
+    if (queue->append(call, argumentTypes, nargs, argv)) {
+        locker.relock();
+        // the receiver may have been destroyed while we were unlocked, in
+        // which case the call goes away with the queue
+        if (queue->receiver) {
+            QCoreApplication::postEvent(queue->receiver, new QBatchedMetaCallEvent(queue));
+            return;
+        }
+    }
+    queue->deref();
+}
+
 template <bool callbacks_enabled>
 void doActivate(QObject *sender, int signal_index, void **argv)
 {
@@ -3843,7 +4271,10 @@ void doActivate(QObject *sender, int signal_index, void **argv)
             // put into the event queue
             if ((c->connectionType == Qt::AutoConnection && !receiverInSameThread)
                 || (c->connectionType == Qt::QueuedConnection)) {
-                queued_activate(sender, signal_index, c, argv);
+                if (c->isBatched)
+                    batched_activate(sender, signal_index, c, argv);
+                else
+                    queued_activate(sender, signal_index, c, argv);
                 continue;
 #if QT_CONFIG(thread)
             } else if (c->connectionType == Qt::BlockingQueuedConnection) {
@@ -4034,8 +4465,7 @@ bool QObject::setProperty(const char *name, const QVariant &value)
 
     int id = meta->indexOfProperty(name);
     if (id < 0) {
-        if (!d->extraData)
-            d->extraData = new QObjectPrivate::ExtraData;
+        d->ensureExtraData();
 
         const int idx = d->extraData->propertyNames.indexOf(name);
 
@@ -4306,8 +4736,7 @@ QObjectUserData::~QObjectUserData()
 void QObject::setUserData(uint id, QObjectUserData* data)
 {
     Q_D(QObject);
-    if (!d->extraData)
-        d->extraData = new QObjectPrivate::ExtraData;
+    d->ensureExtraData();
 
     if (d->extraData->userData.size() <= (int) id)
         d->extraData->userData.resize((int) id + 1);
@@ -5055,7 +5484,8 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
     c->receiverThreadData.storeRelaxed(td);
     c->receiver.storeRelaxed(r);
     c->slotObj = slotObj;
-    c->connectionType = type;
+    c->connectionType = type & ~Qt::BatchedConnection;
+    c->isBatched = (type & Qt::BatchedConnection) != 0;
     c->isSlotObject = true;
     if (types) {
         c->argumentTypes.storeRelaxed(types);
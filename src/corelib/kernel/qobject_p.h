@@ -60,7 +60,9 @@
 #include "QtCore/qlist.h"
 #include "QtCore/qvector.h"
 #include "QtCore/qvariant.h"
+#include "QtCore/qmutex.h"
 #include "QtCore/qreadwritelock.h"
+#include "QtCore/qshareddata.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -105,6 +107,42 @@ struct QAbstractDeclarativeDataImpl : public QAbstractDeclarativeData
     quint32 unused: 31;
 };
 
+class Q_CORE_EXPORT QObjectArena : public QSharedData
+{
+public:
+    class Q_CORE_EXPORT Scope
+    {
+        Q_DISABLE_COPY_MOVE(Scope)
+    public:
+        explicit Scope(QObjectArena *arena);
+        ~Scope();
+
+    private:
+        QObjectArena *previous;
+    };
+
+    QObjectArena();
+    ~QObjectArena();
+
+    static QObjectArena *current();
+
+    void *allocate(size_t size);
+    void release()
+    {
+        if (!ref.deref())
+            delete this;
+    }
+
+private:
+    Q_DISABLE_COPY_MOVE(QObjectArena)
+    enum { ChunkSize = 64 * 1024 };
+
+    QBasicMutex mutex;
+    QVector<char *> chunks;
+    char *chunkEnd = nullptr;
+    char *next = nullptr;
+};
+
 class Q_CORE_EXPORT QObjectPrivate : public QObjectData
 {
     Q_DECLARE_PUBLIC(QObject)
@@ -169,7 +207,8 @@ public:
         ushort connectionType : 3; // 0 == auto, 1 == direct, 2 == queued, 4 == blocking
         ushort isSlotObject : 1;
         ushort ownArgumentTypes : 1;
-        Connection() : ref_(2), ownArgumentTypes(true) {
+        ushort isBatched : 1; // queued calls go through the receiver's BatchedCallQueue
+        Connection() : ref_(2), ownArgumentTypes(true), isBatched(false) {
             //ref_ is 2 for the use in the internal lists, and for the use in QMetaObject::Connection
         }
         ~Connection();
@@ -226,6 +265,68 @@ public:
         int signal;
     };
 
+    /*
+        Queued calls of Qt::BatchedConnection connections to one receiver.
+
+        Emitting threads copy the arguments into the pending batch's chunked
+        storage and only post an event for the first call of a batch; the
+        event then delivers the whole batch. The chunks are recycled for the
+        following batches.
+
+        The receiver member is protected by the receiver's signalSlotLock()
+        and reset when the receiver is destroyed. The pending batch is
+        protected by the mutex. The queue is owned by the receiver's
+        ConnectionData, and by each posted event and emitting thread using
+        it.
+    */
+    struct BatchedCall
+    {
+        QtPrivate::QSlotObjectBase *slotObj;
+        StaticMetaCallFunction callFunction;
+        const QObject *sender;
+        void **args; // followed by the argument types
+        int signalId;
+        int nargs;
+        ushort method_offset;
+        ushort method_relative;
+    };
+
+    struct BatchedCallQueue
+    {
+        enum { ChunkSize = 16384, MaxSpareChunks = 4 };
+
+        struct Batch
+        {
+            QVector<BatchedCall> calls;
+            QVector<char *> chunks;
+            QVector<char *> largeBlocks;
+            int chunkUsed = ChunkSize;
+        };
+
+        QAtomicInt ref;
+        QObject *receiver;
+        QBasicMutex mutex;
+        Batch pending;
+        QVector<char *> spareChunks;
+        bool eventPosted = false;
+
+        explicit BatchedCallQueue(QObject *receiver) : ref(1), receiver(receiver) {}
+        ~BatchedCallQueue();
+        void deref()
+        {
+            if (!ref.deref())
+                delete this;
+        }
+
+        bool append(const BatchedCall &call, const int *argumentTypes, int nargs, void **argv);
+        void deliver(QObject *object);
+        void discardPending();
+
+    private:
+        void *allocate(int size);
+        void release(Batch &batch);
+    };
+
     struct SignalVector : public ConnectionOrSignalVector {
         quintptr allocated;
         // ConnectionList signals[]
@@ -265,9 +366,12 @@ public:
         Connection *senders = nullptr;
         Sender *currentSender = nullptr;   // object currently activating the object
         QAtomicPointer<Connection> orphaned;
+        BatchedCallQueue *batchedCalls = nullptr; // protected by the object's signalSlotLock()
 
         ~ConnectionData()
         {
+            if (batchedCalls)
+                batchedCalls->deref();
             deleteOrphaned(orphaned.loadRelaxed());
             SignalVector *v = signalVector.loadRelaxed();
             if (v)
@@ -320,6 +424,10 @@ public:
 
     QObjectPrivate(int version = QObjectPrivateVersion);
     virtual ~QObjectPrivate();
+    static void *operator new(size_t size);
+    static void *operator new(size_t, void *ptr) noexcept { return ptr; }
+    static void operator delete(void *ptr);
+    static void operator delete(void *, void *) noexcept {}
     void deleteChildren();
 
     inline void checkForIncompatibleLibraryVersion(int version) const;
@@ -374,6 +482,12 @@ public:
         cd->ref.ref();
         connections.storeRelaxed(cd);
     }
+    void ensureExtraData()
+    {
+        if (extraData)
+            return;
+        extraData = arena ? new (arena->allocate(sizeof(ExtraData))) ExtraData : new ExtraData;
+    }
 public:
     ExtraData *extraData;    // extra data set by the user
     // This atomic requires acquire/release semantics in a few places,
@@ -394,6 +508,9 @@ public:
     // these objects are all used to indicate that a QObject was deleted
     // plus QPointer, which keeps a separate list
     QAtomicPointer<QtSharedPointer::ExternalRefCountData> sharedRefcount;
+
+    // last, so that the offsets of the members above stay as they were
+    QObjectArena *arena;     // arena holding this object and its extra data, if any
 };
 
 Q_DECLARE_TYPEINFO(QObjectPrivate::ConnectionList, Q_MOVABLE_TYPE);
@@ -581,6 +698,19 @@ private:
     char prealloc_[3*(sizeof(void*) + sizeof(int))];
 };
 
+class Q_CORE_EXPORT QBatchedMetaCallEvent : public QAbstractMetaCallEvent
+{
+public:
+    explicit QBatchedMetaCallEvent(QObjectPrivate::BatchedCallQueue *queue);
+    ~QBatchedMetaCallEvent() override;
+
+    void placeMetaCall(QObject *object) override;
+
+private:
+    QObjectPrivate::BatchedCallQueue *queue;
+    bool delivered;
+};
+
 class QBoolBlocker
 {
     Q_DISABLE_COPY_MOVE(QBoolBlocker)
@@ -84,6 +84,7 @@ QTimerInfoList::QTimerInfoList()
 #endif
 
     firstTimerInfo = nullptr;
+    insertionCount = 0;
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -175,17 +176,109 @@ void QTimerInfoList::repairTimersIfNeeded()
 #endif
 
 /*
-  insert timer info into list
+  Timers with the same timeout fire in the order they were (re)inserted,
+  which is what the sorted list used to provide.
 */
-void QTimerInfoList::timerInsert(QTimerInfo *ti)
+static inline bool timerLessThan(const QTimerInfo *t1, const QTimerInfo *t2)
+{
+    if (t1->timeout == t2->timeout)
+        return t1->sequence < t2->sequence;
+    return t1->timeout < t2->timeout;
+}
+
+void QTimerInfoList::siftUp(int index)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
+    QTimerInfo *t = at(index);
+    while (index > 0) {
+        const int parent = (index - 1) / 2;
+        QTimerInfo *p = at(parent);
+        if (!timerLessThan(t, p))
             break;
+        (*this)[index] = p;
+        p->heapIndex = index;
+        index = parent;
     }
-    insert(index+1, ti);
+    (*this)[index] = t;
+    t->heapIndex = index;
+}
+
+void QTimerInfoList::siftDown(int index)
+{
+    QTimerInfo *t = at(index);
+    const int n = size();
+    for (;;) {
+        int child = 2 * index + 1;
+        if (child >= n)
+            break;
+        if (child + 1 < n && timerLessThan(at(child + 1), at(child)))
+            ++child;
+        QTimerInfo *c = at(child);
+        if (!timerLessThan(c, t))
+            break;
+        (*this)[index] = c;
+        c->heapIndex = index;
+        index = child;
+    }
+    (*this)[index] = t;
+    t->heapIndex = index;
+}
+
+/*
+  insert timer info into list
+*/
+void QTimerInfoList::timerInsert(QTimerInfo *ti)
+{
+    ti->sequence = insertionCount++;
+    append(ti);
+    siftUp(size() - 1);
+}
+
+/*
+  remove timer info from list, without deleting it
+*/
+void QTimerInfoList::timerRemove(QTimerInfo *ti)
+{
+    const int index = ti->heapIndex;
+    Q_ASSERT(at(index) == ti);
+    QTimerInfo *last = takeLast();
+    if (last == ti)
+        return;
+    (*this)[index] = last;
+    last->heapIndex = index;
+    if (index > 0 && timerLessThan(last, at((index - 1) / 2)))
+        siftUp(index);
+    else
+        siftDown(index);
+}
+
+/*
+  Returns the number of timers in the subtree at \a index that have
+  expired at currentTime. Only the expired part of the heap is visited.
+*/
+int QTimerInfoList::countExpired(int index) const
+{
+    if (index >= size() || currentTime < at(index)->timeout)
+        return 0;
+    return 1 + countExpired(2 * index + 1) + countExpired(2 * index + 2);
+}
+
+/*
+  Returns the earliest timer in the subtree at \a index that is not
+  currently being activated. Only timers being activated (a handful at
+  most, when activateTimers() recurses) cause a descent.
+*/
+QTimerInfo *QTimerInfoList::firstWaitingTimer(int index) const
+{
+    if (index >= size())
+        return nullptr;
+    QTimerInfo *t = at(index);
+    if (!t->activateRef)
+        return t;
+    QTimerInfo *left = firstWaitingTimer(2 * index + 1);
+    QTimerInfo *right = firstWaitingTimer(2 * index + 2);
+    if (!left || (right && timerLessThan(right, left)))
+        return right;
+    return left;
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -389,14 +482,7 @@ bool QTimerInfoList::timerWait(timespec &tm)
     repairTimersIfNeeded();
 
     // Find first waiting timer not already active
-    QTimerInfo *t = nullptr;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
-        }
-    }
-
+    QTimerInfo *t = firstWaitingTimer(0);
     if (!t)
       return false;
 
@@ -423,16 +509,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (const QTimerInfo *t = timersById.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -494,6 +577,7 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
     }
 
     timerInsert(t);
+    timersById.insert(timerId, t);
 
 #ifdef QTIMERINFO_DEBUG
     t->expected = expected;
@@ -508,41 +592,50 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
     // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = nullptr;
-            if (t->activateRef)
-                *(t->activateRef) = nullptr;
-            delete t;
-            return true;
-        }
-    }
-    // id not found
-    return false;
+    QTimerInfo *t = timersById.take(timerId);
+    if (!t)
+        return false; // id not found
+
+    timerRemove(t);
+    if (t == firstTimerInfo)
+        firstTimerInfo = nullptr;
+    if (t->activateRef)
+        *(t->activateRef) = nullptr;
+    delete t;
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
+
+    // compact the remaining timers in place and rebuild the heap afterwards,
+    // rather than paying for a sift on every removal
+    int kept = 0;
+    bool removed = false;
     for (int i = 0; i < count(); ++i) {
         QTimerInfo *t = at(i);
         if (t->obj == object) {
             // object found
-            removeAt(i);
+            timersById.remove(t->id);
             if (t == firstTimerInfo)
                 firstTimerInfo = nullptr;
             if (t->activateRef)
                 *(t->activateRef) = nullptr;
             delete t;
-            // move back one so that we don't skip the new current item
-            --i;
+            removed = true;
+        } else {
+            (*this)[kept++] = t;
         }
     }
+    if (removed) {
+        erase(begin() + kept, end());
+        for (int i = 0; i < kept; ++i)
+            at(i)->heapIndex = i;
+        for (int i = kept / 2 - 1; i >= 0; --i)
+            siftDown(i);
+    }
     return true;
 }
 
@@ -579,11 +672,7 @@ int QTimerInfoList::activateTimers()
 
 
     // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
-            break;
-        maxCount++;
-    }
+    maxCount = countExpired(0);
 
     //fire the timers.
     while (maxCount--) {
@@ -604,9 +693,6 @@ int QTimerInfoList::activateTimers()
             firstTimerInfo = currentTimerInfo;
         }
 
-        // remove from list
-        removeFirst();
-
 #ifdef QTIMERINFO_DEBUG
         float diff;
         if (currentTime < currentTimerInfo->expected) {
@@ -630,8 +716,9 @@ int QTimerInfoList::activateTimers()
         // determine next timeout time
         calculateNextTimeout(currentTimerInfo, currentTime);
 
-        // reinsert timer
-        timerInsert(currentTimerInfo);
+        // move the timer back into place; it is still at the top of the heap
+        currentTimerInfo->sequence = insertionCount++;
+        siftDown(0);
         if (currentTimerInfo->interval > 0)
             n_act++;
 
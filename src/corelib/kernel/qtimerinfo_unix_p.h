@@ -56,6 +56,7 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -69,6 +70,8 @@ struct QTimerInfo {
     timespec timeout;  // - when to actually fire
     QObject *obj;     // - object to receive event
     QTimerInfo **activateRef; // - ref from activateTimers
+    quint64 sequence; // - insertion order among equal timeouts
+    int heapIndex;    // - position in QTimerInfoList
 
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
@@ -77,6 +80,8 @@ struct QTimerInfo {
 #endif
 };
 
+// The list is kept as a binary min-heap ordered by timeout, so first()
+// is always the next timer to fire but the rest is not sorted.
 class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
 {
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)) || defined(QT_BOOTSTRAPPED)
@@ -92,6 +97,15 @@ class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
     // state variables used by activateTimers()
     QTimerInfo *firstTimerInfo;
 
+    QHash<int, QTimerInfo *> timersById;
+    quint64 insertionCount;
+
+    void timerRemove(QTimerInfo *);
+    void siftUp(int index);
+    void siftDown(int index);
+    int countExpired(int index) const;
+    QTimerInfo *firstWaitingTimer(int index) const;
+
 public:
     QTimerInfoList();
 
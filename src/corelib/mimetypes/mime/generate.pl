@@ -29,6 +29,7 @@
 use strict;
 use warnings;
 use Config;
+use Encode qw(encode_utf8);
 local $/;               # Enable "slurp" mode
 
 sub checkCommand($) {
@@ -40,6 +41,325 @@ sub checkCommand($) {
     return 0;
 }
 
+# Minimal reader for the shared-mime-info XML format: collects what
+# update-mime-database would put into mime.cache.
+sub decodeEntities($) {
+    my $s = $_[0];
+    $s =~ s/&#x([0-9a-fA-F]+);/chr(hex($1))/ge;
+    $s =~ s/&#([0-9]+);/chr($1)/ge;
+    $s =~ s/&lt;/</g;
+    $s =~ s/&gt;/>/g;
+    $s =~ s/&quot;/"/g;
+    $s =~ s/&apos;/'/g;
+    $s =~ s/&amp;/&/g;
+    return $s;
+}
+
+sub parseAttributes($) {
+    my ($s, %attrs) = ($_[0]);
+    while ($s =~ /([\w:-]+)\s*=\s*(?:"([^"]*)"|'([^']*)')/g) {
+        $attrs{$1} = decodeEntities(defined($2) ? $2 : $3);
+    }
+    return \%attrs;
+}
+
+sub parseNumber($) {
+    my $s = $_[0];
+    return hex($s) if $s =~ /^0[xX]/;
+    return oct($s) if $s =~ /^0/;
+    return $s + 0;
+}
+
+# Same escapes as makePattern() in qmimemagicrule.cpp
+sub unescapeMagicString($) {
+    my $s = encode_utf8($_[0]);
+    $s =~ s/\\(?:x([0-9a-fA-F]{1,2})|([0-7]{1,3})|(.))/
+        defined($1) ? chr(hex($1)) :
+        defined($2) ? chr(oct($2) & 0xff) :
+        $3 eq 'n' ? "\n" : $3 eq 'r' ? "\r" : $3 eq 't' ? "\t" : $3/gse;
+    return $s;
+}
+
+sub magicNumber($$$) {
+    my ($value, $size, $bigEndian) = @_;
+    my $number = parseNumber($value);
+    my $bytes = '';
+    for my $b (0 .. $size - 1) {
+        my $shift = ($bigEndian ? $size - $b - 1 : $b) * 8;
+        $bytes .= chr(($number >> $shift) & 0xff);
+    }
+    return $bytes;
+}
+
+sub parseMatchlet($) {
+    my $attrs = $_[0];
+    my ($start, $end) = split /:/, $attrs->{offset};
+    $end = $start unless defined($end);
+    my $type = $attrs->{type};
+    my $mask = $attrs->{mask};
+    my %m = (rangeStart => $start + 0, rangeLength => $end - $start + 1, wordSize => 1, children => []);
+    if ($type eq 'string') {
+        $m{value} = unescapeMagicString($attrs->{value});
+        if (defined($mask)) {
+            $mask =~ s/^0[xX]//;
+            $m{mask} = pack('H*', $mask);
+        }
+    } else {
+        # "host" words are stored big-endian, with the word size telling
+        # the reader to swap them on little-endian machines.
+        my %sizes = (byte => [1, 0], big16 => [2, 1], big32 => [4, 1], little16 => [2, 0],
+                     little32 => [4, 0], host16 => [2, 1], host32 => [4, 1]);
+        my $size = $sizes{$type} or die("Unknown magic type $type");
+        $m{wordSize} = $size->[0] if $type =~ /^host/;
+        $m{value} = magicNumber($attrs->{value}, $size->[0], $size->[1]);
+        $m{mask} = magicNumber($mask, $size->[0], $size->[1]) if defined($mask);
+    }
+    return \%m;
+}
+
+sub readMimeTypes($) {
+    my $fname = $_[0];
+    open my $fh, '<:encoding(UTF-8)', $fname or die("Cannot open $fname: $!");
+    my $xml = <$fh>;
+    close $fh;
+    $xml =~ s/<!--.*?-->//gs;
+    $xml =~ s/<!DOCTYPE.*?\]>//s;
+    $xml =~ s/<\?.*?\?>//gs;
+
+    my (%types, $current, @matchlets);
+    while ($xml =~ m{<(/?)([\w:-]+)((?:\s+[\w:-]+\s*=\s*(?:"[^"]*"|'[^']*'))*)\s*(/?)>}g) {
+        my ($closing, $tag, $attributes, $empty) = ($1, $2, $3, $4);
+        my $attrs = parseAttributes($attributes);
+        if ($closing) {
+            undef $current if $tag eq 'mime-type';
+            pop @matchlets if $tag eq 'match' || $tag eq 'magic';
+            next;
+        }
+        if ($tag eq 'mime-type') {
+            my $name = $attrs->{type};
+            $current = $types{$name} ||= { name => $name, globs => [], parents => [], magic => [] };
+        } elsif (!$current) {
+            next;
+        } elsif ($tag eq 'glob') {
+            my $caseSensitive = ($attrs->{'case-sensitive'} || '') eq 'true';
+            my $weight = defined($attrs->{weight}) ? $attrs->{weight} : 50;
+            my $pattern = $attrs->{pattern};
+            $pattern = lc($pattern) unless $caseSensitive;
+            push @{$current->{globs}}, [ $pattern, $weight | ($caseSensitive ? 0x100 : 0) ]
+                unless grep { $_->[0] eq $pattern } @{$current->{globs}};
+        } elsif ($tag eq 'alias') {
+            push @{$current->{aliases}}, $attrs->{type};
+        } elsif ($tag eq 'sub-class-of') {
+            push @{$current->{parents}}, $attrs->{type};
+        } elsif ($tag eq 'icon') {
+            $current->{icon} = $attrs->{name};
+        } elsif ($tag eq 'generic-icon') {
+            $current->{genericIcon} = $attrs->{name};
+        } elsif ($tag eq 'root-XML') {
+            push @{$current->{namespaces}}, [ $attrs->{namespaceURI}, $attrs->{localName} ];
+        } elsif ($tag eq 'magic') {
+            my $priority = defined($attrs->{priority}) ? $attrs->{priority} : 50;
+            my $magic = { priority => $priority, matchlets => [] };
+            push @{$current->{magic}}, $magic;
+            push @matchlets, $magic->{matchlets} unless $empty;
+        } elsif ($tag eq 'match' && @matchlets) {
+            my $m = parseMatchlet($attrs);
+            push @{$matchlets[-1]}, $m;
+            push @matchlets, $m->{children} unless $empty;
+        }
+    }
+    return \%types;
+}
+
+# Writes the types in the binary format of mime.cache (version 1.2, see
+# the shared-mime-info specification), followed by the sorted list of all
+# MIME type names, which mime.cache keeps in a separate "types" file.
+# Returns the cache and the offset of that list.
+sub buildCache($) {
+    my %types = %{$_[0]};
+    my @names = sort keys %types;
+    my $cache = "\0" x 44;
+    my %strings;
+
+    my $align = sub { $cache .= "\0" x (-length($cache) & 3); };
+    my $string = sub {
+        my $s = encode_utf8($_[0]);
+        return $strings{$s} if exists $strings{$s};
+        &$align;
+        $strings{$s} = length($cache);
+        $cache .= $s . "\0";
+        return $strings{$s};
+    };
+    my $bytes = sub {
+        &$align;
+        my $offset = length($cache);
+        $cache .= $_[0];
+        return $offset;
+    };
+    my $reserve = sub {
+        &$align;
+        my $offset = length($cache);
+        $cache .= "\0" x $_[0];
+        return $offset;
+    };
+    my $put = sub {
+        my $offset = shift;
+        substr($cache, $offset, 4 * @_) = pack('N*', @_);
+    };
+    my $header = sub { &$put(4 * $_[0], $_[1]); };
+    &$string($_) for @names;
+
+    # Aliases, sorted by alias
+    my %aliases;
+    for my $t (values %types) {
+        $aliases{$_} = $t->{name} for @{$t->{aliases} || []};
+    }
+    my @aliases = sort keys %aliases;
+    my $list = &$reserve(4 + 8 * @aliases);
+    &$header(1, $list);
+    &$put($list, scalar @aliases);
+    for my $i (0 .. $#aliases) {
+        &$put($list + 4 + 8 * $i, &$string($aliases[$i]), &$string($aliases{$aliases[$i]}));
+    }
+
+    # Parents, sorted by MIME type
+    my @children = grep { @{$types{$_}{parents}} } @names;
+    $list = &$reserve(4 + 8 * @children);
+    &$header(2, $list);
+    &$put($list, scalar @children);
+    for my $i (0 .. $#children) {
+        my @parents = @{$types{$children[$i]}{parents}};
+        my $parents = &$reserve(4 + 4 * @parents);
+        &$put($parents, scalar @parents, map { &$string($_) } @parents);
+        &$put($list + 4 + 8 * $i, &$string($children[$i]), $parents);
+    }
+
+    # Globs: literals, simple "*suffix" patterns in a reversed suffix tree,
+    # and everything else
+    my (@literals, @globs, %tree);
+    for my $name (@names) {
+        for my $glob (@{$types{$name}{globs}}) {
+            my ($pattern, $flags) = @$glob;
+            if ($pattern !~ /[*?\[]/) {
+                push @literals, [ $pattern, $name, $flags ];
+            } elsif ($pattern =~ /^\*([^*?\[]+)$/) {
+                my $node = \%tree;
+                $node = $node->{$_} ||= {} for reverse split //, $1;
+                push @{$node->{''}}, [ $name, $flags ];
+            } else {
+                push @globs, [ $pattern, $name, $flags ];
+            }
+        }
+    }
+    for my $entries ([ 3, \@literals ], [ 5, \@globs ]) {
+        my @sorted = sort { $a->[0] cmp $b->[0] || $a->[1] cmp $b->[1] } @{$entries->[1]};
+        $list = &$reserve(4 + 12 * @sorted);
+        &$header($entries->[0], $list);
+        &$put($list, scalar @sorted);
+        for my $i (0 .. $#sorted) {
+            my ($pattern, $name, $flags) = @{$sorted[$i]};
+            &$put($list + 4 + 12 * $i, &$string($pattern), &$string($name), $flags);
+        }
+    }
+
+    # Each level of the tree is an array of nodes sorted by character;
+    # leaves (character 0) come first.
+    my $writeNodes;
+    $writeNodes = sub {
+        my $node = $_[0];
+        my @leaves = sort { $a->[0] cmp $b->[0] } @{$node->{''} || []};
+        my @chars = sort { ord($a) <=> ord($b) } grep { $_ ne '' } keys %$node;
+        my $count = @leaves + @chars;
+        my $offset = &$reserve(12 * $count);
+        my $i = 0;
+        &$put($offset + 12 * $i++, 0, &$string($_->[0]), $_->[1]) for @leaves;
+        for my $char (@chars) {
+            my ($childCount, $childOffset) = &$writeNodes($node->{$char});
+            &$put($offset + 12 * $i++, ord($char), $childCount, $childOffset);
+        }
+        return ($count, $offset);
+    };
+    $list = &$reserve(8);
+    &$header(4, $list);
+    &$put($list, &$writeNodes(\%tree));
+
+    # Magic, sorted by descending priority
+    my @matches;
+    for my $name (@names) {
+        push @matches, [ $_->{priority}, $name, $_->{matchlets} ] for @{$types{$name}{magic}};
+    }
+    @matches = sort { $b->[0] <=> $a->[0] || $a->[1] cmp $b->[1] } @matches;
+    my $maxExtent = 0;
+    my $writeMatchlets;
+    $writeMatchlets = sub {
+        my @matchlets = @{$_[0]};
+        my $offset = &$reserve(32 * @matchlets);
+        for my $i (0 .. $#matchlets) {
+            my $m = $matchlets[$i];
+            my $extent = $m->{rangeStart} + $m->{rangeLength} + length($m->{value});
+            $maxExtent = $extent if $extent > $maxExtent;
+            my $value = &$bytes($m->{value});
+            my $mask = defined($m->{mask}) ? &$bytes($m->{mask}) : 0;
+            my ($childCount, $childOffset) = @{$m->{children}} ? &$writeMatchlets($m->{children}) : (0, 0);
+            &$put($offset + 32 * $i, $m->{rangeStart}, $m->{rangeLength}, $m->{wordSize},
+                  length($m->{value}), $value, $mask, $childCount, $childOffset);
+        }
+        return (scalar @matchlets, $offset);
+    };
+    $list = &$reserve(12 + 16 * @matches);
+    &$header(6, $list);
+    for my $i (0 .. $#matches) {
+        my ($priority, $name, $matchlets) = @{$matches[$i]};
+        &$put($list + 12 + 16 * $i, $priority, &$string($name), &$writeMatchlets($matchlets));
+    }
+    &$put($list, scalar @matches, $maxExtent, $list + 12);
+
+    # XML namespaces, sorted by URI and local name
+    my @namespaces;
+    for my $name (@names) {
+        push @namespaces, [ @$_, $name ] for @{$types{$name}{namespaces} || []};
+    }
+    @namespaces = sort { $a->[0] cmp $b->[0] || $a->[1] cmp $b->[1] } @namespaces;
+    $list = &$reserve(4 + 12 * @namespaces);
+    &$header(7, $list);
+    &$put($list, scalar @namespaces);
+    for my $i (0 .. $#namespaces) {
+        &$put($list + 4 + 12 * $i, map { &$string($_) } @{$namespaces[$i]});
+    }
+
+    # Icons and generic icons, sorted by MIME type
+    for my $icons ([ 8, 'icon' ], [ 9, 'genericIcon' ]) {
+        my @withIcon = grep { defined($types{$_}{$icons->[1]}) } @names;
+        $list = &$reserve(4 + 8 * @withIcon);
+        &$header($icons->[0], $list);
+        &$put($list, scalar @withIcon);
+        for my $i (0 .. $#withIcon) {
+            &$put($list + 4 + 8 * $i, &$string($withIcon[$i]), &$string($types{$withIcon[$i]}{$icons->[1]}));
+        }
+    }
+
+    # Tree magic is not supported by Qt; write an empty list
+    $list = &$reserve(8);
+    &$header(10, $list);
+
+    $list = &$reserve(4 + 4 * @names);
+    &$put($list, scalar @names, map { &$string($_) } @names);
+
+    substr($cache, 0, 4) = pack('nn', 1, 2);
+    return ($cache, $list);
+}
+
+sub printArray($$) {
+    my ($name, $data) = @_;
+    printf "static const unsigned char %s[] = {", $name;
+    my $i = 0;
+    map {
+        printf "\n  " if $i++ % 12 == 0;
+        printf "0x%02x, ", ord $_
+    } split //, $data;
+    printf "\n};\n";
+}
+
 my $data;
 my $compress;
 my $macro;
@@ -100,14 +420,13 @@ if (!$compress && $zlib) {
     };
 }
 
-# Now print as hex
+# Now print as hex. The binary cache goes first: qmimeprovider.cpp places
+# the first array in its own page-aligned section.
+my ($cache, $typeListOffset) = buildCache(readMimeTypes($fname));
 printf "#define %s\n", $macro if $macro;
-printf "static const unsigned char mimetype_database[] = {";
-my $i = 0;
-map {
-    printf "\n  " if $i++ % 12 == 0;
-    printf "0x%02x, ", ord $_
-} split //, $data;
-printf "\n};\n";
+printf "#define MIME_DATABASE_HAS_CACHE\n";
+printArray("mimetype_database_cache", $cache);
+printf "static constexpr size_t MimeTypeDatabaseCacheTypeListOffset = %d;\n", $typeListOffset;
+printArray("mimetype_database", $data);
 printf "static constexpr size_t MimeTypeDatabaseOriginalSize = %d;\n",
     (stat $fname)[7];
@@ -68,8 +68,10 @@ QMimeDatabasePrivate *QMimeDatabasePrivate::instance()
 }
 
 QMimeDatabasePrivate::QMimeDatabasePrivate()
-    : m_defaultMimeType(QLatin1String("application/octet-stream"))
+    : m_lastCheck(-1),
+      m_defaultMimeType(QLatin1String("application/octet-stream"))
 {
+    m_clock.start();
 }
 
 QMimeDatabasePrivate::~QMimeDatabasePrivate()
@@ -83,12 +85,10 @@ static const
 #endif
 int qmime_secondsBetweenChecks = 5;
 
-bool QMimeDatabasePrivate::shouldCheck()
+bool QMimeDatabasePrivate::shouldCheck() const
 {
-    if (m_lastCheck.isValid() && m_lastCheck.elapsed() < qmime_secondsBetweenChecks * 1000)
-        return false;
-    m_lastCheck.start();
-    return true;
+    const qint64 lastCheck = m_lastCheck.loadAcquire();
+    return lastCheck < 0 || m_clock.elapsed() - lastCheck >= qmime_secondsBetweenChecks * 1000;
 }
 
 #if defined(Q_OS_UNIX) && !defined(Q_OS_INTEGRITY)
@@ -155,26 +155,30 @@ void QMimeDatabasePrivate::loadProviders()
         };
         const auto it = std::find_if(currentProviders.begin(), currentProviders.end(), isInternal);
         if (it == currentProviders.end()) {
-            m_providers.push_back(Providers::value_type(new QMimeXMLProvider(this, QMimeXMLProvider::InternalDatabase)));
+            // Prefer the cache generated at build time, if any, to parsing the XML
+            std::unique_ptr<QMimeProviderBase> provider;
+            if (qEnvironmentVariableIsEmpty("QT_NO_MIME_CACHE"))
+                provider.reset(new QMimeBinaryProvider(this, QMimeProviderBase::InternalDatabase));
+            if (!provider || !provider->isValid())
+                provider.reset(new QMimeXMLProvider(this, QMimeProviderBase::InternalDatabase));
+            m_providers.push_back(std::move(provider));
         } else {
             m_providers.push_back(std::move(*it));
         }
     }
 }
 
-const QMimeDatabasePrivate::Providers &QMimeDatabasePrivate::providers()
+QReadWriteLock *QMimeDatabasePrivate::providersLock()
 {
-#ifndef Q_OS_WASM // stub implementation always returns true
-    Q_ASSERT(!mutex.tryLock()); // caller should have locked mutex
-#endif
-    if (m_providers.empty()) {
-        loadProviders();
-        m_lastCheck.start();
-    } else {
-        if (shouldCheck())
+    if (shouldCheck()) {
+        QWriteLocker locker(&m_lock);
+        // another thread may have reloaded them while we waited for the lock
+        if (shouldCheck()) {
             loadProviders();
+            m_lastCheck.storeRelease(m_clock.elapsed());
+        }
     }
-    return m_providers;
+    return &m_lock;
 }
 
 QString QMimeDatabasePrivate::resolveAlias(const QString &nameOrAlias)
@@ -224,18 +228,23 @@ QMimeGlobMatchResult QMimeDatabasePrivate::findByFileName(const QString &fileNam
 
 void QMimeDatabasePrivate::loadMimeTypePrivate(QMimeTypePrivate &mimePrivate)
 {
-    QMutexLocker locker(&mutex);
+    QWriteLocker locker(providersLock());
     if (mimePrivate.name.isEmpty())
         return; // invalid mimetype
     if (!mimePrivate.loaded) { // XML provider sets loaded=true, binary provider does this on demand
         Q_ASSERT(mimePrivate.fromCache);
-        QMimeBinaryProvider::loadMimeTypePrivate(mimePrivate);
+        for (const auto &provider : providers()) {
+            provider->loadMimeTypePrivate(mimePrivate);
+            if (mimePrivate.loaded)
+                return;
+        }
+        mimePrivate.loaded = true;
     }
 }
 
 void QMimeDatabasePrivate::loadGenericIcon(QMimeTypePrivate &mimePrivate)
 {
-    QMutexLocker locker(&mutex);
+    QWriteLocker locker(providersLock());
     if (mimePrivate.fromCache) {
         mimePrivate.genericIconName.clear();
         for (const auto &provider : providers()) {
@@ -248,7 +257,7 @@ void QMimeDatabasePrivate::loadGenericIcon(QMimeTypePrivate &mimePrivate)
 
 void QMimeDatabasePrivate::loadIcon(QMimeTypePrivate &mimePrivate)
 {
-    QMutexLocker locker(&mutex);
+    QWriteLocker locker(providersLock());
     if (mimePrivate.fromCache) {
         mimePrivate.iconName.clear();
         for (const auto &provider : providers()) {
@@ -277,13 +286,12 @@ static QString fallbackParent(const QString &mimeTypeName)
 
 QStringList QMimeDatabasePrivate::mimeParents(const QString &mimeName)
 {
-    QMutexLocker locker(&mutex);
+    QReadLocker locker(providersLock());
     return parents(mimeName);
 }
 
 QStringList QMimeDatabasePrivate::parents(const QString &mimeName)
 {
-    Q_ASSERT(!mutex.tryLock());
     QStringList result;
     for (const auto &provider : providers())
         provider->addParents(mimeName, result);
@@ -297,7 +305,7 @@ QStringList QMimeDatabasePrivate::parents(const QString &mimeName)
 
 QStringList QMimeDatabasePrivate::listAliases(const QString &mimeName)
 {
-    QMutexLocker locker(&mutex);
+    QReadLocker locker(providersLock());
     QStringList result;
     for (const auto &provider : providers())
         provider->addAliases(mimeName, result);
@@ -306,7 +314,7 @@ QStringList QMimeDatabasePrivate::listAliases(const QString &mimeName)
 
 bool QMimeDatabasePrivate::mimeInherits(const QString &mime, const QString &parent)
 {
-    QMutexLocker locker(&mutex);
+    QReadLocker locker(providersLock());
     return inherits(mime, parent);
 }
 
@@ -514,7 +522,7 @@ QMimeDatabase::~QMimeDatabase()
  */
 QMimeType QMimeDatabase::mimeTypeForName(const QString &nameOrAlias) const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(d->providersLock());
 
     return d->mimeTypeForName(nameOrAlias);
 }
@@ -549,7 +557,7 @@ QMimeType QMimeDatabase::mimeTypeForName(const QString &nameOrAlias) const
 */
 QMimeType QMimeDatabase::mimeTypeForFile(const QFileInfo &fileInfo, MatchMode mode) const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(d->providersLock());
 
     if (fileInfo.isDir())
         return d->mimeTypeForName(QLatin1String("inode/directory"));
@@ -602,7 +610,7 @@ QMimeType QMimeDatabase::mimeTypeForFile(const QFileInfo &fileInfo, MatchMode mo
 QMimeType QMimeDatabase::mimeTypeForFile(const QString &fileName, MatchMode mode) const
 {
     if (mode == MatchExtension) {
-        QMutexLocker locker(&d->mutex);
+        QReadLocker locker(d->providersLock());
         const QStringList matches = d->mimeTypeForFileName(fileName);
         const int matchCount = matches.count();
         if (matchCount == 0) {
@@ -614,7 +622,7 @@ QMimeType QMimeDatabase::mimeTypeForFile(const QString &fileName, MatchMode mode
             return d->mimeTypeForName(matches.first());
         }
     } else {
-        // Implemented as a wrapper around mimeTypeForFile(QFileInfo), so no mutex.
+        // Implemented as a wrapper around mimeTypeForFile(QFileInfo), so no lock.
         QFileInfo fileInfo(fileName);
         return mimeTypeForFile(fileInfo, mode);
     }
@@ -634,7 +642,7 @@ QMimeType QMimeDatabase::mimeTypeForFile(const QString &fileName, MatchMode mode
 */
 QList<QMimeType> QMimeDatabase::mimeTypesForFileName(const QString &fileName) const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(d->providersLock());
 
     const QStringList matches = d->mimeTypeForFileName(fileName);
     QList<QMimeType> mimes;
@@ -651,7 +659,7 @@ QList<QMimeType> QMimeDatabase::mimeTypesForFileName(const QString &fileName) co
 */
 QString QMimeDatabase::suffixForFileName(const QString &fileName) const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(d->providersLock());
     const int suffixLength = d->findByFileName(QFileInfo(fileName).fileName()).m_knownSuffixLength;
     return fileName.right(suffixLength);
 }
@@ -665,7 +673,7 @@ QString QMimeDatabase::suffixForFileName(const QString &fileName) const
 */
 QMimeType QMimeDatabase::mimeTypeForData(const QByteArray &data) const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(d->providersLock());
 
     int accuracy = 0;
     return d->findByData(data, &accuracy);
@@ -680,7 +688,7 @@ QMimeType QMimeDatabase::mimeTypeForData(const QByteArray &data) const
 */
 QMimeType QMimeDatabase::mimeTypeForData(QIODevice *device) const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(d->providersLock());
 
     int accuracy = 0;
     const bool openedByUs = !device->isOpen() && device->open(QIODevice::ReadOnly);
@@ -743,7 +751,7 @@ QMimeType QMimeDatabase::mimeTypeForUrl(const QUrl &url) const
 */
 QMimeType QMimeDatabase::mimeTypeForFileNameAndData(const QString &fileName, QIODevice *device) const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(d->providersLock());
     int accuracy = 0;
     const bool openedByUs = !device->isOpen() && device->open(QIODevice::ReadOnly);
     const QMimeType result = d->mimeTypeForFileNameAndData(fileName, device, &accuracy);
@@ -770,7 +778,7 @@ QMimeType QMimeDatabase::mimeTypeForFileNameAndData(const QString &fileName, QIO
 */
 QMimeType QMimeDatabase::mimeTypeForFileNameAndData(const QString &fileName, const QByteArray &data) const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(d->providersLock());
     QBuffer buffer(const_cast<QByteArray *>(&data));
     buffer.open(QIODevice::ReadOnly);
     int accuracy = 0;
@@ -786,7 +794,7 @@ QMimeType QMimeDatabase::mimeTypeForFileNameAndData(const QString &fileName, con
 */
 QList<QMimeType> QMimeDatabase::allMimeTypes() const
 {
-    QMutexLocker locker(&d->mutex);
+    QReadLocker locker(d->providersLock());
 
     return d->allMimeTypes();
 }
@@ -59,8 +59,9 @@ QT_REQUIRE_CONFIG(mimetype);
 #include "qmimetype_p.h"
 #include "qmimeglobpattern_p.h"
 
+#include <QtCore/qatomic.h>
 #include <QtCore/qelapsedtimer.h>
-#include <QtCore/qmutex.h>
+#include <QtCore/qreadwritelock.h>
 #include <QtCore/qvector.h>
 
 #include <memory>
@@ -95,7 +96,7 @@ public:
     QStringList mimeTypeForFileName(const QString &fileName);
     QMimeGlobMatchResult findByFileName(const QString &fileName);
 
-    // API for QMimeType. Takes care of locking the mutex.
+    // API for QMimeType. Takes care of locking.
     void loadMimeTypePrivate(QMimeTypePrivate &mimePrivate);
     void loadGenericIcon(QMimeTypePrivate &mimePrivate);
     void loadIcon(QMimeTypePrivate &mimePrivate);
@@ -103,18 +104,23 @@ public:
     QStringList listAliases(const QString &mimeName);
     bool mimeInherits(const QString &mime, const QString &parent);
 
+    // Lookups hold this lock for reading, so they run concurrently. (Re)loading
+    // the providers and filling in a QMimeTypePrivate hold it for writing.
+    QReadWriteLock *providersLock();
+
 private:
     using Providers = std::vector<std::unique_ptr<QMimeProviderBase>>;
-    const Providers &providers();
-    bool shouldCheck();
+    const Providers &providers() const { return m_providers; }
+    bool shouldCheck() const;
     void loadProviders();
 
-    mutable Providers m_providers;
-    QElapsedTimer m_lastCheck;
+    Providers m_providers;
+    QElapsedTimer m_clock;
+    QAtomicInteger<qint64> m_lastCheck; // msecs on m_clock, -1 if never checked
+    QReadWriteLock m_lock;
 
 public:
     const QString m_defaultMimeType;
-    QMutex mutex;
 };
 
 QT_END_NAMESPACE
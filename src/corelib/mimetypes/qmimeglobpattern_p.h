@@ -60,7 +60,7 @@ QT_REQUIRE_CONFIG(mimetype);
 
 QT_BEGIN_NAMESPACE
 
-struct QMimeGlobMatchResult
+struct Q_AUTOTEST_EXPORT QMimeGlobMatchResult
 {
     void addMatch(const QString &mimeType, int weight, const QString &pattern, int knownSuffixLength = 0);
 
@@ -93,6 +93,22 @@ bool QMimeMagicRule::operator==(const QMimeMagicRule &other) const
            m_matchFunction == other.m_matchFunction;
 }
 
+// Compares a word at a time; the masks are typically as long as the value.
+static inline bool matchMasked(const char *data, const char *value, const char *mask, int length)
+{
+    int i = 0;
+    for ( ; i + int(sizeof(quint64)) <= length; i += int(sizeof(quint64))) {
+        const quint64 difference = qFromUnaligned<quint64>(data + i) ^ qFromUnaligned<quint64>(value + i);
+        if (difference & qFromUnaligned<quint64>(mask + i))
+            return false;
+    }
+    for ( ; i < length; ++i) {
+        if ((data[i] ^ value[i]) & mask[i])
+            return false;
+    }
+    return true;
+}
+
 // Used by both providers
 bool QMimeMagicRule::matchSubstring(const char *dataPtr, int dataSize, int rangeStart, int rangeLength,
                                     int valueLength, const char *valueData, const char *mask)
@@ -101,52 +117,41 @@ bool QMimeMagicRule::matchSubstring(const char *dataPtr, int dataSize, int range
     // Example: value="ABC", rangeLength=3 -> we need 3+3-1=5 bytes (ABCxx,xABCx,xxABC would match)
     const int dataNeeded = qMin(rangeLength + valueLength - 1, dataSize - rangeStart);
 
+    // Example (continued from above):
+    // dataSize is 4, so dataNeeded was max'ed to 4.
+    // maxStartPos = 4 - 3 + 1 = 2, and indeed
+    // we need to check for a match a positions 0 and 1 (ABCx and xABC).
+    const int maxStartPos = dataNeeded - valueLength + 1;
+    if (maxStartPos <= 0)
+        return false;
+    const char *readDataBase = dataPtr + rangeStart;
+
     if (!mask) {
         // callgrind says QByteArray::indexOf is much slower, since our strings are typically too
         // short for be worth Boyer-Moore matching (1 to 71 bytes, 11 bytes on average).
-        bool found = false;
-        for (int i = rangeStart; i < rangeStart + rangeLength; ++i) {
-            if (i + valueLength > dataSize)
-                break;
-
-            if (memcmp(valueData, dataPtr + i, valueLength) == 0) {
-                found = true;
-                break;
-            }
+        // memchr() is vectorized though, so let it find the candidate positions.
+        const char *p = readDataBase;
+        const char *end = readDataBase + maxStartPos;
+        while ((p = static_cast<const char *>(memchr(p, valueData[0], end - p)))) {
+            if (memcmp(p + 1, valueData + 1, valueLength - 1) == 0)
+                return true;
+            ++p;
         }
-        if (!found)
-            return false;
-    } else {
-        bool found = false;
-        const char *readDataBase = dataPtr + rangeStart;
-        // Example (continued from above):
-        // deviceSize is 4, so dataNeeded was max'ed to 4.
-        // maxStartPos = 4 - 3 + 1 = 2, and indeed
-        // we need to check for a match a positions 0 and 1 (ABCx and xABC).
-        const int maxStartPos = dataNeeded - valueLength + 1;
-        for (int i = 0; i < maxStartPos; ++i) {
-            const char *d = readDataBase + i;
-            bool valid = true;
-            for (int idx = 0; idx < valueLength; ++idx) {
-                if (((*d++) & mask[idx]) != (valueData[idx] & mask[idx])) {
-                    valid = false;
-                    break;
-                }
-            }
-            if (valid)
-                found = true;
-        }
-        if (!found)
-            return false;
+        return false;
     }
-    //qDebug() << "Found" << value << "in" << searchedData;
-    return true;
+
+    for (int i = 0; i < maxStartPos; ++i) {
+        if (matchMasked(readDataBase + i, valueData, mask, valueLength))
+            return true;
+    }
+    return false;
 }
 
 bool QMimeMagicRule::matchString(const QByteArray &data) const
 {
     const int rangeLength = m_endPos - m_startPos + 1;
-    return QMimeMagicRule::matchSubstring(data.constData(), data.size(), m_startPos, rangeLength, m_pattern.size(), m_pattern.constData(), m_mask.constData());
+    const char *mask = m_mask.isEmpty() ? nullptr : m_mask.constData();
+    return QMimeMagicRule::matchSubstring(data.constData(), data.size(), m_startPos, rangeLength, m_pattern.size(), m_pattern.constData(), mask);
 }
 
 template <typename T>
@@ -283,10 +288,8 @@ QMimeMagicRule::QMimeMagicRule(const QString &type,
                 return;
             }
             m_mask = tempMask;
-        } else {
-            m_mask.fill(char(-1), m_pattern.size());
+            m_mask.squeeze();
         }
-        m_mask.squeeze();
         m_matchFunction = &QMimeMagicRule::matchString;
         break;
     case Byte:
@@ -330,7 +333,7 @@ QMimeMagicRule::QMimeMagicRule(const QString &type,
 QByteArray QMimeMagicRule::mask() const
 {
     QByteArray result = m_mask;
-    if (m_type == String) {
+    if (m_type == String && !result.isEmpty()) {
         // restore '0x'
         result = "0x" + result.toHex();
     }
@@ -54,6 +54,8 @@
 #include <QDateTime>
 #include <QtEndian>
 
+#include <algorithm>
+
 #if QT_CONFIG(mimetype_database)
 #  if defined(Q_CC_MSVC)
 #    pragma section(".qtmimedatabase", read, shared)
@@ -90,8 +92,15 @@ QMimeProviderBase::QMimeProviderBase(QMimeDatabasePrivate *db, const QString &di
 }
 
 
+#if QT_CONFIG(mimetype_database)
+static QString internalMimeFileName()
+{
+    return QStringLiteral("<internal MIME data>");
+}
+#endif
+
 QMimeBinaryProvider::QMimeBinaryProvider(QMimeDatabasePrivate *db, const QString &directory)
-    : QMimeProviderBase(db, directory), m_mimetypeListLoaded(false)
+    : QMimeProviderBase(db, directory)
 {
     ensureLoaded();
 }
@@ -99,26 +108,28 @@ QMimeBinaryProvider::QMimeBinaryProvider(QMimeDatabasePrivate *db, const QString
 struct QMimeBinaryProvider::CacheFile
 {
     CacheFile(const QString &fileName);
+    explicit CacheFile(const uchar *embeddedData);
     ~CacheFile();
 
     bool isValid() const { return m_valid; }
     inline quint16 getUint16(int offset) const
     {
-        return qFromBigEndian(*reinterpret_cast<quint16 *>(data + offset));
+        return qFromBigEndian<quint16>(data + offset);
     }
     inline quint32 getUint32(int offset) const
     {
-        return qFromBigEndian(*reinterpret_cast<quint32 *>(data + offset));
+        return qFromBigEndian<quint32>(data + offset);
     }
     inline const char *getCharStar(int offset) const
     {
         return reinterpret_cast<const char *>(data + offset);
     }
+    bool checkVersion();
     bool load();
     bool reload();
 
     QFile file;
-    uchar *data;
+    const uchar *data;
     QDateTime m_mtime;
     bool m_valid;
 };
@@ -129,20 +140,31 @@ QMimeBinaryProvider::CacheFile::CacheFile(const QString &fileName)
     load();
 }
 
+QMimeBinaryProvider::CacheFile::CacheFile(const uchar *embeddedData)
+    : data(embeddedData), m_valid(false)
+{
+    checkVersion();
+}
+
 QMimeBinaryProvider::CacheFile::~CacheFile()
 {
 }
 
+bool QMimeBinaryProvider::CacheFile::checkVersion()
+{
+    const int major = getUint16(0);
+    const int minor = getUint16(2);
+    m_valid = (major == 1 && minor >= 1 && minor <= 2);
+    return m_valid;
+}
+
 bool QMimeBinaryProvider::CacheFile::load()
 {
     if (!file.open(QIODevice::ReadOnly))
         return false;
     data = file.map(0, file.size());
-    if (data) {
-        const int major = getUint16(0);
-        const int minor = getUint16(2);
-        m_valid = (major == 1 && minor >= 1 && minor <= 2);
-    }
+    if (data)
+        checkVersion();
     m_mtime = QFileInfo(file).lastModified();
     return m_valid;
 }
@@ -169,7 +191,11 @@ bool QMimeBinaryProvider::isValid()
 
 bool QMimeBinaryProvider::isInternalDatabase() const
 {
+#if QT_CONFIG(mimetype_database)
+    return m_directory == internalMimeFileName();
+#else
     return false;
+#endif
 }
 
 // Position of the "list offsets" values, at the beginning of the mime.cache file
@@ -202,17 +228,17 @@ void QMimeBinaryProvider::ensureLoaded()
     if (!m_cacheFile) {
         const QString cacheFileName = m_directory + QLatin1String("/mime.cache");
         m_cacheFile = new CacheFile(cacheFileName);
-        m_mimetypeListLoaded = false;
     } else {
-        if (checkCacheChanged())
-            m_mimetypeListLoaded = false;
-        else
+        if (!checkCacheChanged())
             return; // nothing to do
     }
     if (!m_cacheFile->isValid()) { // verify existence and version
         delete m_cacheFile;
         m_cacheFile = nullptr;
+        return;
     }
+    // Not done lazily: lookups only read from the provider, concurrently.
+    loadMimeTypeList();
 }
 
 static QMimeType mimeTypeForNameUnchecked(const QString &name)
@@ -229,8 +255,6 @@ static QMimeType mimeTypeForNameUnchecked(const QString &name)
 
 QMimeType QMimeBinaryProvider::mimeTypeForName(const QString &name)
 {
-    if (!m_mimetypeListLoaded)
-        loadMimeTypeList();
     if (!m_mimetypeNames.contains(name))
         return QMimeType(); // unknown mimetype
     return mimeTypeForNameUnchecked(name);
@@ -332,13 +356,30 @@ bool QMimeBinaryProvider::matchMagicRule(QMimeBinaryProvider::CacheFile *cacheFi
         const int off = firstOffset + matchlet * 32;
         const int rangeStart = cacheFile->getUint32(off);
         const int rangeLength = cacheFile->getUint32(off + 4);
-        //const int wordSize = cacheFile->getUint32(off + 8);
+        const int wordSize = cacheFile->getUint32(off + 8);
         const int valueLength = cacheFile->getUint32(off + 12);
         const int valueOffset = cacheFile->getUint32(off + 16);
         const int maskOffset = cacheFile->getUint32(off + 20);
+        const char *value = cacheFile->getCharStar(valueOffset);
         const char *mask = maskOffset ? cacheFile->getCharStar(maskOffset) : nullptr;
 
-        if (!QMimeMagicRule::matchSubstring(dataPtr, dataSize, rangeStart, rangeLength, valueLength, cacheFile->getCharStar(valueOffset), mask))
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        // host16 and host32 values are stored in big endian, with their word size
+        char hostValue[4];
+        char hostMask[4];
+        if (wordSize > 1 && valueLength == wordSize && wordSize <= 4) {
+            std::reverse_copy(value, value + valueLength, hostValue);
+            value = hostValue;
+            if (mask) {
+                std::reverse_copy(mask, mask + valueLength, hostMask);
+                mask = hostMask;
+            }
+        }
+#else
+        Q_UNUSED(wordSize);
+#endif
+
+        if (!QMimeMagicRule::matchSubstring(dataPtr, dataSize, rangeStart, rangeLength, valueLength, value, mask))
             continue;
 
         const int numChildren = cacheFile->getUint32(off + 24);
@@ -456,25 +497,21 @@ void QMimeBinaryProvider::addAliases(const QString &name, QStringList &result)
 
 void QMimeBinaryProvider::loadMimeTypeList()
 {
-    if (!m_mimetypeListLoaded) {
-        m_mimetypeListLoaded = true;
-        m_mimetypeNames.clear();
-        // Unfortunately mime.cache doesn't have a full list of all mimetypes.
-        // So we have to parse the plain-text files called "types".
-        QFile file(m_directory + QStringLiteral("/types"));
-        if (file.open(QIODevice::ReadOnly)) {
-            QTextStream stream(&file);
-            stream.setCodec("ISO 8859-1");
-            QString line;
-            while (stream.readLineInto(&line))
-                m_mimetypeNames.insert(line);
-        }
+    m_mimetypeNames.clear();
+    // Unfortunately mime.cache doesn't have a full list of all mimetypes.
+    // So we have to parse the plain-text files called "types".
+    QFile file(m_directory + QStringLiteral("/types"));
+    if (file.open(QIODevice::ReadOnly)) {
+        QTextStream stream(&file);
+        stream.setCodec("ISO 8859-1");
+        QString line;
+        while (stream.readLineInto(&line))
+            m_mimetypeNames.insert(line);
     }
 }
 
 void QMimeBinaryProvider::addAllMimeTypes(QList<QMimeType> &result)
 {
-    loadMimeTypeList();
     if (result.isEmpty()) {
         result.reserve(m_mimetypeNames.count());
         for (const QString &name : qAsConst(m_mimetypeNames))
@@ -489,14 +526,28 @@ void QMimeBinaryProvider::addAllMimeTypes(QList<QMimeType> &result)
 
 void QMimeBinaryProvider::loadMimeTypePrivate(QMimeTypePrivate &data)
 {
+    if (data.loaded || !m_mimetypeNames.contains(data.name))
+        return;
+    data.loaded = true;
+
+#if QT_CONFIG(mimetype_database)
+    if (isInternalDatabase()) {
+        // The generated cache has no comments, take them from the XML
+        if (!m_xmlDatabase)
+            m_xmlDatabase.reset(new QMimeXMLProvider(m_db, InternalDatabase));
+        const QMimeType mime = m_xmlDatabase->mimeTypeForName(data.name);
+        if (mime.isValid()) {
+            data.localeComments = mime.d->localeComments;
+            data.globPatterns = mime.d->globPatterns;
+        }
+        return;
+    }
+#endif
+
 #ifdef QT_NO_XMLSTREAMREADER
-    Q_UNUSED(data);
     qWarning("Cannot load mime type since QXmlStreamReader is not available.");
     return;
 #else
-    if (data.loaded)
-        return;
-    data.loaded = true;
     // load comment and globPatterns
 
     const QString file = data.name + QLatin1String(".xml");
@@ -626,14 +677,38 @@ void QMimeBinaryProvider::loadGenericIcon(QMimeTypePrivate &data)
     }
 }
 
-////
-
 #if QT_CONFIG(mimetype_database)
-static QString internalMimeFileName()
+QMimeBinaryProvider::QMimeBinaryProvider(QMimeDatabasePrivate *db, InternalDatabaseEnum)
+    : QMimeProviderBase(db, internalMimeFileName())
 {
-    return QStringLiteral("<internal MIME data>");
+#ifdef MIME_DATABASE_HAS_CACHE
+    m_cacheFile = new CacheFile(mimetype_database_cache);
+    if (!m_cacheFile->isValid()) {
+        delete m_cacheFile;
+        m_cacheFile = nullptr;
+        return;
+    }
+    // The generator appends the list of all MIME types, there's no "types" file
+    const int typeListOffset = MimeTypeDatabaseCacheTypeListOffset;
+    const int numTypes = m_cacheFile->getUint32(typeListOffset);
+    m_mimetypeNames.reserve(numTypes);
+    for (int i = 0; i < numTypes; ++i) {
+        const int nameOffset = m_cacheFile->getUint32(typeListOffset + 4 + 4 * i);
+        m_mimetypeNames.insert(QLatin1String(m_cacheFile->getCharStar(nameOffset)));
+    }
+#endif
 }
+#else // !QT_CONFIG(mimetype_database)
+QMimeBinaryProvider::QMimeBinaryProvider(QMimeDatabasePrivate *db, InternalDatabaseEnum)
+    : QMimeProviderBase(db, QString())
+{
+    Q_UNREACHABLE();
+}
+#endif // QT_CONFIG(mimetype_database)
 
+////
+
+#if QT_CONFIG(mimetype_database)
 QMimeXMLProvider::QMimeXMLProvider(QMimeDatabasePrivate *db, InternalDatabaseEnum)
     : QMimeProviderBase(db, internalMimeFileName())
 {
@@ -63,10 +63,13 @@ QT_REQUIRE_CONFIG(mimetype);
 QT_BEGIN_NAMESPACE
 
 class QMimeMagicRuleMatcher;
+class QMimeXMLProvider;
 
 class QMimeProviderBase
 {
 public:
+    enum InternalDatabaseEnum { InternalDatabase };
+
     QMimeProviderBase(QMimeDatabasePrivate *db, const QString &directory);
     virtual ~QMimeProviderBase() {}
 
@@ -79,6 +82,7 @@ public:
     virtual void addAliases(const QString &name, QStringList &result) = 0;
     virtual void findByMagic(const QByteArray &data, int *accuracyPtr, QMimeType &candidate) = 0;
     virtual void addAllMimeTypes(QList<QMimeType> &result) = 0;
+    virtual void loadMimeTypePrivate(QMimeTypePrivate &) {}
     virtual void loadIcon(QMimeTypePrivate &) {}
     virtual void loadGenericIcon(QMimeTypePrivate &) {}
     virtual void ensureLoaded() {}
@@ -90,11 +94,13 @@ public:
 };
 
 /*
-   Parses the files 'mime.cache' and 'types' on demand
+   Parses the files 'mime.cache' and 'types' on demand,
+   or the cache generated at build time from the internal database
  */
-class QMimeBinaryProvider : public QMimeProviderBase
+class Q_AUTOTEST_EXPORT QMimeBinaryProvider : public QMimeProviderBase
 {
 public:
+    QMimeBinaryProvider(QMimeDatabasePrivate *db, InternalDatabaseEnum);
     QMimeBinaryProvider(QMimeDatabasePrivate *db, const QString &directory);
     virtual ~QMimeBinaryProvider();
 
@@ -107,7 +113,7 @@ public:
     void addAliases(const QString &name, QStringList &result) override;
     void findByMagic(const QByteArray &data, int *accuracyPtr, QMimeType &candidate) override;
     void addAllMimeTypes(QList<QMimeType> &result) override;
-    static void loadMimeTypePrivate(QMimeTypePrivate &);
+    void loadMimeTypePrivate(QMimeTypePrivate &) override;
     void loadIcon(QMimeTypePrivate &) override;
     void loadGenericIcon(QMimeTypePrivate &) override;
     void ensureLoaded() override;
@@ -125,16 +131,16 @@ private:
     CacheFile *m_cacheFile = nullptr;
     QStringList m_cacheFileNames;
     QSet<QString> m_mimetypeNames;
-    bool m_mimetypeListLoaded;
+    // Comments and patterns of the internal database, parsed on demand
+    std::unique_ptr<QMimeXMLProvider> m_xmlDatabase;
 };
 
 /*
    Parses the raw XML files (slower)
  */
-class QMimeXMLProvider : public QMimeProviderBase
+class Q_AUTOTEST_EXPORT QMimeXMLProvider : public QMimeProviderBase
 {
 public:
-    enum InternalDatabaseEnum { InternalDatabase };
 #if QT_CONFIG(mimetype_database)
     enum : bool { InternalDatabaseAvailable = true };
 #else
@@ -770,7 +770,7 @@ static QCborValue::Type convertToExtendedType(QCborContainerPrivate *d)
 {
     qint64 tag = d->elements.at(0).value;
     auto &e = d->elements[1];
-    const ByteData *b = d->byteData(e);
+    const ByteDataRef b = d->byteData(e);
 
     auto replaceByteData = [&](const char *buf, qsizetype len, Element::ValueFlags f) {
         d->data.clear();
@@ -1013,7 +1013,16 @@ void QCborContainerPrivate::replaceAt_complex(Element &e, const QCborValue &valu
         e = value.container->elements.at(value.n);
 
         // Copy string data, if any
-        if (const ByteData *b = value.container->byteData(value.n)) {
+        if (e.flags & Element::ByteDataIsExternal) {
+            // share the external buffer if we can, since e.value remains valid
+            if (!external)
+                external = value.container->external;
+            if (external != value.container->external) {
+                const ByteDataRef b = value.container->byteData(value.n);
+                e.flags &= ~Element::ByteDataIsExternal;
+                e.value = addByteData(b->byte(), b->len);
+            }
+        } else if (const ByteDataRef b = value.container->byteData(value.n)) {
             if (this == value.container)
                 e.value = addByteData(b->toByteArray(), b->len);
             else
@@ -1051,10 +1060,15 @@ QCborValue QCborContainerPrivate::extractAt_complex(Element e)
     auto b = byteData(e);
     auto container = new QCborContainerPrivate;
 
-    if (b->len + qsizetype(sizeof(*b)) < data.size() / 4) {
+    if (e.flags & Element::ByteDataIsExternal) {
+        // share the external buffer
+        container->external = external;
+        container->elements.reserve(1);
+        container->elements.append(e);
+    } else if (b->len + qsizetype(sizeof(ByteData)) < data.size() / 4) {
         // make a shallow copy of the byte data
         container->appendByteData(b->byte(), b->len, e.type, e.flags);
-        usedData -= b->len + qsizetype(sizeof(*b));
+        usedData -= b->len + qsizetype(sizeof(ByteData));
         compact(elements.size());
     } else {
         // just share with the original byte data
@@ -1123,8 +1137,8 @@ static int compareElementRecursive(const QCborContainerPrivate *c1, const Elemen
                                 e2.flags & Element::IsContainer ? e2.container : nullptr);
 
     // string data?
-    const ByteData *b1 = c1 ? c1->byteData(e1) : nullptr;
-    const ByteData *b2 = c2 ? c2->byteData(e2) : nullptr;
+    const ByteDataRef b1 = c1 ? c1->byteData(e1) : nullptr;
+    const ByteDataRef b2 = c2 ? c2->byteData(e2) : nullptr;
     if (b1 || b2) {
         auto len1 = b1 ? b1->len : 0;
         auto len2 = b2 ? b2->len : 0;
@@ -1169,7 +1183,7 @@ static int compareElementRecursive(const QCborContainerPrivate *c1, const Elemen
         if (!(e1.flags & Element::StringIsAscii) || !(e2.flags & Element::StringIsAscii)) {
             // Case 2: one of them is UTF-8 and the other is UTF-16, so lengths
             // are NOT comparable. We need to convert to UTF-16 first...
-            auto string = [](const Element &e, const ByteData *b) {
+            auto string = [](const Element &e, ByteDataRef b) {
                 return e.flags & Element::StringIsUtf16 ? b->asQStringRaw() : b->toUtf8String();
             };
 
@@ -1366,7 +1380,7 @@ static void encodeToCbor(QCborStreamWriter &writer, const QCborContainerPrivate
     } else {
         // just one element
         auto e = d->elements.at(idx);
-        const ByteData *b = d->byteData(idx);
+        const ByteDataRef b = d->byteData(idx);
         switch (e.type) {
         case QCborValue::Integer:
             return writer.append(qint64(e.value));
@@ -2010,7 +2024,7 @@ QDateTime QCborValue::toDateTime(const QDateTime &defaultValue) const
         return defaultValue;
 
     Q_ASSERT(n == -1);
-    const ByteData *byteData = container->byteData(1);
+    const ByteDataRef byteData = container->byteData(1);
     if (!byteData)
         return defaultValue; // date/times are never empty, so this must be invalid
 
@@ -2034,7 +2048,7 @@ QUrl QCborValue::toUrl(const QUrl &defaultValue) const
         return defaultValue;
 
     Q_ASSERT(n == -1);
-    const ByteData *byteData = container->byteData(1);
+    const ByteDataRef byteData = container->byteData(1);
     if (!byteData)
         return QUrl();  // valid, empty URL
 
@@ -2077,7 +2091,7 @@ QUuid QCborValue::toUuid(const QUuid &defaultValue) const
         return defaultValue;
 
     Q_ASSERT(n == -1);
-    const ByteData *byteData = container->byteData(1);
+    const ByteDataRef byteData = container->byteData(1);
     if (!byteData)
         return defaultValue; // UUIDs must always be 16 bytes, so this must be invalid
 
@@ -68,7 +68,8 @@ struct Element
         IsContainer                 = 0x0001,
         HasByteData                 = 0x0002,
         StringIsUtf16               = 0x0004,
-        StringIsAscii               = 0x0008
+        StringIsAscii               = 0x0008,
+        ByteDataIsExternal          = 0x0010   // with HasByteData: value is an ExternalSlice
     };
     Q_DECLARE_FLAGS(ValueFlags, ValueFlag)
 
@@ -117,6 +118,63 @@ struct ByteData
 };
 Q_STATIC_ASSERT(std::is_trivial<ByteData>::value);
 Q_STATIC_ASSERT(std::is_standard_layout<ByteData>::value);
+
+// The byte data of an element, wherever it is stored. Used like a pointer to
+// ByteData, which it replaces as the return type of byteData().
+class ByteDataRef
+{
+    const char *ptr = nullptr;
+public:
+    QByteArray::size_type len = 0;
+
+    ByteDataRef(std::nullptr_t = nullptr) {}
+    ByteDataRef(const ByteData *b) : ptr(b->byte()), len(b->len) {}
+    ByteDataRef(const char *data, QByteArray::size_type size) : ptr(data), len(size) {}
+
+    explicit operator bool() const  { return ptr; }
+    const ByteDataRef *operator->() const { return this; }
+
+    const char *byte() const        { return ptr; }
+    const QChar *utf16() const      { return reinterpret_cast<const QChar *>(ptr); }
+
+    QByteArray toByteArray() const  { return QByteArray(byte(), len); }
+    QString toString() const        { return QString(utf16(), len / 2); }
+    QString toUtf8String() const    { return QString::fromUtf8(byte(), len); }
+
+    QByteArray asByteArrayView() const { return QByteArray::fromRawData(byte(), len); }
+    QLatin1String asLatin1() const  { return QLatin1String(byte(), len); }
+    QStringView asStringView() const{ return QStringView(utf16(), len / 2); }
+    QString asQStringRaw() const    { return QString::fromRawData(utf16(), len / 2); }
+};
+
+// A buffer that elements with the ByteDataIsExternal flag point into,
+// instead of having their bytes copied to the container's data block. It is
+// shared by all containers parsed from it and released with the last one.
+struct ExternalData : public QSharedData
+{
+    explicit ExternalData(const QByteArray &b) : buffer(b) {}
+    virtual ~ExternalData() = default;
+
+    QByteArray buffer;
+};
+
+// Packs the position of external byte data into Element::value
+struct ExternalSlice
+{
+    enum : int { LengthBits = 24 };
+    enum : qint64 {
+        MaxLength = (Q_INT64_C(1) << LengthBits) - 1,
+        MaxOffset = (Q_INT64_C(1) << (63 - LengthBits)) - 1
+    };
+
+    static bool fits(qint64 offset, qint64 len)
+    { return offset <= MaxOffset && len <= MaxLength; }
+    static qint64 pack(qint64 offset, qint64 len) { return (offset << LengthBits) | len; }
+    static QByteArray::size_type offset(qint64 value)
+    { return QByteArray::size_type(value >> LengthBits); }
+    static QByteArray::size_type length(qint64 value)
+    { return QByteArray::size_type(value & MaxLength); }
+};
 } // namespace QtCbor
 
 Q_DECLARE_TYPEINFO(QtCbor::Element, Q_PRIMITIVE_TYPE);
@@ -133,6 +191,7 @@ public:
     QByteArray::size_type usedData = 0;
     QByteArray data;
     QVector<QtCbor::Element> elements;
+    QExplicitlySharedDataPointer<QtCbor::ExternalData> external;
 
     void deref() { if (!ref.deref()) delete this; }
     void compact(qsizetype reserved);
@@ -172,11 +231,20 @@ public:
         return offset;
     }
 
-    const QtCbor::ByteData *byteData(QtCbor::Element e) const
+    QtCbor::ByteDataRef byteData(QtCbor::Element e) const
     {
         if ((e.flags & QtCbor::Element::HasByteData) == 0)
             return nullptr;
 
+        if (e.flags & QtCbor::Element::ByteDataIsExternal) {
+            using QtCbor::ExternalSlice;
+            Q_ASSERT(external);
+            Q_ASSERT(ExternalSlice::offset(e.value) + ExternalSlice::length(e.value)
+                     <= external->buffer.size());
+            return { external->buffer.constData() + ExternalSlice::offset(e.value),
+                     ExternalSlice::length(e.value) };
+        }
+
         size_t offset = size_t(e.value);
         Q_ASSERT((offset % Q_ALIGNOF(QtCbor::ByteData)) == 0);
         Q_ASSERT(offset + sizeof(QtCbor::ByteData) <= size_t(data.size()));
@@ -185,7 +253,7 @@ public:
         Q_ASSERT(offset + sizeof(*b) + size_t(b->len) <= size_t(data.size()));
         return b;
     }
-    const QtCbor::ByteData *byteData(qsizetype idx) const
+    QtCbor::ByteDataRef byteData(qsizetype idx) const
     {
         return byteData(elements.at(idx));
     }
@@ -215,6 +283,8 @@ public:
             e.container->deref();
             e.container = nullptr;
             e.flags = {};
+        } else if (e.flags & QtCbor::Element::ByteDataIsExternal) {
+            // nothing to release in our own data block
         } else if (auto b = byteData(e)) {
             usedData -= b->len + sizeof(QtCbor::ByteData);
         }
@@ -243,6 +313,21 @@ public:
         elements.append(QtCbor::Element(addByteData(data, len), type,
                                         QtCbor::Element::HasByteData | extraFlags));
     }
+    void appendExternalByteData(QtCbor::ExternalData *source, const char *data, qsizetype len,
+                                QCborValue::Type type, QtCbor::Element::ValueFlags extraFlags = {})
+    {
+        // refer to the bytes in source instead of copying them, if the
+        // slice can be represented
+        using QtCbor::ExternalSlice;
+        const qint64 offset = data - source->buffer.constData();
+        if ((external && external != source) || !ExternalSlice::fits(offset, len))
+            return appendByteData(data, len, type, extraFlags);
+        if (!external)
+            external = source;
+        elements.append(QtCbor::Element(ExternalSlice::pack(offset, len), type,
+                                        QtCbor::Element::HasByteData
+                                        | QtCbor::Element::ByteDataIsExternal | extraFlags));
+    }
     void append(QLatin1String s)
     {
         if (!QtPrivate::isAscii(s))
@@ -360,12 +445,12 @@ public:
         return e;
     }
 
-    static int compareUtf8(const QtCbor::ByteData *b, const QLatin1String &s)
+    static int compareUtf8(QtCbor::ByteDataRef b, const QLatin1String &s)
     {
         return QUtf8::compareUtf8(b->byte(), b->len, s);
     }
 
-    static int compareUtf8(const QtCbor::ByteData *b, QStringView s)
+    static int compareUtf8(QtCbor::ByteDataRef b, QStringView s)
     {
         return QUtf8::compareUtf8(b->byte(), b->len, s.data(), s.size());
     }
@@ -376,7 +461,7 @@ public:
         if (e.type != QCborValue::String)
             return int(e.type) - int(QCborValue::String);
 
-        const QtCbor::ByteData *b = byteData(e);
+        const QtCbor::ByteDataRef b = byteData(e);
         if (!b)
             return s.isEmpty() ? 0 : -1;
 
@@ -204,6 +204,8 @@ class Value
 {
 public:
     static QCborContainerPrivate *container(const QCborValue &v) { return v.container; }
+    static QCborContainerPrivate *container(const QJsonValue &v) { return v.d.data(); }
+    static qint64 valueHelper(const QJsonValue &v) { return v.n; }
 
     static QJsonValue fromTrustedCbor(const QCborValue &v)
     {
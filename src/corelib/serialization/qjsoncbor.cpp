@@ -75,7 +75,7 @@ static QString simpleTypeString(QCborValue::Type t)
 
 static QString encodeByteArray(const QCborContainerPrivate *d, qsizetype idx, QCborTag encoding)
 {
-    const ByteData *b = d->byteData(idx);
+    const ByteDataRef b = d->byteData(idx);
     if (!b)
         return QString();
 
@@ -97,7 +97,7 @@ static QString maybeEncodeTag(const QCborContainerPrivate *d)
 {
     qint64 tag = d->elements.at(0).value;
     const Element &e = d->elements.at(1);
-    const ByteData *b = d->byteData(e);
+    const ByteDataRef b = d->byteData(e);
 
     switch (tag) {
     case qint64(QCborKnownTags::DateTimeString):
@@ -521,6 +521,44 @@ QJsonDocument QJsonDocument::fromJson(const QByteArray &json, QJsonParseError *e
     return result;
 }
 
+/*!
+    \since 5.15
+
+    Parses \a json as a UTF-8 encoded JSON document, like fromJson(), but
+    without copying the strings that contain no escape sequences. These keep
+    referring to the contents of \a json, which is shared with the returned
+    document and with all values obtained from it. This saves memory and
+    parsing time for large documents, especially ones consisting mostly of
+    strings.
+
+    \a json may have been created with QByteArray::fromRawData(), for example
+    over a file mapped into memory with QFile::map():
+
+    \snippet code/src_corelib_serialization_qjsondocument.cpp 2
+
+    In that case the memory must remain valid and unchanged for as long as
+    the document or any value obtained from it exist. Otherwise, \a json
+    itself is kept alive until then, even if only a small part of the
+    document is still in use.
+
+    On failure, the returned document is null and the optional \a error
+    variable contains further details about the error.
+
+    \sa fromJson(), QByteArray::fromRawData()
+ */
+QJsonDocument QJsonDocument::fromRawJson(const QByteArray &json, QJsonParseError *error)
+{
+    QExplicitlySharedDataPointer<QtCbor::ExternalData> source(new QtCbor::ExternalData(json));
+    QJsonPrivate::Parser parser(source.data());
+    QJsonDocument result;
+    const QCborValue val = parser.parse(error);
+    if (val.isArray() || val.isMap()) {
+        result.d = qt_make_unique<QJsonDocumentPrivate>();
+        result.d->value = val;
+    }
+    return result;
+}
+
 /*!
     Returns \c true if the document doesn't contain any data.
  */
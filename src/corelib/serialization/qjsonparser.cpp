@@ -47,6 +47,7 @@
 #include "private/qutfcodec_p.h"
 #include "private/qcborvalue_p.h"
 #include "private/qnumeric_p.h"
+#include "private/qsimd_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -230,6 +231,16 @@ Parser::Parser(const char *json, int length)
     end = json + length;
 }
 
+/*
+    Parses the buffer of \a source. Strings without escape sequences refer to
+    it instead of being copied, and the resulting containers keep it alive.
+*/
+Parser::Parser(QtCbor::ExternalData *source)
+    : Parser(source->buffer.constData(), source->buffer.size())
+{
+    external = source;
+}
+
 
 
 /*
@@ -272,6 +283,146 @@ enum {
     Quote = 0x22
 };
 
+/*
+    The scanners below look at 16 or 32 bytes at a time. They stop at the
+    first byte the parser has to look at individually and handle the tail of
+    the input one byte at a time, so they never read past \a end.
+*/
+
+static inline bool isJsonSpace(uchar c)
+{
+    return c == Space || c == Tab || c == LineFeed || c == Return;
+}
+
+// Returns the first byte in [json, end) that is a quote, a backslash or not ASCII.
+static const char *skipPlainAsciiScalar(const char *json, const char *end)
+{
+    for ( ; json < end; ++json) {
+        const uchar c = *json;
+        if (c == Quote || c == '\\' || c >= 0x80)
+            break;
+    }
+    return json;
+}
+
+// Returns the first byte in [json, end) that is not JSON white space.
+static const char *skipSpaceScalar(const char *json, const char *end)
+{
+    while (json < end && isJsonSpace(*json))
+        ++json;
+    return json;
+}
+
+#if defined(__SSE2__) && defined(QT_COMPILER_SUPPORTS_SSE2)
+static inline uint plainAsciiMask(__m128i data)
+{
+    // the high bit of data itself flags the non-ASCII bytes
+    const __m128i special = _mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(Quote)),
+                                         _mm_cmpeq_epi8(data, _mm_set1_epi8('\\')));
+    return _mm_movemask_epi8(_mm_or_si128(special, data));
+}
+
+static inline uint spaceMask(__m128i data)
+{
+    const __m128i space = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(Space)),
+                                                    _mm_cmpeq_epi8(data, _mm_set1_epi8(Tab))),
+                                       _mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(LineFeed)),
+                                                    _mm_cmpeq_epi8(data, _mm_set1_epi8(Return))));
+    return ~_mm_movemask_epi8(space) & 0xffff;
+}
+
+static const char *skipPlainAsciiSimd(const char *json, const char *end)
+{
+    for ( ; end - json >= 16; json += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        if (const uint mask = plainAsciiMask(data))
+            return json + qCountTrailingZeroBits(mask);
+    }
+    return skipPlainAsciiScalar(json, end);
+}
+
+static const char *skipSpaceSimd(const char *json, const char *end)
+{
+    for ( ; end - json >= 16; json += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        if (const uint mask = spaceMask(data))
+            return json + qCountTrailingZeroBits(mask);
+    }
+    return skipSpaceScalar(json, end);
+}
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+// NEON has no movemask: narrow every byte of the comparison result to a nibble
+static inline quint64 nibbleMask(uint8x16_t matches)
+{
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+}
+
+static const char *skipPlainAsciiSimd(const char *json, const char *end)
+{
+    const uint8x16_t quote = vdupq_n_u8(Quote);
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t maxAscii = vdupq_n_u8(0x7f);
+    for ( ; end - json >= 16; json += 16) {
+        const uint8x16_t data = vld1q_u8(reinterpret_cast<const uchar *>(json));
+        const uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(data, quote), vceqq_u8(data, backslash)),
+                                            vcgtq_u8(data, maxAscii));
+        if (const quint64 mask = nibbleMask(special))
+            return json + qCountTrailingZeroBits(mask) / 4;
+    }
+    return skipPlainAsciiScalar(json, end);
+}
+
+static const char *skipSpaceSimd(const char *json, const char *end)
+{
+    for ( ; end - json >= 16; json += 16) {
+        const uint8x16_t data = vld1q_u8(reinterpret_cast<const uchar *>(json));
+        const uint8x16_t space = vorrq_u8(vorrq_u8(vceqq_u8(data, vdupq_n_u8(Space)),
+                                                   vceqq_u8(data, vdupq_n_u8(Tab))),
+                                          vorrq_u8(vceqq_u8(data, vdupq_n_u8(LineFeed)),
+                                                   vceqq_u8(data, vdupq_n_u8(Return))));
+        if (const quint64 mask = nibbleMask(vmvnq_u8(space)))
+            return json + qCountTrailingZeroBits(mask) / 4;
+    }
+    return skipSpaceScalar(json, end);
+}
+#else
+static const char *skipPlainAsciiSimd(const char *json, const char *end)
+{
+    return skipPlainAsciiScalar(json, end);
+}
+
+static const char *skipSpaceSimd(const char *json, const char *end)
+{
+    return skipSpaceScalar(json, end);
+}
+#endif
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+QT_FUNCTION_TARGET(AVX2)
+static const char *skipPlainAsciiAvx2(const char *json, const char *end)
+{
+    const __m256i quote = _mm256_set1_epi8(Quote);
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    for ( ; end - json >= 32; json += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(json));
+        const __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(data, quote),
+                                                _mm256_cmpeq_epi8(data, backslash));
+        if (const uint mask = _mm256_movemask_epi8(_mm256_or_si256(special, data)))
+            return json + qCountTrailingZeroBits(mask);
+    }
+    return skipPlainAsciiSimd(json, end);
+}
+#endif
+
+static inline const char *skipPlainAscii(const char *json, const char *end)
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (end - json >= 32 && qCpuHasFeature(AVX2))
+        return skipPlainAsciiAvx2(json, end);
+#endif
+    return skipPlainAsciiSimd(json, end);
+}
+
 void Parser::eatBOM()
 {
     // eat UTF-8 byte order mark
@@ -285,16 +436,10 @@ void Parser::eatBOM()
 
 bool Parser::eatSpace()
 {
-    while (json < end) {
-        if (*json > Space)
-            break;
-        if (*json != Space &&
-            *json != Tab &&
-            *json != LineFeed &&
-            *json != Return)
-            break;
-        ++json;
-    }
+    // compact documents have no white space at all, don't bother scanning then
+    if (json < end && !isJsonSpace(*json))
+        return true;
+    json = skipSpaceSimd(json, end);
     return (json < end);
 }
 
@@ -393,8 +538,8 @@ static void sortContainer(QCborContainerPrivate *container)
         Q_ASSERT(aKey.flags & QtCbor::Element::HasByteData);
         Q_ASSERT(bKey.flags & QtCbor::Element::HasByteData);
 
-        const QtCbor::ByteData *aData = container->byteData(aKey);
-        const QtCbor::ByteData *bData = container->byteData(bKey);
+        const QtCbor::ByteDataRef aData = container->byteData(aKey);
+        const QtCbor::ByteDataRef bData = container->byteData(bKey);
 
         if (!aData)
             return bData ? -1 : 0;
@@ -765,78 +910,6 @@ bool Parser::parseNumber()
 
         unescaped = %x20-21 / %x23-5B / %x5D-10FFFF
  */
-static inline bool addHexDigit(char digit, uint *result)
-{
-    *result <<= 4;
-    if (digit >= '0' && digit <= '9')
-        *result |= (digit - '0');
-    else if (digit >= 'a' && digit <= 'f')
-        *result |= (digit - 'a') + 10;
-    else if (digit >= 'A' && digit <= 'F')
-        *result |= (digit - 'A') + 10;
-    else
-        return false;
-    return true;
-}
-
-static inline bool scanEscapeSequence(const char *&json, const char *end, uint *ch)
-{
-    ++json;
-    if (json >= end)
-        return false;
-
-    DEBUG << "scan escape" << (char)*json;
-    uint escaped = *json++;
-    switch (escaped) {
-    case '"':
-        *ch = '"'; break;
-    case '\\':
-        *ch = '\\'; break;
-    case '/':
-        *ch = '/'; break;
-    case 'b':
-        *ch = 0x8; break;
-    case 'f':
-        *ch = 0xc; break;
-    case 'n':
-        *ch = 0xa; break;
-    case 'r':
-        *ch = 0xd; break;
-    case 't':
-        *ch = 0x9; break;
-    case 'u': {
-        *ch = 0;
-        if (json > end - 4)
-            return false;
-        for (int i = 0; i < 4; ++i) {
-            if (!addHexDigit(*json, ch))
-                return false;
-            ++json;
-        }
-        return true;
-    }
-    default:
-        // this is not as strict as one could be, but allows for more Json files
-        // to be parsed correctly.
-        *ch = escaped;
-        return true;
-    }
-    return true;
-}
-
-static inline bool scanUtf8Char(const char *&json, const char *end, uint *result)
-{
-    const auto *usrc = reinterpret_cast<const uchar *>(json);
-    const auto *uend = reinterpret_cast<const uchar *>(end);
-    const uchar b = *usrc++;
-    int res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, result, usrc, uend);
-    if (res < 0)
-        return false;
-
-    json = reinterpret_cast<const char *>(usrc);
-    return true;
-}
-
 bool Parser::parseString()
 {
     const char *start = json;
@@ -847,6 +920,9 @@ bool Parser::parseString()
     bool isUtf8 = true;
     bool isAscii = true;
     while (json < end) {
+        json = skipPlainAscii(json, end);
+        if (json >= end)
+            break;
         uint ch = 0;
         if (*json == '"')
             break;
@@ -858,12 +934,12 @@ bool Parser::parseString()
             isUtf8 = false;
             break;
         }
+        // not ASCII, validate the multi-byte sequence
         if (!scanUtf8Char(json, end, &ch)) {
             lastError = QJsonParseError::IllegalUTF8String;
             return false;
         }
-        if (ch > 0x7f)
-            isAscii = false;
+        isAscii = false;
         DEBUG << "  " << ch << char(ch);
     }
     ++json;
@@ -875,9 +951,13 @@ bool Parser::parseString()
 
     // no escape sequences, we are done
     if (isUtf8) {
-        container->appendByteData(start, json - start - 1, QCborValue::String,
-                                  isAscii ? QtCbor::Element::StringIsAscii
-                                          : QtCbor::Element::ValueFlags {});
+        const QtCbor::Element::ValueFlags flags = isAscii ? QtCbor::Element::StringIsAscii
+                                                          : QtCbor::Element::ValueFlags {};
+        if (external)
+            container->appendExternalByteData(external, start, json - start - 1,
+                                              QCborValue::String, flags);
+        else
+            container->appendByteData(start, json - start - 1, QCborValue::String, flags);
         END;
         return true;
     }
@@ -888,6 +968,12 @@ bool Parser::parseString()
 
     QString ucs4;
     while (json < end) {
+        const char *plain = json;
+        json = skipPlainAscii(json, end);
+        if (json != plain)
+            ucs4.append(QLatin1String(plain, int(json - plain)));
+        if (json >= end)
+            break;
         uint ch = 0;
         if (*json == '"')
             break;
@@ -0,0 +1,1118 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qjsonstreamreader.h"
+
+#include <qcoreapplication.h>
+#include <qiodevice.h>
+#include <qjsondocument.h>
+#include <qmetaobject.h>
+#include <qvarlengtharray.h>
+
+#include "qjson_p.h"
+#include "qjsonparser_p.h"
+#include <private/qnumeric_p.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+enum {
+    NestingLimit = 1024,        // same as QJsonDocument::fromJson()
+    ReadChunkSize = 64 * 1024
+};
+
+enum LexResult {
+    LexOk,
+    LexNeedMoreData,
+    LexError
+};
+
+inline bool isJsonSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool isNumberChar(char c)
+{
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/*
+    Checks [p, end), a run of number characters, against the RFC 8259
+    grammar -? (0|[1-9][0-9]*) (\.[0-9]+)? ([eE][+-]?[0-9]+)?. Returns
+    nullptr if it matches, or the first byte that does not fit.
+*/
+const char *checkNumber(const char *p, const char *end)
+{
+    if (p < end && *p == '-')
+        ++p;
+    if (p == end || !isDigit(*p))
+        return p;
+    if (*p++ == '0') {
+        if (p < end && isDigit(*p))
+            return p;
+    } else {
+        while (p < end && isDigit(*p))
+            ++p;
+    }
+    if (p < end && *p == '.') {
+        if (++p == end || !isDigit(*p))
+            return p;
+        while (p < end && isDigit(*p))
+            ++p;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        if (p < end && (*p == '+' || *p == '-'))
+            ++p;
+        if (p == end || !isDigit(*p))
+            return p;
+        while (p < end && isDigit(*p))
+            ++p;
+    }
+    return p == end ? nullptr : p;
+}
+}
+
+class QJsonStreamReaderPrivate
+{
+public:
+    // what the grammar allows at the current position
+    enum Expect : quint8 {
+        ExpectTopLevelValue,
+        ExpectFirstArrayValue,      // value or ]
+        ExpectArrayValue,           // value after ,
+        ExpectArraySeparator,       // , or ]
+        ExpectFirstName,            // name or }
+        ExpectName,                 // name after ,
+        ExpectNameSeparator,        // :
+        ExpectMemberValue,          // value after :
+        ExpectObjectSeparator       // , or }
+    };
+
+    QIODevice *device = nullptr;
+    QByteArray buffer;
+    qsizetype pos = 0;              // first byte not consumed yet
+    qsizetype tokenStart = 0;       // first byte of the current token
+    qint64 bufferOffset = 0;        // offset of buffer[0] in the input
+    qsizetype scanned = 0;          // end of the input looked at when running out of data
+    bool dataFinished = false;      // finishData() was called
+
+    // where findStringEnd() stopped for the string starting at stringQuote,
+    // as offsets in the input, and whether the next byte is escaped
+    qint64 stringQuote = -1;
+    qint64 stringScanned = 0;
+    bool stringEscaped = false;
+
+    QVarLengthArray<char, 16> containers;   // '[' or '{' for every open container
+    Expect expect = ExpectTopLevelValue;
+
+    QJsonStreamReader::TokenType type = QJsonStreamReader::NoToken;
+    QJsonStreamReader::Error error = QJsonStreamReader::NoError;
+    QJsonParseError::ParseError parseError = QJsonParseError::NoError;
+    qint64 errorOffset = 0;
+
+    QString text;
+    qint64 integer = 0;
+    double number = 0;
+    bool numberIsInteger = false;
+    bool boolean = false;
+
+    void reset();
+    void compact();
+    bool fetch();
+    bool inputFinished() const;
+    bool hasPendingData() const;
+    QJsonStreamReader::TokenType setPrematureEnd();
+
+    QJsonStreamReader::TokenType setParseError(QJsonParseError::ParseError code, qsizetype at);
+    QJsonStreamReader::TokenType setToken(QJsonStreamReader::TokenType token);
+    QJsonStreamReader::TokenType endContainer();
+    QJsonStreamReader::TokenType readNext();
+
+    LexResult skipByteOrderMark();
+    LexResult lexValue();
+    LexResult lexString(QJsonStreamReader::TokenType token);
+    LexResult lexLiteral(const char *literal, int length);
+    LexResult lexNumber();
+    qsizetype findStringEnd(qsizetype quote);
+    LexResult findContainerEnd(qsizetype *end);
+};
+
+void QJsonStreamReaderPrivate::reset()
+{
+    buffer.clear();
+    pos = 0;
+    tokenStart = 0;
+    bufferOffset = 0;
+    scanned = 0;
+    dataFinished = false;
+    stringQuote = -1;
+    stringScanned = 0;
+    stringEscaped = false;
+    containers.clear();
+    expect = ExpectTopLevelValue;
+    type = QJsonStreamReader::NoToken;
+    error = QJsonStreamReader::NoError;
+    parseError = QJsonParseError::NoError;
+    errorOffset = 0;
+    text.clear();
+}
+
+void QJsonStreamReaderPrivate::compact()
+{
+    // Drop what has been consumed, but only once it is more than what is
+    // left, so that the moves stay linear in the size of the input.
+    if (pos == buffer.size()) {
+        bufferOffset += pos;
+        scanned -= pos;
+        buffer.clear();
+        pos = 0;
+    } else if (pos >= ReadChunkSize && pos > buffer.size() / 2) {
+        bufferOffset += pos;
+        scanned -= pos;
+        buffer.remove(0, int(pos));
+        pos = 0;
+    }
+    tokenStart = pos;
+}
+
+/*
+    Appends more input from the device to the buffer. Returns false if there
+    is none available right now.
+*/
+bool QJsonStreamReaderPrivate::fetch()
+{
+    if (!device)
+        return false;
+    const qint64 chunk = qMax<qint64>(device->bytesAvailable(), ReadChunkSize);
+    const int oldSize = buffer.size();
+    buffer.resize(oldSize + int(chunk));
+    const qint64 read = device->read(buffer.data() + oldSize, chunk);
+    buffer.resize(oldSize + int(qMax<qint64>(read, 0)));
+    return read > 0;
+}
+
+/*
+    Returns true if no more input can arrive: either finishData() was called
+    or a random-access device is at its end. Otherwise, data passed to
+    addData() or read from a sequential device may always be followed by
+    more.
+*/
+bool QJsonStreamReaderPrivate::inputFinished() const
+{
+    return dataFinished || (device && !device->isSequential() && device->atEnd());
+}
+
+/*
+    Returns true if input arrived that was not looked at yet when the
+    reader last ran out of data.
+*/
+bool QJsonStreamReaderPrivate::hasPendingData() const
+{
+    return scanned < buffer.size() || (device && device->bytesAvailable() > 0);
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::setPrematureEnd()
+{
+    // nothing was consumed, the token is read again once there is more data
+    pos = tokenStart;
+    scanned = buffer.size();
+    error = QJsonStreamReader::PrematureEndOfDocumentError;
+    return type = QJsonStreamReader::Invalid;
+}
+
+QJsonStreamReader::TokenType
+QJsonStreamReaderPrivate::setParseError(QJsonParseError::ParseError code, qsizetype at)
+{
+    error = QJsonStreamReader::NotWellFormedError;
+    parseError = code;
+    errorOffset = bufferOffset + at;
+    text.clear();
+    return type = QJsonStreamReader::Invalid;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::setToken(QJsonStreamReader::TokenType token)
+{
+    switch (token) {
+    case QJsonStreamReader::String:
+    case QJsonStreamReader::Number:
+    case QJsonStreamReader::Bool:
+    case QJsonStreamReader::Null:
+        expect = containers.isEmpty() ? ExpectTopLevelValue
+                                      : containers.last() == '[' ? ExpectArraySeparator
+                                                                 : ExpectObjectSeparator;
+        break;
+    default:
+        break;
+    }
+    return type = token;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::endContainer()
+{
+    const bool isArray = containers.last() == '[';
+    containers.removeLast();
+    // a container is a complete value for its parent
+    setToken(QJsonStreamReader::Null);
+    return type = isArray ? QJsonStreamReader::EndArray : QJsonStreamReader::EndObject;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readNext()
+{
+    if (error == QJsonStreamReader::NotWellFormedError)
+        return type;
+    error = QJsonStreamReader::NoError;
+    compact();
+
+    while (true) {
+        while (pos < buffer.size() && isJsonSpace(buffer.at(pos)))
+            ++pos;
+        if (pos == buffer.size()) {
+            if (fetch())
+                continue;
+            if (expect == ExpectTopLevelValue) {
+                scanned = pos;
+                return type = QJsonStreamReader::EndDocument;
+            }
+            tokenStart = pos;
+            return setPrematureEnd();
+        }
+
+        tokenStart = pos;
+        const char c = buffer.at(pos);
+        LexResult result = LexOk;
+        switch (expect) {
+        case ExpectArraySeparator:
+            if (c == ',') {
+                ++pos;
+                expect = ExpectArrayValue;
+                continue;
+            }
+            if (c != ']')
+                return setParseError(QJsonParseError::MissingValueSeparator, pos);
+            ++pos;
+            return endContainer();
+
+        case ExpectObjectSeparator:
+            if (c == ',') {
+                ++pos;
+                expect = ExpectName;
+                continue;
+            }
+            if (c != '}')
+                return setParseError(QJsonParseError::UnterminatedObject, pos);
+            ++pos;
+            return endContainer();
+
+        case ExpectNameSeparator:
+            if (c != ':')
+                return setParseError(QJsonParseError::MissingNameSeparator, pos);
+            ++pos;
+            expect = ExpectMemberValue;
+            continue;
+
+        case ExpectFirstName:
+            if (c == '}') {
+                ++pos;
+                return endContainer();
+            }
+            Q_FALLTHROUGH();
+        case ExpectName:
+            if (c == '"')
+                result = lexString(QJsonStreamReader::Name);
+            else
+                return setParseError(c == '}' ? QJsonParseError::MissingObject
+                                              : QJsonParseError::UnterminatedObject, pos);
+            break;
+
+        case ExpectFirstArrayValue:
+            if (c == ']') {
+                ++pos;
+                return endContainer();
+            }
+            Q_FALLTHROUGH();
+        case ExpectArrayValue:
+        case ExpectMemberValue:
+            result = lexValue();
+            break;
+
+        case ExpectTopLevelValue:
+            if (bufferOffset + pos == 0 && uchar(c) == 0xef) {
+                result = skipByteOrderMark();
+                if (result == LexOk)
+                    continue;
+            } else {
+                result = lexValue();
+            }
+            break;
+        }
+
+        if (result == LexNeedMoreData)
+            return setPrematureEnd();
+        return type;
+    }
+}
+
+LexResult QJsonStreamReaderPrivate::skipByteOrderMark()
+{
+    static const char bom[] = "\xef\xbb\xbf";
+    while (buffer.size() - pos < 3) {
+        if (memcmp(buffer.constData() + pos, bom, buffer.size() - pos) != 0)
+            break;
+        if (!fetch())
+            return LexNeedMoreData;
+    }
+    if (buffer.size() - pos < 3 || memcmp(buffer.constData() + pos, bom, 3) != 0) {
+        setParseError(QJsonParseError::IllegalValue, pos);
+        return LexError;
+    }
+    pos += 3;
+    return LexOk;
+}
+
+LexResult QJsonStreamReaderPrivate::lexValue()
+{
+    switch (buffer.at(pos)) {
+    case '[':
+    case '{':
+        if (containers.size() >= NestingLimit) {
+            setParseError(QJsonParseError::DeepNesting, pos);
+            return LexError;
+        }
+        containers.append(buffer.at(pos));
+        expect = buffer.at(pos) == '[' ? ExpectFirstArrayValue : ExpectFirstName;
+        type = buffer.at(pos) == '[' ? QJsonStreamReader::StartArray : QJsonStreamReader::StartObject;
+        ++pos;
+        return LexOk;
+    case '"':
+        return lexString(QJsonStreamReader::String);
+    case 't':
+        boolean = true;
+        return lexLiteral("true", 4);
+    case 'f':
+        boolean = false;
+        return lexLiteral("false", 5);
+    case 'n':
+        return lexLiteral("null", 4);
+    default:
+        if (isNumberChar(buffer.at(pos)))
+            return lexNumber();
+        setParseError(QJsonParseError::IllegalValue, pos);
+        return LexError;
+    }
+}
+
+/*
+    Returns the position after the quote closing the string that starts at
+    \a quote, or -1 if the buffer does not hold all of it yet. A later call
+    for the same string continues where this one stopped, so that a long
+    string arriving in small pieces is only scanned once.
+*/
+qsizetype QJsonStreamReaderPrivate::findStringEnd(qsizetype quote)
+{
+    if (stringQuote != bufferOffset + quote) {
+        stringQuote = bufferOffset + quote;
+        stringScanned = stringQuote + 1;
+        stringEscaped = false;
+    }
+    const char *data = buffer.constData();
+    const char *p = data + (stringScanned - bufferOffset);
+    const char *end = data + buffer.size();
+    while (p < end) {
+        if (stringEscaped) {
+            stringEscaped = false;
+            ++p;
+            continue;
+        }
+        const char *backslash = static_cast<const char *>(memchr(p, '\\', end - p));
+        const char *limit = backslash ? backslash : end;
+        if (const char *q = static_cast<const char *>(memchr(p, '"', limit - p))) {
+            stringQuote = -1;
+            return q + 1 - data;
+        }
+        p = limit;
+        if (backslash) {
+            stringEscaped = true;
+            ++p;
+        }
+    }
+    stringScanned = bufferOffset + (p - data);
+    return -1;
+}
+
+LexResult QJsonStreamReaderPrivate::lexString(QJsonStreamReader::TokenType token)
+{
+    qsizetype end;
+    while ((end = findStringEnd(pos)) < 0) {
+        if (!fetch())
+            return LexNeedMoreData;
+    }
+
+    const char *json = buffer.constData() + pos + 1;
+    const char *last = buffer.constData() + end - 1;
+    text.clear();
+    text.reserve(int(last - json));
+    while (json < last) {
+        const char *plain = json;
+        while (json < last && uchar(*json) < 0x80 && *json != '\\')
+            ++json;
+        if (json != plain)
+            text.append(QLatin1String(plain, int(json - plain)));
+        if (json == last)
+            break;
+
+        const qsizetype at = json - buffer.constData();
+        uint ch = 0;
+        if (*json == '\\') {
+            if (!QJsonPrivate::scanEscapeSequence(json, last, &ch)) {
+                setParseError(QJsonParseError::IllegalEscapeSequence, at);
+                return LexError;
+            }
+        } else if (!QJsonPrivate::scanUtf8Char(json, last, &ch)) {
+            setParseError(QJsonParseError::IllegalUTF8String, at);
+            return LexError;
+        }
+        if (QChar::requiresSurrogates(ch)) {
+            text.append(QChar::highSurrogate(ch));
+            text.append(QChar::lowSurrogate(ch));
+        } else {
+            text.append(QChar(ushort(ch)));
+        }
+    }
+
+    pos = end;
+    if (token == QJsonStreamReader::Name)
+        expect = ExpectNameSeparator;
+    setToken(token);
+    return LexOk;
+}
+
+LexResult QJsonStreamReaderPrivate::lexLiteral(const char *literal, int length)
+{
+    while (buffer.size() - pos < length) {
+        if (memcmp(buffer.constData() + pos, literal, buffer.size() - pos) != 0)
+            break;
+        if (!fetch())
+            return LexNeedMoreData;
+    }
+    if (buffer.size() - pos < length || memcmp(buffer.constData() + pos, literal, length) != 0) {
+        setParseError(QJsonParseError::IllegalValue, pos);
+        return LexError;
+    }
+    pos += length;
+    setToken(literal[0] == 'n' ? QJsonStreamReader::Null : QJsonStreamReader::Bool);
+    return LexOk;
+}
+
+LexResult QJsonStreamReaderPrivate::lexNumber()
+{
+    // a number ends with the first byte that cannot be part of it, which
+    // may not have arrived yet
+    qsizetype end = pos;
+    while (true) {
+        while (end < buffer.size() && isNumberChar(buffer.at(end)))
+            ++end;
+        if (end < buffer.size())
+            break;
+        if (!fetch()) {
+            if (!inputFinished() || expect != ExpectTopLevelValue)
+                return LexNeedMoreData;
+            break;
+        }
+    }
+
+    // QByteArray's conversions accept more than JSON does, like "+1" or "1."
+    if (const char *bad = checkNumber(buffer.constData() + pos, buffer.constData() + end)) {
+        setParseError(QJsonParseError::IllegalNumber, bad - buffer.constData());
+        return LexError;
+    }
+    const QByteArray literal = QByteArray::fromRawData(buffer.constData() + pos, int(end - pos));
+    const bool isInt = literal.indexOf('.') < 0 && literal.indexOf('e') < 0 && literal.indexOf('E') < 0;
+    bool ok = false;
+    if (isInt) {
+        integer = literal.toLongLong(&ok);
+        numberIsInteger = ok;
+    }
+    if (!ok) {
+        number = literal.toDouble(&ok);
+        if (!ok) {
+            setParseError(QJsonParseError::IllegalNumber, pos);
+            return LexError;
+        }
+        numberIsInteger = convertDoubleTo(number, &integer);
+    }
+    if (numberIsInteger)
+        number = double(integer);
+
+    pos = end;
+    setToken(QJsonStreamReader::Number);
+    return LexOk;
+}
+
+/*
+    Finds the end of the array or object starting at tokenStart, reading
+    more input as needed. Only brackets and strings are looked at: the
+    contents are validated when the value is parsed.
+*/
+LexResult QJsonStreamReaderPrivate::findContainerEnd(qsizetype *end)
+{
+    qsizetype i = tokenStart + 1;
+    int level = 1;
+    while (true) {
+        while (i < buffer.size()) {
+            const char c = buffer.at(i);
+            if (c == '"') {
+                const qsizetype stringEnd = findStringEnd(i);
+                if (stringEnd < 0)
+                    break;
+                i = stringEnd;
+                continue;
+            }
+            if (c == '[' || c == '{') {
+                ++level;
+            } else if ((c == ']' || c == '}') && --level == 0) {
+                *end = i + 1;
+                return LexOk;
+            }
+            ++i;
+        }
+        if (!fetch())
+            return LexNeedMoreData;
+    }
+}
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 5.15
+
+    \brief The QJsonStreamReader class is a fast pull parser for JSON text,
+    read from a QIODevice or from data added incrementally.
+
+    QJsonDocument::fromJson() needs the whole document in memory and builds
+    the complete tree before returning. QJsonStreamReader instead reports
+    the document one token at a time, in the spirit of QXmlStreamReader and
+    QCborStreamReader, and only keeps the token being read in memory. This
+    makes it suitable for very large documents such as arrays of records or
+    newline-delimited JSON, where the input is a sequence of top-level
+    values separated by white space.
+
+    Call readNext() until atEnd() returns \c true. Each call returns the
+    type of the token just read: the start or the end of an array or an
+    object, the name of an object member, or a scalar value whose contents
+    are available from text(), toInteger(), toDouble(), toBool() or value().
+    When only parts of the document are of interest, readValue() hands back
+    the current array or object as a QJsonValue, and skipCurrentValue()
+    steps over it without building anything.
+
+    \snippet code/src_corelib_serialization_qjsonstreamreader.cpp 0
+
+    If the input ends in the middle of a value, readNext() returns Invalid
+    and error() is PrematureEndOfDocumentError. This is not fatal: once more
+    data has been added with addData(), or has become available on the
+    device, calling readNext() again continues where the reader left off.
+    Call finishData() once all input has been added, so that a number at
+    the very end of it can be reported.
+    Errors in the JSON text itself are reported as NotWellFormedError, and
+    reading stops there.
+
+    \sa QJsonDocument, QXmlStreamReader, QCborStreamReader
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum specifies the type of token the reader just read.
+
+    \value NoToken      The reader has not read anything yet.
+    \value Invalid      An error occurred, reported in error() and errorString().
+    \value StartArray   The start of an array.
+    \value EndArray     The end of an array.
+    \value StartObject  The start of an object.
+    \value EndObject    The end of an object.
+    \value Name         The name of an object member, available from text().
+                        The member's value is the next token.
+    \value String       A string, available from text().
+    \value Number       A number, available from toDouble() and, if it is
+                        integral, from toInteger().
+    \value Bool         \c true or \c false, available from toBool().
+    \value Null         \c null.
+    \value EndDocument  All top-level values have been read.
+*/
+
+/*!
+    \enum QJsonStreamReader::Error
+
+    This enum specifies the errors the reader can run into.
+
+    \value NoError                      No error occurred.
+    \value NotWellFormedError           The input is not valid JSON.
+    \value PrematureEndOfDocumentError  The input ended in the middle of a
+                                        value. Reading can continue once
+                                        more data is available.
+*/
+
+/*!
+    Constructs a reader without input. Use setDevice() or addData() to
+    provide it.
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Constructs a reader that reads from \a device, which must already be
+    open.
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : QJsonStreamReader()
+{
+    setDevice(device);
+}
+
+/*!
+    Constructs a reader that reads from \a data.
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : QJsonStreamReader()
+{
+    addData(data);
+}
+
+/*!
+    Destroys the reader.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Makes the reader read from \a device and resets it to its initial
+    state. The reader does not take ownership of the device.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    Q_D(QJsonStreamReader);
+    d->reset();
+    d->device = device;
+}
+
+/*!
+    Returns the device the reader reads from, or \nullptr.
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->device;
+}
+
+/*!
+    Appends \a data to the input. This is only possible when the reader
+    does not read from a device, and until finishData() is called.
+
+    \sa finishData()
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    Q_D(QJsonStreamReader);
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+    if (d->dataFinished) {
+        qWarning("QJsonStreamReader: addData() after finishData()");
+        return;
+    }
+    d->buffer += data;
+}
+
+/*!
+    \overload
+
+    Appends \a len bytes from \a data to the input.
+*/
+void QJsonStreamReader::addData(const char *data, qsizetype len)
+{
+    addData(QByteArray::fromRawData(data, int(len)));
+}
+
+/*!
+    Tells the reader that no more data follows what was passed to addData()
+    or what the device() still holds.
+
+    Until then, the reader cannot know whether a number at the very end of
+    the input is complete: a top-level number, such as the last value of
+    newline-delimited JSON without a final line break, is only reported
+    once this function has been called.
+
+    \sa addData()
+*/
+void QJsonStreamReader::finishData()
+{
+    Q_D(QJsonStreamReader);
+    d->dataFinished = true;
+    // what is left may read differently now, so look at it again
+    d->scanned = d->pos;
+}
+
+/*!
+    Removes the device or data from the reader and resets it to its
+    initial state.
+*/
+void QJsonStreamReader::clear()
+{
+    Q_D(QJsonStreamReader);
+    d->reset();
+    d->device = nullptr;
+}
+
+/*!
+    Returns \c true if there is nothing left to read: either an error
+    occurred or all input available so far has been read. More input can
+    make it return \c false again, unless the error was NotWellFormedError.
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    Q_D(const QJsonStreamReader);
+    if (d->error == NotWellFormedError)
+        return true;
+    if (d->type == EndDocument || d->error == PrematureEndOfDocumentError)
+        return !d->hasPendingData();
+    return false;
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    \sa tokenType(), atEnd()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    Q_D(QJsonStreamReader);
+    return d->readNext();
+}
+
+/*!
+    Returns the type of the current token.
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type;
+}
+
+/*!
+    Returns the name of the current token type, for example "StartArray".
+*/
+QString QJsonStreamReader::tokenString() const
+{
+    return QString::fromLatin1(QMetaEnum::fromType<TokenType>().valueToKey(tokenType()));
+}
+
+/*!
+    Returns the number of arrays and objects that are open. A StartArray or
+    StartObject token counts the container it opens, an EndArray or
+    EndObject token no longer counts the one it closes.
+*/
+int QJsonStreamReader::depth() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->containers.size();
+}
+
+/*!
+    Returns the offset in bytes from the beginning of the input to the end
+    of the current token.
+*/
+qint64 QJsonStreamReader::offset() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->bufferOffset + d->pos;
+}
+
+/*!
+    Returns the contents of the current String or Name token. The escape
+    sequences have been replaced.
+*/
+QString QJsonStreamReader::text() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == String || d->type == Name ? d->text : QString();
+}
+
+/*!
+    Returns \c true if the current token is a number that can be represented
+    exactly as a 64-bit integer.
+*/
+bool QJsonStreamReader::isInteger() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Number && d->numberIsInteger;
+}
+
+/*!
+    Returns the current number as a 64-bit integer, or 0 if it is not
+    integral.
+
+    \sa isInteger(), toDouble()
+*/
+qint64 QJsonStreamReader::toInteger() const
+{
+    return isInteger() ? d_func()->integer : 0;
+}
+
+/*!
+    Returns the current number, or 0 if the current token is not a number.
+*/
+double QJsonStreamReader::toDouble() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Number ? d->number : 0;
+}
+
+/*!
+    Returns the current boolean, or \c false if the current token is not a
+    boolean.
+*/
+bool QJsonStreamReader::toBool() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Bool && d->boolean;
+}
+
+/*!
+    Returns the value of the current String, Number, Bool or Null token, or
+    an undefined QJsonValue for other tokens.
+
+    \sa readValue()
+*/
+QJsonValue QJsonStreamReader::value() const
+{
+    Q_D(const QJsonStreamReader);
+    switch (d->type) {
+    case String:
+        return d->text;
+    case Number:
+        return d->numberIsInteger ? QJsonValue(d->integer) : QJsonValue(d->number);
+    case Bool:
+        return d->boolean;
+    case Null:
+        return QJsonValue(QJsonValue::Null);
+    default:
+        return QJsonValue(QJsonValue::Undefined);
+    }
+}
+
+/*!
+    Reads the complete value that starts with the current token and returns
+    it. On a StartArray or StartObject token, the whole container is read
+    and the reader is left on the matching EndArray or EndObject token. On
+    scalar tokens this is the same as value().
+
+    If the input ends before the container does, an undefined QJsonValue is
+    returned, error() is PrematureEndOfDocumentError and the reader stays on
+    the start token, so that the call can be repeated once more data is
+    available.
+
+    \sa skipCurrentValue()
+*/
+QJsonValue QJsonStreamReader::readValue()
+{
+    Q_D(QJsonStreamReader);
+    if (d->type != StartArray && d->type != StartObject)
+        return value();
+
+    d->error = NoError;
+    qsizetype end;
+    if (d->findContainerEnd(&end) != LexOk) {
+        d->scanned = d->buffer.size();
+        d->error = PrematureEndOfDocumentError;
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    QJsonPrivate::Parser parser(d->buffer.constData() + d->tokenStart, int(end - d->tokenStart));
+    QJsonParseError parseError;
+    const QCborValue container = parser.parse(&parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        d->setParseError(parseError.error, d->tokenStart + parseError.offset);
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    d->pos = end;
+    d->endContainer();
+    return QJsonPrivate::Value::fromTrustedCbor(container);
+}
+
+/*!
+    Skips the array or object that starts with the current token and leaves
+    the reader on its EndArray or EndObject token, without validating the
+    skipped contents beyond the nesting of brackets. Does nothing on other
+    tokens. Returns \c false if the input ended before the container did;
+    the call can be repeated once more data is available.
+
+    \sa readValue()
+*/
+bool QJsonStreamReader::skipCurrentValue()
+{
+    Q_D(QJsonStreamReader);
+    if (d->type != StartArray && d->type != StartObject)
+        return d->error != NotWellFormedError;
+
+    d->error = NoError;
+    qsizetype end;
+    if (d->findContainerEnd(&end) != LexOk) {
+        d->scanned = d->buffer.size();
+        d->error = PrematureEndOfDocumentError;
+        return false;
+    }
+    d->pos = end;
+    d->endContainer();
+    return true;
+}
+
+/*!
+    Returns the current error, or NoError.
+
+    \sa errorString(), hasError()
+*/
+QJsonStreamReader::Error QJsonStreamReader::error() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->error;
+}
+
+/*!
+    Returns a human-readable description of the current error, including
+    its offset in the input for NotWellFormedError.
+*/
+QString QJsonStreamReader::errorString() const
+{
+    Q_D(const QJsonStreamReader);
+    switch (d->error) {
+    case NoError:
+        break;
+    case NotWellFormedError: {
+        QJsonParseError parseError;
+        parseError.error = d->parseError;
+        parseError.offset = int(d->errorOffset);
+        return QCoreApplication::translate("QJsonStreamReader", "%1 at offset %2")
+                .arg(parseError.errorString()).arg(d->errorOffset);
+    }
+    case PrematureEndOfDocumentError:
+        return QCoreApplication::translate("QJsonStreamReader", "premature end of document");
+    }
+    return QString();
+}
+
+/*!
+    \fn bool QJsonStreamReader::hasError() const
+
+    Returns \c true if error() is not NoError.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isStartArray() const
+
+    Returns \c true if tokenType() is StartArray.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndArray() const
+
+    Returns \c true if tokenType() is EndArray.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isStartObject() const
+
+    Returns \c true if tokenType() is StartObject.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndObject() const
+
+    Returns \c true if tokenType() is EndObject.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isName() const
+
+    Returns \c true if tokenType() is Name.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isString() const
+
+    Returns \c true if tokenType() is String.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isNumber() const
+
+    Returns \c true if tokenType() is Number.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isBool() const
+
+    Returns \c true if tokenType() is Bool.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isNull() const
+
+    Returns \c true if tokenType() is Null.
+*/
+
+QT_END_NAMESPACE
+
+#include "moc_qjsonstreamreader.cpp"
@@ -0,0 +1,582 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qjsonstreamwriter.h"
+
+#include <qiodevice.h>
+#include <qjsonarray.h>
+#include <qjsonobject.h>
+#include <qvarlengtharray.h>
+
+#include "qjson_p.h"
+#include "qjsonwriter_p.h"
+#include <private/qcborvalue_p.h>
+#include <private/qutfcodec_p.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QJsonPrivate;
+
+class QJsonStreamWriterPrivate
+{
+public:
+    enum { FlushThreshold = 16 * 1024 };
+
+    struct Level {
+        bool isObject;
+        bool isEmpty;
+    };
+
+    QIODevice *device = nullptr;
+    QByteArray *output;             // &buffer, or the array passed by the user
+    QByteArray buffer;
+    QVarLengthArray<Level, 16> levels;
+    bool compact = false;
+    bool afterName = false;
+    bool needsLineBreak = false;    // after a compact top-level value
+    bool error = false;
+
+    QJsonStreamWriterPrivate() : output(&buffer) {}
+
+    void reset();
+    void indent(int level);
+    void startValue();
+    void startName();
+    void endValue();
+    void start(char bracket, bool isObject);
+    void end(char bracket, bool isObject);
+    void writeContainer(const QCborContainerPrivate *c, bool isObject);
+    void writeElement(const QCborContainerPrivate *c, qsizetype idx);
+    bool flush();
+};
+
+void QJsonStreamWriterPrivate::reset()
+{
+    buffer.clear();
+    levels.clear();
+    afterName = false;
+    needsLineBreak = false;
+    error = false;
+}
+
+void QJsonStreamWriterPrivate::indent(int level)
+{
+    if (compact || !level)
+        return;
+    const int size = output->size();
+    output->resize(size + 4 * level);
+    memset(output->data() + size, ' ', 4 * level);
+}
+
+// writes what precedes a value: separators and indentation
+void QJsonStreamWriterPrivate::startValue()
+{
+    if (afterName) {
+        afterName = false;
+        return;
+    }
+    if (levels.isEmpty()) {
+        // top-level values after the first one are on a line of their own
+        if (needsLineBreak)
+            *output += '\n';
+        needsLineBreak = false;
+        return;
+    }
+
+    Level &level = levels.last();
+    Q_ASSERT_X(!level.isObject, "QJsonStreamWriter", "object members need a name");
+    if (!level.isEmpty)
+        *output += compact ? "," : ",\n";
+    level.isEmpty = false;
+    indent(levels.size());
+}
+
+void QJsonStreamWriterPrivate::startName()
+{
+    Q_ASSERT_X(!levels.isEmpty() && levels.last().isObject && !afterName,
+               "QJsonStreamWriter", "names can only be written in objects, before a value");
+    Level &level = levels.last();
+    if (!level.isEmpty)
+        *output += compact ? "," : ",\n";
+    level.isEmpty = false;
+    indent(levels.size());
+}
+
+void QJsonStreamWriterPrivate::endValue()
+{
+    if (levels.isEmpty()) {
+        if (compact)
+            needsLineBreak = true;
+        else
+            *output += '\n';
+    }
+    if (device && buffer.size() >= FlushThreshold)
+        flush();
+}
+
+void QJsonStreamWriterPrivate::start(char bracket, bool isObject)
+{
+    startValue();
+    *output += bracket;
+    if (!compact)
+        *output += '\n';
+    levels.append({ isObject, true });
+}
+
+void QJsonStreamWriterPrivate::end(char bracket, bool isObject)
+{
+    Q_ASSERT_X(!levels.isEmpty() && levels.last().isObject == isObject && !afterName,
+               "QJsonStreamWriter", "unbalanced end of array or object");
+    if (levels.isEmpty())
+        return;
+
+    const Level level = levels.last();
+    levels.removeLast();
+    if (!level.isEmpty && !compact)
+        *output += '\n';
+    indent(levels.size());
+    *output += bracket;
+    endValue();
+}
+
+void QJsonStreamWriterPrivate::writeContainer(const QCborContainerPrivate *c, bool isObject)
+{
+    start(isObject ? '{' : '[', isObject);
+    const qsizetype size = c ? c->elements.size() : 0;
+    if (isObject) {
+        for (qsizetype i = 0; i + 1 < size; i += 2) {
+            startName();
+            Writer::scalarToJson(c, i, *output);
+            *output += compact ? ":" : ": ";
+            afterName = true;
+            writeElement(c, i + 1);
+        }
+    } else {
+        for (qsizetype i = 0; i < size; ++i)
+            writeElement(c, i);
+    }
+    end(isObject ? '}' : ']', isObject);
+}
+
+void QJsonStreamWriterPrivate::writeElement(const QCborContainerPrivate *c, qsizetype idx)
+{
+    const QtCbor::Element &e = c->elements.at(idx);
+    if (e.type == QCborValue::Array || e.type == QCborValue::Map) {
+        writeContainer(e.flags & QtCbor::Element::IsContainer ? e.container : nullptr,
+                       e.type == QCborValue::Map);
+        return;
+    }
+    startValue();
+    Writer::scalarToJson(c, idx, *output);
+    endValue();
+}
+
+bool QJsonStreamWriterPrivate::flush()
+{
+    if (!device || buffer.isEmpty())
+        return !error;
+    if (device->write(buffer) != buffer.size())
+        error = true;
+    buffer.clear();
+    return !error;
+}
+
+/*!
+    \class QJsonStreamWriter
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 5.15
+
+    \brief The QJsonStreamWriter class writes JSON text to a QIODevice as it
+    is produced.
+
+    QJsonDocument::toJson() returns the whole document as one QByteArray,
+    which needs a complete QJsonDocument in memory first and as much memory
+    again for the result. QJsonStreamWriter, like QXmlStreamWriter and
+    QCborStreamWriter, writes each value as it is passed in and sends the
+    text to the device in chunks, so that the memory needed is independent
+    of the size of the document.
+
+    Arrays and objects are opened with startArray() and startObject() and
+    closed with endArray() and endObject(). Inside an object, every value is
+    preceded by a call to writeName(). Values are written with writeValue(),
+    which also accepts complete QJsonArray and QJsonObject values, and with
+    writeNull().
+
+    \snippet code/src_corelib_serialization_qjsonstreamwriter.cpp 0
+
+    The format, set with setFormat(), is the same as that of
+    QJsonDocument::toJson(): writing the contents of a document with either
+    class produces identical output. Several top-level values can be written
+    one after the other; they are separated by line breaks, which makes the
+    result suitable for newline-delimited JSON.
+
+    The writer buffers its output and writes to the device whenever a value
+    is complete and the buffer holds enough data, when flush() is called, and
+    when the writer is destroyed. If writing to the device fails, hasError()
+    returns \c true.
+
+    \sa QJsonStreamReader, QJsonDocument::toJson()
+*/
+
+/*!
+    Constructs a writer without a device. Use setDevice() to set it.
+*/
+QJsonStreamWriter::QJsonStreamWriter()
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+}
+
+/*!
+    Constructs a writer that writes to \a device, which must already be
+    open for writing.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QIODevice *device)
+    : QJsonStreamWriter()
+{
+    setDevice(device);
+}
+
+/*!
+    Constructs a writer that appends to \a data. The text is available in
+    \a data as soon as each value is written.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QByteArray *data)
+    : QJsonStreamWriter()
+{
+    d_func()->output = data;
+}
+
+/*!
+    Flushes the buffered output to the device and destroys the writer.
+*/
+QJsonStreamWriter::~QJsonStreamWriter()
+{
+    flush();
+}
+
+/*!
+    Flushes the buffered output to the current device, then makes the writer
+    write to \a device and resets it to its initial state. The writer does
+    not take ownership of the device.
+
+    \sa device()
+*/
+void QJsonStreamWriter::setDevice(QIODevice *device)
+{
+    Q_D(QJsonStreamWriter);
+    d->flush();
+    d->reset();
+    d->device = device;
+    d->output = &d->buffer;
+}
+
+/*!
+    Returns the device the writer writes to, or \nullptr.
+*/
+QIODevice *QJsonStreamWriter::device() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->device;
+}
+
+/*!
+    Sets the \a format of the output. The default is
+    QJsonDocument::Indented. Changing it in the middle of a document
+    produces valid JSON, but it will not be formatted consistently.
+*/
+void QJsonStreamWriter::setFormat(QJsonDocument::JsonFormat format)
+{
+    Q_D(QJsonStreamWriter);
+    d->compact = format == QJsonDocument::Compact;
+}
+
+/*!
+    Returns the format of the output.
+*/
+QJsonDocument::JsonFormat QJsonStreamWriter::format() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->compact ? QJsonDocument::Compact : QJsonDocument::Indented;
+}
+
+/*!
+    Starts an array. Its elements are the values written until the matching
+    endArray().
+*/
+void QJsonStreamWriter::startArray()
+{
+    Q_D(QJsonStreamWriter);
+    d->start('[', false);
+}
+
+/*!
+    Ends the current array.
+*/
+void QJsonStreamWriter::endArray()
+{
+    Q_D(QJsonStreamWriter);
+    d->end(']', false);
+}
+
+/*!
+    Starts an object. Its members are written as pairs of writeName() and a
+    value, until the matching endObject().
+*/
+void QJsonStreamWriter::startObject()
+{
+    Q_D(QJsonStreamWriter);
+    d->start('{', true);
+}
+
+/*!
+    Ends the current object.
+*/
+void QJsonStreamWriter::endObject()
+{
+    Q_D(QJsonStreamWriter);
+    d->end('}', true);
+}
+
+/*!
+    Writes \a name as the name of the next member of the current object.
+    It must be followed by the member's value.
+*/
+void QJsonStreamWriter::writeName(QStringView name)
+{
+    Q_D(QJsonStreamWriter);
+    d->startName();
+    Writer::stringToJson(name, *d->output);
+    *d->output += d->compact ? ":" : ": ";
+    d->afterName = true;
+}
+
+/*!
+    \overload
+*/
+void QJsonStreamWriter::writeName(QLatin1String name)
+{
+    if (!QtPrivate::isAscii(name))
+        return writeName(QString(name));
+
+    Q_D(QJsonStreamWriter);
+    d->startName();
+    Writer::utf8StringToJson(name.data(), name.size(), *d->output);
+    *d->output += d->compact ? ":" : ": ";
+    d->afterName = true;
+}
+
+/*!
+    Writes \a value. Arrays and objects are written completely, flushing the
+    output to the device as it grows, so that writing a large QJsonArray or
+    QJsonObject does not need a second copy of it in memory. An undefined
+    value is written as null.
+*/
+void QJsonStreamWriter::writeValue(const QJsonValue &value)
+{
+    Q_D(QJsonStreamWriter);
+    const QCborContainerPrivate *container = QJsonPrivate::Value::container(value);
+    switch (value.type()) {
+    case QJsonValue::Array:
+    case QJsonValue::Object:
+        d->writeContainer(container, value.isObject());
+        return;
+    case QJsonValue::String:
+        if (container) {
+            d->startValue();
+            Writer::scalarToJson(container, QJsonPrivate::Value::valueHelper(value), *d->output);
+            d->endValue();
+            return;
+        }
+        return writeValue(QStringView());
+    case QJsonValue::Bool:
+        return writeValue(value.toBool());
+    case QJsonValue::Double:
+        return writeValue(value.toDouble());
+    case QJsonValue::Null:
+    case QJsonValue::Undefined:
+        return writeNull();
+    }
+}
+
+/*!
+    \fn void QJsonStreamWriter::writeValue(const QString &value)
+    \overload
+*/
+
+/*!
+    \overload
+*/
+void QJsonStreamWriter::writeValue(QStringView value)
+{
+    Q_D(QJsonStreamWriter);
+    d->startValue();
+    Writer::stringToJson(value, *d->output);
+    d->endValue();
+}
+
+/*!
+    \overload
+*/
+void QJsonStreamWriter::writeValue(QLatin1String value)
+{
+    if (!QtPrivate::isAscii(value))
+        return writeValue(QString(value));
+
+    Q_D(QJsonStreamWriter);
+    d->startValue();
+    Writer::utf8StringToJson(value.data(), value.size(), *d->output);
+    d->endValue();
+}
+
+/*!
+    \overload
+
+    Writes the UTF-8 string \a utf8 of \a len bytes, or up to the
+    terminating null character if \a len is -1. Invalid UTF-8 sequences are
+    replaced, as with QString::fromUtf8().
+*/
+void QJsonStreamWriter::writeValue(const char *utf8, qsizetype len)
+{
+    if (len < 0)
+        len = utf8 ? qsizetype(strlen(utf8)) : 0;
+    if (!QUtf8::isValidUtf8(utf8, len).isValidUtf8)
+        return writeValue(QString::fromUtf8(utf8, int(len)));
+
+    Q_D(QJsonStreamWriter);
+    d->startValue();
+    Writer::utf8StringToJson(utf8, len, *d->output);
+    d->endValue();
+}
+
+/*!
+    \overload
+*/
+void QJsonStreamWriter::writeValue(bool value)
+{
+    Q_D(QJsonStreamWriter);
+    d->startValue();
+    *d->output += value ? "true" : "false";
+    d->endValue();
+}
+
+/*!
+    \overload
+
+    Writes \a value in the shortest form that reads back as the same
+    number. Infinities and NaN are written as null, as JSON has no
+    representation for them.
+*/
+void QJsonStreamWriter::writeValue(double value)
+{
+    Q_D(QJsonStreamWriter);
+    d->startValue();
+    Writer::numberToJson(value, *d->output);
+    d->endValue();
+}
+
+/*!
+    \overload
+
+    Like QJsonValue, this treats integers as doubles: integers beyond 2^53
+    may lose precision.
+*/
+void QJsonStreamWriter::writeValue(qint64 value)
+{
+    Q_D(QJsonStreamWriter);
+    d->startValue();
+    Writer::integerToJson(value, *d->output);
+    d->endValue();
+}
+
+/*!
+    \fn void QJsonStreamWriter::writeValue(int value)
+    \overload
+*/
+
+/*!
+    Writes null.
+*/
+void QJsonStreamWriter::writeNull()
+{
+    Q_D(QJsonStreamWriter);
+    d->startValue();
+    *d->output += "null";
+    d->endValue();
+}
+
+/*!
+    Writes the array or object of \a document as a top-level value. The
+    output is the same as that of QJsonDocument::toJson() in the current
+    format(). Does nothing if the document is null.
+*/
+void QJsonStreamWriter::writeDocument(const QJsonDocument &document)
+{
+    if (document.isArray())
+        writeValue(document.array());
+    else if (document.isObject())
+        writeValue(document.object());
+}
+
+/*!
+    Writes the buffered output to the device. Returns \c false if writing
+    to the device failed, now or earlier.
+
+    \sa hasError()
+*/
+bool QJsonStreamWriter::flush()
+{
+    Q_D(QJsonStreamWriter);
+    return d->flush();
+}
+
+/*!
+    Returns \c true if writing to the device failed.
+*/
+bool QJsonStreamWriter::hasError() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->error;
+}
+
+QT_END_NAMESPACE
@@ -43,6 +43,8 @@
 #include "qjsonwriter_p.h"
 #include "qjson_p.h"
 #include "private/qutfcodec_p.h"
+#include <private/qlocale_p.h>
+#include <private/qlocale_tools_p.h>
 #include <private/qnumeric_p.h>
 #include <private/qcborvalue_p.h>
 
@@ -58,60 +60,78 @@ static inline uchar hexdig(uint u)
     return (u < 0xa ? '0' + u : 'a' + u - 0xa);
 }
 
-static QByteArray escapedString(const QString &s)
+static inline uchar *escapeAscii(uchar *cursor, uint u)
 {
-    QByteArray ba(s.length(), Qt::Uninitialized);
+    *cursor++ = '\\';
+    switch (u) {
+    case 0x22:
+        *cursor++ = '"';
+        break;
+    case 0x5c:
+        *cursor++ = '\\';
+        break;
+    case 0x8:
+        *cursor++ = 'b';
+        break;
+    case 0xc:
+        *cursor++ = 'f';
+        break;
+    case 0xa:
+        *cursor++ = 'n';
+        break;
+    case 0xd:
+        *cursor++ = 'r';
+        break;
+    case 0x9:
+        *cursor++ = 't';
+        break;
+    default:
+        *cursor++ = 'u';
+        *cursor++ = '0';
+        *cursor++ = '0';
+        *cursor++ = hexdig(u>>4);
+        *cursor++ = hexdig(u & 0xf);
+    }
+    return cursor;
+}
+
+static inline bool needsEscape(uchar c)
+{
+    return c < 0x20 || c == 0x22 || c == 0x5c;
+}
 
-    uchar *cursor = reinterpret_cast<uchar *>(const_cast<char *>(ba.constData()));
-    const uchar *ba_end = cursor + ba.length();
-    const ushort *src = reinterpret_cast<const ushort *>(s.constBegin());
-    const ushort *const end = reinterpret_cast<const ushort *>(s.constEnd());
+/*!
+    \internal
+    Appends \a s to \a json as a quoted JSON string.
+*/
+void Writer::stringToJson(QStringView s, QByteArray &json)
+{
+    // the result needs at least one byte per character, more for escapes
+    // and non-ASCII characters
+    int pos = json.size();
+    json.resize(pos + s.size() + 2);
+
+    uchar *cursor = reinterpret_cast<uchar *>(json.data()) + pos;
+    const uchar *ba_end = reinterpret_cast<const uchar *>(json.constData()) + json.size();
+    const ushort *src = reinterpret_cast<const ushort *>(s.begin());
+    const ushort *const end = reinterpret_cast<const ushort *>(s.end());
 
+    *cursor++ = '"';
     while (src != end) {
-        if (cursor >= ba_end - 6) {
-            // ensure we have enough space
-            int pos = cursor - (const uchar *)ba.constData();
-            ba.resize(ba.size()*2);
-            cursor = (uchar *)ba.data() + pos;
-            ba_end = (const uchar *)ba.constData() + ba.length();
+        if (cursor >= ba_end - 7) {
+            // ensure we have enough space, including the closing quote
+            pos = cursor - reinterpret_cast<const uchar *>(json.constData());
+            json.resize(json.size() * 2);
+            cursor = reinterpret_cast<uchar *>(json.data()) + pos;
+            ba_end = reinterpret_cast<const uchar *>(json.constData()) + json.size();
         }
 
         uint u = *src++;
         if (u < 0x80) {
-            if (u < 0x20 || u == 0x22 || u == 0x5c) {
-                *cursor++ = '\\';
-                switch (u) {
-                case 0x22:
-                    *cursor++ = '"';
-                    break;
-                case 0x5c:
-                    *cursor++ = '\\';
-                    break;
-                case 0x8:
-                    *cursor++ = 'b';
-                    break;
-                case 0xc:
-                    *cursor++ = 'f';
-                    break;
-                case 0xa:
-                    *cursor++ = 'n';
-                    break;
-                case 0xd:
-                    *cursor++ = 'r';
-                    break;
-                case 0x9:
-                    *cursor++ = 't';
-                    break;
-                default:
-                    *cursor++ = 'u';
-                    *cursor++ = '0';
-                    *cursor++ = '0';
-                    *cursor++ = hexdig(u>>4);
-                    *cursor++ = hexdig(u & 0xf);
-               }
-            } else {
+            if (needsEscape(u))
+                cursor = escapeAscii(cursor, u);
+            else
                 *cursor++ = (uchar)u;
-            }
         } else if (QUtf8Functions::toUtf8<QUtf8BaseTraits>(u, cursor, src, end) < 0) {
             // failed to get valid utf8 use JSON escape sequence
             *cursor++ = '\\';
@@ -122,15 +142,162 @@ static QByteArray escapedString(const QString &s)
             *cursor++ = hexdig(u & 0x0f);
         }
     }
+    *cursor++ = '"';
 
-    ba.resize(cursor - (const uchar *)ba.constData());
-    return ba;
+    json.resize(cursor - reinterpret_cast<const uchar *>(json.constData()));
 }
 
-static void valueToJson(const QCborValue &v, QByteArray &json, int indent, bool compact)
+/*!
+    \internal
+    Appends the valid UTF-8 string \a utf8 of \a len bytes to \a json as a
+    quoted JSON string. This is what stringToJson() produces for the same
+    string in UTF-16, without the conversion.
+*/
+void Writer::utf8StringToJson(const char *utf8, qsizetype len, QByteArray &json)
 {
-    QCborValue::Type type = v.type();
-    switch (type) {
+    const uchar *src = reinterpret_cast<const uchar *>(utf8);
+    const uchar *const end = src + len;
+
+    json.reserve(json.size() + int(len) + 2);
+    json += '"';
+    while (src != end) {
+        const uchar *plain = src;
+        while (src != end && !needsEscape(*src))
+            ++src;
+        if (src != plain)
+            json.append(reinterpret_cast<const char *>(plain), int(src - plain));
+        if (src == end)
+            break;
+
+        uchar escaped[6];
+        json.append(reinterpret_cast<const char *>(escaped),
+                    int(escapeAscii(escaped, *src++) - escaped));
+    }
+    json += '"';
+}
+
+static void unsignedToJson(quint64 value, bool negative, QByteArray &json)
+{
+    char buf[24];
+    char *const end = buf + sizeof(buf);
+    char *p = end;
+    do {
+        *--p = char('0' + value % 10);
+        value /= 10;
+    } while (value);
+    if (negative)
+        *--p = '-';
+    json.append(p, int(end - p));
+}
+
+/*!
+    \internal
+    Appends \a d to \a json in the shortest form that reads back as the same
+    value. The result is the same as from QByteArray::number() with
+    QLocale::FloatingPointShortest and format 'f' for integers or 'g' for
+    other numbers, without the temporary strings.
+*/
+void Writer::numberToJson(double d, QByteArray &json)
+{
+    if (!qIsFinite(d)) {
+        json += "null"; // +INF || -INF || NaN (see RFC4627#section2.4)
+        return;
+    }
+
+    // integers that doubles represent exactly are their own shortest form
+    const double absolute = std::abs(d);
+    quint64 absInt;
+    const bool isInteger = convertDoubleTo(absolute, &absInt);
+    if (isInteger && absInt <= (Q_UINT64_C(1) << 53)) {
+        unsignedToJson(absInt, d < 0 && absInt, json);
+        return;
+    }
+
+    char digits[QLocaleData::DoubleMaxSignificant + 1];
+    bool negative;
+    int length;
+    int decpt;
+    qt_doubleToAscii(d, QLocaleData::DFSignificantDigits, QLocale::FloatingPointShortest,
+                     digits, sizeof(digits), negative, length, decpt);
+
+    char buf[QLocaleData::DoubleMaxSignificant + 32];
+    char *p = buf;
+    if (negative)
+        *p++ = '-';
+
+    bool exponentForm = false;
+    if (!isInteger && decpt != length) {
+        // choose the shorter form, as QLocaleData::doubleToString() does
+        int cutoff = 6;
+        if (decpt > 0) {
+            cutoff = length + 4;
+            cutoff += decpt > 100 ? 2 : 1;
+            if (length > decpt)
+                ++cutoff;
+        }
+        exponentForm = decpt <= -4 || decpt > cutoff;
+    }
+
+    if (exponentForm) {
+        *p++ = digits[0];
+        if (length > 1) {
+            *p++ = '.';
+            memcpy(p, digits + 1, length - 1);
+            p += length - 1;
+        }
+        int exponent = decpt - 1;
+        *p++ = 'e';
+        *p++ = exponent < 0 ? '-' : '+';
+        exponent = std::abs(exponent);
+        if (exponent >= 100)
+            *p++ = char('0' + exponent / 100);
+        *p++ = char('0' + exponent / 10 % 10);
+        *p++ = char('0' + exponent % 10);
+    } else if (decpt <= 0) {
+        *p++ = '0';
+        *p++ = '.';
+        memset(p, '0', -decpt);
+        p += -decpt;
+        memcpy(p, digits, length);
+        p += length;
+    } else if (decpt >= length) {
+        memcpy(p, digits, length);
+        p += length;
+        memset(p, '0', decpt - length);
+        p += decpt - length;
+    } else {
+        memcpy(p, digits, decpt);
+        p += decpt;
+        *p++ = '.';
+        memcpy(p, digits + decpt, length - decpt);
+        p += length - decpt;
+    }
+    json.append(buf, int(p - buf));
+}
+
+/*!
+    \internal
+    Appends \a i to \a json. Like QJsonValue, this treats integers as
+    doubles, so large ones may lose precision.
+*/
+void Writer::integerToJson(qint64 i, QByteArray &json)
+{
+    const quint64 absInt = i < 0 ? quint64(-(i + 1)) + 1 : quint64(i);
+    if (absInt <= (Q_UINT64_C(1) << 53))
+        unsignedToJson(absInt, i < 0, json);
+    else
+        numberToJson(double(i), json);
+}
+
+/*!
+    \internal
+    Appends the string, number, boolean or null at \a idx in \a d to \a json.
+    Returns false for arrays and objects, which the caller handles.
+*/
+bool Writer::scalarToJson(const QCborContainerPrivate *d, qsizetype idx, QByteArray &json)
+{
+    const QtCbor::Element &e = d->elements.at(idx);
+    switch (e.type) {
     case QCborValue::True:
         json += "true";
         break;
@@ -138,39 +305,50 @@ static void valueToJson(const QCborValue &v, QByteArray &json, int indent, bool
         json += "false";
         break;
     case QCborValue::Integer:
-    case QCborValue::Double: {
-        const double d = v.toDouble();
-        if (qIsFinite(d)) {
-            quint64 absInt;
-            json += QByteArray::number(d, convertDoubleTo(std::abs(d), &absInt) ? 'f' : 'g',
-                                       QLocale::FloatingPointShortest);
-        } else {
-            json += "null"; // +INF || -INF || NaN (see RFC4627#section2.4)
-        }
+        integerToJson(e.value, json);
         break;
-    }
-    case QCborValue::String:
-        json += '"';
-        json += escapedString(v.toString());
-        json += '"';
+    case QCborValue::Double:
+        numberToJson(e.fpvalue(), json);
         break;
+    case QCborValue::String: {
+        const QtCbor::ByteDataRef b = d->byteData(e);
+        if (!b)
+            json += "\"\"";
+        else if (e.flags & QtCbor::Element::StringIsUtf16)
+            stringToJson(b->asStringView(), json);
+        else
+            utf8StringToJson(b->byte(), b->len, json);
+        break;
+    }
     case QCborValue::Array:
+    case QCborValue::Map:
+        return false;
+    case QCborValue::Null:
+    default:
+        json += "null";
+    }
+    return true;
+}
+
+static void valueToJson(const QCborContainerPrivate *d, qsizetype idx, QByteArray &json,
+                        int indent, bool compact)
+{
+    if (Writer::scalarToJson(d, idx, json))
+        return;
+
+    const QtCbor::Element &e = d->elements.at(idx);
+    const QCborContainerPrivate *container = e.flags & QtCbor::Element::IsContainer
+            ? e.container : nullptr;
+    if (e.type == QCborValue::Array) {
         json += compact ? "[" : "[\n";
-        arrayContentToJson(
-                QJsonPrivate::Value::container(v), json, indent + (compact ? 0 : 1), compact);
+        arrayContentToJson(container, json, indent + (compact ? 0 : 1), compact);
         json += QByteArray(4*indent, ' ');
         json += ']';
-        break;
-    case QCborValue::Map:
+    } else {
         json += compact ? "{" : "{\n";
-        objectContentToJson(
-                QJsonPrivate::Value::container(v), json, indent + (compact ? 0 : 1), compact);
+        objectContentToJson(container, json, indent + (compact ? 0 : 1), compact);
         json += QByteArray(4*indent, ' ');
         json += '}';
-        break;
-    case QCborValue::Null:
-    default:
-        json += "null";
     }
 }
 
@@ -184,7 +362,7 @@ static void arrayContentToJson(const QCborContainerPrivate *a, QByteArray &json,
     qsizetype i = 0;
     while (true) {
         json += indentString;
-        valueToJson(a->valueAt(i), json, indent, compact);
+        valueToJson(a, i, json, indent, compact);
 
         if (++i == a->elements.size()) {
             if (!compact)
@@ -206,12 +384,10 @@ static void objectContentToJson(const QCborContainerPrivate *o, QByteArray &json
 
     qsizetype i = 0;
     while (true) {
-        QCborValue e = o->valueAt(i);
         json += indentString;
-        json += '"';
-        json += escapedString(o->valueAt(i).toString());
-        json += compact ? "\":" : "\": ";
-        valueToJson(o->valueAt(i + 1), json, indent, compact);
+        Writer::scalarToJson(o, i, json);
+        json += compact ? ":" : ": ";
+        valueToJson(o, i + 1, json, indent, compact);
 
         if ((i += 2) == o->elements.size()) {
             if (!compact)
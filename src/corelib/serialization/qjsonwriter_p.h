@@ -64,6 +64,12 @@ class Writer
 public:
     static void objectToJson(const QCborContainerPrivate *o, QByteArray &json, int indent, bool compact = false);
     static void arrayToJson(const QCborContainerPrivate *a, QByteArray &json, int indent, bool compact = false);
+
+    static bool scalarToJson(const QCborContainerPrivate *d, qsizetype idx, QByteArray &json);
+    static void stringToJson(QStringView s, QByteArray &json);
+    static void utf8StringToJson(const char *utf8, qsizetype len, QByteArray &json);
+    static void numberToJson(double d, QByteArray &json);
+    static void integerToJson(qint64 i, QByteArray &json);
 };
 
 }
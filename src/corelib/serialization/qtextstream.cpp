@@ -495,29 +495,28 @@ bool QTextStreamPrivate::fillReadBuffer(qint64 maxBytes)
 
     // remove all '\r\n' in the string.
     if (readBuffer.size() > oldReadBufferSize && textModeEnabled) {
-        QChar CR = QLatin1Char('\r');
         QChar *writePtr = readBuffer.data() + oldReadBufferSize;
-        QChar *readPtr = readBuffer.data() + oldReadBufferSize;
-        QChar *endPtr = readBuffer.data() + readBuffer.size();
+        const QChar *readPtr = writePtr;
+        const QChar *endPtr = readBuffer.constData() + readBuffer.size();
 
+        // move the text between carriage returns in blocks
         int n = oldReadBufferSize;
-        if (readPtr < endPtr) {
-            // Cut-off to avoid unnecessary self-copying.
-            while (*readPtr++ != CR) {
-                ++n;
-                if (++writePtr == endPtr)
-                    break;
-            }
-        }
-        while (readPtr < endPtr) {
-            QChar ch = *readPtr++;
-            if (ch != CR) {
-                *writePtr++ = ch;
-            } else {
-                if (n < readBufferOffset)
-                    --readBufferOffset;
-                --bytesRead;
-            }
+        for (;;) {
+            const qsizetype cr = QStringView(readPtr, endPtr).indexOf(QLatin1Char('\r'));
+            const int run = int(cr < 0 ? endPtr - readPtr : cr);
+            if (writePtr != readPtr)
+                memmove(writePtr, readPtr, run * sizeof(QChar));
+            writePtr += run;
+            readPtr += run;
+            n += run;
+            if (readPtr == endPtr)
+                break;
+
+            // skip the carriage return
+            if (n < readBufferOffset)
+                --readBufferOffset;
+            --bytesRead;
+            ++readPtr;
             ++n;
         }
         readBuffer.resize(writePtr - readBuffer.data());
@@ -665,35 +664,50 @@ bool QTextStreamPrivate::scan(const QChar **ptr, int *length, int maxlen, TokenD
             chPtr = string->constData();
             endOffset = string->size();
         }
-        chPtr += startOffset;
-
-        for (; !foundToken && startOffset < endOffset && (!maxlen || totalSize < maxlen); ++startOffset) {
-            const QChar ch = *chPtr++;
-            ++totalSize;
-
-            switch (delimiter) {
-            case Space:
-                if (ch.isSpace()) {
-                    foundToken = true;
-                    delimSize = 1;
-                }
-                break;
-            case NotSpace:
-                if (!ch.isSpace()) {
-                    foundToken = true;
-                    delimSize = 1;
-                }
-                break;
-            case EndOfLine:
-                if (ch == QLatin1Char('\n')) {
-                    foundToken = true;
-                    delimSize = (lastChar == QLatin1Char('\r')) ? 2 : 1;
-                    consumeDelimiter = true;
-                }
-                lastChar = ch;
-                break;
+        if (maxlen)
+            endOffset = qMin(endOffset, startOffset + qMax(0, maxlen - totalSize));
+
+        const QChar *const begin = chPtr + startOffset;
+        const QChar *const end = chPtr + endOffset;
+        const QChar *p = begin;
+        switch (delimiter) {
+        case Space:
+            while (p != end && !p->isSpace())
+                ++p;
+            if (p != end) {
+                foundToken = true;
+                delimSize = 1;
+                ++p;
+            }
+            break;
+        case NotSpace:
+            while (p != end && p->isSpace())
+                ++p;
+            if (p != end) {
+                foundToken = true;
+                delimSize = 1;
+                ++p;
+            }
+            break;
+        case EndOfLine: {
+            // lines are usually long enough to make a vectorized search pay off
+            const qsizetype lf = QStringView(begin, end).indexOf(QLatin1Char('\n'));
+            if (lf < 0) {
+                p = end;
+            } else {
+                p = begin + lf + 1;
+                foundToken = true;
+                const QChar beforeLf = lf ? begin[lf - 1] : lastChar;
+                delimSize = (beforeLf == QLatin1Char('\r')) ? 2 : 1;
+                consumeDelimiter = true;
             }
+            if (p != begin)
+                lastChar = p[-1];
+            break;
+        }
         }
+        totalSize += int(p - begin);
+        startOffset += int(p - begin);
     } while (!foundToken
              && (!maxlen || totalSize < maxlen)
              && (device && (canStillReadFromDevice = fillReadBuffer())));
@@ -1727,6 +1741,50 @@ bool QTextStream::readLineInto(QString *line, qint64 maxlen)
     return true;
 }
 
+/*!
+    \since 5.15
+
+    Reads one line of text from the stream and returns a view of it,
+    without copying the characters into a new QString. The maximum
+    allowed line length is set to \a maxlen; see readLine() for how
+    longer lines are split and how end-of-line characters are handled.
+
+    The returned view points into the stream's internal buffer (or into
+    the string the stream operates on) and stays valid until the next
+    call that reads from, seeks or resets the stream. Use
+    QStringView::toString() to keep the line for longer.
+
+    Returns a null view if the stream has read to the end of the file or
+    an error has occurred; an empty line is returned as an empty but
+    non-null view.
+
+    This is the fastest way to process a large text file line by line:
+
+    \snippet code/src_corelib_io_qtextstream.cpp 11
+
+    \sa readLineInto(), readLine()
+*/
+QStringView QTextStream::readLineView(qint64 maxlen)
+{
+    Q_D(QTextStream);
+    CHECK_VALID_STREAM(QStringView());
+
+    const QChar *readPtr;
+    int length;
+    if (!d->scan(&readPtr, &length, int(maxlen), QTextStreamPrivate::EndOfLine))
+        return QStringView();
+
+    // Consuming the last chunk of the read buffer releases it, and
+    // consuming far into it moves the rest to the front. Keep a reference
+    // to the characters in either case, so that the view stays valid.
+    if (d->device && (d->readBufferOffset + d->lastTokenSize >= d->readBuffer.size()
+                      || d->readBufferOffset + d->lastTokenSize > QTEXTSTREAM_BUFFERSIZE)) {
+        d->lineViewBuffer = d->readBuffer;
+    }
+    d->consumeLastToken();
+    return QStringView(readPtr, length);
+}
+
 /*!
     \since 4.1
 
@@ -128,6 +128,7 @@ public:
 
     QString writeBuffer;
     QString readBuffer;
+    QString lineViewBuffer; // keeps the last readLineView() result alive
     int readBufferOffset;
     int readConverterSavedStateOffset; //the offset between readBufferStartDevicePos and that start of the buffer
     qint64 readBufferStartDevicePos;
@@ -70,6 +70,7 @@ public: \
 private:
 #endif
 #include <private/qmemory_p.h>
+#include <private/qsimd_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -983,7 +984,13 @@ bool QXmlStreamReaderPrivate::scanUntil(const char *str, short tokenToInject)
     int oldLineNumber = lineNumber;
 
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    for (;;) {
+        /* Characters that can neither be invalid nor start str are copied
+           in blocks. */
+        fastScanRun(ushort(*str), ushort(*str));
+        if ((c = getChar()) == StreamEOF)
+            break;
+
         /* First, we do the validation & normalization. */
         switch (c) {
         case '\r':
@@ -1143,6 +1150,122 @@ bool QXmlStreamReaderPrivate::scanAttType()
     return false;
 }
 
+/*!
+ \internal
+
+ Returns a pointer to the first character in [\a ptr, \a end) that is a
+ control character, one of the non-characters U+FFFE and U+FFFF, or equal to
+ one of \a c1 to \a c4. Eight characters are tested at a time where SIMD
+ instructions are available.
+ */
+static const ushort *findXmlDelimiter(const ushort *ptr, const ushort *end,
+                                      ushort c1, ushort c2, ushort c3, ushort c4)
+{
+#if defined(__SSE2__)
+    const __m128i controlMax = _mm_set1_epi16(0x1f);
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i nonCharacter = _mm_set1_epi16(-1);
+    const __m128i m1 = _mm_set1_epi16(short(c1));
+    const __m128i m2 = _mm_set1_epi16(short(c2));
+    const __m128i m3 = _mm_set1_epi16(short(c3));
+    const __m128i m4 = _mm_set1_epi16(short(c4));
+    for ( ; end - ptr >= 8; ptr += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        // c < 0x20 and c >= 0xfffe, using unsigned saturation
+        __m128i hit = _mm_cmpeq_epi16(_mm_subs_epu16(data, controlMax), _mm_setzero_si128());
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi16(_mm_adds_epu16(data, one), nonCharacter));
+        hit = _mm_or_si128(hit, _mm_or_si128(_mm_cmpeq_epi16(data, m1), _mm_cmpeq_epi16(data, m2)));
+        hit = _mm_or_si128(hit, _mm_or_si128(_mm_cmpeq_epi16(data, m3), _mm_cmpeq_epi16(data, m4)));
+        const uint mask = uint(_mm_movemask_epi8(hit));
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask) / 2;
+    }
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64) // vaddv is only available on Aarch64
+    const uint16x8_t vmask = { 1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7 };
+    const uint16x8_t controlEnd = vdupq_n_u16(0x20);
+    const uint16x8_t nonCharacter = vdupq_n_u16(0xfffe);
+    const uint16x8_t m1 = vdupq_n_u16(c1);
+    const uint16x8_t m2 = vdupq_n_u16(c2);
+    const uint16x8_t m3 = vdupq_n_u16(c3);
+    const uint16x8_t m4 = vdupq_n_u16(c4);
+    for ( ; end - ptr >= 8; ptr += 8) {
+        const uint16x8_t data = vld1q_u16(ptr);
+        uint16x8_t hit = vorrq_u16(vcltq_u16(data, controlEnd), vcgeq_u16(data, nonCharacter));
+        hit = vorrq_u16(hit, vorrq_u16(vceqq_u16(data, m1), vceqq_u16(data, m2)));
+        hit = vorrq_u16(hit, vorrq_u16(vceqq_u16(data, m3), vceqq_u16(data, m4)));
+        const uint mask = vaddvq_u16(vandq_u16(hit, vmask));
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+#endif
+    for ( ; ptr != end; ++ptr) {
+        const ushort c = *ptr;
+        if (c < 0x20 || c >= 0xfffe || c == c1 || c == c2 || c == c3 || c == c4)
+            break;
+    }
+    return ptr;
+}
+
+/*!
+ \internal
+
+ Returns a pointer to the first character in [\a ptr, \a end) that is
+ neither a space nor a tab.
+ */
+static const ushort *skipXmlBlanks(const ushort *ptr, const ushort *end)
+{
+#if defined(__SSE2__)
+    const __m128i space = _mm_set1_epi16(' ');
+    const __m128i tab = _mm_set1_epi16('\t');
+    for ( ; end - ptr >= 8; ptr += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        const __m128i blank = _mm_or_si128(_mm_cmpeq_epi16(data, space), _mm_cmpeq_epi16(data, tab));
+        const uint mask = uint(_mm_movemask_epi8(blank)) ^ 0xffff;
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask) / 2;
+    }
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    const uint16x8_t vmask = { 1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7 };
+    const uint16x8_t space = vdupq_n_u16(' ');
+    const uint16x8_t tab = vdupq_n_u16('\t');
+    for ( ; end - ptr >= 8; ptr += 8) {
+        const uint16x8_t data = vld1q_u16(ptr);
+        const uint16x8_t blank = vorrq_u16(vceqq_u16(data, space), vceqq_u16(data, tab));
+        const uint mask = vaddvq_u16(vandq_u16(blank, vmask)) ^ 0xff;
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+#endif
+    while (ptr != end && (*ptr == ' ' || *ptr == '\t'))
+        ++ptr;
+    return ptr;
+}
+
+/*!
+ \internal
+
+ Copies the characters at the current read position up to the next
+ control character, non-character or one of \a delim1 to \a delim4 into
+ the text buffer in one go, so that the per-character code in the
+ scanners only needs to see the characters that need special treatment.
+ Returns the number of characters copied.
+
+ Nothing is copied while characters are pending on the put stack.
+ */
+inline int QXmlStreamReaderPrivate::fastScanRun(ushort delim1, ushort delim2, ushort delim3, ushort delim4)
+{
+    if (putStack.size())
+        return 0;
+    const ushort *begin = reinterpret_cast<const ushort *>(readBuffer.constData()) + readBufferPos;
+    const ushort *end = reinterpret_cast<const ushort *>(readBuffer.constData()) + readBuffer.size();
+    const int n = int(findXmlDelimiter(begin, end, delim1, delim2, delim3, delim4) - begin);
+    if (n) {
+        textBuffer.append(reinterpret_cast<const QChar *>(begin), n);
+        readBufferPos += n;
+    }
+    return n;
+}
+
 /*!
  \internal
 
@@ -1159,7 +1282,10 @@ inline int QXmlStreamReaderPrivate::fastScanLiteralContent()
 {
     int n = 0;
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    for (;;) {
+        n += fastScanRun('&', '<', '\"', '\'');
+        if ((c = getChar()) == StreamEOF)
+            break;
         switch (ushort(c)) {
         case 0xfffe:
         case 0xffff:
@@ -1209,7 +1335,17 @@ inline int QXmlStreamReaderPrivate::fastScanSpace()
 {
     int n = 0;
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    for (;;) {
+        if (!putStack.size()) {
+            const ushort *begin = reinterpret_cast<const ushort *>(readBuffer.constData()) + readBufferPos;
+            const ushort *end = reinterpret_cast<const ushort *>(readBuffer.constData()) + readBuffer.size();
+            const int blanks = int(skipXmlBlanks(begin, end) - begin);
+            textBuffer.append(reinterpret_cast<const QChar *>(begin), blanks);
+            readBufferPos += blanks;
+            n += blanks;
+        }
+        if ((c = getChar()) == StreamEOF)
+            break;
         switch (c) {
         case '\r':
             if ((c = filterCarriageReturn()) == 0)
@@ -1242,7 +1378,13 @@ inline int QXmlStreamReaderPrivate::fastScanContentCharList()
 {
     int n = 0;
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    for (;;) {
+        const int run = fastScanRun('&', '<', ']');
+        for (int i = textBuffer.size() - run; isWhitespace && i < textBuffer.size(); ++i)
+            isWhitespace = textBuffer.at(i) == QLatin1Char(' ');
+        n += run;
+        if ((c = getChar()) == StreamEOF)
+            break;
         switch (ushort(c)) {
         case 0xfffe:
         case 0xffff:
@@ -1002,6 +1002,7 @@ public:
 
     // scan optimization functions. Not strictly necessary but LALR is
     // not very well suited for scanning fast
+    inline int fastScanRun(ushort delim1, ushort delim2, ushort delim3 = 0, ushort delim4 = 0);
     int fastScanLiteralContent();
     int fastScanSpace();
     int fastScanContentCharList();
@@ -121,7 +121,10 @@ public:
 
     QCollatorSortKey sortKey(const QString &string) const;
 
+    void sort(QStringList &strings) const;
+
 private:
+    friend class QCollatorSortKeyTable;
     QCollatorPrivate *d;
 
     void detach();
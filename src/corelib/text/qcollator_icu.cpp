@@ -48,6 +48,8 @@
 #include <unicode/ustring.h>
 #include <unicode/ures.h>
 
+#include <cstring>
+
 #include "qdebug.h"
 
 QT_BEGIN_NAMESPACE
@@ -107,6 +109,11 @@ void QCollatorPrivate::cleanup()
     collator = nullptr;
 }
 
+bool QCollatorPrivate::usesStringComparison() const
+{
+    return !collator;
+}
+
 int QCollator::compare(QStringView s1, QStringView s2) const
 {
     if (!s1.size())
@@ -151,6 +158,29 @@ QCollatorSortKey QCollator::sortKey(const QString &string) const
     return QCollatorSortKey(new QCollatorSortKeyPrivate(QByteArray()));
 }
 
+void QCollatorPrivate::appendSortKey(QStringView string, QVector<CollatorKeyUnit> &keys) const
+{
+    const int offset = keys.size();
+    int capacity = 16 + string.size() + (string.size() >> 2);
+    keys.resize(offset + capacity);
+    int size = ucol_getSortKey(collator, reinterpret_cast<const UChar *>(string.data()),
+                               string.size(), keys.data() + offset, capacity);
+    if (size > capacity) {
+        capacity = size;
+        keys.resize(offset + capacity);
+        size = ucol_getSortKey(collator, reinterpret_cast<const UChar *>(string.data()),
+                               string.size(), keys.data() + offset, capacity);
+    }
+    keys.resize(offset + size);
+}
+
+int QCollatorPrivate::compareSortKeys(const CollatorKeyUnit *key1, int length1,
+                                      const CollatorKeyUnit *key2, int length2)
+{
+    const int result = memcmp(key1, key2, qMin(length1, length2));
+    return result ? result : length1 - length2;
+}
+
 int QCollatorSortKey::compare(const QCollatorSortKey &otherKey) const
 {
     return qstrcmp(d->m_key, otherKey.d->m_key);
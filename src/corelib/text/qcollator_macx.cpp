@@ -92,6 +92,11 @@ void QCollatorPrivate::cleanup()
     collator = 0;
 }
 
+bool QCollatorPrivate::usesStringComparison() const
+{
+    return !collator;
+}
+
 int QCollator::compare(QStringView s1, QStringView s2) const
 {
     if (!s1.size())
@@ -142,6 +147,32 @@ QCollatorSortKey QCollator::sortKey(const QString &string) const
     return QCollatorSortKey(new QCollatorSortKeyPrivate(std::move(ret)));
 }
 
+void QCollatorPrivate::appendSortKey(QStringView string, QVector<CollatorKeyUnit> &keys) const
+{
+    //Documentation recommends having it 5 times as big as the input
+    const int offset = keys.size();
+    keys.resize(offset + string.size() * 5);
+    ItemCount actualSize;
+    int status = UCGetCollationKey(collator, reinterpret_cast<const UniChar *>(string.data()),
+                                   string.size(), keys.size() - offset, &actualSize,
+                                   keys.data() + offset);
+    if (status == kUCOutputBufferTooSmall) {
+        keys.resize(offset + int(actualSize));
+        UCGetCollationKey(collator, reinterpret_cast<const UniChar *>(string.data()),
+                          string.size(), keys.size() - offset, &actualSize,
+                          keys.data() + offset);
+    }
+    keys.resize(offset + int(actualSize));
+}
+
+int QCollatorPrivate::compareSortKeys(const CollatorKeyUnit *key1, int length1,
+                                      const CollatorKeyUnit *key2, int length2)
+{
+    SInt32 order;
+    UCCompareCollationKeys(key1, length1, key2, length2, 0, &order);
+    return order;
+}
+
 int QCollatorSortKey::compare(const QCollatorSortKey &key) const
 {
     if (!d.data())
@@ -68,15 +68,18 @@ QT_BEGIN_NAMESPACE
 #if QT_CONFIG(icu)
 typedef UCollator *CollatorType;
 typedef QByteArray CollatorKeyType;
+typedef uchar CollatorKeyUnit;
 const CollatorType NoCollator = nullptr;
 
 #elif defined(Q_OS_MACOS)
 typedef CollatorRef CollatorType;
 typedef QVector<UCCollationValue> CollatorKeyType;
+typedef UCCollationValue CollatorKeyUnit;
 const CollatorType NoCollator = 0;
 
 #elif defined(Q_OS_WIN)
 typedef QString CollatorKeyType;
+typedef uchar CollatorKeyUnit;
 typedef int CollatorType;
 const CollatorType NoCollator = 0;
 #  ifdef Q_OS_WINRT
@@ -85,6 +88,7 @@ const CollatorType NoCollator = 0;
 
 #else // posix - ignores CollatorType collator, only handles system locale
 typedef QVector<wchar_t> CollatorKeyType;
+typedef wchar_t CollatorKeyUnit;
 typedef bool CollatorType;
 const CollatorType NoCollator = false;
 #endif
@@ -121,6 +125,15 @@ public:
     void init();
     void cleanup();
 
+    // Whether compare() falls back to plain string comparison (in the C
+    // locale), in which case there are no sort keys to be had.
+    bool usesStringComparison() const;
+    // Appends the sort key of the non-empty string to keys, without any
+    // terminator. init() must have been called; safe to call concurrently.
+    void appendSortKey(QStringView string, QVector<CollatorKeyUnit> &keys) const;
+    static int compareSortKeys(const CollatorKeyUnit *key1, int length1,
+                               const CollatorKeyUnit *key2, int length2);
+
 private:
     Q_DISABLE_COPY_MOVE(QCollatorPrivate)
 };
@@ -142,6 +155,37 @@ private:
     Q_DISABLE_COPY_MOVE(QCollatorSortKeyPrivate)
 };
 
+/*
+    Collates a list of strings in bulk: the sort key of every string is
+    computed once, and all of them are stored back to back in a single
+    buffer, so that sorting only compares keys. Keys are built, and large
+    lists are sorted, using the global thread pool.
+*/
+class Q_CORE_EXPORT QCollatorSortKeyTable
+{
+public:
+    QCollatorSortKeyTable(const QCollator &collator, const QStringList &strings);
+
+    int size() const { return strings.size(); }
+    // same result as QCollator::compare() on the strings at i and j
+    int compare(int i, int j) const;
+    // the indexes of the strings in collation order; equal strings keep
+    // their relative order
+    QVector<int> sortedIndexes() const;
+    // the position of every string in the collation order, equal strings
+    // sharing the same rank
+    QVector<int> ranks() const;
+
+private:
+    QCollator collator;
+    const QStringList strings;
+    QVector<CollatorKeyUnit> keys;
+    QVector<int> keyOffsets;
+    Qt::CaseSensitivity caseSensitivity;
+    bool compareStrings;
+
+    Q_DISABLE_COPY_MOVE(QCollatorSortKeyTable)
+};
 
 QT_END_NAMESPACE
 
@@ -65,6 +65,11 @@ void QCollatorPrivate::cleanup()
 {
 }
 
+bool QCollatorPrivate::usesStringComparison() const
+{
+    return locale.language() == QLocale::C;
+}
+
 static void stringToWCharArray(QVarLengthArray<wchar_t> &ret, QStringView string)
 {
     ret.resize(string.length());
@@ -113,6 +118,33 @@ QCollatorSortKey QCollator::sortKey(const QString &string) const
     return QCollatorSortKey(new QCollatorSortKeyPrivate(std::move(result)));
 }
 
+void QCollatorPrivate::appendSortKey(QStringView string, QVector<CollatorKeyUnit> &keys) const
+{
+    QVarLengthArray<wchar_t> original;
+    stringToWCharArray(original, string);
+
+    const int offset = keys.size();
+    keys.resize(offset + original.size());
+    size_t size = std::wcsxfrm(keys.data() + offset, original.constData(), original.size());
+    if (size >= size_t(original.size())) {
+        keys.resize(offset + int(size) + 1);
+        size = std::wcsxfrm(keys.data() + offset, original.constData(), size + 1);
+    }
+    keys.resize(offset + int(size));
+}
+
+int QCollatorPrivate::compareSortKeys(const CollatorKeyUnit *key1, int length1,
+                                      const CollatorKeyUnit *key2, int length2)
+{
+    // what wcscmp() does, without needing terminators
+    const int length = qMin(length1, length2);
+    for (int i = 0; i < length; ++i) {
+        if (key1[i] != key2[i])
+            return key1[i] < key2[i] ? -1 : 1;
+    }
+    return length1 - length2;
+}
+
 int QCollatorSortKey::compare(const QCollatorSortKey &otherKey) const
 {
     return std::wcscmp(d->m_key.constData(), otherKey.d->m_key.constData());
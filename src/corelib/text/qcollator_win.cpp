@@ -47,6 +47,8 @@
 #include <qt_windows.h>
 #include <qsysinfo.h>
 
+#include <cstring>
+
 QT_BEGIN_NAMESPACE
 
 //NOTE: SORT_DIGITSASNUMBERS is available since win7
@@ -87,6 +89,11 @@ void QCollatorPrivate::cleanup()
 {
 }
 
+bool QCollatorPrivate::usesStringComparison() const
+{
+    return locale.language() == QLocale::C;
+}
+
 int QCollator::compare(QStringView s1, QStringView s2) const
 {
     if (!s1.size())
@@ -172,6 +179,46 @@ QCollatorSortKey QCollator::sortKey(const QString &string) const
     return QCollatorSortKey(new QCollatorSortKeyPrivate(std::move(ret)));
 }
 
+void QCollatorPrivate::appendSortKey(QStringView string, QVector<CollatorKeyUnit> &keys) const
+{
+    // With LCMAP_SORTKEY, the destination is a byte buffer and its size is
+    // counted in bytes
+#ifndef USE_COMPARESTRINGEX
+    int size = LCMapStringW(localeID, LCMAP_SORTKEY | collator,
+                            reinterpret_cast<const wchar_t*>(string.data()), string.size(),
+                            0, 0);
+#else
+    int size = LCMapStringEx(LPCWSTR(localeName.utf16()), LCMAP_SORTKEY | collator,
+                             reinterpret_cast<LPCWSTR>(string.data()), string.size(),
+                             0, 0, NULL, NULL, 0);
+#endif
+    const int offset = keys.size();
+    keys.resize(offset + size);
+#ifndef USE_COMPARESTRINGEX
+    int finalSize = LCMapStringW(localeID, LCMAP_SORTKEY | collator,
+                                 reinterpret_cast<const wchar_t*>(string.data()), string.size(),
+                                 reinterpret_cast<wchar_t*>(keys.data() + offset), size);
+#else
+    int finalSize = LCMapStringEx(LPCWSTR(localeName.utf16()), LCMAP_SORTKEY | collator,
+                                  reinterpret_cast<LPCWSTR>(string.data()), string.size(),
+                                  reinterpret_cast<LPWSTR>(keys.data() + offset), size,
+                                  NULL, NULL, 0);
+#endif
+    if (finalSize == 0) {
+        qWarning()
+            << "there were problems when generating the sort key by LCMapStringW with error:"
+            << GetLastError();
+    }
+    keys.resize(offset + finalSize);
+}
+
+int QCollatorPrivate::compareSortKeys(const CollatorKeyUnit *key1, int length1,
+                                      const CollatorKeyUnit *key2, int length2)
+{
+    const int result = memcmp(key1, key2, qMin(length1, length2));
+    return result ? result : length1 - length2;
+}
+
 int QCollatorSortKey::compare(const QCollatorSortKey &otherKey) const
 {
     return d->m_key.compare(otherKey.d->m_key);
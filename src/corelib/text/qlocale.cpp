@@ -63,6 +63,7 @@
 #include "qvariant.h"
 #include "qstringbuilder.h"
 #include "private/qnumeric_p.h"
+#include <algorithm>
 #include <cmath>
 #ifndef QT_NO_SYSTEMLOCALE
 #   include "qmutex.h"
@@ -3620,7 +3621,6 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
         width = 0;
 
     bool negative = false;
-    QString num_str;
 
     int decpt;
     int bufSize = 1;
@@ -3637,11 +3637,17 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
 
     qt_doubleToAscii(d, form, precision, buf.data(), bufSize, negative, length, decpt);
 
+    // The number is assembled on the stack and copied into a QString once
+    // it is complete, including padding and sign.
+    DigitBuff digits;
+    digits.resize(length);
+    for (int i = 0; i < length; ++i)
+        digits[i] = QLatin1Char(buf[i]);
+    int num_pad_chars = 0;
+
     if (qstrncmp(buf.data(), "inf", 3) == 0 || qstrncmp(buf.data(), "nan", 3) == 0) {
-        num_str = QString::fromLatin1(buf.data(), length);
+        // nothing to do; we don't pad special numbers
     } else { // Handle normal numbers
-        QString digits = QString::fromLatin1(buf.data(), length);
-
         if (_zero.unicode() != '0') {
             ushort z = _zero.unicode() - '0';
             for (int i = 0; i < digits.length(); ++i)
@@ -3651,15 +3657,15 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
         bool always_show_decpt = (flags & ForcePoint);
         switch (form) {
             case DFExponent: {
-                num_str = exponentForm(_zero, decimal, exponential, group, plus, minus,
-                                       digits, decpt, precision, PMDecimalDigits,
-                                       always_show_decpt, flags & ZeroPadExponent);
+                exponentForm(_zero, decimal, exponential, plus, minus,
+                             digits, decpt, precision, PMDecimalDigits,
+                             always_show_decpt, flags & ZeroPadExponent);
                 break;
             }
             case DFDecimal: {
-                num_str = decimalForm(_zero, decimal, group,
-                                      digits, decpt, precision, PMDecimalDigits,
-                                      always_show_decpt, flags & ThousandsGroup);
+                decimalForm(_zero, decimal, group,
+                            digits, decpt, precision, PMDecimalDigits,
+                            always_show_decpt, flags & ThousandsGroup);
                 break;
             }
             case DFSignificantDigits: {
@@ -3680,13 +3686,13 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
                 }
 
                 if (decpt != digits.length() && (decpt <= -4 || decpt > cutoff))
-                    num_str = exponentForm(_zero, decimal, exponential, group, plus, minus,
-                                           digits, decpt, precision, mode,
-                                           always_show_decpt, flags & ZeroPadExponent);
+                    exponentForm(_zero, decimal, exponential, plus, minus,
+                                 digits, decpt, precision, mode,
+                                 always_show_decpt, flags & ZeroPadExponent);
                 else
-                    num_str = decimalForm(_zero, decimal, group,
-                                          digits, decpt, precision, mode,
-                                          always_show_decpt, flags & ThousandsGroup);
+                    decimalForm(_zero, decimal, group,
+                                digits, decpt, precision, mode,
+                                always_show_decpt, flags & ThousandsGroup);
                 break;
             }
         }
@@ -3697,25 +3703,31 @@ QString QLocaleData::doubleToString(const QChar _zero, const QChar plus, const Q
         // pad with zeros. LeftAdjusted overrides this flag). Also, we don't
         // pad special numbers
         if (flags & QLocaleData::ZeroPadded && !(flags & QLocaleData::LeftAdjusted)) {
-            int num_pad_chars = width - num_str.length();
+            num_pad_chars = width - digits.length();
             // leave space for the sign
             if (negative
                     || flags & QLocaleData::AlwaysShowSign
                     || flags & QLocaleData::BlankBeforePositive)
                 --num_pad_chars;
-
-            for (int i = 0; i < num_pad_chars; ++i)
-                num_str.prepend(_zero);
+            num_pad_chars = qMax(num_pad_chars, 0);
         }
     }
 
     // add sign
+    QChar sign;
     if (negative)
-        num_str.prepend(minus);
+        sign = minus;
     else if (flags & QLocaleData::AlwaysShowSign)
-        num_str.prepend(plus);
+        sign = plus;
     else if (flags & QLocaleData::BlankBeforePositive)
-        num_str.prepend(QLatin1Char(' '));
+        sign = QLatin1Char(' ');
+
+    QString num_str(int(!sign.isNull()) + num_pad_chars + digits.length(), Qt::Uninitialized);
+    QChar *out = num_str.data();
+    if (!sign.isNull())
+        *out++ = sign;
+    out = std::fill_n(out, num_pad_chars, _zero);
+    memcpy(out, digits.constData(), digits.length() * sizeof(QChar));
 
     if (flags & QLocaleData::CapitalEorX)
         num_str = std::move(num_str).toUpper();
@@ -3737,6 +3749,23 @@ QString QLocaleData::longLongToString(const QChar zero, const QChar group,
                                          int base, int width,
                                          unsigned flags)
 {
+    if (precision == -1 && flags == NoFlags) {
+        // Plain conversion: write the digits into a stack buffer and allocate once.
+        const bool negative = l < 0 && base == 10;
+QT_WARNING_PUSH
+QT_WARNING_DISABLE_MSVC(4146)
+        const qulonglong magnitude = negative ? -qulonglong(l) : qulonglong(l);
+QT_WARNING_POP
+        QChar buff[66];
+        QChar *const end = buff + 66;
+        QChar *p = qulltoa(end, magnitude, base, zero);
+        if (p == end)
+            *--p = base == 10 ? zero : QChar::fromLatin1('0');
+        if (negative)
+            *--p = minus;
+        return QString(p, int(end - p));
+    }
+
     bool precision_not_specified = false;
     if (precision == -1) {
         precision_not_specified = true;
@@ -3947,6 +3976,44 @@ bool QLocaleData::numberToCLocale(QStringView s, QLocale::NumberOptions number_o
             break;
     }
 
+    // Fast path for the common case: locales using the C locale's digits and
+    // symbols, with no separators in the input, are narrowed directly.
+    if (m_zero == '0' && m_decimal == '.' && m_group == ',' && m_minus == '-'
+            && m_plus == '+' && m_exponential == 'e'
+            && !(number_options & (QLocale::RejectLeadingZeroInExponent
+                                   | QLocale::RejectTrailingZeroesAfterDot))) {
+        bool seenDot = false;
+        bool seenExponent = false;
+        auto i = idx;
+        for (; i < l; ++i) {
+            const ushort c = uc[i].unicode();
+            char out;
+            if ((c >= '0' && c <= '9') || c == '+' || c == '-') {
+                out = char(c);
+            } else if (c == '.') {
+                if (seenDot || seenExponent)
+                    break;
+                seenDot = true;
+                out = '.';
+            } else if (c >= 'a' && c <= 'z') {
+                out = char(c);
+                seenExponent |= c == 'e';
+            } else if (c >= 'A' && c <= 'Z') {
+                out = char(c - 'A' + 'a');
+                seenExponent |= c == 'E';
+            } else {
+                break;
+            }
+            result->append(out);
+        }
+        if (i == l) {
+            result->append('\0');
+            return true;
+        }
+        // let the general loop below deal with it
+        result->clear();
+    }
+
     int group_cnt = 0; // counts number of group chars
     int decpt_idx = -1;
     int last_separator_idx = -1;
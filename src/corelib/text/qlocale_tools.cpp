@@ -453,8 +453,20 @@ qstrtoll(const char * nptr, const char **endptr, int base, bool *ok)
 
 QString qulltoa(qulonglong l, int base, const QChar _zero)
 {
-    ushort buff[65]; // length of MAX_ULLONG in base 2
-    ushort *p = buff + 65;
+    QChar buff[65]; // length of MAX_ULLONG in base 2
+    QChar *p = qulltoa(buff + 65, l, base, _zero);
+
+    return QString(p, 65 - (p - buff));
+}
+
+/*
+    Writes the digits of \a l backwards into the buffer that ends at \a end
+    and returns a pointer to the first one. The buffer must have room for 64
+    digits. Nothing is written for 0.
+*/
+QChar *qulltoa(QChar *end, qulonglong l, int base, const QChar _zero)
+{
+    ushort *p = reinterpret_cast<ushort *>(end);
 
     if (base != 10 || _zero.unicode() == '0') {
         while (l != 0) {
@@ -480,18 +492,17 @@ QString qulltoa(qulonglong l, int base, const QChar _zero)
         }
     }
 
-    return QString(reinterpret_cast<QChar *>(p), 65 - (p - buff));
+    return reinterpret_cast<QChar *>(p);
 }
 
-QString &decimalForm(QChar zero, QChar decimal, QChar group,
-                     QString &digits, int decpt, int precision,
-                     PrecisionMode pm,
-                     bool always_show_decpt,
-                     bool thousands_group)
+void decimalForm(QChar zero, QChar decimal, QChar group,
+                 DigitBuff &digits, int decpt, int precision,
+                 PrecisionMode pm,
+                 bool always_show_decpt,
+                 bool thousands_group)
 {
     if (decpt < 0) {
-        for (int i = 0; i < -decpt; ++i)
-            digits.prepend(zero);
+        digits.insert(0, -decpt, zero);
         decpt = 0;
     }
     else if (decpt > digits.length()) {
@@ -521,16 +532,14 @@ QString &decimalForm(QChar zero, QChar decimal, QChar group,
 
     if (decpt == 0)
         digits.prepend(zero);
-
-    return digits;
 }
 
-QString &exponentForm(QChar zero, QChar decimal, QChar exponential,
-                      QChar group, QChar plus, QChar minus,
-                      QString &digits, int decpt, int precision,
-                      PrecisionMode pm,
-                      bool always_show_decpt,
-                      bool leading_zero_in_exponent)
+void exponentForm(QChar zero, QChar decimal, QChar exponential,
+                  QChar plus, QChar minus,
+                  DigitBuff &digits, int decpt, int precision,
+                  PrecisionMode pm,
+                  bool always_show_decpt,
+                  bool leading_zero_in_exponent)
 {
     int exp = decpt - 1;
 
@@ -549,10 +558,14 @@ QString &exponentForm(QChar zero, QChar decimal, QChar exponential,
         digits.insert(1, decimal);
 
     digits.append(exponential);
-    digits.append(QLocaleData::longLongToString(zero, group, plus, minus,
-                   exp, leading_zero_in_exponent ? 2 : 1, 10, -1, QLocaleData::AlwaysShowSign));
-
-    return digits;
+    digits.append(exp < 0 ? minus : plus);
+
+    QChar buff[65];
+    QChar *const end = buff + 65;
+    QChar *p = qulltoa(end, exp < 0 ? -qulonglong(exp) : qulonglong(exp), 10, zero);
+    for (int i = end - p; i < (leading_zero_in_exponent ? 2 : 1); ++i)
+        *--p = zero;
+    digits.append(p, end - p);
 }
 
 double qstrtod(const char *s00, const char **se, bool *ok)
@@ -68,6 +68,7 @@ void qt_doubleToAscii(double d, QLocaleData::DoubleForm form, int precision, cha
                       bool &sign, int &length, int &decpt);
 
 QString qulltoa(qulonglong l, int base, const QChar _zero);
+QChar *qulltoa(QChar *end, qulonglong l, int base, const QChar _zero);
 Q_CORE_EXPORT QString qdtoa(qreal d, int *decpt, int *sign);
 
 enum PrecisionMode {
@@ -76,17 +77,20 @@ enum PrecisionMode {
     PMChopTrailingZeros =   0x03
 };
 
-QString &decimalForm(QChar zero, QChar decimal, QChar group,
-                     QString &digits, int decpt, int precision,
-                     PrecisionMode pm,
-                     bool always_show_decpt,
-                     bool thousands_group);
-QString &exponentForm(QChar zero, QChar decimal, QChar exponential,
-                      QChar group, QChar plus, QChar minus,
-                      QString &digits, int decpt, int precision,
-                      PrecisionMode pm,
-                      bool always_show_decpt,
-                      bool leading_zero_in_exponent);
+// digits of a floating point number, kept on the stack while it is formatted
+typedef QVarLengthArray<QChar, 64> DigitBuff;
+
+void decimalForm(QChar zero, QChar decimal, QChar group,
+                 DigitBuff &digits, int decpt, int precision,
+                 PrecisionMode pm,
+                 bool always_show_decpt,
+                 bool thousands_group);
+void exponentForm(QChar zero, QChar decimal, QChar exponential,
+                  QChar plus, QChar minus,
+                  DigitBuff &digits, int decpt, int precision,
+                  PrecisionMode pm,
+                  bool always_show_decpt,
+                  bool leading_zero_in_exponent);
 
 inline bool isZero(double d)
 {
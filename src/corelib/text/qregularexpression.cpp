@@ -41,6 +41,7 @@
 
 #include "qregularexpression.h"
 
+#include <QtCore/qcache.h>
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qhashfunctions.h>
 #include <QtCore/qmutex.h>
@@ -573,6 +574,12 @@ QT_BEGIN_NAMESPACE
     \c{QT_ENABLE_REGEXP_JIT} environment variable to a non-zero or zero value
     respectively.
 
+    When the JIT runs out of stack space while matching, a stack of up to 512
+    kilobytes is allocated for the thread performing the match. Patterns that
+    recurse deeply may need more; the limit can be changed by setting the
+    \c{QT_REGEXP_JIT_STACK_SIZE} environment variable to the maximum size in
+    kilobytes.
+
     \sa QRegularExpressionMatch, QRegularExpressionMatchIterator
 */
 
@@ -840,6 +847,29 @@ static int convertToPcreOptions(QRegularExpression::MatchOptions matchOptions)
     return options;
 }
 
+/*
+    A compiled (and possibly JIT-compiled) pattern, together with the
+    information we extract from it. Objects of this class are shared by all
+    the QRegularExpressionPrivate objects using the same pattern and pattern
+    options, in any thread: matching never modifies the PCRE code, so no
+    locking is needed to use it once it has been built.
+*/
+struct QPcreCompiledPattern : QSharedData
+{
+    QPcreCompiledPattern() = default;
+    ~QPcreCompiledPattern()
+    {
+        pcre2_code_free_16(code);
+    }
+    Q_DISABLE_COPY_MOVE(QPcreCompiledPattern)
+
+    pcre2_code_16 *code = nullptr;
+    int errorCode = 0;
+    int errorOffset = -1;
+    int capturingCount = 0;
+    bool usingCrLfNewlines = false;
+};
+
 struct QRegularExpressionPrivate : QSharedData
 {
     QRegularExpressionPrivate();
@@ -876,15 +906,23 @@ struct QRegularExpressionPrivate : QSharedData
     // (right after a detach happened).
     mutable QMutex mutex;
 
-    // The PCRE code pointer is reference-counted by the QRegularExpressionPrivate
-    // objects themselves; when the private is copied (i.e. a detach happened)
-    // it is set to nullptr
+    // The PCRE code is owned by compiledPatternData, which may be shared with
+    // other QRegularExpressionPrivate objects through the pattern cache;
+    // compiledPattern is a shortcut to its code. When the private is copied
+    // (i.e. a detach happened) both are reset
+    QExplicitlySharedDataPointer<QPcreCompiledPattern> compiledPatternData;
     pcre2_code_16 *compiledPattern;
     int errorCode;
     int errorOffset;
     int capturingCount;
     bool usingCrLfNewlines;
     bool isDirty;
+    // set by QRegularExpression::fromPatterns(); matches then report the
+    // index of the pattern that matched
+    bool isMultiPattern;
+    // set by fromPatterns() to the index of the pattern that failed to
+    // compile, which is then the pattern of this object
+    int invalidPatternIndex;
 };
 
 struct QRegularExpressionMatchPrivate : QSharedData
@@ -912,6 +950,8 @@ struct QRegularExpressionMatchPrivate : QSharedData
 
     int capturedCount;
 
+    int patternIndex;
+
     bool hasMatch;
     bool hasPartialMatch;
     bool isValid;
@@ -952,7 +992,9 @@ QRegularExpressionPrivate::QRegularExpressionPrivate()
       errorOffset(-1),
       capturingCount(0),
       usingCrLfNewlines(false),
-      isDirty(true)
+      isDirty(true),
+      isMultiPattern(false),
+      invalidPatternIndex(-1)
 {
 }
 
@@ -983,7 +1025,9 @@ QRegularExpressionPrivate::QRegularExpressionPrivate(const QRegularExpressionPri
       errorOffset(-1),
       capturingCount(0),
       usingCrLfNewlines(false),
-      isDirty(true)
+      isDirty(true),
+      isMultiPattern(other.isMultiPattern),
+      invalidPatternIndex(other.invalidPatternIndex)
 {
 }
 
@@ -992,7 +1036,7 @@ QRegularExpressionPrivate::QRegularExpressionPrivate(const QRegularExpressionPri
 */
 void QRegularExpressionPrivate::cleanCompiledPattern()
 {
-    pcre2_code_free_16(compiledPattern);
+    compiledPatternData.reset();
     compiledPattern = nullptr;
     errorCode = 0;
     errorOffset = -1;
@@ -1000,8 +1044,69 @@ void QRegularExpressionPrivate::cleanCompiledPattern()
     usingCrLfNewlines = false;
 }
 
+struct QRegularExpressionCacheKey
+{
+    QString pattern;
+    QRegularExpression::PatternOptions patternOptions;
+
+    bool operator==(const QRegularExpressionCacheKey &other) const
+    {
+        return patternOptions == other.patternOptions && pattern == other.pattern;
+    }
+};
+
+static inline uint qHash(const QRegularExpressionCacheKey &key, uint seed = 0) noexcept
+{
+    QtPrivate::QHashCombine hash;
+    seed = hash(seed, key.pattern);
+    seed = hash(seed, int(key.patternOptions));
+    return seed;
+}
+
+/*
+    The process-wide cache of compiled patterns. It allows QRegularExpression
+    objects created independently from the same pattern string and options,
+    possibly in different threads, to share a single (JIT-)compiled pattern
+    instead of compiling it again.
+*/
+class QRegularExpressionPatternCache
+{
+public:
+    // number of compiled patterns kept alive by the cache itself
+    enum { MaxCachedPatterns = 256 };
+
+    QRegularExpressionPatternCache() : cache(MaxCachedPatterns) {}
+
+    QExplicitlySharedDataPointer<QPcreCompiledPattern> find(const QRegularExpressionCacheKey &key)
+    {
+        // the reference must be taken while holding the lock, as another
+        // thread may evict (and release) the entry at any time
+        const QMutexLocker lock(&mutex);
+        if (const auto entry = cache.object(key))
+            return *entry;
+        return QExplicitlySharedDataPointer<QPcreCompiledPattern>();
+    }
+
+    void insert(const QRegularExpressionCacheKey &key,
+                const QExplicitlySharedDataPointer<QPcreCompiledPattern> &compiled)
+    {
+        const QMutexLocker lock(&mutex);
+        cache.insert(key, new QExplicitlySharedDataPointer<QPcreCompiledPattern>(compiled));
+    }
+
+private:
+    QMutex mutex;
+    QCache<QRegularExpressionCacheKey, QExplicitlySharedDataPointer<QPcreCompiledPattern> > cache;
+};
+
+Q_GLOBAL_STATIC(QRegularExpressionPatternCache, patternCache)
+
 /*!
     \internal
+
+    Compiles the pattern, unless a QRegularExpression with the same pattern
+    string and options already did so, in which case the compiled pattern is
+    taken from the process-wide cache.
 */
 void QRegularExpressionPrivate::compilePattern()
 {
@@ -1013,6 +1118,21 @@ void QRegularExpressionPrivate::compilePattern()
     isDirty = false;
     cleanCompiledPattern();
 
+    const QRegularExpressionCacheKey key = { pattern, patternOptions };
+    QRegularExpressionPatternCache *cache = patternCache();
+
+    if (cache)
+        compiledPatternData = cache->find(key);
+
+    if (compiledPatternData) {
+        compiledPattern = compiledPatternData->code;
+        errorCode = compiledPatternData->errorCode;
+        errorOffset = compiledPatternData->errorOffset;
+        capturingCount = compiledPatternData->capturingCount;
+        usingCrLfNewlines = compiledPatternData->usingCrLfNewlines;
+        return;
+    }
+
     int options = convertToPcreOptions(patternOptions);
     options |= PCRE2_UTF;
 
@@ -1026,14 +1146,23 @@ void QRegularExpressionPrivate::compilePattern()
 
     if (!compiledPattern) {
         errorOffset = static_cast<int>(patternErrorOffset);
-        return;
     } else {
         // ignore whatever PCRE2 wrote into errorCode -- leave it to 0 to mean "no error"
         errorCode = 0;
+
+        optimizePattern();
+        getPatternInfo();
     }
 
-    optimizePattern();
-    getPatternInfo();
+    compiledPatternData = new QPcreCompiledPattern;
+    compiledPatternData->code = compiledPattern;
+    compiledPatternData->errorCode = errorCode;
+    compiledPatternData->errorOffset = errorOffset;
+    compiledPatternData->capturingCount = capturingCount;
+    compiledPatternData->usingCrLfNewlines = usingCrLfNewlines;
+
+    if (cache)
+        cache->insert(key, compiledPatternData);
 }
 
 /*!
@@ -1065,6 +1194,21 @@ void QRegularExpressionPrivate::getPatternInfo()
 }
 
 
+/*
+    Returns the maximum size of the thread-local JIT stacks, in bytes. It
+    defaults to 512K and can be changed through the QT_REGEXP_JIT_STACK_SIZE
+    environment variable (in kilobytes) for workloads matching patterns
+    that recurse deeply.
+*/
+static int jitStackMaximumSize()
+{
+    bool ok;
+    const int kilobytes = qEnvironmentVariableIntValue("QT_REGEXP_JIT_STACK_SIZE", &ok);
+    if (ok && kilobytes > 0)
+        return qMin(kilobytes, 1024 * 1024) * 1024;
+    return 512 * 1024;
+}
+
 /*
     Simple "smartpointer" wrapper around a pcre2_jit_stack_16, to be used with
     QThreadStorage.
@@ -1080,8 +1224,9 @@ public:
     QPcreJitStackPointer()
     {
         // The default JIT stack size in PCRE is 32K,
-        // we allocate from 32K up to 512K.
-        stack = pcre2_jit_stack_create_16(32 * 1024, 512 * 1024, nullptr);
+        // we allocate from 32K up to 512K (unless configured otherwise).
+        static const int maximumSize = jitStackMaximumSize();
+        stack = pcre2_jit_stack_create_16(qMin(32 * 1024, maximumSize), maximumSize, nullptr);
     }
     /*!
         \internal
@@ -1343,6 +1488,16 @@ QRegularExpressionMatchPrivate *QRegularExpressionPrivate::doMatch(const QString
         priv->hasMatch = true;
         priv->capturedCount = result;
         priv->capturedOffsets.resize(result * 2);
+
+        if (isMultiPattern) {
+            // the alternatives built by fromPatterns() end with (*:<index>)
+            if (PCRE2_SPTR16 mark = pcre2_get_mark_16(matchData)) {
+                int index = 0;
+                for (; *mark >= '0' && *mark <= '9'; ++mark)
+                    index = index * 10 + (*mark - '0');
+                priv->patternIndex = *mark ? -1 : index;
+            }
+        }
     } else {
         // no match, partial match or error
         priv->hasPartialMatch = (result == PCRE2_ERROR_PARTIAL);
@@ -1405,6 +1560,7 @@ QRegularExpressionMatchPrivate::QRegularExpressionMatchPrivate(const QRegularExp
       subjectStart(subjectStart), subjectLength(subjectLength),
       matchType(matchType), matchOptions(matchOptions),
       capturedCount(0),
+      patternIndex(-1),
       hasMatch(false), hasPartialMatch(false), isValid(false)
 {
 }
@@ -1534,6 +1690,8 @@ void QRegularExpression::setPattern(const QString &pattern)
 {
     d.detach();
     d->isDirty = true;
+    d->isMultiPattern = false;
+    d->invalidPatternIndex = -1;
     d->pattern = pattern;
 }
 
@@ -1669,7 +1827,12 @@ QString QRegularExpression::errorString() const
         } while (errorStringLength < 0);
         errorString.resize(errorStringLength);
 
-        return QCoreApplication::translate("QRegularExpression", std::move(errorString).toLatin1().constData());
+        errorString = QCoreApplication::translate("QRegularExpression", std::move(errorString).toLatin1().constData());
+        if (d->invalidPatternIndex >= 0) {
+            return QCoreApplication::translate("QRegularExpression", "pattern %1: %2")
+                    .arg(d->invalidPatternIndex).arg(errorString);
+        }
+        return errorString;
     }
     return QCoreApplication::translate("QRegularExpression", "no error");
 }
@@ -1825,12 +1988,43 @@ QRegularExpressionMatchIterator QRegularExpression::globalMatch(const QStringRef
     \sa QRegularExpressionMatchIterator, {global matching}
 */
 
+/*!
+    \since 5.15
+
+    Scans the \a subject string for all the given \a patterns at once, using
+    the pattern options \a options. This is equivalent to:
+
+    \snippet code/src_corelib_tools_qregularexpression.cpp 35
+
+    The returned QRegularExpressionMatchIterator is positioned before the
+    first match result (if any). The matches do not overlap; use
+    QRegularExpressionMatch::patternIndex() to find out which pattern
+    produced each of them.
+
+    As compiled patterns are cached, calling this function repeatedly with
+    the same list of patterns does not compile them again.
+
+    \sa fromPatterns(), globalMatch()
+*/
+QRegularExpressionMatchIterator QRegularExpression::matchMany(const QStringList &patterns,
+                                                              const QString &subject,
+                                                              PatternOptions options)
+{
+    return fromPatterns(patterns, options).globalMatch(subject);
+}
+
 /*!
     \since 5.4
 
     Compiles the pattern immediately, including JIT compiling it (if
     the JIT is enabled) for optimization.
 
+    Since Qt 5.15, compiled patterns are shared between all the
+    QRegularExpression objects having the same pattern and pattern options,
+    even across threads; a process-wide cache keeps recently compiled
+    patterns alive, so creating a QRegularExpression again from the same
+    pattern string does not compile it again.
+
     \sa isValid(), {Debugging Code that Uses QRegularExpression}
 */
 void QRegularExpression::optimize() const
@@ -2112,6 +2306,75 @@ QString QRegularExpression::anchoredPattern(QStringView expression)
            + QLatin1String(")\\z");
 }
 
+/*!
+    \since 5.15
+
+    Returns a regular expression that matches any of the given \a patterns,
+    compiled with the pattern options \a options. A match of the returned
+    regular expression is the leftmost match of any of the patterns; if more
+    than one pattern matches at that position, the first one in \a patterns
+    wins. QRegularExpressionMatch::patternIndex() reports which pattern
+    matched.
+
+    This allows to scan a subject string for a set of patterns in a single
+    pass, for instance by doing a global match:
+
+    \snippet code/src_corelib_tools_qregularexpression.cpp 34
+
+    The capturing groups of each pattern are numbered starting from 1, as if
+    the pattern was used on its own, so captured(1) is the first capturing
+    group of whichever pattern matched. Different patterns must not use
+    different names for capturing groups having the same number, and
+    patterns should not use the \c{(*MARK)} verb.
+
+    Each pattern must be a valid regular expression on its own. If one is
+    not, the returned regular expression is invalid: its pattern() is the
+    first offending pattern, patternErrorOffset() is the offset inside it and
+    errorString() starts with its index in \a patterns.
+
+    If \a patterns is empty, the returned regular expression never matches.
+
+    \sa matchMany(), QRegularExpressionMatch::patternIndex()
+*/
+QRegularExpression QRegularExpression::fromPatterns(const QStringList &patterns,
+                                                    PatternOptions options)
+{
+    if (patterns.isEmpty())
+        return QRegularExpression(QStringLiteral("(*FAIL)"), options);
+
+    // A pattern that is not valid on its own, such as "a)|(b", could still
+    // make a valid combination that no longer matches what was asked for.
+    for (int i = 0; i < patterns.size(); ++i) {
+        QRegularExpression re(patterns.at(i), options);
+        if (!re.isValid()) {
+            re.d->isMultiPattern = true;
+            re.d->invalidPatternIndex = i;
+            return re;
+        }
+    }
+
+    // Each pattern becomes an alternative of a branch reset group, so that
+    // all of them number their capturing groups from 1, and ends with a
+    // mark recording its index, which doMatch() reads back.
+    QString combined = QStringLiteral("(?|");
+    for (int i = 0; i < patterns.size(); ++i) {
+        if (i)
+            combined += QLatin1Char('|');
+        combined += QLatin1String("(?:") + patterns.at(i);
+        // terminate an unterminated \Q quote in the pattern
+        combined += QLatin1String("\\E");
+        // terminate a trailing comment in the pattern
+        if (options & ExtendedPatternSyntaxOption)
+            combined += QLatin1Char('\n');
+        combined += QLatin1String(")(*:") + QString::number(i) + QLatin1Char(')');
+    }
+    combined += QLatin1Char(')');
+
+    QRegularExpression re(combined, options);
+    re.d->isMultiPattern = true;
+    return re;
+}
+
 /*!
     \since 5.1
 
@@ -2238,6 +2501,24 @@ int QRegularExpressionMatch::lastCapturedIndex() const
     return d->capturedCount - 1;
 }
 
+/*!
+    \since 5.15
+
+    Returns the index, in the list of patterns passed to
+    QRegularExpression::fromPatterns(), of the pattern that produced this
+    match.
+
+    If the regular expression was not created by
+    QRegularExpression::fromPatterns(), or if it did not match, this
+    function returns -1.
+
+    \sa QRegularExpression::matchMany()
+*/
+int QRegularExpressionMatch::patternIndex() const
+{
+    return d->patternIndex;
+}
+
 /*!
     Returns the substring captured by the \a nth capturing group.
 
@@ -160,6 +160,12 @@ public:
     static QString wildcardToRegularExpression(QStringView str);
     static QString anchoredPattern(QStringView expression);
 
+    static QRegularExpression fromPatterns(const QStringList &patterns,
+                                           PatternOptions options = NoPatternOption);
+    static QRegularExpressionMatchIterator matchMany(const QStringList &patterns,
+                                                     const QString &subject,
+                                                     PatternOptions options = NoPatternOption);
+
     bool operator==(const QRegularExpression &re) const;
     inline bool operator!=(const QRegularExpression &re) const { return !operator==(re); }
 
@@ -211,6 +217,7 @@ public:
     bool isValid() const;
 
     int lastCapturedIndex() const;
+    int patternIndex() const;
 
     QString captured(int nth = 0) const;
     QStringRef capturedRef(int nth = 0) const;
@@ -47,7 +47,9 @@
 #include "qwaitcondition.h"
 #include "qreadwritelock_p.h"
 #include "qelapsedtimer.h"
+#include "qdeadlinetimer.h"
 #include "private/qfreelist_p.h"
+#include "private/qfutex_p.h"
 #include "private/qlocking_p.h"
 
 QT_BEGIN_NAMESPACE
@@ -62,6 +64,12 @@ QT_BEGIN_NAMESPACE
  *    are waiting, and the lock is not recursive.
  *  - when d_ptr == 0x2: We are locked for write and nobody is waiting. (no contention)
  *  - In any other case, d_ptr points to an actual QReadWriteLockPrivate.
+ *
+ * Where futexes are available, non-recursive locks never use a QReadWriteLockPrivate.
+ * Contention is recorded in d_ptr as well: bit 2 is set while writers wait and bit 3
+ * while readers wait, and the waiting threads sleep on d_ptr itself. Unlocking clears
+ * both bits and wakes all waiters, who then compete for the lock again. Only recursive
+ * locks, whose d_ptr always points to a QReadWriteLockPrivate, take the mutex.
  */
 
 namespace {
@@ -69,11 +77,129 @@ enum {
     StateMask = 0x3,
     StateLockedForRead = 0x1,
     StateLockedForWrite = 0x2,
+    StateWritersWaiting = 0x4,
+    StateReadersWaiting = 0x8,
+    StateWaitersMask = StateWritersWaiting | StateReadersWaiting,
+    StateReaderIncrement = 0x10
 };
 const auto dummyLockedForRead = reinterpret_cast<QReadWriteLockPrivate *>(quintptr(StateLockedForRead));
 const auto dummyLockedForWrite = reinterpret_cast<QReadWriteLockPrivate *>(quintptr(StateLockedForWrite));
 inline bool isUncontendedLocked(const QReadWriteLockPrivate *d)
 { return quintptr(d) & StateMask; }
+
+#ifdef QT_ALWAYS_USE_FUTEX
+typedef QAtomicPointer<QReadWriteLockPrivate> StateWord;
+
+inline QReadWriteLockPrivate *toState(quintptr state)
+{ return reinterpret_cast<QReadWriteLockPrivate *>(state); }
+
+// Returns false if the deadline expired before d_ptr changed from \a expected.
+bool futexWaitUntil(StateWord &d_ptr, quintptr expected, QDeadlineTimer deadline)
+{
+    if (deadline.isForever()) {
+        QtFutex::futexWait(d_ptr, toState(expected));
+        return true;
+    }
+    const qint64 remaining = deadline.remainingTimeNSecs();
+    if (remaining <= 0)
+        return false;
+    return QtFutex::futexWait(d_ptr, toState(expected), remaining);
+}
+
+// Sets \a flag in \a state unless it is set already. Returns false if d_ptr
+// changed in the mean time, in which case \a d holds its new value.
+bool setWaitingFlag(StateWord &d_ptr, quintptr &state, quintptr flag, QReadWriteLockPrivate *&d)
+{
+    if (state & flag)
+        return true;
+    if (!d_ptr.testAndSetRelaxed(d, toState(state | flag), d))
+        return false;
+    state |= flag;
+    return true;
+}
+
+bool futexLockForRead(StateWord &d_ptr, QReadWriteLockPrivate *d, int timeout)
+{
+    const QDeadlineTimer deadline(timeout);
+    while (true) {
+        quintptr state = quintptr(d);
+        if (state == 0) {
+            if (d_ptr.testAndSetAcquire(nullptr, dummyLockedForRead, d))
+                return true;
+            continue;
+        }
+
+        // readers don't overtake a waiting writer
+        if ((state & StateLockedForRead) && !(state & StateWritersWaiting)) {
+            Q_ASSERT_X(state < 0x80000000U, "QReadWriteLock::tryLockForRead()",
+                       "Overflow in lock counter");
+            if (d_ptr.testAndSetAcquire(d, toState(state + StateReaderIncrement), d))
+                return true;
+            continue;
+        }
+
+        if (timeout == 0)
+            return false;
+        if (!setWaitingFlag(d_ptr, state, StateReadersWaiting, d))
+            continue;
+        if (!futexWaitUntil(d_ptr, state, deadline))
+            return false;
+        d = d_ptr.loadAcquire();
+    }
+}
+
+bool futexLockForWrite(StateWord &d_ptr, QReadWriteLockPrivate *d, int timeout)
+{
+    const QDeadlineTimer deadline(timeout);
+    while (true) {
+        quintptr state = quintptr(d);
+        if (state == 0) {
+            if (d_ptr.testAndSetAcquire(nullptr, dummyLockedForWrite, d))
+                return true;
+            continue;
+        }
+
+        if (timeout == 0)
+            return false;
+        if (!setWaitingFlag(d_ptr, state, StateWritersWaiting, d))
+            continue;
+        if (futexWaitUntil(d_ptr, state, deadline)) {
+            d = d_ptr.loadAcquire();
+            continue;
+        }
+
+        // Timed out. Readers may be held back only because of us: clear the flag
+        // and wake everybody, other waiting writers will set it again.
+        d = d_ptr.loadRelaxed();
+        while ((quintptr(d) & StateWritersWaiting)
+               && !d_ptr.testAndSetRelaxed(d, toState(quintptr(d) & ~quintptr(StateWritersWaiting)), d)) {
+        }
+        QtFutex::futexWakeAll(d_ptr);
+        return false;
+    }
+}
+
+void futexUnlock(StateWord &d_ptr, QReadWriteLockPrivate *d)
+{
+    while (true) {
+        const quintptr state = quintptr(d);
+        Q_ASSERT_X(state & StateMask, "QReadWriteLock::unlock()", "Cannot unlock an unlocked lock");
+
+        if ((state & StateLockedForRead) && state >= StateReaderIncrement) {
+            // not the last reader
+            if (d_ptr.testAndSetRelease(d, toState(state - StateReaderIncrement), d))
+                return;
+            continue;
+        }
+
+        if (!d_ptr.testAndSetRelease(d, nullptr, d))
+            continue;
+        if (state & StateWaitersMask)
+            QtFutex::futexWakeAll(d_ptr);
+        return;
+    }
+}
+#endif // QT_ALWAYS_USE_FUTEX
 }
 
 /*! \class QReadWriteLock
@@ -226,6 +352,11 @@ bool QReadWriteLock::tryLockForRead(int timeout)
     if (d_ptr.testAndSetAcquire(nullptr, dummyLockedForRead, d))
         return true;
 
+#ifdef QT_ALWAYS_USE_FUTEX
+    if (!d || isUncontendedLocked(d))
+        return futexLockForRead(d_ptr, d, timeout);
+#endif
+
     while (true) {
         if (d == nullptr) {
             if (!d_ptr.testAndSetAcquire(nullptr, dummyLockedForRead, d))
@@ -340,6 +471,11 @@ bool QReadWriteLock::tryLockForWrite(int timeout)
     if (d_ptr.testAndSetAcquire(nullptr, dummyLockedForWrite, d))
         return true;
 
+#ifdef QT_ALWAYS_USE_FUTEX
+    if (!d || isUncontendedLocked(d))
+        return futexLockForWrite(d_ptr, d, timeout);
+#endif
+
     while (true) {
         if (d == nullptr) {
             if (!d_ptr.testAndSetAcquire(d, dummyLockedForWrite, d))
@@ -393,6 +529,12 @@ bool QReadWriteLock::tryLockForWrite(int timeout)
 void QReadWriteLock::unlock()
 {
     QReadWriteLockPrivate *d = d_ptr.loadAcquire();
+#ifdef QT_ALWAYS_USE_FUTEX
+    if (isUncontendedLocked(d)) {
+        futexUnlock(d_ptr, d);
+        return;
+    }
+#endif
     while (true) {
         Q_ASSERT_X(d, "QReadWriteLock::unlock()", "Cannot unlock an unlocked lock");
 
@@ -93,6 +93,7 @@ QThreadData::~QThreadData()
     thread.storeRelease(nullptr);
     delete t;
 
+    mergeIncomingPostedEvents();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
@@ -121,6 +122,20 @@ void QThreadData::deref()
 #endif
 }
 
+void QThreadData::mergeIncomingPostedEvents()
+{
+    QObject *receiver;
+    QEvent *event;
+    bool merged = false;
+    while (postEventList.takeIncoming(&receiver, &event)) {
+        postEventList.addEvent(QPostEvent(receiver, event, Qt::NormalEventPriority));
+        ++QObjectPrivate::get(receiver)->postedEvents;
+        merged = true;
+    }
+    if (merged)
+        canWait = false;
+}
+
 QAbstractEventDispatcher *QThreadData::createEventDispatcher()
 {
     QAbstractEventDispatcher *ed = QThreadPrivate::createEventDispatcher(this);
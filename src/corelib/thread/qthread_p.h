@@ -117,9 +117,106 @@ public:
 
     QMutex mutex;
 
+    // Uncompressible events posted with Qt::NormalEventPriority don't take
+    // the mutex: postEvent() stores them in this bounded multi-producer ring
+    // and they are moved into the list, in posting order, by whoever locks
+    // the mutex next (see QThreadData::mergeIncomingPostedEvents()). When the
+    // ring is full, postEvent() falls back to the locked path.
+    //
+    // Each slot's sequence tells producers and the consumer whose turn it is
+    // (D. Vyukov's bounded queue). The tail combines the next position with a
+    // Closed bit, set by QObject::moveToThread() while objects leave this
+    // list, and an epoch bumped on every reopen, so a producer can only
+    // reserve a slot if no move happened since it checked the receiver's
+    // thread data.
+    enum {
+        IncomingSize = 256,
+        PositionMask = 0x00ffffff,
+        Closed = 0x01000000,
+        EpochIncrement = 0x02000000
+    };
+    struct IncomingSlot
+    {
+        QAtomicInteger<quint32> sequence;
+        QObject *receiver;
+        QEvent *event;
+    };
+    IncomingSlot incoming[IncomingSize];
+    QAtomicInteger<quint32> incomingTail;
+    QAtomicInteger<quint32> incomingHead; // only written with the mutex locked
+
     inline QPostEventList()
         : QVector<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0)
-    { }
+    {
+        for (int i = 0; i < IncomingSize; ++i)
+            incoming[i].sequence.storeRelaxed(i);
+    }
+
+    // stillOwned() is called after every read of the tail; it must return
+    // false if the receiver no longer lives in this list's thread
+    template <typename StillOwned>
+    bool tryPushIncoming(QObject *receiver, QEvent *event, StillOwned stillOwned)
+    {
+        quint32 tail = incomingTail.loadAcquire();
+        for (;;) {
+            if ((tail & Closed) || !stillOwned())
+                return false;
+            const quint32 pos = tail & PositionMask;
+            IncomingSlot &slot = incoming[pos % IncomingSize];
+            if (slot.sequence.loadAcquire() != pos) {
+                // either the ring is full or another producer took the slot
+                const quint32 current = incomingTail.loadAcquire();
+                if (current == tail)
+                    return false;
+                tail = current;
+                continue;
+            }
+            const quint32 next = (tail & ~quint32(PositionMask)) | ((pos + 1) & PositionMask);
+            if (incomingTail.testAndSetAcquire(tail, next, tail)) {
+                slot.receiver = receiver;
+                slot.event = event;
+                slot.sequence.storeRelease((pos + 1) & PositionMask);
+                return true;
+            }
+        }
+    }
+
+    bool hasIncoming() const
+    {
+        return (incomingTail.loadAcquire() & PositionMask) != incomingHead.loadRelaxed();
+    }
+
+    // must be called with the mutex locked; returns false when no more
+    // published events are waiting
+    bool takeIncoming(QObject **receiver, QEvent **event)
+    {
+        const quint32 pos = incomingHead.loadRelaxed();
+        IncomingSlot &slot = incoming[pos % IncomingSize];
+        if (slot.sequence.loadAcquire() != ((pos + 1) & PositionMask))
+            return false;
+        *receiver = slot.receiver;
+        *event = slot.event;
+        slot.sequence.storeRelease((pos + IncomingSize) & PositionMask);
+        incomingHead.storeRelaxed((pos + 1) & PositionMask);
+        return true;
+    }
+
+    // must be called with the mutex locked; waits for producers that have
+    // already reserved a slot, so that everything posted so far can be taken
+    void closeIncoming()
+    {
+        const quint32 end = incomingTail.fetchAndOrOrdered(Closed) & PositionMask;
+        for (quint32 pos = incomingHead.loadRelaxed(); pos != end; pos = (pos + 1) & PositionMask) {
+            while (incoming[pos % IncomingSize].sequence.loadAcquire() != ((pos + 1) & PositionMask))
+                QThread::yieldCurrentThread();
+        }
+    }
+
+    void reopenIncoming()
+    {
+        const quint32 tail = incomingTail.loadRelaxed();
+        incomingTail.storeRelease((tail & ~quint32(Closed)) + EpochIncrement);
+    }
 
     void addEvent(const QPostEvent &ev) {
         int priority = ev.priority;
@@ -270,9 +367,12 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
-        return canWait;
+        return canWait && !postEventList.hasIncoming();
     }
 
+    // must be called with postEventList.mutex locked
+    void mergeIncomingPostedEvents();
+
     // This class provides per-thread (by way of being a QThreadData
     // member) storage for qFlagLocation()
     class FlaggedDebugSignatures
@@ -60,6 +60,13 @@ public:
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // runnables handed to or stolen by this thread, all of the same priority
+    QMutex localMutex;
+    QQueue<QRunnable *> localTasks;
+    QAtomicInt localTaskCount;
+    int localPriority;
+    uint nextVictim;
 };
 
 /*
@@ -71,7 +78,7 @@ public:
     \internal
 */
 QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
-    :manager(manager), runnable(nullptr)
+    :manager(manager), runnable(nullptr), localPriority(0), nextVictim(0)
 {
     setStackSize(manager->stackSize);
 }
@@ -88,48 +95,48 @@ void QThreadPoolThread::run()
 
         do {
             if (r) {
-                const bool del = r->autoDelete();
-                Q_ASSERT(!del || r->ref == 1);
-
-
-                // run the task
+                // keep running tasks from the local queue, or stolen from
+                // other threads, without the lock until it runs dry or the
+                // thread limits change
+                const int limitSerial = manager->limitSerial.loadRelaxed();
                 locker.unlock();
+                do {
+                    const bool del = r->autoDelete();
+                    Q_ASSERT(!del || r->ref == 1);
+
+                    // run the task
 #ifndef QT_NO_EXCEPTIONS
-                try {
+                    try {
 #endif
-                    r->run();
+                        r->run();
 #ifndef QT_NO_EXCEPTIONS
-                } catch (...) {
-                    qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
-                             "This is not supported, exceptions thrown in worker threads must be\n"
-                             "caught before control returns to Qt Concurrent.");
-                    registerThreadInactive();
-                    throw;
-                }
+                    } catch (...) {
+                        qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
+                                 "This is not supported, exceptions thrown in worker threads must be\n"
+                                 "caught before control returns to Qt Concurrent.");
+                        locker.relock();
+                        registerThreadInactive();
+                        throw;
+                    }
 #endif
 
-                if (del)
-                    delete r;
+                    if (del)
+                        delete r;
+                    r = nullptr;
+                    if (manager->limitSerial.loadRelaxed() == limitSerial)
+                        r = manager->takeLocalTask(this);
+                } while (r);
                 locker.relock();
             }
 
             // if too many threads are active, expire this thread
-            if (manager->tooManyThreadsActive())
-                break;
-
-            if (manager->queue.isEmpty()) {
-                r = nullptr;
+            if (manager->tooManyThreadsActive()) {
+                manager->requeueLocalTasks(this);
                 break;
             }
 
-            QueuePage *page = manager->queue.first();
-            r = page->pop();
-
-            if (page->isFinished()) {
-                manager->queue.removeFirst();
-                delete page;
-            }
-        } while (true);
+            r = manager->takeTask(this);
+        } while (r);
 
         // if too many threads are active, expire this thread
         bool expired = manager->tooManyThreadsActive();
@@ -156,8 +163,10 @@ void QThreadPoolThread::run()
 
 void QThreadPoolThread::registerThreadInactive()
 {
-    if (--manager->activeThreads == 0)
+    if (--manager->activeThreads == 0) {
         manager->noActiveThreads.wakeAll();
+        manager->deleteRetiredStealTargets();
+    }
 }
 
 
@@ -165,8 +174,15 @@ void QThreadPoolThread::registerThreadInactive()
     \internal
 */
 QThreadPoolPrivate:: QThreadPoolPrivate()
+    : queuedHighestPriority(INT_MIN)
 { }
 
+QThreadPoolPrivate::~QThreadPoolPrivate()
+{
+    delete stealTargets.loadRelaxed();
+    qDeleteAll(retiredStealTargets);
+}
+
 bool QThreadPoolPrivate::tryStart(QRunnable *task)
 {
     Q_ASSERT(task != nullptr);
@@ -212,6 +228,9 @@ inline bool comparePriority(int priority, const QueuePage *p)
 void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
 {
     Q_ASSERT(runnable != nullptr);
+    ++queuedTaskCount;
+    if (queue.isEmpty() || priority > queue.first()->priority())
+        queuedHighestPriority.storeRelaxed(priority);
     for (QueuePage *page : qAsConst(queue)) {
         if (page->priority() == priority && !page->isFull()) {
             page->push(runnable);
@@ -222,6 +241,208 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
     queue.insert(std::distance(queue.constBegin(), it), new QueuePage(runnable, priority));
 }
 
+/*!
+    \internal
+
+    Returns the next runnable for \a thread, which has run out of local
+    work or was woken up: its own local queue unless the shared queue holds
+    runnables of a higher priority, then the shared queue, then runnables
+    stolen from other threads. When taking from a long shared queue, a
+    share of the runnables with the same priority moves to the local queue
+    of \a thread, from where it can run them without taking the mutex.
+
+    Must be called with the mutex locked.
+*/
+QRunnable *QThreadPoolPrivate::takeTask(QThreadPoolThread *thread)
+{
+    if (thread->localTaskCount.loadRelaxed()
+            && (queue.isEmpty() || queue.first()->priority() <= thread->localPriority)) {
+        QMutexLocker localLocker(&thread->localMutex);
+        if (!thread->localTasks.isEmpty()) {
+            QRunnable *r = thread->localTasks.dequeue();
+            thread->localTaskCount.storeRelaxed(thread->localTasks.size());
+            return r;
+        }
+    }
+
+    if (queue.isEmpty())
+        return stealTask(thread);
+
+    QueuePage *page = queue.first();
+    const int priority = page->priority();
+    QRunnable *r = page->pop();
+    --queuedTaskCount;
+    if (page->isFinished()) {
+        queue.removeFirst();
+        delete page;
+    }
+
+    // leave enough for the other threads to start with
+    enum { MaxBatchSize = 64 };
+    int batchSize = qMin(queuedTaskCount / qMax(maxThreadCount, 1), int(MaxBatchSize));
+    if (batchSize > 0 && !thread->localTaskCount.loadRelaxed()) {
+        QMutexLocker localLocker(&thread->localMutex);
+        thread->localPriority = priority;
+        int moved = 0;
+        while (moved < batchSize && !queue.isEmpty() && queue.first()->priority() == priority) {
+            page = queue.first();
+            thread->localTasks.enqueue(page->pop());
+            ++moved;
+            if (page->isFinished()) {
+                queue.removeFirst();
+                delete page;
+            }
+        }
+        queuedTaskCount -= moved;
+        thread->localTaskCount.storeRelaxed(thread->localTasks.size());
+        localLocker.unlock();
+
+        // idle threads can steal from this thread
+        for (int i = 0; i < moved && !waitingThreads.isEmpty(); ++i)
+            waitingThreads.takeFirst()->runnableReady.wakeOne();
+    }
+
+    updateQueueState();
+    return r;
+}
+
+/*!
+    \internal
+
+    Returns the next runnable for \a thread from its local queue, or stolen
+    from another thread, without locking the mutex. Returns \nullptr if
+    there is none, or if the shared queue holds runnables that should run
+    first.
+*/
+QRunnable *QThreadPoolPrivate::takeLocalTask(QThreadPoolThread *thread)
+{
+    const int highestQueued = queuedHighestPriority.loadRelaxed();
+    if (thread->localTaskCount.loadRelaxed()) {
+        if (highestQueued > thread->localPriority)
+            return nullptr;
+        QMutexLocker localLocker(&thread->localMutex);
+        if (!thread->localTasks.isEmpty()) {
+            QRunnable *r = thread->localTasks.dequeue();
+            thread->localTaskCount.storeRelaxed(thread->localTasks.size());
+            return r;
+        }
+    }
+
+    // runnables in the shared queue were queued before any in other threads'
+    // local queues could have been taken from there
+    if (highestQueued != INT_MIN)
+        return nullptr;
+    return stealTask(thread);
+}
+
+/*!
+    \internal
+
+    Takes up to half of the local runnables of another thread. The first
+    one is returned, the rest move to the local queue of \a thief, which
+    must be empty.
+*/
+QRunnable *QThreadPoolPrivate::stealTask(QThreadPoolThread *thief)
+{
+    const StealTargets *victims = stealTargets.loadAcquire();
+    if (!victims)
+        return nullptr;
+
+    enum { MaxStealSize = 32 };
+    const int count = victims->size();
+    for (int i = 0; i < count; ++i) {
+        // start with a different victim each time to spread the contention
+        QThreadPoolThread *victim = victims->at(int(thief->nextVictim++ % uint(count)));
+        if (victim == thief || !victim->localTaskCount.loadRelaxed())
+            continue;
+
+        QRunnable *stolen[MaxStealSize];
+        int stolenCount;
+        int priority;
+        {
+            QMutexLocker victimLocker(&victim->localMutex);
+            stolenCount = qMin((victim->localTasks.size() + 1) / 2, int(MaxStealSize));
+            // take the newest ones, the victim continues with the oldest
+            for (int j = stolenCount - 1; j >= 0; --j)
+                stolen[j] = victim->localTasks.takeLast();
+            victim->localTaskCount.storeRelaxed(victim->localTasks.size());
+            priority = victim->localPriority;
+        }
+        if (!stolenCount)
+            continue;
+
+        if (stolenCount > 1) {
+            QMutexLocker localLocker(&thief->localMutex);
+            Q_ASSERT(thief->localTasks.isEmpty());
+            thief->localPriority = priority;
+            for (int j = 1; j < stolenCount; ++j)
+                thief->localTasks.enqueue(stolen[j]);
+            thief->localTaskCount.storeRelaxed(thief->localTasks.size());
+        }
+        return stolen[0];
+    }
+    return nullptr;
+}
+
+/*!
+    \internal
+
+    Puts the local runnables of \a thread back into the shared queue before
+    the thread expires. Must be called with the mutex locked.
+*/
+void QThreadPoolPrivate::requeueLocalTasks(QThreadPoolThread *thread)
+{
+    if (!thread->localTaskCount.loadRelaxed())
+        return;
+
+    QMutexLocker localLocker(&thread->localMutex);
+    while (!thread->localTasks.isEmpty())
+        enqueueTask(thread->localTasks.dequeue(), thread->localPriority);
+    thread->localTaskCount.storeRelaxed(0);
+    localLocker.unlock();
+    tryToStartMoreThreads();
+}
+
+/*!
+    \internal
+
+    Must be called with the mutex locked whenever runnables were removed
+    from the shared queue.
+*/
+void QThreadPoolPrivate::updateQueueState()
+{
+    queuedHighestPriority.storeRelaxed(queue.isEmpty() ? INT_MIN : queue.first()->priority());
+}
+
+/*!
+    \internal
+
+    Publishes the current set of threads for stealTask(), which runs without
+    the mutex. Lists that are replaced stay alive until no thread can still
+    be using them, see deleteRetiredStealTargets(). Must be called with the
+    mutex locked.
+*/
+void QThreadPoolPrivate::publishStealTargets()
+{
+    const StealTargets *targets = new StealTargets(allThreads.cbegin(), allThreads.cend());
+    if (const StealTargets *old = stealTargets.fetchAndStoreRelease(targets))
+        retiredStealTargets.append(old);
+}
+
+/*!
+    \internal
+
+    Deletes the steal target lists replaced by publishStealTargets(). Only
+    active threads call stealTask() without the mutex, so this must be called
+    with the mutex locked while no thread is active.
+*/
+void QThreadPoolPrivate::deleteRetiredStealTargets()
+{
+    Q_ASSERT(activeThreads == 0);
+    qDeleteAll(retiredStealTargets);
+    retiredStealTargets.clear();
+}
+
 int QThreadPoolPrivate::activeThreadCount() const
 {
     return (allThreads.count()
@@ -239,12 +460,14 @@ void QThreadPoolPrivate::tryToStartMoreThreads()
             break;
 
         page->pop();
+        --queuedTaskCount;
 
         if (page->isFinished()) {
             queue.removeFirst();
             delete page;
         }
     }
+    updateQueueState();
 }
 
 bool QThreadPoolPrivate::tooManyThreadsActive() const
@@ -263,6 +486,7 @@ void QThreadPoolPrivate::startThread(QRunnable *runnable)
     thread->setObjectName(QLatin1String("Thread (pooled)"));
     Q_ASSERT(!allThreads.contains(thread.data())); // if this assert hits, we have an ABA problem (deleted threads don't get removed here)
     allThreads.insert(thread.data());
+    publishStealTargets();
     ++activeThreads;
 
     thread->runnable = runnable;
@@ -281,6 +505,11 @@ void QThreadPoolPrivate::reset()
     allThreadsCopy.swap(allThreads);
     expiredThreads.clear();
     waitingThreads.clear();
+
+    // threads started from now on only see the new steal target lists
+    QVector<const StealTargets *> stealTargetsCopy;
+    stealTargetsCopy.swap(retiredStealTargets);
+    publishStealTargets();
     mutex.unlock();
 
     for (QThreadPoolThread *thread: qAsConst(allThreadsCopy)) {
@@ -290,6 +519,7 @@ void QThreadPoolPrivate::reset()
         }
         delete thread;
     }
+    qDeleteAll(stealTargetsCopy);
 
     mutex.lock();
 }
@@ -324,7 +554,15 @@ bool QThreadPoolPrivate::waitForDone(int msecs)
 
 void QThreadPoolPrivate::clear()
 {
+    // A thread in stealTask() holds the runnables it is moving between two
+    // local queues in neither of them, so they are not found here.
     QMutexLocker locker(&mutex);
+    for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+        QMutexLocker localLocker(&thread->localMutex);
+        while (!thread->localTasks.isEmpty())
+            enqueueTask(thread->localTasks.dequeue(), thread->localPriority);
+        thread->localTaskCount.storeRelaxed(0);
+    }
     while (!queue.isEmpty()) {
         auto *page = queue.takeLast();
         while (!page->isFinished()) {
@@ -338,6 +576,8 @@ void QThreadPoolPrivate::clear()
         }
         delete page;
     }
+    queuedTaskCount = 0;
+    updateQueueState();
 }
 
 /*!
@@ -365,21 +605,35 @@ bool QThreadPool::tryTake(QRunnable *runnable)
         return false;
 
     QMutexLocker locker(&d->mutex);
+    bool found = false;
     for (QueuePage *page : qAsConst(d->queue)) {
         if (page->tryTake(runnable)) {
             if (page->isFinished()) {
                 d->queue.removeOne(page);
                 delete page;
             }
-            if (runnable->autoDelete()) {
-                Q_ASSERT(runnable->ref == 1);
-                --runnable->ref; // undo ++ref in start()
-            }
-            return true;
+            --d->queuedTaskCount;
+            d->updateQueueState();
+            found = true;
+            break;
+        }
+    }
+    for (auto it = d->allThreads.cbegin(), end = d->allThreads.cend(); !found && it != end; ++it) {
+        QThreadPoolThread *thread = *it;
+        QMutexLocker localLocker(&thread->localMutex);
+        if (thread->localTasks.removeOne(runnable)) {
+            thread->localTaskCount.storeRelaxed(thread->localTasks.size());
+            found = true;
         }
     }
+    if (!found)
+        return false;
 
-    return false;
+    if (runnable->autoDelete()) {
+        Q_ASSERT(runnable->ref == 1);
+        --runnable->ref; // undo ++ref in start()
+    }
+    return true;
 }
 
     /*!
@@ -657,6 +911,7 @@ void QThreadPool::setMaxThreadCount(int maxThreadCount)
         return;
 
     d->maxThreadCount = maxThreadCount;
+    d->limitSerial.ref();
     d->tryToStartMoreThreads();
 }
 
@@ -694,6 +949,7 @@ void QThreadPool::reserveThread()
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
     ++d->reservedThreads;
+    d->limitSerial.ref();
 }
 
 /*! \property QThreadPool::stackSize
@@ -761,6 +1017,10 @@ bool QThreadPool::waitForDone(int msecs)
     The runnables for which \l{QRunnable::autoDelete()}{runnable->autoDelete()}
     returns \c true are deleted.
 
+    \note While threads of the pool are running, a few runnables that a
+    thread is just taking over from another one can escape clear() and
+    still run.
+
     \sa start()
 */
 void QThreadPool::clear()
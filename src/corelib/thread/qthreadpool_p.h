@@ -154,11 +154,20 @@ class Q_CORE_EXPORT QThreadPoolPrivate : public QObjectPrivate
 
 public:
     QThreadPoolPrivate();
+    ~QThreadPoolPrivate();
 
     bool tryStart(QRunnable *task);
     void enqueueTask(QRunnable *task, int priority = 0);
     int activeThreadCount() const;
 
+    QRunnable *takeTask(QThreadPoolThread *thread);
+    QRunnable *takeLocalTask(QThreadPoolThread *thread);
+    QRunnable *stealTask(QThreadPoolThread *thief);
+    void requeueLocalTasks(QThreadPoolThread *thread);
+    void updateQueueState();
+    void publishStealTargets();
+    void deleteRetiredStealTargets();
+
     void tryToStartMoreThreads();
     bool tooManyThreadsActive() const;
 
@@ -177,6 +186,18 @@ public:
     QVector<QueuePage*> queue;
     QWaitCondition noActiveThreads;
 
+    // Worker threads move a share of the queued runnables into their own
+    // local queue and other workers steal from there, so that picking up
+    // the next runnable rarely needs the mutex. The atomics below let
+    // workers check without the mutex whether they should come back to the
+    // shared queue or re-evaluate the thread limits.
+    typedef QVector<QThreadPoolThread *> StealTargets;
+    QAtomicPointer<const StealTargets> stealTargets;
+    QVector<const StealTargets *> retiredStealTargets;
+    QAtomicInt queuedHighestPriority;
+    QAtomicInt limitSerial;
+    int queuedTaskCount = 0;
+
     int expiryTimeout = 30000;
     int maxThreadCount = QThread::idealThreadCount();
     int reservedThreads = 0;
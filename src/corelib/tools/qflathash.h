@@ -0,0 +1,780 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFLATHASH_H
+#define QFLATHASH_H
+
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qcontainertools_impl.h>
+#include <QtCore/qhashfunctions.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qrefcount.h>
+
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(Q_PROCESSOR_ARM_64)
+#  include <arm_neon.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace QFlatHashPrivate {
+
+// One control byte per slot: a full slot stores the low 7 bits of its
+// key's hash, free slots have the sign bit set.
+enum : signed char {
+    Empty = -128,
+    Deleted = -2
+};
+
+struct Data
+{
+    QtPrivate::RefCount ref;
+    int size;
+    int capacity;       // power of two, multiple of Group::Width
+    int growthLeft;     // inserts into empty slots left before a rehash
+    uint seed;
+    signed char *ctrl;
+};
+
+// A Group is Width consecutive control bytes which are matched against a
+// value in one go. Matches are reported as a bit mask in which slot n is
+// represented by bit (n << Shift).
+#if defined(__SSE2__)
+struct Group
+{
+    enum { Width = 16, Shift = 0 };
+    typedef uint Mask;
+
+    explicit Group(const signed char *p) noexcept
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))) {}
+
+    Mask match(signed char h2) const noexcept
+    { return uint(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl))); }
+    Mask matchEmpty() const noexcept
+    { return match(Empty); }
+    Mask matchEmptyOrDeleted() const noexcept
+    { return uint(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl))); }
+
+private:
+    __m128i ctrl;
+};
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(Q_PROCESSOR_ARM_64)
+struct Group
+{
+    enum { Width = 16, Shift = 2 };
+    typedef quint64 Mask;
+
+    explicit Group(const signed char *p) noexcept
+        : ctrl(vld1q_s8(reinterpret_cast<const int8_t *>(p))) {}
+
+    Mask match(signed char h2) const noexcept
+    { return toMask(vceqq_s8(ctrl, vdupq_n_s8(h2))); }
+    Mask matchEmpty() const noexcept
+    { return match(Empty); }
+    Mask matchEmptyOrDeleted() const noexcept
+    { return toMask(vcltq_s8(ctrl, vdupq_n_s8(-1))); }
+
+private:
+    // narrow each 0x00/0xff byte to a nibble and keep one bit of it
+    static Mask toMask(uint8x16_t m) noexcept
+    {
+        const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(m), 4);
+        return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & Q_UINT64_C(0x8888888888888888);
+    }
+
+    int8x16_t ctrl;
+};
+#else
+struct Group
+{
+    enum { Width = 16, Shift = 0 };
+    typedef uint Mask;
+
+    explicit Group(const signed char *p) noexcept : ctrl(p) {}
+
+    Mask match(signed char h2) const noexcept
+    {
+        Mask m = 0;
+        for (int i = 0; i < Width; ++i)
+            m |= Mask(ctrl[i] == h2) << i;
+        return m;
+    }
+    Mask matchEmpty() const noexcept
+    { return match(Empty); }
+    Mask matchEmptyOrDeleted() const noexcept
+    {
+        Mask m = 0;
+        for (int i = 0; i < Width; ++i)
+            m |= Mask(ctrl[i] < -1) << i;
+        return m;
+    }
+
+private:
+    const signed char *ctrl;
+};
+#endif
+
+inline int lowestIndex(Group::Mask m) noexcept
+{ return int(qCountTrailingZeroBits(m) >> Group::Shift); }
+inline Group::Mask clearLowest(Group::Mask m) noexcept
+{ return m & (m - 1); }
+
+// qHash() results are not required to have well distributed bits (integers
+// hash to themselves), so finalize them before splitting into the group
+// index and the 7 bits stored in the control byte.
+inline uint mix(uint h) noexcept
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+inline signed char h2(uint h) noexcept { return static_cast<signed char>(h & 0x7f); }
+
+// Triangular probing over the groups; visits every group exactly once
+// because the number of groups is a power of two.
+struct Probe
+{
+    Probe(uint h, int capacity) noexcept
+        : mask(uint(capacity) / Group::Width - 1), group((h >> 7) & mask), step(0) {}
+
+    int offset() const noexcept { return int(group * Group::Width); }
+    void next() noexcept { group = (group + ++step) & mask; }
+
+    uint mask;
+    uint group;
+    uint step;
+};
+
+// At most 7/8 of the slots are used, so every probe finds an empty slot.
+inline int maxLoad(int capacity) noexcept { return capacity - capacity / 8; }
+
+// The largest power of two that fits into an int.
+const int MaxCapacity = 1 << 30;
+
+// Sizes above maxLoad(MaxCapacity) are clamped to the maximum capacity.
+inline int capacityForSize(int size) noexcept
+{
+    Q_ASSERT_X(size <= maxLoad(MaxCapacity), "QFlatHash", "Size exceeds the maximum capacity");
+    int capacity = Group::Width;
+    while (maxLoad(capacity) < size && capacity < MaxCapacity)
+        capacity *= 2;
+    return capacity;
+}
+
+} // namespace QFlatHashPrivate
+
+template <class Key, class T>
+struct QFlatHashNode
+{
+    Key key;
+    T value;
+
+    QFlatHashNode(const Key &key0, const T &value0) : key(key0), value(value0) {}
+    QFlatHashNode(const Key &key0, T &&value0) : key(key0), value(std::move(value0)) {}
+};
+
+template <class Key, class T>
+class QFlatHash
+{
+    typedef QFlatHashNode<Key, T> Node;
+    typedef QFlatHashPrivate::Data Data;
+    typedef QFlatHashPrivate::Group Group;
+
+    Q_STATIC_ASSERT_X(alignof(Node) <= alignof(std::max_align_t),
+                      "QFlatHash does not support over-aligned keys or values");
+
+    Data *d;
+
+    static Q_DECL_CONSTEXPR size_t nodeOffset() noexcept
+    { return (sizeof(Data) + alignof(Node) - 1) & ~(alignof(Node) - 1); }
+    static Node *nodes(Data *data) noexcept
+    { return reinterpret_cast<Node *>(reinterpret_cast<char *>(data) + nodeOffset()); }
+    static int nextFull(const Data *data, int i) noexcept
+    {
+        while (++i < data->capacity && data->ctrl[i] < 0)
+            ;
+        return i;
+    }
+    static int previousFull(const Data *data, int i) noexcept
+    {
+        while (--i > 0 && data->ctrl[i] < 0)
+            ;
+        return i;
+    }
+
+public:
+    inline QFlatHash() noexcept : d(nullptr) { }
+    inline QFlatHash(std::initializer_list<std::pair<Key,T> > list)
+        : d(nullptr)
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<std::pair<Key,T> >::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(it->first, it->second);
+    }
+    QFlatHash(const QFlatHash &other) noexcept : d(other.d) { if (d) d->ref.ref(); }
+    ~QFlatHash() { if (d && !d->ref.deref()) freeData(d); }
+
+    QFlatHash &operator=(const QFlatHash &other) noexcept
+    { QFlatHash copy(other); swap(copy); return *this; }
+    QFlatHash(QFlatHash &&other) noexcept : d(other.d) { other.d = nullptr; }
+    QFlatHash &operator=(QFlatHash &&other) noexcept
+    { QFlatHash moved(std::move(other)); swap(moved); return *this; }
+#ifdef Q_QDOC
+    template <typename InputIterator>
+    QFlatHash(InputIterator f, InputIterator l);
+#else
+    template <typename InputIterator, QtPrivate::IfAssociativeIteratorHasKeyAndValue<InputIterator> = true>
+    QFlatHash(InputIterator f, InputIterator l)
+        : QFlatHash()
+    {
+        QtPrivate::reserveIfForwardIterator(this, f, l);
+        for (; f != l; ++f)
+            insert(f.key(), f.value());
+    }
+
+    template <typename InputIterator, QtPrivate::IfAssociativeIteratorHasFirstAndSecond<InputIterator> = true>
+    QFlatHash(InputIterator f, InputIterator l)
+        : QFlatHash()
+    {
+        QtPrivate::reserveIfForwardIterator(this, f, l);
+        for (; f != l; ++f)
+            insert(f->first, f->second);
+    }
+#endif
+    void swap(QFlatHash &other) noexcept { qSwap(d, other.d); }
+
+    bool operator==(const QFlatHash &other) const;
+    bool operator!=(const QFlatHash &other) const { return !(*this == other); }
+
+    inline int size() const noexcept { return d ? d->size : 0; }
+
+    inline bool isEmpty() const noexcept { return size() == 0; }
+
+    inline int capacity() const noexcept { return d ? d->capacity : 0; }
+    void reserve(int size);
+    void squeeze();
+
+    inline void detach() { if (d && d->ref.isShared()) detach_helper(); }
+    inline bool isDetached() const noexcept { return !d || !d->ref.isShared(); }
+    bool isSharedWith(const QFlatHash &other) const noexcept { return d == other.d; }
+
+    void clear() { *this = QFlatHash(); }
+
+    int remove(const Key &key);
+    T take(const Key &key);
+
+    bool contains(const Key &key) const { return findIndex(key) >= 0; }
+    const Key key(const T &value) const;
+    const Key key(const T &value, const Key &defaultKey) const;
+    const T value(const Key &key) const;
+    const T value(const Key &key, const T &defaultValue) const;
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const { return value(key); }
+
+    QList<Key> keys() const;
+    QList<Key> keys(const T &value) const;
+    QList<T> values() const;
+    int count(const Key &key) const { return contains(key) ? 1 : 0; }
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class const_iterator;
+        friend class QFlatHash<Key, T>;
+        Data *d;
+        int i;
+
+        iterator(Data *data, int index) noexcept : d(data), i(index) { }
+        Node *node() const noexcept { return QFlatHash::nodes(d) + i; }
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        Q_DECL_CONSTEXPR iterator() noexcept : d(nullptr), i(0) { }
+
+        inline const Key &key() const noexcept { return node()->key; }
+        inline T &value() const noexcept { return node()->value; }
+        inline T &operator*() const noexcept { return node()->value; }
+        inline T *operator->() const noexcept { return &node()->value; }
+        inline bool operator==(const iterator &o) const noexcept { return i == o.i && d == o.d; }
+        inline bool operator!=(const iterator &o) const noexcept { return !(*this == o); }
+        inline bool operator==(const const_iterator &o) const noexcept { return i == o.i && d == o.d; }
+        inline bool operator!=(const const_iterator &o) const noexcept { return !(*this == o); }
+
+        inline iterator &operator++() noexcept { i = QFlatHash::nextFull(d, i); return *this; }
+        inline iterator operator++(int) noexcept { iterator r = *this; ++*this; return r; }
+        inline iterator &operator--() noexcept { i = QFlatHash::previousFull(d, i); return *this; }
+        inline iterator operator--(int) noexcept { iterator r = *this; --*this; return r; }
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class iterator;
+        friend class QFlatHash<Key, T>;
+        const Data *d;
+        int i;
+
+        const_iterator(const Data *data, int index) noexcept : d(data), i(index) { }
+        const Node *node() const noexcept { return QFlatHash::nodes(const_cast<Data *>(d)) + i; }
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        Q_DECL_CONSTEXPR const_iterator() noexcept : d(nullptr), i(0) { }
+        const_iterator(const iterator &o) noexcept : d(o.d), i(o.i) { }
+
+        inline const Key &key() const noexcept { return node()->key; }
+        inline const T &value() const noexcept { return node()->value; }
+        inline const T &operator*() const noexcept { return node()->value; }
+        inline const T *operator->() const noexcept { return &node()->value; }
+        inline bool operator==(const const_iterator &o) const noexcept { return i == o.i && d == o.d; }
+        inline bool operator!=(const const_iterator &o) const noexcept { return !(*this == o); }
+
+        inline const_iterator &operator++() noexcept { i = QFlatHash::nextFull(d, i); return *this; }
+        inline const_iterator operator++(int) noexcept { const_iterator r = *this; ++*this; return r; }
+        inline const_iterator &operator--() noexcept { i = QFlatHash::previousFull(d, i); return *this; }
+        inline const_iterator operator--(int) noexcept { const_iterator r = *this; --*this; return r; }
+    };
+    friend class const_iterator;
+
+    // STL style
+    inline iterator begin() { detach(); return iterator(d, d ? nextFull(d, -1) : 0); }
+    inline const_iterator begin() const noexcept { return constBegin(); }
+    inline const_iterator cbegin() const noexcept { return constBegin(); }
+    inline const_iterator constBegin() const noexcept { return const_iterator(d, d ? nextFull(d, -1) : 0); }
+    inline iterator end() { detach(); return iterator(d, capacity()); }
+    inline const_iterator end() const noexcept { return constEnd(); }
+    inline const_iterator cend() const noexcept { return constEnd(); }
+    inline const_iterator constEnd() const noexcept { return const_iterator(d, capacity()); }
+
+    iterator erase(iterator it) { return erase(const_iterator(it)); }
+    iterator erase(const_iterator it);
+
+    iterator find(const Key &key);
+    const_iterator find(const Key &key) const { return constFind(key); }
+    const_iterator constFind(const Key &key) const;
+    iterator insert(const Key &key, const T &value) { return emplace(key, value); }
+    iterator insert(const Key &key, T &&value) { return emplace(key, std::move(value)); }
+    void insert(const QFlatHash &other);
+
+    // STL compatibility
+    typedef T mapped_type;
+    typedef Key key_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    inline bool empty() const noexcept { return isEmpty(); }
+
+    typedef iterator Iterator;
+    typedef const_iterator ConstIterator;
+
+private:
+    static uint hashOf(const Key &key, uint seed)
+    { return QFlatHashPrivate::mix(qHash(key, seed)); }
+
+    int findIndex(const Key &key) const;
+    int findIndex(const Key &key, uint h) const;
+    static int findInsertSlot(const Data *data, uint h) noexcept;
+    template <typename V> iterator emplace(const Key &key, V &&value);
+    void eraseAt(int i) noexcept;
+
+    static Data *allocate(int capacity, uint seed);
+    static void freeData(Data *data) noexcept;
+    void detach_helper();
+    void rehash(int capacity);
+};
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::Data *QFlatHash<Key, T>::allocate(int capacity, uint seed)
+{
+    const size_t ctrlOffset = nodeOffset() + size_t(capacity) * sizeof(Node);
+    Data *data = static_cast<Data *>(::malloc(ctrlOffset + size_t(capacity)));
+    Q_CHECK_PTR(data);
+    data->ref.initializeOwned();
+    data->size = 0;
+    data->capacity = capacity;
+    data->growthLeft = QFlatHashPrivate::maxLoad(capacity);
+    data->seed = seed;
+    data->ctrl = reinterpret_cast<signed char *>(data) + ctrlOffset;
+    ::memset(data->ctrl, QFlatHashPrivate::Empty, size_t(capacity));
+    return data;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::freeData(Data *data) noexcept
+{
+    if (QTypeInfo<Node>::isComplex) {
+        Node *n = nodes(data);
+        for (int i = 0; i < data->capacity; ++i) {
+            if (data->ctrl[i] >= 0)
+                n[i].~Node();
+        }
+    }
+    ::free(data);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::detach_helper()
+{
+    Data *x = allocate(d->capacity, d->seed);
+    Node *from = nodes(d);
+    Node *to = nodes(x);
+    QT_TRY {
+        for (int i = 0; i < d->capacity; ++i) {
+            if (d->ctrl[i] >= 0) {
+                new (to + i) Node(from[i]);
+                x->ctrl[i] = d->ctrl[i];
+            }
+        }
+    } QT_CATCH(...) {
+        freeData(x);
+        QT_RETHROW;
+    }
+    // tombstones are copied along so that probe sequences stay intact
+    ::memcpy(x->ctrl, d->ctrl, size_t(d->capacity));
+    x->size = d->size;
+    x->growthLeft = d->growthLeft;
+    if (!d->ref.deref())
+        freeData(d);
+    d = x;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::rehash(int capacity)
+{
+    Data *x = allocate(capacity, d ? d->seed : uint(qGlobalQHashSeed()));
+    if (d) {
+        Q_ASSERT(!d->ref.isShared());
+        Node *from = nodes(d);
+        Node *to = nodes(x);
+        for (int i = 0; i < d->capacity; ++i) {
+            if (d->ctrl[i] < 0)
+                continue;
+            const uint h = hashOf(from[i].key, x->seed);
+            const int slot = findInsertSlot(x, h);
+            new (to + slot) Node(std::move(from[i]));
+            from[i].~Node();
+            x->ctrl[slot] = QFlatHashPrivate::h2(h);
+        }
+        x->size = d->size;
+        x->growthLeft -= d->size;
+        ::free(d);
+    }
+    d = x;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::findIndex(const Key &key) const
+{
+    if (!d || d->size == 0)
+        return -1;
+    return findIndex(key, hashOf(key, d->seed));
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::findIndex(const Key &key, uint h) const
+{
+    const signed char h2 = QFlatHashPrivate::h2(h);
+    const Node *n = nodes(d);
+    for (QFlatHashPrivate::Probe p(h, d->capacity); ; p.next()) {
+        const Group group(d->ctrl + p.offset());
+        for (Group::Mask m = group.match(h2); m; m = QFlatHashPrivate::clearLowest(m)) {
+            const int i = p.offset() + QFlatHashPrivate::lowestIndex(m);
+            if (n[i].key == key)
+                return i;
+        }
+        if (group.matchEmpty())
+            return -1;
+    }
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::findInsertSlot(const Data *data, uint h) noexcept
+{
+    for (QFlatHashPrivate::Probe p(h, data->capacity); ; p.next()) {
+        if (const Group::Mask m = Group(data->ctrl + p.offset()).matchEmptyOrDeleted())
+            return p.offset() + QFlatHashPrivate::lowestIndex(m);
+    }
+}
+
+template <class Key, class T>
+template <typename V>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::emplace(const Key &key, V &&value)
+{
+    detach();
+    if (!d)
+        rehash(Group::Width);
+    const uint h = hashOf(key, d->seed);
+    int i = findIndex(key, h);
+    if (i >= 0) {
+        nodes(d)[i].value = std::forward<V>(value);
+        return iterator(d, i);
+    }
+
+    i = findInsertSlot(d, h);
+    if (d->growthLeft == 0 && d->ctrl[i] == QFlatHashPrivate::Empty) {
+        if (d->size >= QFlatHashPrivate::maxLoad(QFlatHashPrivate::MaxCapacity))
+            qBadAlloc();
+        // key and value may refer to a node of this hash, which the rehash moves
+        Node node(key, std::forward<V>(value));
+        // rehash in place if it is mostly tombstones that fill the table
+        if (d->size <= QFlatHashPrivate::maxLoad(d->capacity) / 2)
+            rehash(d->capacity);
+        else
+            rehash(d->capacity * 2);
+        i = findInsertSlot(d, h);
+        new (nodes(d) + i) Node(std::move(node));
+    } else {
+        new (nodes(d) + i) Node(key, std::forward<V>(value));
+    }
+    if (d->ctrl[i] == QFlatHashPrivate::Empty)
+        --d->growthLeft;
+    d->ctrl[i] = QFlatHashPrivate::h2(h);
+    ++d->size;
+    return iterator(d, i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::eraseAt(int i) noexcept
+{
+    nodes(d)[i].~Node();
+    --d->size;
+    // A group that still has an empty slot ends every probe sequence that
+    // reaches it, so the slot can become empty again instead of a tombstone.
+    const int groupStart = i & ~(Group::Width - 1);
+    if (Group(d->ctrl + groupStart).matchEmpty()) {
+        d->ctrl[i] = QFlatHashPrivate::Empty;
+        ++d->growthLeft;
+    } else {
+        d->ctrl[i] = QFlatHashPrivate::Deleted;
+    }
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::reserve(int asize)
+{
+    if (asize <= 0)
+        return;
+    detach();
+    if (asize > size() + (d ? d->growthLeft : 0))
+        rehash(qMax(QFlatHashPrivate::capacityForSize(asize), capacity()));
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::squeeze()
+{
+    if (isEmpty()) {
+        clear();
+        return;
+    }
+    detach();
+    rehash(QFlatHashPrivate::capacityForSize(d->size));
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::remove(const Key &key)
+{
+    const int i = findIndex(key);
+    if (i < 0)
+        return 0;
+    detach();
+    eraseAt(i);
+    return 1;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE T QFlatHash<Key, T>::take(const Key &key)
+{
+    const int i = findIndex(key);
+    if (i < 0)
+        return T();
+    detach();
+    T t = std::move(nodes(d)[i].value);
+    eraseAt(i);
+    return t;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(const_iterator it)
+{
+    if (it == constEnd())
+        return end();
+    Q_ASSERT_X(it.d == d, "QFlatHash::erase", "The specified iterator argument 'it' is invalid");
+    const int i = it.i;
+    detach();
+    eraseAt(i);
+    return iterator(d, nextFull(d, i));
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &akey) const
+{
+    const int i = findIndex(akey);
+    return i < 0 ? T() : nodes(d)[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &akey, const T &defaultValue) const
+{
+    const int i = findIndex(akey);
+    return i < 0 ? defaultValue : nodes(d)[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE T &QFlatHash<Key, T>::operator[](const Key &akey)
+{
+    const int i = findIndex(akey);
+    if (i >= 0) {
+        detach();
+        return nodes(d)[i].value;
+    }
+    return *emplace(akey, T());
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE const Key QFlatHash<Key, T>::key(const T &avalue) const
+{
+    return key(avalue, Key());
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE const Key QFlatHash<Key, T>::key(const T &avalue, const Key &defaultKey) const
+{
+    for (const_iterator it = constBegin(), e = constEnd(); it != e; ++it) {
+        if (it.value() == avalue)
+            return it.key();
+    }
+    return defaultKey;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(size());
+    for (const_iterator it = constBegin(), e = constEnd(); it != e; ++it)
+        res.append(it.key());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys(const T &avalue) const
+{
+    QList<Key> res;
+    for (const_iterator it = constBegin(), e = constEnd(); it != e; ++it) {
+        if (it.value() == avalue)
+            res.append(it.key());
+    }
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<T> QFlatHash<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(size());
+    for (const_iterator it = constBegin(), e = constEnd(); it != e; ++it)
+        res.append(it.value());
+    return res;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::find(const Key &akey)
+{
+    detach();
+    const int i = findIndex(akey);
+    return i < 0 ? end() : iterator(d, i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::constFind(const Key &akey) const
+{
+    const int i = findIndex(akey);
+    return i < 0 ? constEnd() : const_iterator(d, i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::insert(const QFlatHash &other)
+{
+    if (d == other.d)
+        return;
+    reserve(size() + other.size());
+    for (const_iterator it = other.constBegin(), e = other.constEnd(); it != e; ++it)
+        insert(it.key(), it.value());
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE bool QFlatHash<Key, T>::operator==(const QFlatHash &other) const
+{
+    if (d == other.d)
+        return true;
+    if (size() != other.size())
+        return false;
+    for (const_iterator it = constBegin(), e = constEnd(); it != e; ++it) {
+        const const_iterator o = other.constFind(it.key());
+        if (o == other.constEnd() || !(o.value() == it.value()))
+            return false;
+    }
+    return true;
+}
+
+QT_END_NAMESPACE
+
+#endif // QFLATHASH_H
@@ -48,11 +48,13 @@
 #endif
 #include <qapplication.h>
 #include <QtCore/qcollator.h>
+#include <QtCore/private/qcollator_p.h>
 #if QT_CONFIG(regularexpression)
 #  include <QtCore/qregularexpression.h>
 #endif
 
 #include <algorithm>
+#include <numeric>
 
 #ifdef Q_OS_WIN
 #  include <QtCore/QVarLengthArray>
@@ -1033,15 +1035,36 @@ void QFileSystemModelPrivate::_q_performDelayedSort()
 class QFileSystemModelSorter
 {
 public:
-    inline QFileSystemModelSorter(int column) : sortColumn(column)
+    typedef QVector<QFileSystemModelPrivate::QFileSystemNode *> NodeList;
+
+    // The names (and types) of all the nodes are collated once up front,
+    // comparisons then only look at the resulting ranks
+    inline QFileSystemModelSorter(int column, const NodeList &nodes)
+        : nodes(nodes), sortColumn(column)
     {
+        QCollator naturalCompare;
         naturalCompare.setNumericMode(true);
         naturalCompare.setCaseSensitivity(Qt::CaseInsensitive);
+
+        QStringList names;
+        names.reserve(nodes.size());
+        for (const auto *node : nodes)
+            names.append(node->fileName);
+        nameRanks = QCollatorSortKeyTable(naturalCompare, names).ranks();
+
+        if (sortColumn == 2) {
+            QStringList types;
+            types.reserve(nodes.size());
+            for (const auto *node : nodes)
+                types.append(node->type());
+            typeRanks = QCollatorSortKeyTable(naturalCompare, types).ranks();
+        }
     }
 
-    bool compareNodes(const QFileSystemModelPrivate::QFileSystemNode *l,
-                    const QFileSystemModelPrivate::QFileSystemNode *r) const
+    bool compareNodes(int lhs, int rhs) const
     {
+        const QFileSystemModelPrivate::QFileSystemNode *l = nodes.at(lhs);
+        const QFileSystemModelPrivate::QFileSystemNode *r = nodes.at(rhs);
         switch (sortColumn) {
         case 0: {
 #ifndef Q_OS_MAC
@@ -1051,7 +1074,7 @@ public:
             if (left ^ right)
                 return left;
 #endif
-            return naturalCompare.compare(l->fileName, r->fileName) < 0;
+            return nameRanks.at(lhs) < nameRanks.at(rhs);
                 }
         case 1:
         {
@@ -1063,22 +1086,21 @@ public:
 
             qint64 sizeDifference = l->size() - r->size();
             if (sizeDifference == 0)
-                return naturalCompare.compare(l->fileName, r->fileName) < 0;
+                return nameRanks.at(lhs) < nameRanks.at(rhs);
 
             return sizeDifference < 0;
         }
         case 2:
         {
-            int compare = naturalCompare.compare(l->type(), r->type());
-            if (compare == 0)
-                return naturalCompare.compare(l->fileName, r->fileName) < 0;
+            if (typeRanks.at(lhs) == typeRanks.at(rhs))
+                return nameRanks.at(lhs) < nameRanks.at(rhs);
 
-            return compare < 0;
+            return typeRanks.at(lhs) < typeRanks.at(rhs);
         }
         case 3:
         {
             if (l->lastModified() == r->lastModified())
-                return naturalCompare.compare(l->fileName, r->fileName) < 0;
+                return nameRanks.at(lhs) < nameRanks.at(rhs);
 
             return l->lastModified() < r->lastModified();
         }
@@ -1087,15 +1109,16 @@ public:
         return false;
     }
 
-    bool operator()(const QFileSystemModelPrivate::QFileSystemNode *l,
-                    const QFileSystemModelPrivate::QFileSystemNode *r) const
+    bool operator()(int lhs, int rhs) const
     {
-        return compareNodes(l, r);
+        return compareNodes(lhs, rhs);
     }
 
 
 private:
-    QCollator naturalCompare;
+    const NodeList &nodes;
+    QVector<int> nameRanks;
+    QVector<int> typeRanks;
     int sortColumn;
 };
 
@@ -1120,8 +1143,10 @@ void QFileSystemModelPrivate::sortChildren(int column, const QModelIndex &parent
             iterator.value()->isVisible = false;
         }
     }
-    QFileSystemModelSorter ms(column);
-    std::sort(values.begin(), values.end(), ms);
+    QFileSystemModelSorter ms(column, values);
+    QVector<int> order(values.count());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), ms);
     // First update the new visible list
     indexNode->visibleChildren.clear();
     //No more dirty item we reset our internal dirty index
@@ -1129,8 +1154,8 @@ void QFileSystemModelPrivate::sortChildren(int column, const QModelIndex &parent
     const int numValues = values.count();
     indexNode->visibleChildren.reserve(numValues);
     for (int i = 0; i < numValues; ++i) {
-        indexNode->visibleChildren.append(values.at(i)->fileName);
-        values.at(i)->isVisible = true;
+        indexNode->visibleChildren.append(values.at(order.at(i))->fileName);
+        values.at(order.at(i))->isVisible = true;
     }
 
     if (!disableRecursiveSort) {
@@ -29,6 +29,7 @@
 #include <QtTest/QtTest>
 
 #include <qtextcodec.h>
+#include <QRandomGenerator>
 #include <QScopedPointer>
 
 static const char utf8bom[] = "\xEF\xBB\xBF";
@@ -61,8 +62,99 @@ private slots:
 
     void nonCharacters_data();
     void nonCharacters();
+
+    void longText_data();
+    void longText();
+    void longUtf16Text_data();
+    void longUtf16Text();
+    void splitSurrogate_data();
+    void splitSurrogate();
 };
 
+// Reference conversions, one code point at a time, with the same error
+// handling as the codec: one replacement per invalid byte or lone surrogate
+static QString referenceFromUtf8(const QByteArray &utf8)
+{
+    QString result;
+    const uchar *src = reinterpret_cast<const uchar *>(utf8.constData());
+    const int size = utf8.size();
+    for (int i = 0; i < size; ) {
+        const uchar b = src[i];
+        if (b < 0x80) {
+            result += QChar(b);
+            ++i;
+            continue;
+        }
+
+        int length = 0;
+        uint uc = 0;
+        uint minimum = 0;
+        if (b >= 0xc2 && b < 0xe0) {
+            length = 2;
+            uc = b & 0x1f;
+            minimum = 0x80;
+        } else if (b >= 0xe0 && b < 0xf0) {
+            length = 3;
+            uc = b & 0x0f;
+            minimum = 0x800;
+        } else if (b >= 0xf0 && b < 0xf5) {
+            length = 4;
+            uc = b & 0x07;
+            minimum = 0x10000;
+        }
+
+        bool valid = length && i + length <= size;
+        for (int j = 1; valid && j < length; ++j) {
+            valid = (src[i + j] & 0xc0) == 0x80;
+            uc = (uc << 6) | (src[i + j] & 0x3f);
+        }
+        valid = valid && uc >= minimum && !QChar::isSurrogate(uc) && uc <= QChar::LastValidCodePoint;
+        if (!valid) {
+            result += QChar(QChar::ReplacementCharacter);
+            ++i;
+        } else if (QChar::requiresSurrogates(uc)) {
+            result += QChar(QChar::highSurrogate(uc));
+            result += QChar(QChar::lowSurrogate(uc));
+            i += length;
+        } else {
+            result += QChar(uc);
+            i += length;
+        }
+    }
+    return result;
+}
+
+static QByteArray referenceToUtf8(const QString &utf16)
+{
+    QByteArray result;
+    for (int i = 0; i < utf16.size(); ++i) {
+        uint uc = utf16.at(i).unicode();
+        if (QChar::isHighSurrogate(uc) && i + 1 < utf16.size() && utf16.at(i + 1).isLowSurrogate()) {
+            uc = QChar::surrogateToUcs4(ushort(uc), utf16.at(++i).unicode());
+        } else if (QChar::isSurrogate(uc)) {
+            result += '?';
+            continue;
+        }
+
+        if (uc < 0x80) {
+            result += char(uc);
+        } else if (uc < 0x800) {
+            result += char(0xc0 | (uc >> 6));
+            result += char(0x80 | (uc & 0x3f));
+        } else if (uc < 0x10000) {
+            result += char(0xe0 | (uc >> 12));
+            result += char(0x80 | ((uc >> 6) & 0x3f));
+            result += char(0x80 | (uc & 0x3f));
+        } else {
+            result += char(0xf0 | (uc >> 18));
+            result += char(0x80 | ((uc >> 12) & 0x3f));
+            result += char(0x80 | ((uc >> 6) & 0x3f));
+            result += char(0x80 | (uc & 0x3f));
+        }
+    }
+    return result;
+}
+
 void tst_Utf8::initTestCase()
 {
     QTest::addColumn<bool>("useLocale");
@@ -273,5 +365,158 @@ void tst_Utf8::nonCharacters()
         qWarning("System codec reports failure when it shouldn't. Should report bug upstream.");
 }
 
+void tst_Utf8::longText_data()
+{
+    QTest::addColumn<QByteArray>("utf8");
+
+    // long enough for the vectorized code paths; the leading ASCII
+    // character keeps the codec from treating any of it as a BOM
+    auto repeated = [](const char *text) {
+        QByteArray result("x");
+        for (int i = 0; i < 8; ++i)
+            result += text;
+        return result;
+    };
+    QTest::newRow("chinese") << repeated("统一码联盟的目标是让全世界的文字都能在电脑上处理。");
+    QTest::newRow("japanese") << repeated("日本語のテキストには、ひらがな、カタカナと漢字が混在します。");
+    QTest::newRow("russian") << repeated("Съешь же ещё этих мягких французских булок, да выпей чаю. ");
+    QTest::newRow("greek") << repeated("Ξεσκεπάζω την ψυχοφθόρα βδελυγμία. ");
+    QTest::newRow("french") << repeated("Le cœur déçu mais l'âme plutôt naïve, Louÿs rêva de crapaüter. ");
+    QTest::newRow("german") << repeated("Falsches Üben von Xylophonmusik quält jeden größeren Zwerg. ");
+    QTest::newRow("mixed") << repeated("Qt 5.15: 文字列 «строка» €100 ½ ∑ 😀 done. ");
+
+    QRandomGenerator rng(0x5eed);
+    auto randomCodePoint = [&rng]() -> uint {
+        switch (rng.bounded(10)) {
+        case 0: case 1: case 2:
+            return rng.bounded(0x20, 0x80);
+        case 3: case 4:
+            return rng.bounded(0x80, 0x800);
+        case 5: case 6: case 7: case 8: {
+            const uint uc = rng.bounded(0x800, 0x10000);
+            return QChar::isSurrogate(uc) ? 0x20ac : uc;
+        }
+        default:
+            return rng.bounded(0x10000, 0x110000);
+        }
+    };
+    static const char *const invalidSequences[] = {
+        "\x80", "\xbf", "\xc0\xaf", "\xc1\xbf", "\xe0\x80\xaf", "\xe0\x9f\xbf",
+        "\xed\xa0\x80", "\xed\xbf\xbf", "\xe4\xb8", "\xc3", "\xf5\x80\x80\x80", "\xff"
+    };
+    for (int row = 0; row < 20; ++row) {
+        const bool withErrors = row % 2;
+        QByteArray utf8("x");
+        const int count = rng.bounded(20, 200);
+        for (int i = 0; i < count; ++i) {
+            if (withErrors && rng.bounded(16) == 0) {
+                utf8 += invalidSequences[rng.bounded(int(sizeof(invalidSequences) / sizeof(*invalidSequences)))];
+            } else {
+                const uint uc = randomCodePoint();
+                utf8 += QString::fromUcs4(&uc, 1).toUtf8();
+            }
+        }
+        QTest::addRow("random-%s-%d", withErrors ? "invalid" : "valid", row) << utf8;
+    }
+}
+
+void tst_Utf8::longText()
+{
+    QFETCH(QByteArray, utf8);
+
+    QTextCodec *utf8Codec = QTextCodec::codecForMib(106);
+    const QString utf16 = referenceFromUtf8(utf8);
+    QCOMPARE(QString::fromUtf8(utf8), utf16);
+    QCOMPARE(utf8Codec->toUnicode(utf8), utf16);
+    QCOMPARE(utf16.toUtf8(), referenceToUtf8(utf16));
+
+    // start at every offset, so that the sequences cross the vector
+    // boundaries at different places
+    for (int offset = 1; offset < 48 && offset < utf8.size(); ++offset) {
+        const QByteArray tail = "x" + utf8.mid(offset);
+        const QString expected = referenceFromUtf8(tail);
+        QCOMPARE(QString::fromUtf8(tail), expected);
+        QCOMPARE(utf8Codec->toUnicode(tail), expected);
+        QCOMPARE(expected.toUtf8(), referenceToUtf8(expected));
+    }
+}
+
+void tst_Utf8::longUtf16Text_data()
+{
+    QTest::addColumn<QString>("utf16");
+
+    QRandomGenerator rng(0xc0de);
+    for (int row = 0; row < 20; ++row) {
+        QString utf16;
+        const int count = rng.bounded(20, 200);
+        for (int i = 0; i < count; ++i) {
+            switch (rng.bounded(8)) {
+            case 0:
+                utf16 += QChar(ushort(rng.bounded(0x20, 0x80)));
+                break;
+            case 1: case 2:
+                utf16 += QChar(ushort(rng.bounded(0x80, 0x800)));
+                break;
+            case 3: case 4: case 5:
+                utf16 += QChar(ushort(rng.bounded(0x800, 0xd800)));
+                break;
+            case 6:
+                // a surrogate pair
+                utf16 += QChar(ushort(rng.bounded(0xd800, 0xdc00)));
+                utf16 += QChar(ushort(rng.bounded(0xdc00, 0xe000)));
+                break;
+            default:
+                // lone surrogates in every third row
+                utf16 += QChar(ushort(row % 3 ? rng.bounded(0xe000, 0x10000)
+                                              : rng.bounded(0xd800, 0xe000)));
+            }
+        }
+        QTest::addRow("random-%d", row) << utf16;
+    }
+}
+
+void tst_Utf8::longUtf16Text()
+{
+    QFETCH(QString, utf16);
+
+    for (int offset = 0; offset < 24 && offset < utf16.size(); ++offset) {
+        const QString tail = utf16.mid(offset);
+        const QByteArray expected = referenceToUtf8(tail);
+        QCOMPARE(tail.toUtf8(), expected);
+
+        // the codec keeps a trailing high surrogate for the next call
+        if (!tail.back().isHighSurrogate())
+            QCOMPARE(QTextCodec::codecForMib(106)->fromUnicode(tail), expected);
+    }
+}
+
+void tst_Utf8::splitSurrogate_data()
+{
+    QTest::addColumn<QChar>("bmpChar");
+
+    QTest::newRow("latin") << QChar(0x00e9);
+    QTest::newRow("cyrillic") << QChar(0x0439);
+    QTest::newRow("cjk") << QChar(0x4e2d);
+}
+
+void tst_Utf8::splitSurrogate()
+{
+    QFETCH(QChar, bmpChar);
+    const QChar pair[] = { QChar::highSurrogate(0x1f600), QChar::lowSurrogate(0x1f600) };
+
+    // the pending high surrogate makes the second call write one byte more
+    // than three per character it gets, right before the block converters
+    QTextCodec *codec = QTextCodec::codecForMib(106);
+    for (int count = 15; count < 50; ++count) {
+        const QString tail = QString(pair[1]) + QString(count, bmpChar);
+        const QScopedPointer<QTextEncoder> encoder(codec->makeEncoder(QTextCodec::IgnoreHeader));
+        QByteArray encoded = encoder->fromUnicode(pair, 1);
+        QVERIFY(encoded.isEmpty());
+        encoded += encoder->fromUnicode(tail);
+        QVERIFY(!encoder->hasFailure());
+        QCOMPARE(encoded, referenceToUtf8(QString(pair[0]) + tail));
+    }
+}
+
 QTEST_MAIN(tst_Utf8)
 #include "tst_utf8.moc"
@@ -82,6 +82,9 @@ int main(int argc, char **argv)
     MyClass cl;
     QMetaObject::invokeMethod(&cl, "mySlot1");
 
+    if (qEnvironmentVariableIsSet("QT_LOGGING_TEST_FATAL"))
+        qFatal("qFatal");
+
     return 0;
 }
 
@@ -61,6 +61,8 @@ private slots:
     void qMessagePattern_data();
     void qMessagePattern();
     void setMessagePattern();
+    void asyncOutput_data();
+    void asyncOutput();
 
     void formatLogMessage_data();
     void formatLogMessage();
@@ -906,6 +908,71 @@ void tst_qmessagehandler::setMessagePattern()
 #endif // QT_CONFIG(process)
 }
 
+void tst_qmessagehandler::asyncOutput_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<bool>("fatal");
+
+    // an empty pattern makes the helper use qSetMessagePattern()
+    QTest::newRow("set-pattern") << QString() << false;
+    QTest::newRow("basic") << "%{type} %{appname} %{line} %{function} %{message}" << false;
+    QTest::newRow("ifs") << "[%{if-debug}D%{endif}%{if-warning}W%{endif}%{if-critical}C%{endif}] "
+                            "%{if-category}%{category}: %{endif}%{message}" << false;
+    QTest::newRow("fatal") << "%{type} %{message}" << true;
+}
+
+void tst_qmessagehandler::asyncOutput()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+#ifdef Q_OS_ANDROID
+    QSKIP("This test crashes on Android");
+#endif
+    QFETCH(QString, pattern);
+    QFETCH(bool, fatal);
+
+#ifndef Q_OS_ANDROID
+    const QString appExe(QLatin1String("helper"));
+#else
+    const QString appExe(QCoreApplication::applicationDirPath() + QLatin1String("/libhelper.so"));
+#endif
+
+    // the output written by the background thread must be the same as the
+    // one written right away, in the same order, including what was logged
+    // right before a fatal message
+    QByteArray outputs[2];
+    for (int async = 0; async < 2; ++async) {
+        QStringList environment;
+        environment.reserve(m_baseEnvironment.size() + 3);
+        std::copy_if(m_baseEnvironment.cbegin(), m_baseEnvironment.cend(),
+                     std::back_inserter(environment), [](const QString &str) {
+            return !str.startsWith(QLatin1String("QT_MESSAGE_PATTERN"))
+                    && !str.startsWith(QLatin1String("QT_LOGGING_ASYNC"));
+        });
+        if (!pattern.isEmpty())
+            environment.prepend("QT_MESSAGE_PATTERN=" + pattern);
+        if (fatal)
+            environment.prepend(QLatin1String("QT_LOGGING_TEST_FATAL=1"));
+        environment.prepend(QLatin1String("QT_LOGGING_ASYNC=") + QString::number(async));
+
+        QProcess process;
+        process.setEnvironment(environment);
+        process.start(appExe);
+        QVERIFY2(process.waitForStarted(), qPrintable(
+            QString::fromLatin1("Could not start %1: %2").arg(appExe, process.errorString())));
+        process.waitForFinished();
+        QCOMPARE(process.exitStatus() == QProcess::CrashExit, fatal);
+        outputs[async] = process.readAllStandardError();
+    }
+
+    QVERIFY(!outputs[0].isEmpty());
+    if (fatal)
+        QVERIFY(outputs[0].endsWith("fatal qFatal\n"));
+    QCOMPARE(QString::fromLocal8Bit(outputs[1]), QString::fromLocal8Bit(outputs[0]));
+#endif // QT_CONFIG(process)
+}
+
 Q_DECLARE_METATYPE(QtMsgType)
 
 void tst_qmessagehandler::formatLogMessage_data()
@@ -1,6 +1,7 @@
 TEMPLATE=subdirs
 SUBDIRS=\
     qabstractfileengine \
+    qasyncfile \
     qbuffer \
     qdataurl \
     qdebug \
@@ -75,3 +76,6 @@ android: SUBDIRS -= \
     qprocess \
     qdir \
     qresourceengine
+
+!qtConfig(asyncfile): SUBDIRS -= \
+    qasyncfile
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qasyncfile
+QT = core-private testlib
+SOURCES = tst_qasyncfile.cpp
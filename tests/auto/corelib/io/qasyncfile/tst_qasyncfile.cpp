@@ -0,0 +1,276 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QAsyncFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/private/qasyncfile_p.h>
+
+Q_DECLARE_METATYPE(QFileDevice::FileError)
+
+class tst_QAsyncFile : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void writeAndRead_data() { backends(); }
+    void writeAndRead();
+    void shortRead_data() { backends(); }
+    void shortRead();
+    void manyRequests_data() { backends(); }
+    void manyRequests();
+    void readError_data() { backends(); }
+    void readError();
+    void destroyWithPendingRequests_data() { backends(); }
+    void destroyWithPendingRequests();
+    void closeFromSlot_data() { backends(); }
+    void closeFromSlot();
+    void deleteFromSlot_data() { backends(); }
+    void deleteFromSlot();
+    void invalidRequests();
+
+private:
+    void backends();
+    void openFile(QAsyncFile &file, QIODevice::OpenMode mode);
+
+    QTemporaryDir dir;
+};
+
+void tst_QAsyncFile::initTestCase()
+{
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+    qRegisterMetaType<QFileDevice::FileError>();
+}
+
+void tst_QAsyncFile::init()
+{
+    // don't let the native rows pass on the fallback backend
+    if (qstrcmp(QTest::currentDataTag(), "native") != 0)
+        return;
+    QAsyncFile probe(dir.filePath(QLatin1String("probe")));
+    QVERIFY2(probe.open(QIODevice::WriteOnly), qPrintable(probe.errorString()));
+    if (!static_cast<QAsyncFilePrivate *>(QObjectPrivate::get(&probe))->nativeBackend)
+        QSKIP("io_uring is not available");
+}
+
+void tst_QAsyncFile::backends()
+{
+    QTest::addColumn<bool>("threadPool");
+    QTest::newRow("native") << false;
+    QTest::newRow("threadpool") << true;
+}
+
+void tst_QAsyncFile::openFile(QAsyncFile &file, QIODevice::OpenMode mode)
+{
+    // the backend is chosen when the file is opened
+    QFETCH(bool, threadPool);
+    if (threadPool)
+        qputenv("QT_NO_IO_URING", "1");
+    QVERIFY2(file.open(mode), qPrintable(file.errorString()));
+    qunsetenv("QT_NO_IO_URING");
+}
+
+void tst_QAsyncFile::writeAndRead()
+{
+    QAsyncFile file(dir.filePath(QTest::currentDataTag()));
+    openFile(file, QIODevice::ReadWrite);
+    QVERIFY(file.isOpen());
+
+    QSignalSpy writeSpy(&file, &QAsyncFile::writeFinished);
+    QSignalSpy errorSpy(&file, &QAsyncFile::errorOccurred);
+    const quint64 first = file.write(0, "Hello, ");
+    const quint64 second = file.write(7, "World");
+    QVERIFY(first);
+    QVERIFY(second);
+    QVERIFY(first != second);
+    QCOMPARE(file.pendingRequests(), 2);
+
+    QTRY_COMPARE(writeSpy.count(), 2);
+    QCOMPARE(errorSpy.count(), 0);
+    QCOMPARE(file.pendingRequests(), 0);
+    QCOMPARE(file.size(), qint64(12));
+
+    QSignalSpy readSpy(&file, &QAsyncFile::readFinished);
+    const quint64 read = file.read(7, 5);
+    QTRY_COMPARE(readSpy.count(), 1);
+    QCOMPARE(readSpy.at(0).at(0).value<quint64>(), read);
+    QCOMPARE(readSpy.at(0).at(1).toByteArray(), QByteArray("World"));
+}
+
+void tst_QAsyncFile::shortRead()
+{
+    const QString name = dir.filePath(QLatin1String("short-") + QTest::currentDataTag());
+    {
+        QFile f(name);
+        QVERIFY(f.open(QIODevice::WriteOnly));
+        f.write("0123456789");
+    }
+
+    QAsyncFile file(name);
+    openFile(file, QIODevice::ReadOnly);
+
+    QSignalSpy readSpy(&file, &QAsyncFile::readFinished);
+    file.read(6, 100);
+    file.read(100, 10);
+    QTRY_COMPARE(readSpy.count(), 2);
+
+    QSet<QByteArray> results;
+    for (const auto &args : qAsConst(readSpy))
+        results.insert(args.at(1).toByteArray());
+    QCOMPARE(results, QSet<QByteArray>({ "6789", QByteArray() }));
+}
+
+void tst_QAsyncFile::manyRequests()
+{
+    QAsyncFile file(dir.filePath(QLatin1String("many-") + QTest::currentDataTag()));
+    openFile(file, QIODevice::ReadWrite);
+
+    // more than fit into a ring at once
+    const int count = 500;
+    const QByteArray block(4096, 'x');
+    QSignalSpy writeSpy(&file, &QAsyncFile::writeFinished);
+    for (int i = 0; i < count; ++i)
+        QVERIFY(file.write(qint64(i) * block.size(), block));
+
+    file.waitForFinished();
+    QCOMPARE(writeSpy.count(), count);
+    QCOMPARE(file.pendingRequests(), 0);
+    QCOMPARE(file.size(), qint64(count) * block.size());
+
+    QSignalSpy readSpy(&file, &QAsyncFile::readFinished);
+    for (int i = 0; i < count; ++i)
+        file.read(qint64(i) * block.size(), block.size());
+    file.close();
+    QCOMPARE(readSpy.count(), count);
+    for (const auto &args : qAsConst(readSpy))
+        QCOMPARE(args.at(1).toByteArray(), block);
+}
+
+void tst_QAsyncFile::readError()
+{
+#ifdef Q_OS_LINUX
+    // page zero is never mapped, so reading it through /proc fails with EIO
+    QAsyncFile file(QStringLiteral("/proc/self/mem"));
+    openFile(file, QIODevice::ReadOnly);
+
+    QSignalSpy errorSpy(&file, &QAsyncFile::errorOccurred);
+    QSignalSpy readSpy(&file, &QAsyncFile::readFinished);
+    const quint64 id = file.read(0, 10);
+    QTRY_COMPARE(errorSpy.count(), 1);
+    QCOMPARE(readSpy.count(), 0);
+    QCOMPARE(errorSpy.at(0).at(0).value<quint64>(), id);
+    QCOMPARE(file.error(), QFileDevice::ReadError);
+    QVERIFY(!file.errorString().isEmpty());
+#else
+    QSKIP("This test requires /proc/self/mem");
+#endif
+}
+
+void tst_QAsyncFile::destroyWithPendingRequests()
+{
+    QScopedPointer<QAsyncFile> file(new QAsyncFile(dir.filePath(QLatin1String("destroy-")
+                                                                + QTest::currentDataTag())));
+    openFile(*file, QIODevice::WriteOnly);
+
+    QSignalSpy writeSpy(file.data(), &QAsyncFile::writeFinished);
+    for (int i = 0; i < 100; ++i)
+        file->write(i * 16, QByteArray(16, 'a'));
+    file.reset();
+    QCOMPARE(writeSpy.count(), 0);
+}
+
+void tst_QAsyncFile::closeFromSlot()
+{
+    QAsyncFile file(dir.filePath(QLatin1String("close-") + QTest::currentDataTag()));
+    openFile(file, QIODevice::WriteOnly);
+
+    // close() reports the remaining requests, including those that completed
+    // together with the one whose slot closes the file, and nothing after
+    QList<quint64> finished;
+    bool closedInSlot = false;
+    connect(&file, &QAsyncFile::writeFinished, [&](quint64 id) {
+        finished.append(id);
+        if (!closedInSlot) {
+            closedInSlot = true;
+            file.close();
+            QVERIFY(!file.isOpen());
+        }
+    });
+    const int count = 50;
+    for (int i = 0; i < count; ++i)
+        QVERIFY(file.write(i * 16, QByteArray(16, 'a')));
+    QTRY_VERIFY(closedInSlot);
+    QCOMPARE(finished.size(), count);
+    QCOMPARE(file.pendingRequests(), 0);
+    QTest::qWait(50);
+    QCOMPARE(finished.size(), count);
+
+    // the file can be opened and used again
+    openFile(file, QIODevice::WriteOnly);
+    QVERIFY(file.write(0, "again"));
+    QTRY_COMPARE(finished.size(), count + 1);
+}
+
+void tst_QAsyncFile::deleteFromSlot()
+{
+    QAsyncFile *file = new QAsyncFile(dir.filePath(QLatin1String("delete-")
+                                                   + QTest::currentDataTag()));
+    openFile(*file, QIODevice::WriteOnly);
+
+    int finished = 0;
+    QPointer<QAsyncFile> guard(file);
+    connect(file, &QAsyncFile::writeFinished, [&]() {
+        ++finished;
+        delete file;
+    });
+    for (int i = 0; i < 50; ++i)
+        file->write(i * 16, QByteArray(16, 'a'));
+    QTRY_VERIFY(!guard);
+    QTest::qWait(50);
+    QCOMPARE(finished, 1);
+}
+
+void tst_QAsyncFile::invalidRequests()
+{
+    QAsyncFile file(dir.filePath(QLatin1String("invalid")));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("QAsyncFile::read: .* not open for reading"));
+    QCOMPARE(file.read(0, 1), quint64(0));
+
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("QAsyncFile::read: .* not open for reading"));
+    QCOMPARE(file.read(0, 1), quint64(0));
+    QTest::ignoreMessage(QtWarningMsg, "QAsyncFile::write: Invalid offset");
+    QCOMPARE(file.write(-1, "x"), quint64(0));
+    QCOMPARE(file.pendingRequests(), 0);
+}
+
+QTEST_MAIN(tst_QAsyncFile)
+#include "tst_qasyncfile.moc"
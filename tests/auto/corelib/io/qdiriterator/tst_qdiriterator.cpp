@@ -103,6 +103,9 @@ private slots:
     void longPath();
     void dirorder();
     void relativePaths();
+    void parallelSubdirectories_data();
+    void parallelSubdirectories();
+    void parallelSubdirectoriesEarlyExit();
 #if defined(Q_OS_WIN)
     void uncPaths_data();
     void uncPaths();
@@ -334,6 +337,35 @@ void tst_QDirIterator::iterateRelativeDirectory_data()
                    "entrylist/directory/dummy,"
                    "entrylist/writable").split(',');
 
+    QTest::newRow("QDir::ParallelSubdirectories | QDir::FollowSymlinks")
+        << QString("entrylist") << QDirIterator::IteratorFlags(QDirIterator::ParallelSubdirectories | QDirIterator::FollowSymlinks)
+        << QDir::Filters(QDir::NoFilter) << QStringList("*")
+        << QString(
+                   "entrylist/.,"
+                   "entrylist/..,"
+                   "entrylist/directory/.,"
+                   "entrylist/directory/..,"
+                   "entrylist/file,"
+#ifndef Q_NO_SYMLINKS
+                   "entrylist/linktofile.lnk,"
+#endif
+                   "entrylist/directory,"
+                   "entrylist/directory/dummy,"
+#if !defined(Q_NO_SYMLINKS) && !defined(Q_NO_SYMLINKS_TO_DIRS)
+                   "entrylist/linktodirectory.lnk,"
+#endif
+                   "entrylist/writable").split(',');
+
+    QTest::newRow("QDir::ParallelSubdirectories / QDir::Files")
+        << QString("entrylist") << QDirIterator::IteratorFlags(QDirIterator::ParallelSubdirectories)
+        << QDir::Filters(QDir::Files) << QStringList("*")
+        << QString("entrylist/directory/dummy,"
+                   "entrylist/file,"
+#ifndef Q_NO_SYMLINKS
+                   "entrylist/linktofile.lnk,"
+#endif
+                   "entrylist/writable").split(',');
+
     QTest::newRow("empty, default")
         << QString("empty") << QDirIterator::IteratorFlags{}
         << QDir::Filters(QDir::NoFilter) << QStringList("*")
@@ -587,6 +619,95 @@ void tst_QDirIterator::relativePaths()
     }
 }
 
+static void createTree(const QString &path, int depth)
+{
+    QDir dir(path);
+    for (int i = 0; i < 10; ++i) {
+        QFile file(dir.filePath(QString::fromLatin1("file%1.txt").arg(i)));
+        QVERIFY2(file.open(QIODevice::WriteOnly), qPrintable(file.errorString()));
+    }
+    QVERIFY(dir.mkdir(QLatin1String(".hidden")));
+    if (depth == 0)
+        return;
+    for (int i = 0; i < 4; ++i) {
+        const QString name = QString::fromLatin1("dir%1").arg(i);
+        QVERIFY(dir.mkdir(name));
+        createTree(dir.filePath(name), depth - 1);
+    }
+}
+
+void tst_QDirIterator::parallelSubdirectories_data()
+{
+    QTest::addColumn<QDir::Filters>("filters");
+    QTest::addColumn<QStringList>("nameFilters");
+
+    QTest::newRow("default") << QDir::Filters(QDir::NoFilter) << QStringList();
+    QTest::newRow("files") << QDir::Filters(QDir::Files) << QStringList();
+    QTest::newRow("dirs") << QDir::Filters(QDir::Dirs | QDir::NoDotAndDotDot) << QStringList();
+    QTest::newRow("hidden") << QDir::Filters(QDir::AllEntries | QDir::Hidden | QDir::NoDotAndDotDot)
+                            << QStringList();
+    QTest::newRow("name filters") << QDir::Filters(QDir::AllEntries | QDir::NoDotAndDotDot)
+                                  << QStringList({"file1*", "dir2"});
+}
+
+void tst_QDirIterator::parallelSubdirectories()
+{
+    QFETCH(QDir::Filters, filters);
+    QFETCH(QStringList, nameFilters);
+
+    QTemporaryDir tempDir;
+    QVERIFY2(tempDir.isValid(), qPrintable(tempDir.errorString()));
+    createTree(tempDir.path(), 3);
+    if (QTest::currentTestFailed())
+        return;
+
+    QStringList expected;
+    QDirIterator sequential(tempDir.path(), nameFilters, filters, QDirIterator::Subdirectories);
+    while (sequential.hasNext())
+        expected << sequential.next();
+    QVERIFY(!expected.isEmpty());
+
+    const QSet<QString> expectedSet(expected.cbegin(), expected.cend());
+    QStringList actual;
+    QSet<QString> seen;
+    QDirIterator parallel(tempDir.path(), nameFilters, filters, QDirIterator::ParallelSubdirectories);
+    while (parallel.hasNext()) {
+        const QString next = parallel.next();
+        QCOMPARE(parallel.filePath(), next);
+        QCOMPARE(parallel.fileInfo(), QFileInfo(next));
+        QCOMPARE(parallel.path(), tempDir.path());
+        actual << next;
+        seen.insert(next);
+
+        // a directory is returned before anything that is inside it
+        const QString parent = parallel.fileInfo().path();
+        if (expectedSet.contains(parent))
+            QVERIFY2(seen.contains(parent), qPrintable(next));
+    }
+    QVERIFY(!parallel.hasNext());
+
+    expected.sort();
+    actual.sort();
+    QCOMPARE(actual, expected);
+}
+
+void tst_QDirIterator::parallelSubdirectoriesEarlyExit()
+{
+    QTemporaryDir tempDir;
+    QVERIFY2(tempDir.isValid(), qPrintable(tempDir.errorString()));
+    createTree(tempDir.path(), 4);
+    if (QTest::currentTestFailed())
+        return;
+
+    // destroying the iterator stops the walk that is still running
+    for (int count : {0, 1, 100}) {
+        QDirIterator it(tempDir.path(), QDirIterator::ParallelSubdirectories);
+        for (int i = 0; i < count && it.hasNext(); ++i)
+            it.next();
+        QVERIFY(it.hasNext());
+    }
+}
+
 #if defined(Q_OS_WIN)
 void tst_QDirIterator::uncPaths_data()
 {
@@ -34,6 +34,7 @@
 #include <QElapsedTimer>
 #include <QTextStream>
 #include <QDir>
+#include <QScopeGuard>
 #if defined(Q_OS_WIN) && !defined(Q_OS_WINRT)
 #include <windows.h>
 #endif
@@ -86,6 +87,10 @@ private slots:
     void watchDirectoryAttributeChanges();
 #endif
 
+    void recursiveWatch_data();
+    void recursiveWatch();
+    void coalescedChanges();
+
 private:
     QString m_tempDirPattern;
 };
@@ -841,5 +846,145 @@ void tst_QFileSystemWatcher::watchDirectoryAttributeChanges()
 }
 #endif
 
+void tst_QFileSystemWatcher::recursiveWatch_data()
+{
+    QTest::addColumn<bool>("allowFanotify");
+
+    // fanotify needs privileges; without them both rows use inotify
+    QTest::newRow("fanotify") << true;
+    QTest::newRow("inotify") << false;
+}
+
+static bool writeFile(const QString &path, const QByteArray &contents)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+        return false;
+    return file.write(contents) == contents.size();
+}
+
+void tst_QFileSystemWatcher::recursiveWatch()
+{
+#ifndef Q_OS_LINUX
+    QSKIP("Recursive watches are only supported on Linux");
+#else
+    QFETCH(bool, allowFanotify);
+    if (!allowFanotify)
+        qputenv("QT_NO_FANOTIFY", "1");
+    auto restoreEnvironment = qScopeGuard([] { qunsetenv("QT_NO_FANOTIFY"); });
+
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY2(temporaryDirectory.isValid(), qPrintable(temporaryDirectory.errorString()));
+    QDir testDir(temporaryDirectory.path());
+    QVERIFY(testDir.mkpath("tree/a/b"));
+    const QString root = testDir.filePath("tree");
+
+    QFileSystemWatcher watcher;
+    QStringList changedPaths;
+    connect(&watcher, &QFileSystemWatcher::pathsChanged,
+            [&changedPaths] (const QStringList &paths) { changedPaths += paths; });
+    FileSystemWatcherSpy directorySpy(&watcher, FileSystemWatcherSpy::SpyOnDirectoryChanged);
+
+    QVERIFY(watcher.addRecursivePath(root));
+    QCOMPARE(watcher.directories(), QStringList(root));
+    QVERIFY(!watcher.addRecursivePath(root + "/a")); // overlaps the tree
+
+    // existing subdirectories
+    const QString existingFile = root + "/a/b/existing.txt";
+    QVERIFY(writeFile(existingFile, "created"));
+    QTRY_VERIFY2(changedPaths.contains(existingFile), qPrintable(changedPaths.join(", ")));
+    QVERIFY(changedPaths.contains(root + "/a/b"));
+    QTRY_VERIFY2(directorySpy.count() > 0, directorySpy.receivedFilesMessage());
+
+    changedPaths.clear();
+    QVERIFY(writeFile(existingFile, "modified"));
+    QTRY_VERIFY2(changedPaths.contains(existingFile), qPrintable(changedPaths.join(", ")));
+
+    // new subdirectories, including what was created in them before they were watched
+    changedPaths.clear();
+    QVERIFY(testDir.mkpath("tree/c/d"));
+    const QString newFile = root + "/c/d/new.txt";
+    QVERIFY(writeFile(newFile, "created"));
+    QTRY_VERIFY2(changedPaths.contains(newFile), qPrintable(changedPaths.join(", ")));
+    QVERIFY(changedPaths.contains(root + "/c"));
+
+    changedPaths.clear();
+    QVERIFY(writeFile(newFile, "modified"));
+    QTRY_VERIFY2(changedPaths.contains(newFile), qPrintable(changedPaths.join(", ")));
+
+    // directories moved within the tree are watched under their new name
+    changedPaths.clear();
+    QVERIFY(testDir.rename("tree/c", "tree/a/e"));
+    QTRY_VERIFY2(changedPaths.contains(root + "/a/e"), qPrintable(changedPaths.join(", ")));
+    QVERIFY(changedPaths.contains(root + "/c"));
+    changedPaths.clear();
+    const QString movedFile = root + "/a/e/d/new.txt";
+    QVERIFY(writeFile(movedFile, "modified"));
+    QTRY_VERIFY2(changedPaths.contains(movedFile), qPrintable(changedPaths.join(", ")));
+
+    // the tree is removed with its root
+    QVERIFY(watcher.removePath(root));
+    QVERIFY(watcher.directories().isEmpty());
+    changedPaths.clear();
+    QVERIFY(writeFile(existingFile, "unwatched"));
+    QTest::qWait(200);
+    QVERIFY2(changedPaths.isEmpty(), qPrintable(changedPaths.join(", ")));
+
+    // removing the root directory ends the watch
+    QVERIFY(watcher.addRecursivePath(root));
+    directorySpy.clear();
+    QVERIFY(QDir(root).removeRecursively());
+    QTRY_VERIFY(watcher.directories().isEmpty());
+    QVERIFY2(directorySpy.count() > 0, directorySpy.receivedFilesMessage());
+#endif
+}
+
+void tst_QFileSystemWatcher::coalescedChanges()
+{
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY2(temporaryDirectory.isValid(), qPrintable(temporaryDirectory.errorString()));
+    QDir testDir(temporaryDirectory.path());
+    const QString fileName = testDir.filePath("coalesced.txt");
+    const QString otherFileName = testDir.filePath("other.txt");
+    QVERIFY(writeFile(fileName, "created"));
+    QVERIFY(writeFile(otherFileName, "created"));
+
+    QFileSystemWatcher watcher;
+    QCOMPARE(watcher.coalescingInterval(), 0);
+    watcher.setCoalescingInterval(300);
+    QCOMPARE(watcher.coalescingInterval(), 300);
+    QVERIFY(watcher.addPath(fileName));
+    QVERIFY(watcher.addPath(otherFileName));
+
+    FileSystemWatcherSpy fileSpy(&watcher, FileSystemWatcherSpy::SpyOnFileChanged);
+    QList<QStringList> batches;
+    connect(&watcher, &QFileSystemWatcher::pathsChanged,
+            [&batches] (const QStringList &paths) { batches.append(paths); });
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < 5; ++i) {
+        QVERIFY(writeFile(fileName, QByteArray::number(i)));
+        QCoreApplication::processEvents();
+    }
+    QVERIFY(writeFile(otherFileName, "modified"));
+    if (timer.elapsed() >= 300)
+        QSKIP("The changes took longer than the coalescing interval");
+
+    QTRY_COMPARE(batches.size(), 1);
+    QCOMPARE(batches.first(), QStringList() << fileName << otherFileName);
+    QCOMPARE(fileSpy.count(), 2);
+    QTest::qWait(400);
+    QCOMPARE(batches.size(), 1);
+
+    // paths removed from the watcher are not reported anymore
+    QVERIFY(writeFile(fileName, "modified"));
+    QTest::qWait(50);
+    QVERIFY(watcher.removePath(fileName));
+    QTest::qWait(400);
+    QCOMPARE(batches.size(), 1);
+    QCOMPARE(fileSpy.count(), 2);
+}
+
 QTEST_MAIN(tst_QFileSystemWatcher)
 #include "tst_qfilesystemwatcher.moc"
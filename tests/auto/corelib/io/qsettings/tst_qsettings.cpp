@@ -178,6 +178,7 @@ private slots:
     void testVariantTypes();
     void testMetaTypes_data();
     void testMetaTypes();
+    void indexedFormat();
 #endif
     void rainersSyncBugOnMac_data();
     void rainersSyncBugOnMac();
@@ -288,6 +289,7 @@ static void populateWithFormats()
     QTest::newRow("ini") << QSettings::IniFormat;
     QTest::newRow("custom1") << QSettings::CustomFormat1;
     QTest::newRow("custom2") << QSettings::CustomFormat2;
+    QTest::newRow("indexed") << QSettings::IndexedFormat;
 }
 
 tst_QSettings::tst_QSettings()
@@ -1366,7 +1368,7 @@ void tst_QSettings::testVariantTypes()
 
     // We store key sequences as strings instead of binary variant blob, for improved
     // readability in the resulting format.
-    if (format >= QSettings::InvalidFormat) {
+    if (format >= QSettings::InvalidFormat || format == QSettings::IndexedFormat) {
         testVal("keysequence", QKeySequence(Qt::ControlModifier + Qt::Key_F1), QKeySequence, KeySequence);
     } else {
         testVal("keysequence",
@@ -3583,6 +3585,103 @@ void tst_QSettings::dontReorderIniKeysNeedlessly()
 }
 #endif
 
+#ifdef QT_BUILD_INTERNAL
+void tst_QSettings::indexedFormat()
+{
+    const QString fileName = settingsPath("indexed.qsettings");
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        for (int i = 0; i < 1000; ++i)
+            settings.setValue(QString("group%1/key%2").arg(i % 10).arg(i), i);
+        settings.setValue("size", QSize(4, 56));
+        settings.sync();
+        QCOMPARE(settings.status(), QSettings::NoError);
+    }
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray indexed = file.readAll();
+    file.close();
+
+    // changes are appended to the file
+    {
+        QConfFile::clearCache();
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QCOMPARE(settings.value("group3/key3"), QVariant(3));
+        QCOMPARE(settings.value("size"), QVariant(QSize(4, 56)));
+        QVERIFY(!settings.contains("group3/key4"));
+        settings.setValue("group3/key3", "changed");
+        settings.setValue("group3/new", true);
+        settings.remove("group4");
+        settings.sync();
+        QCOMPARE(settings.status(), QSettings::NoError);
+    }
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray contents = file.readAll();
+    file.close();
+    QVERIFY(contents.size() > indexed.size());
+    QVERIFY(contents.startsWith(indexed));
+
+    {
+        QConfFile::clearCache();
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QCOMPARE(settings.value("group3/key3"), QVariant("changed"));
+        QCOMPARE(settings.value("group3/new"), QVariant(true));
+        QCOMPARE(settings.value("group3/key13"), QVariant(13));
+        QVERIFY(!settings.contains("group4/key4"));
+        settings.beginGroup("group3");
+        QCOMPARE(settings.childKeys().size(), 101);
+        settings.endGroup();
+        QCOMPARE(settings.childGroups().size(), 9);
+        QCOMPARE(settings.allKeys().size(), 902);
+    }
+
+    // a damaged record at the end is ignored, and the file is rewritten on the next change
+    QVERIFY(file.open(QIODevice::Append));
+    file.write("\x10\0\0\0garbage", 11);
+    file.close();
+    {
+        QConfFile::clearCache();
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QCOMPARE(settings.value("group3/key3"), QVariant("changed"));
+        settings.setValue("group3/key3", 3);
+        settings.sync();
+        QCOMPARE(settings.status(), QSettings::NoError);
+    }
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    contents = file.readAll();
+    file.close();
+    QVERIFY(!contents.endsWith("garbage"));
+    {
+        QConfFile::clearCache();
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QCOMPARE(settings.value("group3/key3"), QVariant(3));
+        QCOMPARE(settings.allKeys().size(), 902);
+    }
+
+    // the changes are merged into the index before they add up
+    {
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        for (int i = 0; i < 100; ++i) {
+            settings.setValue("group0/key0", QString(1000, QLatin1Char('a' + i % 26)));
+            settings.sync();
+            QCOMPARE(settings.status(), QSettings::NoError);
+        }
+    }
+    QVERIFY(QFileInfo(fileName).size() < 2 * contents.size());
+    {
+        QConfFile::clearCache();
+        QSettings settings(fileName, QSettings::IndexedFormat);
+        QCOMPARE(settings.value("group0/key0"), QVariant(QString(1000, QLatin1Char('a' + 99 % 26))));
+        QCOMPARE(settings.allKeys().size(), 902);
+    }
+}
+#endif
+
 void tst_QSettings::rainersSyncBugOnMac_data()
 {
     ctor_data();
@@ -2889,6 +2889,48 @@ void tst_QSortFilterProxyModel::sortStable()
     QCOMPARE(lastItemData, filterModel->index(2,0, firstRoot).data());
 }
 
+void tst_QSortFilterProxyModel::sortLocaleAware()
+{
+    const QStringList strings = { "banana", "Apple", QString(), "apple", QString::fromUtf8("\xc3\xa9" "clair"),
+                                  "Zebra", "eclair", "banana", "", "cherry", "10", "9" };
+    QStringListModel model(strings);
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.setSortLocaleAware(true);
+
+    auto proxyStrings = [&proxy]() {
+        QStringList result;
+        for (int row = 0; row < proxy.rowCount(); ++row)
+            result.append(proxy.index(row, 0).data().toString());
+        return result;
+    };
+
+    QStringList expected = strings;
+    std::stable_sort(expected.begin(), expected.end(), [](const QString &a, const QString &b) {
+        return a.localeAwareCompare(b) < 0;
+    });
+    proxy.sort(0, Qt::AscendingOrder);
+    QCOMPARE(proxyStrings(), expected);
+
+    expected = strings;
+    std::stable_sort(expected.begin(), expected.end(), [](const QString &a, const QString &b) {
+        return b.localeAwareCompare(a) < 0;
+    });
+    proxy.sort(0, Qt::DescendingOrder);
+    QCOMPARE(proxyStrings(), expected);
+
+    // numbers are not compared as strings
+    QStandardItemModel numbers;
+    for (int value : { 10, 9, 100, 1 }) {
+        QStandardItem *item = new QStandardItem;
+        item->setData(value, Qt::DisplayRole);
+        numbers.appendRow(item);
+    }
+    proxy.setSourceModel(&numbers);
+    proxy.sort(0, Qt::AscendingOrder);
+    QCOMPARE(proxyStrings(), QStringList({ "1", "9", "10", "100" }));
+}
+
 void tst_QSortFilterProxyModel::hiddenColumns()
 {
     class MyStandardItemModel : public QStandardItemModel
@@ -113,6 +113,7 @@ private slots:
     void sortColumnTracking2();
 
     void sortStable();
+    void sortLocaleAware();
 
     void hiddenColumns();
     void insertRowsSort();
@@ -532,6 +532,80 @@ void tst_QCoreApplication::deliverInDefinedOrder()
     QObject::connect(&obj, SIGNAL(done()), &app, SLOT(quit()));
     app.exec();
 }
+
+class HoppingReceiver : public QObject
+{
+public:
+    enum { Producers = 4, CallsPerProducer = 5000, HopInterval = 97 };
+
+    HoppingReceiver(QThread *first, QThread *second)
+        : threads{first, second}
+    {
+        std::fill_n(lastSequence, int(Producers), -1);
+    }
+
+    void receive(int producer, int sequence)
+    {
+        if (thread() != QThread::currentThread())
+            ++wrongThread;
+        if (sequence <= lastSequence[producer])
+            ++outOfOrder;
+        lastSequence[producer] = sequence;
+
+        if (++received == Producers * CallsPerProducer)
+            done.release();
+        else if (received % HopInterval == 0)
+            moveToThread(threads[thread() == threads[0] ? 1 : 0]);
+    }
+
+    QThread *threads[2];
+    int lastSequence[Producers];
+    int received = 0;
+    int wrongThread = 0;
+    int outOfOrder = 0;
+    QSemaphore done;
+};
+
+void tst_QCoreApplication::queuedCallsWhileMoving()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    // queued calls are posted without locking the receiver's event list;
+    // none may be lost or delivered in the wrong thread or order while the
+    // receiver keeps moving between threads
+    QThread first;
+    QThread second;
+    first.start();
+    second.start();
+
+    HoppingReceiver receiver(&first, &second);
+    receiver.moveToThread(&first);
+
+    QVector<QThread *> producers;
+    for (int p = 0; p < HoppingReceiver::Producers; ++p) {
+        producers << QThread::create([&receiver, p]() {
+            for (int i = 0; i < HoppingReceiver::CallsPerProducer; ++i)
+                QMetaObject::invokeMethod(&receiver, [&receiver, p, i]() { receiver.receive(p, i); },
+                                          Qt::QueuedConnection);
+        });
+        producers.last()->start();
+    }
+
+    const bool finished = receiver.done.tryAcquire(1, 60000);
+    for (QThread *producer : qAsConst(producers))
+        QVERIFY(producer->wait());
+    qDeleteAll(producers);
+    first.quit();
+    second.quit();
+    QVERIFY(first.wait());
+    QVERIFY(second.wait());
+
+    QVERIFY(finished);
+    QCOMPARE(receiver.wrongThread, 0);
+    QCOMPARE(receiver.outOfOrder, 0);
+}
 #endif // QT_CONFIG(thread)
 
 void tst_QCoreApplication::applicationPid()
@@ -1,4 +1,4 @@
 CONFIG += testcase
 TARGET = tst_qeventdispatcher
-QT = core testlib
+QT = core-private testlib
 SOURCES += tst_qeventdispatcher.cpp
@@ -33,6 +33,11 @@
 #  include <QtCore/QCoreApplication>
 #endif
 #include <QtTest/QtTest>
+#include <QtCore/private/qglobal_p.h>
+
+#if QT_CONFIG(epoll)
+#  include <unistd.h>
+#endif
 
 enum {
     PreciseTimerInterval    =   10,
@@ -69,6 +74,9 @@ private slots:
     void processEventsOnlySendsQueuedEvents();
     void postedEventsPingPong();
     void eventLoopExit();
+#if QT_CONFIG(epoll)
+    void epollBackend();
+#endif
 };
 
 bool tst_QEventDispatcher::event(QEvent *e)
@@ -419,5 +427,52 @@ void tst_QEventDispatcher::eventLoopExit()
     QVERIFY(!timeoutObserved);
 }
 
+#if QT_CONFIG(epoll)
+void tst_QEventDispatcher::epollBackend()
+{
+    // QEventDispatcherUNIX switches to epoll when QT_EVENTDISPATCHER_EPOLL is
+    // set at construction; secondary threads create their dispatcher on start
+    qputenv("QT_EVENTDISPATCHER_EPOLL", "1");
+    auto cleanup = qScopeGuard([] { qunsetenv("QT_EVENTDISPATCHER_EPOLL"); });
+
+    int fds[2];
+    QCOMPARE(::pipe(fds), 0);
+    auto closeFds = qScopeGuard([&fds] { ::close(fds[0]); ::close(fds[1]); });
+
+    int reads = 0;
+    int result = -1;
+    QScopedPointer<QThread> thread(QThread::create([&]() {
+        QEventLoop loop;
+        const auto poke = [&]() {
+            if (::write(fds[1], "x", 1) != 1)
+                loop.exit(3);
+        };
+
+        QSocketNotifier reader(fds[0], QSocketNotifier::Read);
+        QObject::connect(&reader, &QSocketNotifier::activated, [&]() {
+            char c;
+            if (::read(fds[0], &c, 1) != 1)
+                loop.exit(2);
+            // toggling the notifier removes and re-adds the registration
+            reader.setEnabled(false);
+            if (++reads == 3) {
+                loop.exit(0);
+                return;
+            }
+            reader.setEnabled(true);
+            QTimer::singleShot(PreciseTimerInterval, Qt::PreciseTimer, poke);
+        });
+        QTimer::singleShot(0, poke);
+        QTimer::singleShot(5000, [&loop]() { loop.exit(1); });
+        result = loop.exec();
+    }));
+    thread->start();
+    QVERIFY(thread->wait(10000));
+
+    QCOMPARE(result, 0);
+    QCOMPARE(reads, 3);
+}
+#endif
+
 QTEST_MAIN(tst_QEventDispatcher)
 #include "tst_qeventdispatcher.moc"
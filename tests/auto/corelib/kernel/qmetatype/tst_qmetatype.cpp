@@ -72,6 +72,7 @@ private:
 private slots:
     void defined();
     void threadSafety();
+    void lookupWhileRegistering();
     void namespaces();
     void id();
     void qMetaTypeId();
@@ -459,6 +460,77 @@ void tst_QMetaType::threadSafety()
     QCOMPARE(Bar::failureCount, 0);
 }
 
+struct ConvertedWhileRegistering
+{
+    QString toString() const { return QString(); }
+};
+Q_DECLARE_METATYPE(ConvertedWhileRegistering)
+
+class MetaTypeReader : public QThread
+{
+public:
+    MetaTypeReader(const QVector<QByteArray> &names, const QVector<int> &types)
+        : names(names), types(types) {}
+
+    QAtomicInt stop;
+    int failureCount = 0;
+
+protected:
+    void run() override
+    {
+        const int convertedId = qMetaTypeId<ConvertedWhileRegistering>();
+        while (!stop.loadAcquire()) {
+            for (int i = 0; i < names.size(); ++i) {
+                if (QMetaType::type(names.at(i)) != types.at(i))
+                    ++failureCount;
+                if (QMetaType::typeName(types.at(i)) != names.at(i))
+                    ++failureCount;
+                if (QMetaType::sizeOf(types.at(i)) != int(sizeof(Bar)))
+                    ++failureCount;
+            }
+            if (!QMetaType::hasRegisteredConverterFunction(convertedId, QMetaType::QString))
+                ++failureCount;
+        }
+    }
+
+private:
+    const QVector<QByteArray> names;
+    const QVector<int> types;
+};
+
+void tst_QMetaType::lookupWhileRegistering()
+{
+    // Readers of already registered types must see consistent data while
+    // other types are being registered concurrently.
+    QVector<QByteArray> names;
+    QVector<int> types;
+    for (int i = 0; i < 50; ++i) {
+        names.append("LookupWhileRegistering" + QByteArray::number(i));
+        types.append(qRegisterMetaType<Bar>(names.last().constData()));
+    }
+    QMetaType::registerConverter<ConvertedWhileRegistering, QString>(&ConvertedWhileRegistering::toString);
+
+    MetaTypeReader r1(names, types);
+    MetaTypeReader r2(names, types);
+    r1.start();
+    r2.start();
+
+    for (int i = 0; i < 2000; ++i) {
+        const QByteArray name = "LookupWhileRegisteringNew" + QByteArray::number(i);
+        const int id = qRegisterMetaType<Bar>(name.constData());
+        QCOMPARE(QMetaType::type(name), id);
+        QCOMPARE(QMetaType::registerTypedef((name + "Alias").constData(), id), id);
+        QCOMPARE(QMetaType::type(name + "Alias"), id);
+    }
+
+    r1.stop.storeRelease(1);
+    r2.stop.storeRelease(1);
+    QVERIFY(r1.wait());
+    QVERIFY(r2.wait());
+    QCOMPARE(r1.failureCount, 0);
+    QCOMPARE(r2.failureCount, 0);
+}
+
 namespace TestSpace
 {
     struct Foo { double d; public: ~Foo() {} };
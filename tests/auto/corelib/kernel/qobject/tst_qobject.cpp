@@ -92,6 +92,9 @@ private slots:
     void recursiveSignalEmission();
     void signalBlocking();
     void blockingQueuedConnection();
+    void batchedConnection();
+    void batchedConnectionUnregisteredType();
+    void arenaAllocation();
     void childEvents();
     void installEventFilter();
     void deleteSelfInSlot();
@@ -3084,6 +3087,225 @@ void tst_QObject::blockingQueuedConnection()
     }
 }
 
+class BatchedSender : public QObject
+{
+    Q_OBJECT
+signals:
+    void send(int value, const QString &string);
+};
+
+class BatchedReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    QVector<int> values;
+    QStringList strings;
+    int metaCallEvents = 0;
+    int deleteAfter = -1;
+    bool wrongThread = false;
+
+    bool inOrder() const
+    {
+        for (int i = 0; i < values.size(); ++i) {
+            if (values.at(i) != i || strings.at(i) != QString::number(i))
+                return false;
+        }
+        return true;
+    }
+
+public slots:
+    void receive(int value, const QString &string)
+    {
+        if (thread() != QThread::currentThread())
+            wrongThread = true;
+        values << value;
+        strings << string;
+        if (values.size() == deleteAfter)
+            delete this;
+    }
+
+protected:
+    bool event(QEvent *e) override
+    {
+        if (e->type() == QEvent::MetaCall)
+            ++metaCallEvents;
+        return QObject::event(e);
+    }
+};
+
+class BatchedEmitterThread : public QThread
+{
+public:
+    BatchedEmitterThread(BatchedSender *sender, int count) : sender(sender), count(count) {}
+
+    void run() override
+    {
+        for (int i = 0; i < count; ++i)
+            emit sender->send(i, QString::number(i));
+    }
+
+    BatchedSender *sender;
+    int count;
+};
+
+void tst_QObject::batchedConnection()
+{
+    const auto batched = Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection);
+    {
+        // all calls queued before the event loop runs arrive in one event
+        BatchedSender sender;
+        BatchedReceiver receiver;
+        QVERIFY(connect(&sender, &BatchedSender::send, &receiver, &BatchedReceiver::receive, batched));
+        for (int i = 0; i < 1000; ++i)
+            emit sender.send(i, QString::number(i));
+        QVERIFY(receiver.values.isEmpty());
+        QCoreApplication::processEvents();
+        QCOMPARE(receiver.values.size(), 1000);
+        QVERIFY(receiver.inOrder());
+        QCOMPARE(receiver.metaCallEvents, 1);
+
+        // and the next batch starts a new event
+        emit sender.send(1000, QStringLiteral("1000"));
+        QCoreApplication::processEvents();
+        QCOMPARE(receiver.values.size(), 1001);
+        QCOMPARE(receiver.metaCallEvents, 2);
+    }
+    {
+        // across threads, with a string-based connection
+        BatchedSender sender;
+        BatchedReceiver receiver;
+        QVERIFY(receiver.connect(&sender, SIGNAL(send(int,QString)), SLOT(receive(int,QString)),
+                                 Qt::ConnectionType(Qt::AutoConnection | Qt::BatchedConnection)));
+        BatchedEmitterThread thread(&sender, 20000);
+        thread.start();
+        QVERIFY(thread.wait());
+        QTRY_COMPARE(receiver.values.size(), 20000);
+        QVERIFY(receiver.inOrder());
+        QVERIFY(!receiver.wrongThread);
+        QVERIFY(receiver.metaCallEvents < 20000);
+    }
+    {
+        // a batch stops at a slot deleting the receiver
+        BatchedSender sender;
+        QPointer<BatchedReceiver> receiver = new BatchedReceiver;
+        receiver->deleteAfter = 3;
+        connect(&sender, &BatchedSender::send, receiver.data(), &BatchedReceiver::receive, batched);
+        for (int i = 0; i < 10; ++i)
+            emit sender.send(i, QString::number(i));
+        QCoreApplication::processEvents();
+        QVERIFY(!receiver);
+    }
+    {
+        // destroying the receiver drops its pending batch
+        BatchedSender sender;
+        BatchedReceiver *receiver = new BatchedReceiver;
+        connect(&sender, &BatchedSender::send, receiver, &BatchedReceiver::receive, batched);
+        for (int i = 0; i < 10; ++i)
+            emit sender.send(i, QString::number(i));
+        delete receiver;
+        emit sender.send(10, QStringLiteral("10"));
+        QCoreApplication::processEvents();
+    }
+    {
+        // and so does removing its event
+        BatchedSender sender;
+        BatchedReceiver receiver;
+        connect(&sender, &BatchedSender::send, &receiver, &BatchedReceiver::receive, batched);
+        for (int i = 0; i < 10; ++i)
+            emit sender.send(100 + i, QString::number(i));
+        QCoreApplication::removePostedEvents(&receiver, QEvent::MetaCall);
+        emit sender.send(0, QStringLiteral("0"));
+        QCoreApplication::processEvents();
+        QCOMPARE(receiver.values, QVector<int>{0});
+    }
+}
+
+struct BatchedUnregisteredType {};
+
+class BatchedUnregisteredSender : public QObject
+{
+    Q_OBJECT
+signals:
+    void send(BatchedUnregisteredType);
+public slots:
+    void receive(BatchedUnregisteredType) {}
+};
+
+void tst_QObject::batchedConnectionUnregisteredType()
+{
+    // the batched flag does not skip the checks for queued arguments
+    const auto batched = Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection);
+    const char *warning = "QObject::connect: Cannot queue arguments of type 'BatchedUnregisteredType'\n"
+                          "(Make sure 'BatchedUnregisteredType' is registered using qRegisterMetaType().)";
+    BatchedUnregisteredSender object;
+
+    QTest::ignoreMessage(QtWarningMsg, warning);
+    QVERIFY(!connect(&object, SIGNAL(send(BatchedUnregisteredType)),
+                     &object, SLOT(receive(BatchedUnregisteredType)), batched));
+
+    const QMetaObject *mo = object.metaObject();
+    const QMetaMethod signal = mo->method(mo->indexOfSignal("send(BatchedUnregisteredType)"));
+    const QMetaMethod slot = mo->method(mo->indexOfSlot("receive(BatchedUnregisteredType)"));
+    QTest::ignoreMessage(QtWarningMsg, warning);
+    QVERIFY(!connect(&object, signal, &object, slot, batched));
+}
+
+void tst_QObject::arenaAllocation()
+{
+    QExplicitlySharedDataPointer<QObjectArena> arena(new QObjectArena);
+    QObject *root;
+    QObject *child = nullptr;
+    QTimer *timer;
+    {
+        QObjectArena::Scope scope(arena.data());
+        QCOMPARE(QObjectArena::current(), arena.data());
+        root = new QObject;
+        for (int i = 0; i < 100; ++i) {
+            child = new QObject(root);
+            child->setObjectName(QString::number(i));
+            child->setProperty("index", i);
+        }
+        timer = new QTimer(root);
+        timer->start(1000);
+
+        {
+            QObjectArena::Scope nested(nullptr);
+            QVERIFY(!QObjectArena::current());
+            QObject heapObject;
+            QVERIFY(!QObjectPrivate::get(&heapObject)->arena);
+        }
+        QCOMPARE(QObjectArena::current(), arena.data());
+    }
+    QVERIFY(!QObjectArena::current());
+    QCOMPARE(QObjectPrivate::get(root)->arena, arena.data());
+    QCOMPARE(QObjectPrivate::get(child)->arena, arena.data());
+    QCOMPARE(QObjectPrivate::get(timer)->arena, arena.data());
+    QVERIFY(timer->isActive());
+
+    // objects created outside of the scope live on the heap, even as children
+    QObject *heapChild = new QObject(root);
+    QVERIFY(!QObjectPrivate::get(heapChild)->arena);
+    heapChild->setObjectName(QStringLiteral("heap"));
+
+    QObject *found = root->findChild<QObject *>(QStringLiteral("42"));
+    QVERIFY(found);
+    QCOMPARE(found->property("index").toInt(), 42);
+    found->setProperty("late", true);  // extra data created after the scope ended
+    QVERIFY(found->property("late").toBool());
+
+    int destroyedCount = 0;
+    const QObjectList children = root->children();
+    for (QObject *object : children)
+        connect(object, &QObject::destroyed, [&destroyedCount] { ++destroyedCount; });
+
+    // the arena stays alive as long as objects allocated from it do
+    arena.reset();
+    delete found;
+    QCOMPARE(destroyedCount, 1);
+    delete root;
+    QCOMPARE(destroyedCount, children.size());
+}
+
 class EventSpy : public QObject
 {
     Q_OBJECT
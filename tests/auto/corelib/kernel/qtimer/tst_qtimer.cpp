@@ -40,6 +40,8 @@
 #include <qthread.h>
 #include <qelapsedtimer.h>
 
+#include <memory>
+
 #if defined Q_OS_UNIX
 #include <unistd.h>
 #endif
@@ -88,6 +90,7 @@ private slots:
     void dontBlockEvents();
     void postedEventsShouldNotStarveTimers();
     void callOnTimeout();
+    void manyTimers();
 };
 
 void tst_QTimer::zeroTimer()
@@ -1043,6 +1046,47 @@ void tst_QTimer::callOnTimeout()
     QVERIFY(!connection);
 }
 
+void tst_QTimer::manyTimers()
+{
+    // exercises the timer heap with removals from the middle, restarts and
+    // removal of all timers of one object, interleaved with activation
+    const int count = 3000;
+    std::vector<std::unique_ptr<QTimer>> timers;
+    QVector<int> fired(count);
+    for (int i = 0; i < count; ++i) {
+        timers.emplace_back(new QTimer);
+        QTimer *timer = timers.back().get();
+        timer->setSingleShot(true);
+        timer->setTimerType(Qt::TimerType(i % 3));
+        timer->setInterval(20 + (i * 37) % 200);
+        connect(timer, &QTimer::timeout, [&fired, i] { ++fired[i]; });
+        timer->start();
+    }
+
+    // a multi-timer object whose timers all go away at once
+    QObject *owner = new QObject;
+    for (int i = 0; i < 100; ++i)
+        owner->startTimer(10 + i);
+
+    for (int i = 0; i < count; i += 5)
+        timers[i]->stop();
+    for (int i = 1; i < count; i += 5)
+        timers[i]->start(10);
+    delete owner;
+
+    for (int i = 0; i < count; ++i) {
+        if (i % 5)
+            QVERIFY(timers[i]->remainingTime() >= 0);
+        else
+            QCOMPARE(timers[i]->remainingTime(), -1);
+    }
+
+    QTRY_VERIFY_WITH_TIMEOUT(std::count(fired.cbegin(), fired.cend(), 1) == count - count / 5,
+                             5000);
+    for (int i = 0; i < count; i += 5)
+        QCOMPARE(fired.at(i), 0);
+}
+
 class OrderHelper : public QObject
 {
     Q_OBJECT
@@ -4,7 +4,7 @@ requires(qtConfig(private_tests))
 
 TARGET = tst_qmimedatabase-cache
 
-QT = core testlib concurrent
+QT = core-private testlib concurrent
 
 SOURCES = tst_qmimedatabase-cache.cpp
 HEADERS = ../tst_qmimedatabase.h
@@ -4,7 +4,7 @@ requires(qtConfig(private_tests))
 
 TARGET = tst_qmimedatabase-xml
 
-QT = core testlib concurrent
+QT = core-private testlib concurrent
 
 SOURCES += tst_qmimedatabase-xml.cpp
 HEADERS += ../tst_qmimedatabase.h
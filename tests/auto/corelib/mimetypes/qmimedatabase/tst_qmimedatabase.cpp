@@ -29,6 +29,7 @@
 #include <qmimedatabase.h>
 
 #include "qstandardpaths.h"
+#include <private/qmimeprovider_p.h>
 
 #ifdef Q_OS_UNIX
 #include <sys/types.h>
@@ -546,6 +547,10 @@ void tst_QMimeDatabase::mimeTypeForData_data()
     QTest::newRow("PDF magic") << QByteArray("%PDF-") << "application/pdf";
     QTest::newRow("PHP, High-priority rule") << QByteArray("<?php") << "application/x-php";
     QTest::newRow("diff\\t") << QByteArray("diff\t") << "text/x-patch";
+    const quint16 cpioMagic = 070707; // host16 rule, stored in host byte order
+    QTest::newRow("cpio, host-endian magic")
+        << QByteArray(reinterpret_cast<const char *>(&cpioMagic), sizeof(cpioMagic)).append("0000")
+        << "application/x-cpio";
     QTest::newRow("unknown") << QByteArray("\001abc?}") << "application/octet-stream";
 }
 
@@ -852,6 +857,82 @@ void tst_QMimeDatabase::findByFile()
 }
 
 
+void tst_QMimeDatabase::internalDatabaseCache()
+{
+#if QT_CONFIG(mimetype_database)
+    // The binary cache embedded in QtCore must describe exactly the same
+    // database as the embedded XML it was generated from.
+    QMimeXMLProvider xml(nullptr, QMimeProviderBase::InternalDatabase);
+    QMimeBinaryProvider binary(nullptr, QMimeProviderBase::InternalDatabase);
+    QVERIFY(xml.isValid());
+    if (!binary.isValid())
+        QSKIP("QtCore was built without a prebuilt MIME cache");
+
+    QList<QMimeType> xmlTypes;
+    xml.addAllMimeTypes(xmlTypes);
+    QList<QMimeType> binaryTypes;
+    binary.addAllMimeTypes(binaryTypes);
+    QCOMPARE(binaryTypes.count(), xmlTypes.count());
+
+    for (const QMimeType &mime : qAsConst(xmlTypes)) {
+        const QString name = mime.name();
+        QVERIFY2(binary.mimeTypeForName(name).isValid(), qPrintable(name));
+
+        QStringList xmlList, binaryList;
+        xml.addParents(name, xmlList);
+        binary.addParents(name, binaryList);
+        xmlList.sort();
+        binaryList.sort();
+        QCOMPARE(binaryList, xmlList);
+
+        xmlList.clear();
+        binaryList.clear();
+        xml.addAliases(name, xmlList);
+        binary.addAliases(name, binaryList);
+        xmlList.sort();
+        binaryList.sort();
+        QCOMPARE(binaryList, xmlList);
+
+        const QStringList patterns = mime.globPatterns();
+        for (QString fileName : patterns) {
+            if (fileName.contains(QLatin1Char('[')))
+                continue;
+            fileName.replace(QLatin1Char('*'), QLatin1Char('x')).replace(QLatin1Char('?'), QLatin1Char('x'));
+            QMimeGlobMatchResult xmlResult, binaryResult;
+            xml.addFileNameMatches(fileName, xmlResult);
+            binary.addFileNameMatches(fileName, binaryResult);
+            xmlResult.m_matchingMimeTypes.sort();
+            binaryResult.m_matchingMimeTypes.sort();
+            QCOMPARE(binaryResult.m_matchingMimeTypes, xmlResult.m_matchingMimeTypes);
+        }
+    }
+
+    const quint16 cpioMagic = 070707;
+    const QByteArray samples[] = {
+        QByteArray("%PDF-1.4"),
+        QByteArray("<?php echo 1;"),
+        QByteArray("\x89PNG\r\n\x1a\n"),
+        QByteArray("\x1f\x8b\x08\x00", 4),
+        QByteArray("\x7f" "ELF\x02\x01\x01", 7),
+        QByteArray("PK\x03\x04"),
+        QByteArray("#!/bin/sh\n"),
+        QByteArray("\x78\x9f\x3e\x22"),
+        QByteArray(reinterpret_cast<const char *>(&cpioMagic), sizeof(cpioMagic)),
+        QByteArray("\001abc?}"),
+    };
+    for (const QByteArray &data : samples) {
+        int xmlAccuracy = 0, binaryAccuracy = 0;
+        QMimeType xmlCandidate, binaryCandidate;
+        xml.findByMagic(data, &xmlAccuracy, xmlCandidate);
+        binary.findByMagic(data, &binaryAccuracy, binaryCandidate);
+        QCOMPARE(binaryCandidate.name(), xmlCandidate.name());
+        QCOMPARE(binaryAccuracy, xmlAccuracy);
+    }
+#else
+    QSKIP("QtCore was built without the internal MIME database");
+#endif
+}
+
 void tst_QMimeDatabase::fromThreads()
 {
     QThreadPool tp;
@@ -67,6 +67,7 @@ private slots:
     void suffixes();
     void knownSuffix();
     void symlinkToFifo();
+    void internalDatabaseCache();
     void fromThreads();
 
     // shared-mime-info test suite
@@ -107,6 +107,8 @@ private Q_SLOTS:
     void invalidBinaryData();
     void parseNumbers();
     void parseStrings();
+    void parseLongStrings();
+    void fromRawJson();
     void parseDuplicateKeys();
     void testParser();
 
@@ -2261,6 +2263,93 @@ void tst_QtJson::parseStrings()
 
 }
 
+void tst_QtJson::parseLongStrings()
+{
+    // the parser scans strings and white space in blocks of up to 32 bytes,
+    // put the interesting bytes at every offset around the block boundaries
+    for (int length = 0; length < 70; ++length) {
+        const QByteArray plain(length, 'a');
+        const QString expected = QString::fromLatin1(plain);
+        const QByteArray indent(length, ' ');
+
+        QByteArray json = "[" + indent + "\"" + plain + "\"," + indent + "\n\"" + plain + "\\n"
+                + plain + "\",\t\"" + plain + UNICODE_DJE + plain + "\"]";
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        QJsonArray array = doc.array();
+        QCOMPARE(array.size(), 3);
+        QCOMPARE(array.at(0).toString(), expected);
+        QCOMPARE(array.at(1).toString(), expected + QLatin1Char('\n') + expected);
+        QCOMPARE(array.at(2).toString(), expected + QString::fromUtf8(UNICODE_DJE) + expected);
+
+        // invalid UTF-8 is still found after a long run of ASCII
+        json = "[\"" + plain + "\xff" + plain + "\"]";
+        doc = QJsonDocument::fromJson(json, &error);
+        QCOMPARE(error.error, QJsonParseError::IllegalUTF8String);
+
+        json = "[\"" + plain;
+        doc = QJsonDocument::fromJson(json, &error);
+        QCOMPARE(error.error, QJsonParseError::UnterminatedString);
+    }
+}
+
+void tst_QtJson::fromRawJson()
+{
+    const QByteArray json = "{ \"name\": \"plain\", \"utf8\": \"gr\xc3\xbc\xc3\x9f\", "
+                            "\"escaped\": \"a\\tb\", \"list\": [ \"one\", 2, \"three\" ], "
+                            "\"nested\": { \"key\": \"value\" } }";
+    QJsonParseError error;
+    const QJsonDocument expected = QJsonDocument::fromJson(json);
+    QJsonDocument doc = QJsonDocument::fromRawJson(json, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(doc, expected);
+    QCOMPARE(doc.toJson(), expected.toJson());
+    QCOMPARE(doc.object().value("utf8").toString(), QString::fromUtf8("gr\xc3\xbc\xc3\x9f"));
+    QCOMPARE(doc.object().value("escaped").toString(), QStringLiteral("a\tb"));
+    QCOMPARE(QCborValue::fromJsonValue(doc.object()), QCborValue::fromJsonValue(expected.object()));
+
+    // strings refer to the buffer passed in
+    QByteArray buffer = "[\"abc\", \"abc\"]";
+    {
+        const QJsonDocument raw = QJsonDocument::fromRawJson(QByteArray::fromRawData(buffer.constData(),
+                                                                                   buffer.size()));
+        buffer[3] = 'X';
+        QCOMPARE(raw.array().at(0).toString(), QStringLiteral("aXc"));
+        QCOMPARE(raw.array().at(1).toString(), QStringLiteral("abc"));
+    }
+
+    // values outlive the document and the caller's copy of the buffer
+    QJsonValue name;
+    QJsonArray list;
+    {
+        QByteArray temporary = json;
+        temporary.detach();
+        QJsonObject object = QJsonDocument::fromRawJson(temporary).object();
+        name = object.value("name");
+        list = object.value("list").toArray();
+        object.insert("name", "changed");
+        QCOMPARE(object.value("name").toString(), QStringLiteral("changed"));
+        QCOMPARE(object.take("utf8").toString(), QString::fromUtf8("gr\xc3\xbc\xc3\x9f"));
+    }
+    QCOMPARE(name.toString(), QStringLiteral("plain"));
+    QCOMPARE(list, expected.object().value("list").toArray());
+
+    // mixing values from different buffers
+    QJsonArray other = QJsonDocument::fromRawJson("[\"four\"]").array();
+    other.append(list.at(0));
+    other.append(name);
+    list.append(other.at(0));
+    list.removeAt(1);
+    QCOMPARE(other, QJsonArray({ "four", "one", "plain" }));
+    QCOMPARE(list, QJsonArray({ "one", "three", "four" }));
+
+    // errors are reported as with fromJson()
+    doc = QJsonDocument::fromRawJson("[\"unterminated", &error);
+    QVERIFY(doc.isNull());
+    QCOMPARE(error.error, QJsonParseError::UnterminatedString);
+}
+
 void tst_QtJson::parseDuplicateKeys()
 {
     const char *json = "{ \"B\": true, \"A\": null, \"B\": false }";
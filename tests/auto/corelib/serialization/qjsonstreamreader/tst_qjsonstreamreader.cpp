@@ -0,0 +1,407 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QBuffer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonStreamReader>
+
+class tst_QJsonStreamReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void tokens();
+    void scalars_data();
+    void scalars();
+    void incremental_data();
+    void incremental();
+    void device();
+    void readValue_data();
+    void readValue();
+    void readValueIncremental();
+    void skipCurrentValue();
+    void multipleDocuments();
+    void byteOrderMark();
+    void errors_data();
+    void errors();
+    void deepNesting();
+};
+
+typedef QVector<QJsonStreamReader::TokenType> TokenList;
+Q_DECLARE_METATYPE(TokenList)
+
+static const char sampleDocument[] =
+        "{ \"name\": \"Qt\", \"tags\": [ true, null, 1.5, -3 ], \"empty\": {}, \"list\": [] }";
+
+static QString dump(QJsonStreamReader &reader)
+{
+    QString result;
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QJsonStreamReader::StartArray: result += '['; break;
+        case QJsonStreamReader::EndArray: result += ']'; break;
+        case QJsonStreamReader::StartObject: result += '{'; break;
+        case QJsonStreamReader::EndObject: result += '}'; break;
+        case QJsonStreamReader::Name: result += reader.text() + ':'; break;
+        case QJsonStreamReader::String: result += '"' + reader.text() + "\","; break;
+        case QJsonStreamReader::Number: result += QString::number(reader.toDouble()) + ','; break;
+        case QJsonStreamReader::Bool: result += reader.toBool() ? "true," : "false,"; break;
+        case QJsonStreamReader::Null: result += "null,"; break;
+        case QJsonStreamReader::EndDocument: result += '$'; break;
+        case QJsonStreamReader::NoToken:
+        case QJsonStreamReader::Invalid:
+            break;
+        }
+    }
+    return result;
+}
+
+void tst_QJsonStreamReader::tokens()
+{
+    QJsonStreamReader reader{QByteArray(sampleDocument)};
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+
+    const TokenList expected = {
+        QJsonStreamReader::StartObject,
+        QJsonStreamReader::Name, QJsonStreamReader::String,
+        QJsonStreamReader::Name, QJsonStreamReader::StartArray,
+        QJsonStreamReader::Bool, QJsonStreamReader::Null,
+        QJsonStreamReader::Number, QJsonStreamReader::Number,
+        QJsonStreamReader::EndArray,
+        QJsonStreamReader::Name, QJsonStreamReader::StartObject, QJsonStreamReader::EndObject,
+        QJsonStreamReader::Name, QJsonStreamReader::StartArray, QJsonStreamReader::EndArray,
+        QJsonStreamReader::EndObject,
+        QJsonStreamReader::EndDocument
+    };
+    const QVector<int> depths = { 1, 1, 1, 1, 2, 2, 2, 2, 2, 1, 1, 2, 1, 1, 2, 1, 0, 0 };
+
+    TokenList actual;
+    QVector<int> actualDepths;
+    while (!reader.atEnd()) {
+        actual << reader.readNext();
+        actualDepths << reader.depth();
+    }
+    QCOMPARE(actual, expected);
+    QCOMPARE(actualDepths, depths);
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.tokenString(), QStringLiteral("EndDocument"));
+    QCOMPARE(reader.offset(), qint64(strlen(sampleDocument)));
+}
+
+void tst_QJsonStreamReader::scalars_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QJsonValue>("value");
+
+    QTest::newRow("true") << QByteArray("[true]") << QJsonValue(true);
+    QTest::newRow("false") << QByteArray("[false]") << QJsonValue(false);
+    QTest::newRow("null") << QByteArray("[null]") << QJsonValue(QJsonValue::Null);
+    QTest::newRow("zero") << QByteArray("[0]") << QJsonValue(0);
+    QTest::newRow("int64") << QByteArray("[-9007199254740993]") << QJsonValue(qint64(-9007199254740993LL));
+    QTest::newRow("double") << QByteArray("[2.5e3]") << QJsonValue(2500);
+    QTest::newRow("fraction") << QByteArray("[0.125]") << QJsonValue(0.125);
+    QTest::newRow("string") << QByteArray("[\"plain\"]") << QJsonValue("plain");
+    QTest::newRow("empty-string") << QByteArray("[\"\"]") << QJsonValue("");
+    QTest::newRow("escapes") << QByteArray("[\"a\\\"b\\\\c\\n\\u00e9\"]")
+                             << QJsonValue(QString::fromUtf8("a\"b\\c\n\xc3\xa9"));
+    QTest::newRow("utf8") << QByteArray("[\"z\xc3\xbc\xe2\x82\xac\"]")
+                          << QJsonValue(QString::fromUtf8("z\xc3\xbc\xe2\x82\xac"));
+    QTest::newRow("surrogates") << QByteArray("[\"\\ud83d\\ude00 \xf0\x9f\x98\x80\"]")
+                                << QJsonValue(QString::fromUtf8("\xf0\x9f\x98\x80 \xf0\x9f\x98\x80"));
+    QTest::newRow("trailing-backslash") << QByteArray("[\"\\\\\"]") << QJsonValue("\\");
+}
+
+void tst_QJsonStreamReader::scalars()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QJsonValue, value);
+
+    QJsonStreamReader reader(json);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    reader.readNext();
+    QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+    QCOMPARE(reader.value(), value);
+    QCOMPARE(reader.readValue(), value);
+    QCOMPARE(reader.value(), QJsonDocument::fromJson(json).array().at(0));
+    if (value.isDouble()) {
+        QCOMPARE(reader.toDouble(), value.toDouble());
+        QCOMPARE(reader.isInteger(), double(qint64(value.toDouble())) == value.toDouble());
+    }
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+}
+
+void tst_QJsonStreamReader::incremental_data()
+{
+    QTest::addColumn<int>("chunkSize");
+
+    for (int size : { 1, 2, 3, 7, 64 })
+        QTest::addRow("%d", size) << size;
+}
+
+void tst_QJsonStreamReader::incremental()
+{
+    QFETCH(int, chunkSize);
+
+    const QByteArray json = QByteArray(sampleDocument)
+            + "\n[\"\\u00e9\\\\\\\"\xc3\xa9\", 12345678] \"\\\\\" 42";
+    QJsonStreamReader whole(json);
+    whole.finishData();
+    const QString expected = dump(whole);
+    QVERIFY(expected.endsWith("42,$"));
+
+    QJsonStreamReader reader;
+    QString actual;
+    for (int i = 0; i < json.size(); i += chunkSize) {
+        reader.addData(json.mid(i, chunkSize));
+        actual += dump(reader);
+        QVERIFY(reader.error() != QJsonStreamReader::NotWellFormedError);
+    }
+    // a number at the very end of the input is only complete once the
+    // reader knows that nothing follows
+    QVERIFY(!actual.endsWith("42,"));
+    reader.finishData();
+    actual += dump(reader);
+    QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+
+    // every chunk ends the document in between values
+    actual.remove('$');
+    QCOMPARE(actual + '$', expected.left(expected.size() - 1).remove('$') + '$');
+}
+
+void tst_QJsonStreamReader::device()
+{
+    QByteArray json = "[";
+    for (int i = 0; i < 100000; ++i)
+        json += "{\"id\":" + QByteArray::number(i) + ",\"name\":\"item\"},";
+    json += "null]";
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.device(), &buffer);
+
+    qint64 sum = 0;
+    int count = 0;
+    while (!reader.atEnd()) {
+        if (reader.readNext() == QJsonStreamReader::Name && reader.text() == QLatin1String("id")) {
+            QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+            sum += reader.toInteger();
+            ++count;
+        }
+    }
+    QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndDocument);
+    QCOMPARE(count, 100000);
+    QCOMPARE(sum, qint64(99999) * 100000 / 2);
+}
+
+void tst_QJsonStreamReader::readValue_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("sample") << QByteArray(sampleDocument);
+    QTest::newRow("nested") << QByteArray("[[[]],{\"a\":[{\"b\":\"]}\\\"[{\"}]}]");
+    QTest::newRow("empty-array") << QByteArray("[]");
+    QTest::newRow("empty-object") << QByteArray("{}");
+}
+
+void tst_QJsonStreamReader::readValue()
+{
+    QFETCH(QByteArray, json);
+
+    const QJsonDocument document = QJsonDocument::fromJson(json);
+    QVERIFY(!document.isNull());
+    const QJsonValue expected = document.isArray() ? QJsonValue(document.array())
+                                                   : QJsonValue(document.object());
+
+    QJsonStreamReader reader(json);
+    reader.readNext();
+    QCOMPARE(reader.readValue(), expected);
+    QVERIFY(reader.isEndArray() || reader.isEndObject());
+    QCOMPARE(reader.depth(), 0);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+
+    // nested values
+    QJsonStreamReader inner("{\"outer\":" + json + ",\"after\":1}");
+    inner.readNext();
+    QCOMPARE(inner.readNext(), QJsonStreamReader::Name);
+    inner.readNext();
+    QCOMPARE(inner.readValue(), expected);
+    QCOMPARE(inner.depth(), 1);
+    QCOMPARE(inner.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(inner.text(), QStringLiteral("after"));
+    QCOMPARE(inner.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(inner.readNext(), QJsonStreamReader::EndObject);
+}
+
+void tst_QJsonStreamReader::readValueIncremental()
+{
+    const QByteArray json(sampleDocument);
+    QJsonStreamReader reader;
+    reader.addData(json.left(5));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonValue::Undefined));
+    QCOMPARE(reader.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::StartObject);
+    QVERIFY(reader.atEnd());
+
+    reader.addData(json.mid(5));
+    QVERIFY(!reader.atEnd());
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonDocument::fromJson(json).object()));
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+
+    // an invalid container is reported by readValue()
+    QJsonStreamReader invalid(QByteArray("[1, 2 3]"));
+    invalid.readNext();
+    QCOMPARE(invalid.readValue(), QJsonValue(QJsonValue::Undefined));
+    QCOMPARE(invalid.error(), QJsonStreamReader::NotWellFormedError);
+    QVERIFY(invalid.atEnd());
+}
+
+void tst_QJsonStreamReader::skipCurrentValue()
+{
+    QJsonStreamReader reader{QByteArray(sampleDocument)};
+    reader.readNext();
+    QVERIFY(reader.skipCurrentValue());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+
+    QJsonStreamReader partial{QByteArray(sampleDocument)};
+    partial.readNext();
+    partial.readNext();
+    partial.readNext();
+    QCOMPARE(partial.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(partial.readNext(), QJsonStreamReader::StartArray);
+    QVERIFY(partial.skipCurrentValue());
+    QCOMPARE(partial.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(partial.text(), QStringLiteral("empty"));
+
+    QJsonStreamReader unterminated(QByteArray("[[1, 2]"));
+    unterminated.readNext();
+    QVERIFY(!unterminated.skipCurrentValue());
+    QCOMPARE(unterminated.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+}
+
+void tst_QJsonStreamReader::multipleDocuments()
+{
+    QJsonStreamReader reader(QByteArray("{\"a\":1}\n{\"a\":2}\r\n[3] \"four\" 5\n"));
+    QVector<QJsonValue> values;
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (reader.depth() == 0 && reader.tokenType() != QJsonStreamReader::EndDocument)
+            values << reader.value();
+        else if (reader.depth() == 1 && (reader.isStartObject() || reader.isStartArray()))
+            values << reader.readValue();
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(values.size(), 5);
+    QCOMPARE(values.at(0), QJsonValue(QJsonObject{{"a", 1}}));
+    QCOMPARE(values.at(1), QJsonValue(QJsonObject{{"a", 2}}));
+    QCOMPARE(values.at(2), QJsonValue(QJsonArray{3}));
+    QCOMPARE(values.at(3), QJsonValue("four"));
+    QCOMPARE(values.at(4), QJsonValue(5));
+}
+
+void tst_QJsonStreamReader::byteOrderMark()
+{
+    QJsonStreamReader reader(QByteArray("\xef\xbb\xbf[1]"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+
+    QJsonStreamReader invalid(QByteArray("\xef\xbb[1]"));
+    QCOMPARE(invalid.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(invalid.error(), QJsonStreamReader::NotWellFormedError);
+}
+
+void tst_QJsonStreamReader::errors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QJsonStreamReader::Error>("error");
+    QTest::addColumn<qint64>("errorOffset");
+
+    QTest::newRow("unterminated-array") << QByteArray("[1, 2") << QJsonStreamReader::PrematureEndOfDocumentError << qint64(-1);
+    QTest::newRow("unterminated-string") << QByteArray("[\"abc") << QJsonStreamReader::PrematureEndOfDocumentError << qint64(-1);
+    QTest::newRow("partial-literal") << QByteArray("[tr") << QJsonStreamReader::PrematureEndOfDocumentError << qint64(-1);
+    QTest::newRow("missing-separator") << QByteArray("[1 2]") << QJsonStreamReader::NotWellFormedError << qint64(3);
+    QTest::newRow("missing-colon") << QByteArray("{\"a\" 1}") << QJsonStreamReader::NotWellFormedError << qint64(5);
+    QTest::newRow("trailing-comma") << QByteArray("{\"a\":1,}") << QJsonStreamReader::NotWellFormedError << qint64(7);
+    QTest::newRow("bad-name") << QByteArray("{a:1}") << QJsonStreamReader::NotWellFormedError << qint64(1);
+    QTest::newRow("bad-literal") << QByteArray("[nul]") << QJsonStreamReader::NotWellFormedError << qint64(1);
+    QTest::newRow("bad-value") << QByteArray("[#]") << QJsonStreamReader::NotWellFormedError << qint64(1);
+    QTest::newRow("bad-number") << QByteArray("[1.2.3]") << QJsonStreamReader::NotWellFormedError << qint64(4);
+    QTest::newRow("plus-sign") << QByteArray("[+1]") << QJsonStreamReader::NotWellFormedError << qint64(1);
+    QTest::newRow("leading-zero") << QByteArray("[01]") << QJsonStreamReader::NotWellFormedError << qint64(2);
+    QTest::newRow("no-integer-part") << QByteArray("[.5]") << QJsonStreamReader::NotWellFormedError << qint64(1);
+    QTest::newRow("no-fraction") << QByteArray("[1.]") << QJsonStreamReader::NotWellFormedError << qint64(3);
+    QTest::newRow("minus-only") << QByteArray("[-]") << QJsonStreamReader::NotWellFormedError << qint64(2);
+    QTest::newRow("no-exponent") << QByteArray("[1e+]") << QJsonStreamReader::NotWellFormedError << qint64(4);
+    QTest::newRow("bad-escape") << QByteArray("[\"\\u12\"]") << QJsonStreamReader::NotWellFormedError << qint64(2);
+    QTest::newRow("bad-utf8") << QByteArray("[\"\xff\"]") << QJsonStreamReader::NotWellFormedError << qint64(2);
+}
+
+void tst_QJsonStreamReader::errors()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QJsonStreamReader::Error, error);
+    QFETCH(qint64, errorOffset);
+
+    QJsonStreamReader reader(json);
+    while (!reader.atEnd())
+        reader.readNext();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), error);
+    QVERIFY(!reader.errorString().isEmpty());
+    if (errorOffset >= 0)
+        QVERIFY2(reader.errorString().endsWith(QString::number(errorOffset)),
+                 qPrintable(reader.errorString()));
+
+    // a well-formedness error is final
+    if (error == QJsonStreamReader::NotWellFormedError) {
+        reader.addData("]");
+        QVERIFY(reader.atEnd());
+        QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    }
+}
+
+void tst_QJsonStreamReader::deepNesting()
+{
+    QJsonStreamReader reader(QByteArray(2000, '['));
+    while (!reader.atEnd())
+        reader.readNext();
+    QCOMPARE(reader.error(), QJsonStreamReader::NotWellFormedError);
+    QCOMPARE(reader.depth(), 1024);
+}
+
+QTEST_APPLESS_MAIN(tst_QJsonStreamReader)
+
+#include "tst_qjsonstreamreader.moc"
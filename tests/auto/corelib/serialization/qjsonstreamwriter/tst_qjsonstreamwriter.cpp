@@ -0,0 +1,313 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QBuffer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonStreamWriter>
+
+class tst_QJsonStreamWriter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sameAsToJson_data();
+    void sameAsToJson();
+    void tokens_data();
+    void tokens();
+    void strings();
+    void numbers_data();
+    void numbers();
+    void multipleDocuments();
+    void byteArray();
+    void chunkedOutput();
+    void deviceError();
+};
+
+static QJsonDocument sampleDocument()
+{
+    QJsonObject nested {
+        { "empty array", QJsonArray() },
+        { "empty object", QJsonObject() },
+        { "list", QJsonArray { 1, -2.5, true, false, QJsonValue::Null, "text" } }
+    };
+    QJsonObject object {
+        { "name", "Qt" },
+        { QString::fromUtf8("n\xc3\xa4me"), QString::fromUtf8("v\xc3\xa4lue \xf0\x9f\x98\x80") },
+        { "escapes", "\"quoted\"\\\n\t\x01" },
+        { "nested", nested },
+        { "deep", QJsonArray { QJsonArray { QJsonArray { QJsonObject { { "a", 1e300 } } } } } }
+    };
+    return QJsonDocument(object);
+}
+
+void tst_QJsonStreamWriter::sameAsToJson_data()
+{
+    QTest::addColumn<QJsonDocument>("document");
+    QTest::addColumn<bool>("compact");
+
+    const QByteArray parsed = "{\"a\": [1, 2, {\"b\": \"c\\u00e9\\ud83d\\ude00\"}], \"d\": \"plain\"}";
+    const QJsonDocument documents[] = {
+        sampleDocument(),
+        QJsonDocument(sampleDocument().object().value("nested").toObject().value("list").toArray()),
+        QJsonDocument(QJsonArray()),
+        QJsonDocument(QJsonObject()),
+        QJsonDocument::fromJson(parsed),
+        QJsonDocument::fromRawJson(parsed)
+    };
+    int i = 0;
+    for (const QJsonDocument &document : documents) {
+        QTest::addRow("indented-%d", i) << document << false;
+        QTest::addRow("compact-%d", i) << document << true;
+        ++i;
+    }
+}
+
+void tst_QJsonStreamWriter::sameAsToJson()
+{
+    QFETCH(QJsonDocument, document);
+    QFETCH(bool, compact);
+
+    const QJsonDocument::JsonFormat format = compact ? QJsonDocument::Compact
+                                                     : QJsonDocument::Indented;
+    QByteArray data;
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    {
+        QJsonStreamWriter writer(&buffer);
+        writer.setFormat(format);
+        QCOMPARE(writer.format(), format);
+        writer.writeDocument(document);
+    }
+    QCOMPARE(data, document.toJson(format));
+}
+
+typedef std::function<void(QJsonStreamWriter &)> Writes;
+Q_DECLARE_METATYPE(Writes)
+
+void tst_QJsonStreamWriter::tokens_data()
+{
+    QTest::addColumn<Writes>("writes");
+    QTest::addColumn<QJsonDocument>("expected");
+
+    QTest::newRow("array") << Writes([](QJsonStreamWriter &w) {
+        w.startArray();
+        w.writeValue(1);
+        w.writeValue(QStringLiteral("two"));
+        w.writeValue(QLatin1String("three"));
+        w.writeValue("four");
+        w.writeValue(QJsonValue(5.5));
+        w.writeNull();
+        w.writeValue(false);
+        w.startArray();
+        w.endArray();
+        w.startObject();
+        w.endObject();
+        w.endArray();
+    }) << QJsonDocument(QJsonArray { 1, "two", "three", "four", 5.5, QJsonValue::Null, false,
+                                     QJsonArray(), QJsonObject() });
+
+    QTest::newRow("object") << Writes([](QJsonStreamWriter &w) {
+        w.startObject();
+        w.writeName(QLatin1String("a"));
+        w.writeValue(qint64(1) << 40);
+        w.writeName(QStringLiteral("b"));
+        w.startArray();
+        w.writeValue(QJsonObject { { "c", true } });
+        w.endArray();
+        w.writeName(QLatin1String("d"));
+        w.writeValue(QJsonArray { 1, 2 });
+        w.endObject();
+    }) << QJsonDocument(QJsonObject { { "a", double(qint64(1) << 40) },
+                                      { "b", QJsonArray { QJsonObject { { "c", true } } } },
+                                      { "d", QJsonArray { 1, 2 } } });
+}
+
+void tst_QJsonStreamWriter::tokens()
+{
+    QFETCH(Writes, writes);
+    QFETCH(QJsonDocument, expected);
+
+    for (QJsonDocument::JsonFormat format : { QJsonDocument::Indented, QJsonDocument::Compact }) {
+        QByteArray data;
+        QJsonStreamWriter writer(&data);
+        writer.setFormat(format);
+        writes(writer);
+        QCOMPARE(data, expected.toJson(format));
+    }
+}
+
+void tst_QJsonStreamWriter::strings()
+{
+    QByteArray data;
+    QJsonStreamWriter writer(&data);
+    writer.setFormat(QJsonDocument::Compact);
+    writer.startArray();
+    writer.writeValue(QString());
+    writer.writeValue(QLatin1String("caf\xe9"));
+    writer.writeValue("caf\xc3\xa9");
+    writer.writeValue("bad \xff utf-8");
+    writer.writeValue("\x1f\"\\/", 4);
+    writer.writeValue(QString(QChar(0xd800)));
+    writer.endArray();
+
+    QCOMPARE(data, QByteArray("[\"\",\"caf\xc3\xa9\",\"caf\xc3\xa9\",\"bad \xef\xbf\xbd utf-8\","
+                              "\"\\u001f\\\"\\\\/\",\"\\ud800\"]"));
+}
+
+void tst_QJsonStreamWriter::numbers_data()
+{
+    QTest::addColumn<double>("value");
+
+    QTest::newRow("zero") << 0.0;
+    QTest::newRow("negative-zero") << -0.0;
+    QTest::newRow("integer") << 42.0;
+    QTest::newRow("negative") << -17.0;
+    QTest::newRow("2^53") << 9007199254740992.0;
+    QTest::newRow("2^63") << 9223372036854775808.0;
+    QTest::newRow("1e20") << 1e20;
+    QTest::newRow("fraction") << 0.1;
+    QTest::newRow("small") << 1.5e-7;
+    QTest::newRow("0.001") << 0.001;
+    QTest::newRow("large-fraction") << 123456789.125;
+    QTest::newRow("max") << std::numeric_limits<double>::max();
+    QTest::newRow("min") << std::numeric_limits<double>::min();
+    QTest::newRow("denormal") << std::numeric_limits<double>::denorm_min();
+    QTest::newRow("third") << -1.0 / 3;
+}
+
+void tst_QJsonStreamWriter::numbers()
+{
+    QFETCH(double, value);
+
+    QByteArray data;
+    QJsonStreamWriter writer(&data);
+    writer.setFormat(QJsonDocument::Compact);
+    writer.startArray();
+    writer.writeValue(value);
+    writer.endArray();
+
+    const double absolute = std::abs(value);
+    const bool isInteger = absolute < 18446744073709551616.0 && absolute == std::floor(absolute);
+    QCOMPARE(data, '[' + QByteArray::number(value, isInteger ? 'f' : 'g',
+                                            QLocale::FloatingPointShortest) + ']');
+    QCOMPARE(QJsonDocument::fromJson(data).array().at(0).toDouble(), value);
+}
+
+void tst_QJsonStreamWriter::multipleDocuments()
+{
+    QByteArray data;
+    QJsonStreamWriter writer(&data);
+    writer.setFormat(QJsonDocument::Compact);
+    writer.writeValue(QJsonObject { { "a", 1 } });
+    writer.writeValue(QJsonArray { 2 });
+    writer.writeValue(3);
+    QCOMPARE(data, QByteArray("{\"a\":1}\n[2]\n3"));
+
+    data.clear();
+    writer.setFormat(QJsonDocument::Indented);
+    writer.writeValue(4);
+    QCOMPARE(data, QByteArray("\n4\n"));
+}
+
+void tst_QJsonStreamWriter::byteArray()
+{
+    QByteArray data = "prefix ";
+    QJsonStreamWriter writer(&data);
+    QVERIFY(!writer.device());
+    writer.setFormat(QJsonDocument::Compact);
+    writer.startArray();
+    QCOMPARE(data, QByteArray("prefix ["));
+    writer.writeValue(true);
+    QCOMPARE(data, QByteArray("prefix [true"));
+    writer.endArray();
+    QVERIFY(writer.flush());
+    QVERIFY(!writer.hasError());
+    QCOMPARE(data, QByteArray("prefix [true]"));
+}
+
+void tst_QJsonStreamWriter::chunkedOutput()
+{
+    QJsonArray array;
+    for (int i = 0; i < 50000; ++i)
+        array.append(QJsonObject { { "id", i }, { "name", QString::number(i) } });
+    const QByteArray expected = QJsonDocument(array).toJson();
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    {
+        QJsonStreamWriter writer(&buffer);
+        QCOMPARE(writer.device(), &buffer);
+        writer.startArray();
+        for (const QJsonValue &value : qAsConst(array))
+            writer.writeValue(value);
+        writer.endArray();
+
+        // output reached the device while writing and little is pending
+        QVERIFY(buffer.size() > 0);
+        QVERIFY(expected.size() - buffer.size() < 64 * 1024);
+    }
+    QCOMPARE(data, expected);
+
+    // the same for a single large value
+    data.clear();
+    buffer.seek(0);
+    {
+        QJsonStreamWriter writer(&buffer);
+        writer.writeValue(array);
+        QVERIFY(buffer.size() > 0);
+        QVERIFY(expected.size() - buffer.size() < 64 * 1024);
+        QVERIFY(writer.flush());
+        QCOMPARE(buffer.size(), qint64(expected.size()));
+    }
+    QCOMPARE(data, expected);
+}
+
+void tst_QJsonStreamWriter::deviceError()
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamWriter writer(&buffer);
+    writer.writeValue(QJsonArray { 1, 2, 3 });
+    QVERIFY(!writer.hasError());
+    QTest::ignoreMessage(QtWarningMsg, "QIODevice::write (QBuffer): ReadOnly device");
+    QVERIFY(!writer.flush());
+    QVERIFY(writer.hasError());
+
+    writer.setDevice(nullptr);
+    QVERIFY(!writer.hasError());
+}
+
+QTEST_APPLESS_MAIN(tst_QJsonStreamWriter)
+
+#include "tst_qjsonstreamwriter.moc"
@@ -80,6 +80,9 @@ private slots:
     void readLineMaxlen();
     void readLinesFromBufferCRCR();
     void readLineInto();
+    void readLineView_data();
+    void readLineView();
+    void readLineViewLongInput();
 
     // all
     void readAllFromDevice_data();
@@ -665,6 +668,89 @@ void tst_QTextStream::readLineInto()
     QVERIFY(line.isEmpty());
 }
 
+// ------------------------------------------------------------------------------
+void tst_QTextStream::readLineView_data()
+{
+    generateLineData(false);
+}
+
+// ------------------------------------------------------------------------------
+void tst_QTextStream::readLineView()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QStringList, lines);
+
+    for (int textMode = 0; textMode < 2; ++textMode) {
+        const QIODevice::OpenMode mode = textMode ? QIODevice::ReadOnly | QIODevice::Text
+                                                  : QIODevice::ReadOnly;
+        QBuffer buffer(&data);
+        QVERIFY(buffer.open(mode));
+        QTextStream stream(&buffer);
+        QStringList list;
+        for (QStringView line = stream.readLineView(); !line.isNull(); line = stream.readLineView())
+            list << line.toString();
+        QVERIFY(stream.atEnd());
+
+        if (textMode) {
+            // must match readLine(), which sees the text without any '\r'
+            QBuffer other(&data);
+            QVERIFY(other.open(mode));
+            QTextStream otherStream(&other);
+            lines.clear();
+            for (QString line = otherStream.readLine(); !line.isNull(); line = otherStream.readLine())
+                lines << line;
+        }
+        QCOMPARE(list, lines);
+    }
+}
+
+// ------------------------------------------------------------------------------
+void tst_QTextStream::readLineViewLongInput()
+{
+    // lines of varying length, so that they straddle the internal buffer
+    // boundaries in different places
+    QByteArray data;
+    QStringList lines;
+    for (int i = 0; i < 5000; ++i) {
+        QString line = QString::number(i) + QLatin1Char(' ')
+                + QString(i % 97, QChar(i % 3 ? 0x00e9 : 'x'));
+        if (i % 11 == 0)
+            line.clear();
+        lines << line;
+        data += line.toUtf8() + (i % 2 ? "\r\n" : "\n");
+    }
+
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QTextStream stream(&buffer);
+    stream.setCodec("UTF-8");
+
+    int i = 0;
+    QStringView line;
+    while (!(line = stream.readLineView()).isNull()) {
+        QVERIFY(i < lines.size());
+        QCOMPARE(line.toString(), lines.at(i));
+        ++i;
+    }
+    QCOMPARE(i, lines.size());
+
+    QString string = QString::fromUtf8(data);
+    QTextStream stringStream(&string);
+    for (i = 0; !(line = stringStream.readLineView()).isNull(); ++i)
+        QCOMPARE(line.toString(), lines.at(i));
+    QCOMPARE(i, lines.size());
+
+    // interleaving with other read functions
+    QVERIFY(stream.seek(0));
+    QCOMPARE(stream.readLine(), lines.at(0));
+    QCOMPARE(stream.readLineView().toString(), lines.at(1));
+    int number = 0;
+    stream >> number;
+    QCOMPARE(number, 2);
+    QCOMPARE(stream.readLineView().toString(), lines.at(2).mid(1));
+    QCOMPARE(stream.readLineView(3).toString(), lines.at(3).left(3));
+}
+
 // ------------------------------------------------------------------------------
 void tst_QTextStream::readLineFromString_data()
 {
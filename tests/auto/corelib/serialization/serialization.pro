@@ -7,6 +7,8 @@ SUBDIRS = \
     qcborvalue_json \
     qdatastream \
     qdatastream_core_pixmap \
+    qjsonstreamreader \
+    qjsonstreamwriter \
     qtextstream \
     qxmlstream
 
@@ -30,7 +30,9 @@
 
 #include <qlocale.h>
 #include <qcollator.h>
+#include <qthreadpool.h>
 #include <private/qglobal_p.h>
+#include <private/qcollator_p.h>
 
 #include <cstring>
 
@@ -44,6 +46,9 @@ private Q_SLOTS:
     void compare_data();
     void compare();
 
+    void sort_data();
+    void sort();
+
     void state();
 };
 
@@ -207,9 +212,17 @@ void tst_QCollator::compare()
     if (numericMode)
         collator.setNumericMode(true);
 
+    // the bulk sort keys must agree with compare()
+    auto tableCompare = [&collator](const QString &s1, const QString &s2) {
+        const QCollatorSortKeyTable table(collator, QStringList { s1, s2 });
+        return table.compare(0, 1);
+    };
+
     QCOMPARE(asSign(collator.compare(s1, s2)), result);
+    QCOMPARE(asSign(tableCompare(s1, s2)), result);
     collator.setCaseSensitivity(Qt::CaseInsensitive);
     QCOMPARE(asSign(collator.compare(s1, s2)), caseInsensitiveResult);
+    QCOMPARE(asSign(tableCompare(s1, s2)), caseInsensitiveResult);
 #if !QT_CONFIG(iconv)
     collator.setIgnorePunctuation(ignorePunctuation);
     QCOMPARE(asSign(collator.compare(s1, s2)), punctuationResult);
@@ -217,6 +230,73 @@ void tst_QCollator::compare()
 }
 
 
+void tst_QCollator::sort_data()
+{
+    QTest::addColumn<QLocale>("locale");
+    QTest::addColumn<Qt::CaseSensitivity>("caseSensitivity");
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("threads");
+
+    for (int size : { 0, 1, 50, 20000 }) {
+        for (int threads : { 1, 4 }) {
+            if (threads > 1 && size < 20000)
+                continue;
+            QTest::addRow("C-%d-threads%d", size, threads)
+                    << QLocale::c() << Qt::CaseSensitive << size << threads;
+            QTest::addRow("C-insensitive-%d-threads%d", size, threads)
+                    << QLocale::c() << Qt::CaseInsensitive << size << threads;
+            QTest::addRow("default-%d-threads%d", size, threads)
+                    << QLocale() << Qt::CaseSensitive << size << threads;
+        }
+    }
+}
+
+void tst_QCollator::sort()
+{
+    QFETCH(QLocale, locale);
+    QFETCH(Qt::CaseSensitivity, caseSensitivity);
+    QFETCH(int, size);
+    QFETCH(int, threads);
+
+    QCollator collator(locale);
+    collator.setCaseSensitivity(caseSensitivity);
+
+    // plenty of duplicates, case variants and empty strings
+    static const char *const words[] = { "apple", "Apple", "banana", "", "cherry", "file10",
+                                         "file9", "FILE9", "\xc3\xa9t\xc3\xa9", "zebra" };
+    QStringList strings;
+    for (int i = 0; i < size; ++i) {
+        const int n = int((i * 2654435761u) % 997);
+        strings.append(QString::fromUtf8(words[n % 10]) + QString::number(n % 7));
+        if (n % 13 == 0)
+            strings.last().clear();
+    }
+
+    QStringList expected = strings;
+    std::stable_sort(expected.begin(), expected.end(), [&collator](const QString &a, const QString &b) {
+        return collator.compare(a, b) < 0;
+    });
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int oldMaxThreadCount = pool->maxThreadCount();
+    pool->setMaxThreadCount(threads);
+    const auto restore = qScopeGuard([&] { pool->setMaxThreadCount(oldMaxThreadCount); });
+
+    QStringList sorted = strings;
+    collator.sort(sorted);
+    QCOMPARE(sorted, expected);
+
+    const QCollatorSortKeyTable table(collator, strings);
+    const QVector<int> order = table.sortedIndexes();
+    const QVector<int> ranks = table.ranks();
+    QCOMPARE(order.size(), size);
+    for (int i = 1; i < order.size(); ++i) {
+        const int compared = collator.compare(strings.at(order.at(i - 1)), strings.at(order.at(i)));
+        QVERIFY(compared <= 0);
+        QCOMPARE(ranks.at(order.at(i)) - ranks.at(order.at(i - 1)), compared < 0 ? 1 : 0);
+    }
+}
+
 void tst_QCollator::state()
 {
     QCollator c;
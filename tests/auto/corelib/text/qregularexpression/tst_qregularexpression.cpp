@@ -79,6 +79,13 @@ private slots:
     void QStringAndQStringRefEquivalence();
     void threadSafety_data();
     void threadSafety();
+    void threadSafetyIndependentObjects_data() { threadSafety_data(); }
+    void threadSafetyIndependentObjects();
+    void sharedCompiledPattern();
+    void fromPatterns_data();
+    void fromPatterns();
+    void fromInvalidPatterns();
+    void matchMany();
 
     void wildcard_data();
     void wildcard();
@@ -2188,6 +2195,173 @@ void tst_QRegularExpression::threadSafety()
     }
 }
 
+void tst_QRegularExpression::threadSafetyIndependentObjects()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QString, subject);
+
+    // distinct objects built from the same pattern string share the
+    // compiled pattern, which each thread compiles or picks up concurrently
+    const int threadCount = qMax(QThread::idealThreadCount(), 4);
+    for (int iteration = 0; iteration < 10; ++iteration) {
+        QVector<QRegularExpression> expressions;
+        for (int i = 0; i < threadCount; ++i)
+            expressions.append(QRegularExpression(pattern));
+
+        QVector<MatcherThread *> threads;
+        for (int i = 0; i < threadCount; ++i) {
+            MatcherThread *thread = new MatcherThread(expressions.at(i), subject);
+            thread->start();
+            threads.push_back(thread);
+        }
+
+        for (int i = 0; i < threadCount; ++i)
+            threads[i]->wait();
+
+        qDeleteAll(threads);
+    }
+}
+
+void tst_QRegularExpression::sharedCompiledPattern()
+{
+    const QString pattern = QStringLiteral("(\\w+)@(\\w+)");
+    const QRegularExpression re1(pattern);
+    const QRegularExpression re2(pattern);
+    const QRegularExpression re3(pattern, QRegularExpression::CaseInsensitiveOption);
+    QVERIFY(re1.isValid());
+    QVERIFY(re2.isValid());
+    QCOMPARE(re2.captureCount(), 2);
+    QCOMPARE(re3.captureCount(), 2);
+    QCOMPARE(re2.match("mail: user@host").captured(2), QStringLiteral("host"));
+
+    // the options are part of the cache key
+    const QRegularExpression caseSensitive(QStringLiteral("abc"));
+    const QRegularExpression caseInsensitive(QStringLiteral("abc"), QRegularExpression::CaseInsensitiveOption);
+    QVERIFY(!caseSensitive.match("ABC").hasMatch());
+    QVERIFY(caseInsensitive.match("ABC").hasMatch());
+
+    // errors are cached too
+    const QRegularExpression invalid1(QStringLiteral("a(b"));
+    const QRegularExpression invalid2(QStringLiteral("a(b"));
+    QVERIFY(!invalid1.isValid());
+    QVERIFY(!invalid2.isValid());
+    QCOMPARE(invalid2.errorString(), invalid1.errorString());
+    QCOMPARE(invalid2.patternErrorOffset(), invalid1.patternErrorOffset());
+
+    // changing the pattern of a copy does not affect the original
+    QRegularExpression copy = re1;
+    copy.setPattern(QStringLiteral("x(y)"));
+    QCOMPARE(copy.captureCount(), 1);
+    QCOMPARE(re1.captureCount(), 2);
+    QVERIFY(re1.match("a@b").hasMatch());
+}
+
+void tst_QRegularExpression::fromPatterns_data()
+{
+    QTest::addColumn<QStringList>("patterns");
+    QTest::addColumn<QRegularExpression::PatternOptions>("options");
+    QTest::addColumn<QString>("subject");
+    // one "index:captured(0):captured(1)" entry per match
+    QTest::addColumn<QStringList>("matches");
+
+    const QRegularExpression::PatternOptions none = QRegularExpression::NoPatternOption;
+
+    QTest::newRow("empty") << QStringList() << none << "abc" << QStringList();
+    QTest::newRow("single") << QStringList { "b+" } << none << "abbcb"
+                            << QStringList { "0:bb:", "0:b:" };
+    QTest::newRow("tokens") << QStringList { "(\\d+)", "([a-z]+)", "\\s+" } << none << "ab 12 c"
+                            << QStringList { "1:ab:ab", "2: :", "0:12:12", "2: :", "1:c:c" };
+    QTest::newRow("first-wins") << QStringList { "ab", "abc" } << none << "abc"
+                                << QStringList { "0:ab:" };
+    QTest::newRow("leftmost-wins") << QStringList { "c", "b" } << none << "abc"
+                                   << QStringList { "1:b:", "0:c:" };
+    QTest::newRow("backreference") << QStringList { "(x)y", "(a)\\1" } << none << "aaxy"
+                                   << QStringList { "1:aa:a", "0:xy:x" };
+    QTest::newRow("options") << QStringList { "abc", "def" } << QRegularExpression::PatternOptions(QRegularExpression::CaseInsensitiveOption)
+                             << "ABCdEf" << QStringList { "0:ABC:", "1:dEf:" };
+    QTest::newRow("extended-comment") << QStringList { "a b # letters", "c" }
+                                      << QRegularExpression::PatternOptions(QRegularExpression::ExtendedPatternSyntaxOption)
+                                      << "abc" << QStringList { "0:ab:", "1:c:" };
+    QTest::newRow("user-mark") << QStringList { "a(*MARK:x)b", "c" } << none << "abc"
+                               << QStringList { "0:ab:", "1:c:" };
+    QTest::newRow("quote") << QStringList { "\\Qa|", "b" } << none << "a|b"
+                           << QStringList { "0:a|:", "1:b:" };
+}
+
+void tst_QRegularExpression::fromPatterns()
+{
+    QFETCH(QStringList, patterns);
+    QFETCH(QRegularExpression::PatternOptions, options);
+    QFETCH(QString, subject);
+    QFETCH(QStringList, matches);
+
+    const QRegularExpression re = QRegularExpression::fromPatterns(patterns, options);
+    QVERIFY2(re.isValid(), qPrintable(re.errorString()));
+    QCOMPARE(re.patternOptions(), options);
+
+    QStringList result;
+    QRegularExpressionMatchIterator i = re.globalMatch(subject);
+    while (i.hasNext()) {
+        const QRegularExpressionMatch match = i.next();
+        consistencyCheck(match);
+        result << QString::number(match.patternIndex()) + QLatin1Char(':')
+                  + match.captured(0) + QLatin1Char(':') + match.captured(1);
+    }
+    QCOMPARE(result, matches);
+}
+
+void tst_QRegularExpression::fromInvalidPatterns()
+{
+    // balanced together, but not on their own
+    QRegularExpression re = QRegularExpression::fromPatterns({ QStringLiteral("x"),
+                                                               QStringLiteral("a)|(b"),
+                                                               QStringLiteral("(") });
+    QVERIFY(!re.isValid());
+    QCOMPARE(re.pattern(), QStringLiteral("a)|(b"));
+    QCOMPARE(re.patternErrorOffset(), 1);
+    QVERIFY2(re.errorString().startsWith(QLatin1String("pattern 1: ")), qPrintable(re.errorString()));
+    QTest::ignoreMessage(QtWarningMsg, "QRegularExpressionPrivate::doMatch(): called on an invalid QRegularExpression object");
+    QVERIFY(!re.match(QStringLiteral("a)|(b")).hasMatch());
+
+    // the index stays with the options, but not with another pattern
+    re.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+    QVERIFY(re.errorString().startsWith(QLatin1String("pattern 1: ")));
+    re.setPattern(QStringLiteral("("));
+    QVERIFY(!re.isValid());
+    QVERIFY(!re.errorString().startsWith(QLatin1String("pattern")));
+}
+
+void tst_QRegularExpression::matchMany()
+{
+    const QStringList patterns = { QStringLiteral("(?<key>\\w+)="), QStringLiteral("\\d+") };
+
+    QRegularExpressionMatchIterator i = QRegularExpression::matchMany(patterns, QStringLiteral("a=1 bb=22"));
+    QVERIFY(i.isValid());
+    QStringList result;
+    while (i.hasNext()) {
+        const QRegularExpressionMatch match = i.next();
+        result << QString::number(match.patternIndex()) + QLatin1Char(':') + match.captured();
+    }
+    QCOMPARE(result, QStringList({ "0:a=", "1:1", "0:bb=", "1:22" }));
+
+    // an invalid pattern makes the whole set invalid
+    QTest::ignoreMessage(QtWarningMsg, "QRegularExpressionPrivate::doMatch(): called on an invalid QRegularExpression object");
+    i = QRegularExpression::matchMany({ QStringLiteral("a"), QStringLiteral("(") }, QStringLiteral("a"));
+    QVERIFY(!i.hasNext());
+
+    // plain regular expressions do not report a pattern index
+    const QRegularExpressionMatch match = QRegularExpression(QStringLiteral("a(*:0)")).match(QStringLiteral("a"));
+    QVERIFY(match.hasMatch());
+    QCOMPARE(match.patternIndex(), -1);
+    QCOMPARE(QRegularExpression::fromPatterns({ QStringLiteral("x") }).match(QStringLiteral("y")).patternIndex(), -1);
+
+    // setting another pattern turns the expression into a plain one
+    QRegularExpression re = QRegularExpression::fromPatterns({ QStringLiteral("a") });
+    QCOMPARE(re.match(QStringLiteral("a")).patternIndex(), 0);
+    re.setPattern(re.pattern());
+    QCOMPARE(re.match(QStringLiteral("a")).patternIndex(), -1);
+}
+
 void tst_QRegularExpression::wildcard_data()
 {
     QTest::addColumn<QString>("pattern");
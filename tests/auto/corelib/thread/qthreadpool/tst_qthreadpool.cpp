@@ -104,6 +104,8 @@ private slots:
     void stressTest();
     void takeAllAndIncreaseMaxThreadCount();
     void waitForDoneAfterTake();
+    void runsEveryTaskOnce();
+    void takeAndClearWhileBusy();
 
 private:
     QMutex m_functionTestMutex;
@@ -1385,5 +1387,93 @@ void tst_QThreadPool::waitForDoneAfterTake()
 
 }
 
+void tst_QThreadPool::runsEveryTaskOnce()
+{
+    // small tasks started from several threads and from the pool's own
+    // threads, with mixed priorities, move between the shared queue and the
+    // threads' local queues; each must run exactly once
+    enum { Producers = 4, TasksPerProducer = 2500, Children = 3 };
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+
+    QAtomicInt runs;
+    QVector<QThread *> producers;
+    for (int p = 0; p < Producers; ++p) {
+        producers << QThread::create([&pool, &runs]() {
+            for (int i = 0; i < TasksPerProducer; ++i) {
+                const int priority = i % 5 == 0 ? 1 : 0;
+                pool.start([&pool, &runs, i]() {
+                    runs.ref();
+                    if (i % 100 == 0) {
+                        for (int c = 0; c < Children; ++c)
+                            pool.start([&runs]() { runs.ref(); });
+                    }
+                }, priority);
+            }
+        });
+        producers.last()->start();
+    }
+    for (QThread *producer : qAsConst(producers))
+        QVERIFY(producer->wait());
+    qDeleteAll(producers);
+
+    QVERIFY(pool.waitForDone(5 * 60 * 1000));
+    QCOMPARE(runs.loadRelaxed(), Producers * (TasksPerProducer + TasksPerProducer / 100 * Children));
+}
+
+void tst_QThreadPool::takeAndClearWhileBusy()
+{
+    class Task : public QRunnable
+    {
+    public:
+        Task(QSemaphore *started, QSemaphore *gate, QAtomicInt *runs)
+            : started(started), gate(gate), runs(runs)
+        { setAutoDelete(false); }
+
+        void run() override
+        {
+            runs->ref();
+            if (started) {
+                started->release();
+                gate->acquire();
+            }
+        }
+
+        QSemaphore *started;
+        QSemaphore *gate;
+        QAtomicInt *runs;
+    };
+
+    QSemaphore started;
+    QSemaphore gate;
+    QAtomicInt runs;
+    QThreadPool pool;
+    pool.setMaxThreadCount(1);
+
+    // the first task blocks the only thread while the rest gets queued;
+    // when it resumes, the thread takes a batch of them into its local queue
+    Task first(&started, &gate, &runs);
+    Task second(&started, &gate, &runs);
+    std::vector<std::unique_ptr<Task>> queued;
+    pool.start(&first);
+    started.acquire();
+    pool.start(&second);
+    for (int i = 0; i < 100; ++i) {
+        queued.emplace_back(new Task(nullptr, nullptr, &runs));
+        pool.start(queued.back().get());
+    }
+    gate.release();
+    started.acquire();
+
+    QVERIFY(pool.tryTake(queued.front().get()));
+    QVERIFY(pool.tryTake(queued.back().get()));
+    QVERIFY(!pool.tryTake(&second));
+    pool.clear();
+
+    gate.release();
+    QVERIFY(pool.waitForDone(5 * 60 * 1000));
+    QCOMPARE(runs.loadRelaxed(), 2);
+}
+
 QTEST_MAIN(tst_QThreadPool);
 #include "tst_qthreadpool.moc"
@@ -0,0 +1,444 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qflathash.h>
+#include <qhash.h>
+#include <qmap.h>
+#include <qrandom.h>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void insertAndLookup();
+    void operatorBracket();
+    void removeAndTake();
+    void growth();
+    void insertOwnValueWhileGrowing();
+    void compareWithQHash();
+    void tombstones();
+    void collisions();
+    void iterators();
+    void eraseWhileIterating();
+    void implicitSharing();
+    void reserveAndSqueeze();
+    void keysAndValues();
+    void equality();
+    void initializerList();
+    void countInstances();
+};
+
+struct Foo
+{
+    static int count;
+    int value;
+
+    Foo(int v = 0) : value(v) { ++count; }
+    Foo(const Foo &other) : value(other.value) { ++count; }
+    ~Foo() { --count; }
+    Foo &operator=(const Foo &other) { value = other.value; return *this; }
+    bool operator==(const Foo &other) const { return value == other.value; }
+};
+int Foo::count = 0;
+
+// A key type that makes every key land in the same probe sequence.
+struct BadKey
+{
+    int value;
+    bool operator==(const BadKey &other) const { return value == other.value; }
+};
+uint qHash(const BadKey &, uint seed = 0) { return seed; }
+
+void tst_QFlatHash::insertAndLookup()
+{
+    QFlatHash<QString, int> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.capacity(), 0);
+    QVERIFY(!hash.contains(QStringLiteral("one")));
+    QCOMPARE(hash.value(QStringLiteral("one")), 0);
+    QCOMPARE(hash.value(QStringLiteral("one"), 42), 42);
+    QVERIFY(hash.constFind(QStringLiteral("one")) == hash.constEnd());
+
+    hash.insert(QStringLiteral("one"), 1);
+    hash.insert(QStringLiteral("two"), 2);
+    QCOMPARE(hash.size(), 2);
+    QVERIFY(hash.contains(QStringLiteral("one")));
+    QCOMPARE(hash.value(QStringLiteral("two")), 2);
+    QCOMPARE(hash.count(QStringLiteral("two")), 1);
+    QCOMPARE(hash.count(QStringLiteral("three")), 0);
+
+    // inserting an existing key replaces its value
+    QFlatHash<QString, int>::iterator it = hash.insert(QStringLiteral("one"), 11);
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(it.key(), QStringLiteral("one"));
+    QCOMPARE(it.value(), 11);
+    QCOMPARE(hash.value(QStringLiteral("one")), 11);
+
+    QFlatHash<QString, int>::const_iterator cit = hash.constFind(QStringLiteral("two"));
+    QVERIFY(cit != hash.constEnd());
+    QCOMPARE(*cit, 2);
+
+    it = hash.find(QStringLiteral("two"));
+    *it = 22;
+    QCOMPARE(hash.value(QStringLiteral("two")), 22);
+    QCOMPARE(hash.key(22), QStringLiteral("two"));
+    QCOMPARE(hash.key(99, QStringLiteral("none")), QStringLiteral("none"));
+}
+
+void tst_QFlatHash::operatorBracket()
+{
+    QFlatHash<int, QString> hash;
+    hash[1] = QStringLiteral("a");
+    hash[2] += QStringLiteral("b");
+    hash[2] += QStringLiteral("c");
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash[2], QStringLiteral("bc"));
+
+    const QFlatHash<int, QString> &constHash = hash;
+    QCOMPARE(constHash[3], QString());
+    QCOMPARE(hash.size(), 2);
+}
+
+void tst_QFlatHash::removeAndTake()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i * 10);
+
+    QCOMPARE(hash.remove(1000), 0);
+    QCOMPARE(hash.remove(10), 1);
+    QCOMPARE(hash.remove(10), 0);
+    QVERIFY(!hash.contains(10));
+    QCOMPARE(hash.size(), 99);
+
+    QCOMPARE(hash.take(20), 200);
+    QCOMPARE(hash.take(20), 0);
+    QCOMPARE(hash.size(), 98);
+
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.contains(i), i != 10 && i != 20);
+
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.capacity(), 0);
+}
+
+void tst_QFlatHash::growth()
+{
+    const int N = 100000;
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < N; ++i) {
+        hash.insert(i, -i);
+        QVERIFY(hash.size() <= hash.capacity() * 7 / 8);
+    }
+    QCOMPARE(hash.size(), N);
+    for (int i = 0; i < N; ++i)
+        QCOMPARE(hash.value(i, 1), -i);
+    QVERIFY(!hash.contains(N));
+    QVERIFY(!hash.contains(-1));
+}
+
+void tst_QFlatHash::insertOwnValueWhileGrowing()
+{
+    // the inserted value lives in the node that the growth moves away
+    const int N = 1000;
+    QFlatHash<QString, QString> hash;
+    hash.insert(QStringLiteral("0"), QStringLiteral("value"));
+    for (int i = 1; i < N; ++i) {
+        const int capacity = hash.capacity();
+        const QString &value = hash.find(QString::number(i - 1)).value();
+        hash.insert(QString::number(i), value);
+        if (hash.capacity() != capacity)
+            QCOMPARE(hash.value(QString::number(i)), QStringLiteral("value"));
+    }
+    QVERIFY(hash.capacity() > 16);
+    for (int i = 0; i < N; ++i)
+        QCOMPARE(hash.value(QString::number(i)), QStringLiteral("value"));
+}
+
+void tst_QFlatHash::compareWithQHash()
+{
+    QRandomGenerator rng(1234);
+    QFlatHash<QString, int> hash;
+    QHash<QString, int> reference;
+
+    for (int round = 0; round < 50000; ++round) {
+        const QString key = QString::number(rng.bounded(2000));
+        switch (rng.bounded(4)) {
+        case 0:
+        case 1:
+            hash.insert(key, round);
+            reference.insert(key, round);
+            break;
+        case 2:
+            QCOMPARE(hash.remove(key), reference.remove(key));
+            break;
+        case 3:
+            QCOMPARE(hash.take(key), reference.take(key));
+            break;
+        }
+        QCOMPARE(hash.size(), reference.size());
+    }
+
+    for (auto it = reference.cbegin(); it != reference.cend(); ++it)
+        QCOMPARE(hash.value(it.key(), -1), it.value());
+    int visited = 0;
+    for (auto it = hash.cbegin(); it != hash.cend(); ++it) {
+        QCOMPARE(reference.value(it.key(), -1), it.value());
+        ++visited;
+    }
+    QCOMPARE(visited, reference.size());
+}
+
+void tst_QFlatHash::tombstones()
+{
+    // Repeatedly inserting and removing keys must reuse deleted slots
+    // instead of growing the table without bound.
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+    const int capacity = hash.capacity();
+
+    for (int i = 100; i < 100000; ++i) {
+        hash.insert(i, i);
+        QCOMPARE(hash.remove(i - 100), 1);
+    }
+    QCOMPARE(hash.size(), 100);
+    QVERIFY(hash.capacity() <= 2 * capacity);
+    for (int i = 100000 - 100; i < 100000; ++i)
+        QCOMPARE(hash.value(i, -1), i);
+}
+
+void tst_QFlatHash::collisions()
+{
+    QFlatHash<BadKey, int> hash;
+    for (int i = 0; i < 500; ++i)
+        hash.insert(BadKey{i}, i);
+    QCOMPARE(hash.size(), 500);
+    for (int i = 0; i < 500; i += 2)
+        QCOMPARE(hash.remove(BadKey{i}), 1);
+    for (int i = 0; i < 500; ++i)
+        QCOMPARE(hash.value(BadKey{i}, -1), i % 2 ? i : -1);
+}
+
+void tst_QFlatHash::iterators()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.begin() == hash.end());
+    QVERIFY(hash.constBegin() == hash.constEnd());
+
+    QMap<int, int> seen;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i * 2);
+    for (QFlatHash<int, int>::iterator it = hash.begin(); it != hash.end(); ++it) {
+        QCOMPARE(it.value(), it.key() * 2);
+        it.value() = it.key() * 3;
+        seen.insert(it.key(), 0);
+    }
+    QCOMPARE(seen.size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.value(i), i * 3);
+
+    // walking backwards visits the same elements
+    int count = 0;
+    QFlatHash<int, int>::const_iterator it = hash.constEnd();
+    while (it != hash.constBegin()) {
+        --it;
+        QCOMPARE(it.value(), it.key() * 3);
+        ++count;
+    }
+    QCOMPARE(count, 1000);
+
+    int sum = 0;
+    for (int value : qAsConst(hash))
+        sum += value;
+    QCOMPARE(sum, 3 * 999 * 1000 / 2);
+}
+
+void tst_QFlatHash::eraseWhileIterating()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+
+    QFlatHash<int, int>::iterator it = hash.begin();
+    while (it != hash.end()) {
+        if (it.key() % 3 == 0)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(hash.size(), 666);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.contains(i), i % 3 != 0);
+}
+
+void tst_QFlatHash::implicitSharing()
+{
+    QFlatHash<int, QString> hash;
+    hash.insert(1, QStringLiteral("one"));
+    hash.insert(2, QStringLiteral("two"));
+
+    QFlatHash<int, QString> copy = hash;
+    QVERIFY(copy.isSharedWith(hash));
+    QVERIFY(!hash.isDetached());
+
+    // lookups and failed removals do not detach
+    QCOMPARE(copy.value(1), QStringLiteral("one"));
+    QCOMPARE(copy.remove(3), 0);
+    QVERIFY(copy.isSharedWith(hash));
+
+    copy.insert(3, QStringLiteral("three"));
+    QVERIFY(!copy.isSharedWith(hash));
+    QVERIFY(hash.isDetached());
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(copy.size(), 3);
+
+    copy = hash;
+    copy.remove(1);
+    QCOMPARE(hash.value(1), QStringLiteral("one"));
+    QVERIFY(!copy.contains(1));
+
+    copy = hash;
+    copy[2] = QStringLiteral("deux");
+    QCOMPARE(hash.value(2), QStringLiteral("two"));
+
+    copy = hash;
+    copy.erase(copy.constFind(2));
+    QVERIFY(hash.contains(2));
+    QVERIFY(!copy.contains(2));
+
+    QFlatHash<int, QString> moved = std::move(copy);
+    QVERIFY(copy.isEmpty());
+    QCOMPARE(moved.size(), 1);
+}
+
+void tst_QFlatHash::reserveAndSqueeze()
+{
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    const int capacity = hash.capacity();
+    QVERIFY(capacity * 7 / 8 >= 1000);
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    hash.squeeze();
+    QVERIFY(hash.capacity() < capacity);
+    QCOMPARE(hash.size(), 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i, -1), i);
+
+    hash.clear();
+    hash.squeeze();
+    QCOMPARE(hash.capacity(), 0);
+}
+
+void tst_QFlatHash::keysAndValues()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 10; ++i)
+        hash.insert(i, i % 2);
+
+    QList<int> keys = hash.keys();
+    std::sort(keys.begin(), keys.end());
+    QCOMPARE(keys, QList<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+    QList<int> odd = hash.keys(1);
+    std::sort(odd.begin(), odd.end());
+    QCOMPARE(odd, QList<int>({1, 3, 5, 7, 9}));
+
+    QList<int> values = hash.values();
+    QCOMPARE(values.size(), 10);
+    QCOMPARE(values.count(0), 5);
+
+    QFlatHash<int, int> other;
+    other.insert(100, 100);
+    other.insert(hash);
+    QCOMPARE(other.size(), 11);
+}
+
+void tst_QFlatHash::equality()
+{
+    QFlatHash<QString, int> a;
+    QFlatHash<QString, int> b;
+    QVERIFY(a == b);
+
+    for (int i = 0; i < 100; ++i)
+        a.insert(QString::number(i), i);
+    for (int i = 99; i >= 0; --i)
+        b.insert(QString::number(i), i);
+    QVERIFY(a == b);
+
+    b[QStringLiteral("5")] = -5;
+    QVERIFY(a != b);
+    b.remove(QStringLiteral("5"));
+    QVERIFY(a != b);
+}
+
+void tst_QFlatHash::initializerList()
+{
+    QFlatHash<int, QString> hash{{1, QStringLiteral("bar")}, {-1, QStringLiteral("baz")}, {0, QString()}};
+    QCOMPARE(hash.size(), 3);
+    QCOMPARE(hash.value(1), QStringLiteral("bar"));
+    QCOMPARE(hash.value(-1), QStringLiteral("baz"));
+    QVERIFY(hash.contains(0));
+
+    const QHash<int, QString> source = {{1, QStringLiteral("a")}, {2, QStringLiteral("b")}};
+    const QFlatHash<int, QString> fromIterators(source.keyValueBegin(), source.keyValueEnd());
+    QCOMPARE(fromIterators.size(), 2);
+    QCOMPARE(fromIterators.value(2), QStringLiteral("b"));
+}
+
+void tst_QFlatHash::countInstances()
+{
+    {
+        QFlatHash<int, Foo> hash;
+        for (int i = 0; i < 1000; ++i)
+            hash.insert(i, Foo(i));
+        QCOMPARE(Foo::count, 1000);
+
+        QFlatHash<int, Foo> copy = hash;
+        copy.remove(0);
+        QCOMPARE(Foo::count, 1999);
+
+        for (int i = 0; i < 500; ++i)
+            hash.remove(i);
+        QCOMPARE(Foo::count, 1499);
+        hash.squeeze();
+        QCOMPARE(Foo::count, 1499);
+    }
+    QCOMPARE(Foo::count, 0);
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
@@ -1,4 +1,4 @@
 CONFIG += testcase
 TARGET = tst_qguieventdispatcher
-QT = core gui testlib
+QT = core-private gui testlib
 SOURCES += ../../../corelib/kernel/qeventdispatcher/tst_qeventdispatcher.cpp
@@ -42,6 +42,13 @@ private slots:
     void fromUnicode() const;
     void toUnicode_data() const;
     void toUnicode() const;
+    void fromUtf8_data() const;
+    void fromUtf8() const;
+    void toUtf8_data() const { fromUtf8_data(); }
+    void toUtf8() const;
+
+private:
+    static QByteArray corpus(const char *fileName);
 };
 
 void tst_QTextCodec::codecForName() const
@@ -162,7 +169,51 @@ void tst_QTextCodec::toUnicode() const
 }
 
 
+QByteArray tst_QTextCodec::corpus(const char *fileName)
+{
+    const QString testFile = QFINDTESTDATA(fileName);
+    QFile file(testFile);
+    if (testFile.isEmpty() || !file.open(QFile::ReadOnly))
+        return QByteArray();
+
+    // about 100 kB of text
+    const QByteArray data = file.readAll();
+    return data.repeated(qMax(1, 100000 / data.size()));
+}
+
+void tst_QTextCodec::fromUtf8_data() const
+{
+    QTest::addColumn<QByteArray>("utf8");
+
+    QTest::newRow("ascii") << QByteArray("The quick brown fox jumps over the lazy dog.\n").repeated(2000);
+    QTest::newRow("european") << corpus("european.txt");
+    QTest::newRow("cyrillic-greek") << corpus("cyrillic.txt");
+    QTest::newRow("cjk") << corpus("cjk.txt");
+    QTest::newRow("mixed") << corpus("utf-8.txt");
+}
+
+void tst_QTextCodec::fromUtf8() const
+{
+    QFETCH(QByteArray, utf8);
+    QVERIFY2(!utf8.isEmpty(), "cannot find the test data");
+
+    QBENCHMARK {
+        QString s = QString::fromUtf8(utf8);
+        Q_UNUSED(s);
+    }
+}
+
+void tst_QTextCodec::toUtf8() const
+{
+    QFETCH(QByteArray, utf8);
+    QVERIFY2(!utf8.isEmpty(), "cannot find the test data");
 
+    const QString s = QString::fromUtf8(utf8);
+    QBENCHMARK {
+        QByteArray ba = s.toUtf8();
+        Q_UNUSED(ba);
+    }
+}
 
 QTEST_MAIN(tst_QTextCodec)
 
@@ -4,4 +4,4 @@ QT = core testlib
 TARGET = tst_bench_qtextcodec
 SOURCES += main.cpp
 
-TESTDATA = utf-8.txt
+TESTDATA = utf-8.txt cjk.txt cyrillic.txt european.txt
@@ -2,6 +2,7 @@ TEMPLATE = subdirs
 SUBDIRS = \
         io \
         json \
+        serialization \
         mimetypes \
         kernel \
         text \
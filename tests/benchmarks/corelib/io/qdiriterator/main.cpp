@@ -28,6 +28,7 @@
 #include <QDebug>
 #include <QDirIterator>
 #include <QString>
+#include <QTemporaryDir>
 #include <qplatformdefs.h>
 
 #ifdef Q_OS_WIN
@@ -48,15 +49,45 @@ class tst_qdiriterator : public QObject
 {
     Q_OBJECT
 private slots:
+    void initTestCase();
     void posix();
     void posix_data() { data(); }
     void diriterator();
     void diriterator_data() { data(); }
+    void diriterator_parallel();
+    void diriterator_parallel_data() { data(); }
     void fsiterator();
     void fsiterator_data() { data(); }
     void data();
+
+private:
+    QTemporaryDir tempDir;
 };
 
+static void createTree(const QString &path, int depth)
+{
+    QDir dir(path);
+    for (int i = 0; i < 30; ++i) {
+        QFile file(dir.filePath(QString::fromLatin1("file%1.txt").arg(i)));
+        if (!file.open(QIODevice::WriteOnly))
+            qFatal("Cannot create %s: %s", qPrintable(file.fileName()), qPrintable(file.errorString()));
+    }
+    if (depth == 0)
+        return;
+    for (int i = 0; i < 5; ++i) {
+        const QString name = QString::fromLatin1("dir%1").arg(i);
+        dir.mkdir(name);
+        createTree(dir.filePath(name), depth - 1);
+    }
+}
+
+void tst_qdiriterator::initTestCase()
+{
+    QVERIFY2(tempDir.isValid(), qPrintable(tempDir.errorString()));
+    // 3906 directories, 117180 files
+    createTree(tempDir.path(), 5);
+}
+
 
 void tst_qdiriterator::data()
 {
@@ -65,16 +96,15 @@ void tst_qdiriterator::data()
 #else
     const char *qtdir = ::getenv("QTDIR");
 #endif
-    if (!qtdir) {
-        fprintf(stderr, "QTDIR not set\n");
-        exit(1);
-    }
 
     QTest::addColumn<QByteArray>("dirpath");
-    QByteArray ba = QByteArray(qtdir) + "/src/corelib";
-    QByteArray ba1 = ba + "/io";
-    QTest::newRow(ba) << ba;
-    //QTest::newRow(ba1) << ba1;
+    QTest::newRow("generated tree") << QFile::encodeName(tempDir.path());
+    if (qtdir) {
+        QByteArray ba = QByteArray(qtdir) + "/src/corelib";
+        QByteArray ba1 = ba + "/io";
+        QTest::newRow(ba) << ba;
+        //QTest::newRow(ba1) << ba1;
+    }
 }
 
 #ifdef Q_OS_WIN
@@ -203,6 +233,26 @@ void tst_qdiriterator::diriterator()
     qDebug() << count;
 }
 
+void tst_qdiriterator::diriterator_parallel()
+{
+    QFETCH(QByteArray, dirpath);
+
+    int count = 0;
+
+    QBENCHMARK {
+        int c = 0;
+
+        QDirIterator dir(dirpath, QDir::Files, QDirIterator::ParallelSubdirectories);
+
+        while (dir.hasNext()) {
+            dir.next();
+            ++c;
+        }
+        count = c;
+    }
+    qDebug() << count;
+}
+
 void tst_qdiriterator::fsiterator()
 {
     QFETCH(QByteArray, dirpath);
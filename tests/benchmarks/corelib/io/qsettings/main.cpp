@@ -0,0 +1,133 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtCore/QSettings>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include <private/qsettings_p.h>
+
+static const int KeyCount = 50000;
+
+class tst_QSettings : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void startup_data();
+    void startup();
+    void syncOneKey_data();
+    void syncOneKey();
+
+private:
+    QString fileName(QSettings::Format format) const;
+
+    QTemporaryDir tempDir;
+};
+
+QString tst_QSettings::fileName(QSettings::Format format) const
+{
+    return tempDir.filePath(format == QSettings::IndexedFormat
+                            ? QStringLiteral("settings.qsettings") : QStringLiteral("settings.ini"));
+}
+
+void tst_QSettings::initTestCase()
+{
+#ifndef QT_BUILD_INTERNAL
+    QSKIP("This benchmark needs a developer build to clear the cache of settings files.");
+#endif
+    QVERIFY2(tempDir.isValid(), qPrintable(tempDir.errorString()));
+
+    for (QSettings::Format format : {QSettings::IniFormat, QSettings::IndexedFormat}) {
+        QSettings settings(fileName(format), format);
+        for (int i = 0; i < KeyCount; ++i) {
+            const QString key = QString::fromLatin1("section%1/group%2/key%3").arg(i % 500).arg(i % 7).arg(i);
+            if (i % 2)
+                settings.setValue(key, i);
+            else
+                settings.setValue(key, QString::fromLatin1("value number %1").arg(i));
+        }
+        settings.sync();
+        QCOMPARE(settings.status(), QSettings::NoError);
+    }
+}
+
+static void populateWithFormats()
+{
+    QTest::addColumn<QSettings::Format>("format");
+
+    QTest::newRow("ini") << QSettings::IniFormat;
+    QTest::newRow("indexed") << QSettings::IndexedFormat;
+}
+
+void tst_QSettings::startup_data()
+{
+    populateWithFormats();
+}
+
+// opening a settings file and reading a few values from it, as applications do when they start
+void tst_QSettings::startup()
+{
+    QFETCH(QSettings::Format, format);
+    const QString name = fileName(format);
+
+    QBENCHMARK {
+#ifdef QT_BUILD_INTERNAL
+        QConfFile::clearCache();
+#endif
+        QSettings settings(name, format);
+        for (int i = 0; i < 20; ++i) {
+            const int key = i * 2477;
+            const QString path = QString::fromLatin1("section%1/group%2/key%3").arg(key % 500).arg(key % 7).arg(key);
+            QVERIFY(settings.contains(path));
+        }
+    }
+}
+
+void tst_QSettings::syncOneKey_data()
+{
+    populateWithFormats();
+}
+
+// changing a value and saving the file
+void tst_QSettings::syncOneKey()
+{
+    QFETCH(QSettings::Format, format);
+    QSettings settings(fileName(format), format);
+    int value = 0;
+
+    QBENCHMARK {
+        settings.setValue(QStringLiteral("section42/group0/changed"), ++value);
+        settings.sync();
+    }
+    QCOMPARE(settings.status(), QSettings::NoError);
+}
+
+QTEST_MAIN(tst_QSettings)
+
+#include "main.moc"
@@ -30,16 +30,32 @@
 #include <QIODevice>
 #include <QString>
 #include <QBuffer>
+#include <QTemporaryFile>
 #include <qtest.h>
 
 class tst_qtextstream : public QObject
 {
     Q_OBJECT
 private slots:
+    void initTestCase();
     void writeSingleChar_data();
     void writeSingleChar();
+    void readLine_data();
+    void readLine();
+    void readLineInto_data() { readLine_data(); }
+    void readLineInto();
+    void readLineView_data() { readLine_data(); }
+    void readLineView();
+    void readWords_data() { readLine_data(); }
+    void readWords();
+    void readNumbers();
 
 private:
+    bool openLog(QFile &file, QTextStream &stream);
+
+    QTemporaryFile asciiLog;
+    QTemporaryFile utf8Log;
+    QTemporaryFile numbers;
 };
 
 enum Output { StringOutput, DeviceOutput };
@@ -115,6 +131,128 @@ void tst_qtextstream::writeSingleChar()
     QCOMPARE(result.left(10), QString("hhhhhhhhhh"));
 }
 
+static bool writeTestFile(QTemporaryFile &file, const QByteArray &line, int count)
+{
+    if (!file.open())
+        return false;
+    QByteArray data;
+    for (int i = 0; i < count; ++i) {
+        data += QByteArray::number(i);
+        data += line;
+    }
+    return file.write(data) == data.size() && file.flush();
+}
+
+void tst_qtextstream::initTestCase()
+{
+    const int lines = 200000;
+    QVERIFY(writeTestFile(asciiLog,
+        " 2020-04-01T12:00:00 [info] worker: request served in 12 ms from cache\n", lines));
+    QVERIFY(writeTestFile(utf8Log,
+        " 2020-04-01T12:00:00 [info] Arbeitsgr\xc3\xb6\xc3\x9f" "e: 12 ms \xe2\x80\x94 caf\xc3\xa9 \xe2\x82\xac\n", lines));
+    QVERIFY(writeTestFile(numbers, " 1234567 -42 3.25\n", lines));
+}
+
+bool tst_qtextstream::openLog(QFile &file, QTextStream &stream)
+{
+    QFETCH(bool, utf8);
+    QFETCH(QByteArray, codec);
+    QFETCH(bool, textMode);
+
+    file.setFileName(utf8 ? utf8Log.fileName() : asciiLog.fileName());
+    if (!file.open(textMode ? QIODevice::ReadOnly | QIODevice::Text : QIODevice::ReadOnly))
+        return false;
+    stream.setDevice(&file);
+    stream.setCodec(codec.constData());
+    return true;
+}
+
+void tst_qtextstream::readLine_data()
+{
+    QTest::addColumn<bool>("utf8");
+    QTest::addColumn<QByteArray>("codec");
+    QTest::addColumn<bool>("textMode");
+
+    QTest::newRow("ascii-utf8") << false << QByteArray("UTF-8") << false;
+    QTest::newRow("ascii-utf8-text") << false << QByteArray("UTF-8") << true;
+    QTest::newRow("ascii-latin1") << false << QByteArray("ISO-8859-1") << false;
+    QTest::newRow("nonascii-utf8") << true << QByteArray("UTF-8") << false;
+}
+
+void tst_qtextstream::readLine()
+{
+    qint64 total = 0;
+    QBENCHMARK {
+        QFile file;
+        QTextStream stream;
+        QVERIFY(openLog(file, stream));
+        while (!stream.atEnd())
+            total += stream.readLine().size();
+    }
+    QVERIFY(total > 0);
+}
+
+void tst_qtextstream::readLineInto()
+{
+    qint64 total = 0;
+    QBENCHMARK {
+        QFile file;
+        QTextStream stream;
+        QVERIFY(openLog(file, stream));
+        QString line;
+        while (stream.readLineInto(&line))
+            total += line.size();
+    }
+    QVERIFY(total > 0);
+}
+
+void tst_qtextstream::readLineView()
+{
+    qint64 total = 0;
+    QBENCHMARK {
+        QFile file;
+        QTextStream stream;
+        QVERIFY(openLog(file, stream));
+        for (QStringView line = stream.readLineView(); !line.isNull(); line = stream.readLineView())
+            total += line.size();
+    }
+    QVERIFY(total > 0);
+}
+
+void tst_qtextstream::readWords()
+{
+    qint64 total = 0;
+    QBENCHMARK {
+        QFile file;
+        QTextStream stream;
+        QVERIFY(openLog(file, stream));
+        QString word;
+        while (!stream.atEnd()) {
+            stream >> word;
+            total += word.size();
+        }
+    }
+    QVERIFY(total > 0);
+}
+
+void tst_qtextstream::readNumbers()
+{
+    QFile file(numbers.fileName());
+    qint64 total = 0;
+    QBENCHMARK {
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QTextStream stream(&file);
+        int i, j;
+        double d;
+        while (!stream.atEnd()) {
+            stream >> i >> j >> d;
+            total += i + j + qint64(d);
+        }
+        file.close();
+    }
+    QVERIFY(total > 0);
+}
+
 QTEST_MAIN(tst_qtextstream)
 
 #include "main.moc"
@@ -29,6 +29,9 @@
 #include <QtTest>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
+#include <qjsonarray.h>
+#include <qjsonstreamreader.h>
+#include <qjsonstreamwriter.h>
 
 class BenchmarkQtBinaryJson: public QObject
 {
@@ -45,6 +48,17 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void parseLargeDocument_data();
+    void parseLargeDocument();
+    void parseLargeDocumentRaw_data() { parseLargeDocument_data(); }
+    void parseLargeDocumentRaw();
+    void streamLargeDocument_data() { parseLargeDocument_data(); }
+    void streamLargeDocument();
+
+    void toJsonLargeDocument_data();
+    void toJsonLargeDocument();
+    void writeLargeDocument_data() { toJsonLargeDocument_data(); }
+    void writeLargeDocument();
 
     void toByteArray();
     void fromByteArray();
@@ -120,6 +134,144 @@ void BenchmarkQtBinaryJson::parseJsonToVariant()
     }
 }
 
+static QByteArray largeDocument(const QByteArray &value, int indent)
+{
+    // an array of records resembling the output of a typical web service
+    QJsonArray records;
+    const QString text = QString::fromUtf8(value);
+    for (int i = 0; i < 20000; ++i) {
+        QJsonObject record;
+        record.insert(QStringLiteral("id"), i);
+        record.insert(QStringLiteral("name"), QStringLiteral("record %1").arg(i));
+        record.insert(QStringLiteral("description"), text);
+        record.insert(QStringLiteral("tags"), QJsonArray { text.left(16), text.left(32) });
+        record.insert(QStringLiteral("active"), (i % 3) == 0);
+        records.append(record);
+    }
+    QByteArray json = QJsonDocument(records).toJson(indent ? QJsonDocument::Indented
+                                                           : QJsonDocument::Compact);
+    if (indent > 4)
+        json.replace("\n    ", "\n" + QByteArray(indent, ' '));
+    return json;
+}
+
+void BenchmarkQtBinaryJson::parseLargeDocument_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    const QByteArray ascii = "The quick brown fox jumps over the lazy dog, then it goes back to "
+                             "its den at the edge of the forest where it sleeps until the morning.";
+    const QByteArray utf8 = "Příliš žluťoučký kůň úpěl ďábelské ódy, Съешь же ещё этих мягких "
+                            "французских булок, да выпей чаю. いろはにほへと ちりぬるを";
+    // serialized with escape sequences
+    const QByteArray escaped = "C:\\Program Files\\Example\\bin\n\t\"quoted\" and "
+                               "\x7f with a line feed\nat the end of the description";
+
+    QTest::newRow("ascii, compact") << largeDocument(ascii, 0);
+    QTest::newRow("ascii, indented") << largeDocument(ascii, 4);
+    QTest::newRow("ascii, deeply indented") << largeDocument(ascii, 40);
+    QTest::newRow("utf-8, compact") << largeDocument(utf8, 0);
+    QTest::newRow("escaped, compact") << largeDocument(escaped, 0);
+
+    QString testFile = QFINDTESTDATA("test.json");
+    QFile file(testFile);
+    if (file.open(QFile::ReadOnly)) {
+        const QByteArray test = file.readAll().trimmed();
+        QByteArray json = "[";
+        for (int i = 0; i < 200; ++i)
+            json += test + ',';
+        json.back() = ']';
+        QTest::newRow("test.json x200") << json;
+    }
+}
+
+void BenchmarkQtBinaryJson::parseLargeDocument()
+{
+    QFETCH(QByteArray, json);
+
+    QJsonParseError error;
+    QVERIFY(!QJsonDocument::fromJson(json, &error).isNull());
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    QBENCHMARK {
+        QJsonDocument doc = QJsonDocument::fromJson(json);
+        Q_UNUSED(doc);
+    }
+}
+
+void BenchmarkQtBinaryJson::parseLargeDocumentRaw()
+{
+    QFETCH(QByteArray, json);
+
+    QBENCHMARK {
+        QJsonDocument doc = QJsonDocument::fromRawJson(json);
+        Q_UNUSED(doc);
+    }
+}
+
+void BenchmarkQtBinaryJson::streamLargeDocument()
+{
+    QFETCH(QByteArray, json);
+
+    QBENCHMARK {
+        QBuffer buffer(&json);
+        buffer.open(QIODevice::ReadOnly);
+        QJsonStreamReader reader(&buffer);
+        while (!reader.atEnd())
+            reader.readNext();
+        QVERIFY(!reader.hasError());
+    }
+}
+
+void BenchmarkQtBinaryJson::toJsonLargeDocument_data()
+{
+    QTest::addColumn<QJsonDocument>("document");
+    QTest::addColumn<bool>("compact");
+
+    const QByteArray ascii = "The quick brown fox jumps over the lazy dog, then it goes back to "
+                             "its den at the edge of the forest where it sleeps until the morning.";
+    const QByteArray utf8 = "Příliš žluťoučký kůň úpěl ďábelské ódy, Съешь же ещё этих мягких "
+                            "французских булок, да выпей чаю. いろはにほへと ちりぬるを";
+    const QJsonDocument asciiDocument = QJsonDocument::fromJson(largeDocument(ascii, 0));
+    const QJsonDocument utf8Document = QJsonDocument::fromJson(largeDocument(utf8, 0));
+
+    QJsonArray numbers;
+    for (int i = 0; i < 100000; ++i)
+        numbers.append(QJsonArray { i, i * 0.001, 1.0 / (i + 1) });
+
+    QTest::newRow("ascii, compact") << asciiDocument << true;
+    QTest::newRow("ascii, indented") << asciiDocument << false;
+    QTest::newRow("utf-8, compact") << utf8Document << true;
+    QTest::newRow("numbers, compact") << QJsonDocument(numbers) << true;
+}
+
+void BenchmarkQtBinaryJson::toJsonLargeDocument()
+{
+    QFETCH(QJsonDocument, document);
+    QFETCH(bool, compact);
+
+    QBENCHMARK {
+        const QByteArray json = document.toJson(compact ? QJsonDocument::Compact
+                                                        : QJsonDocument::Indented);
+        Q_UNUSED(json);
+    }
+}
+
+void BenchmarkQtBinaryJson::writeLargeDocument()
+{
+    QFETCH(QJsonDocument, document);
+    QFETCH(bool, compact);
+
+    QFile null(QProcess::nullDevice());
+    QVERIFY(null.open(QIODevice::WriteOnly));
+    QBENCHMARK {
+        QJsonStreamWriter writer(&null);
+        writer.setFormat(compact ? QJsonDocument::Compact : QJsonDocument::Indented);
+        writer.writeDocument(document);
+        QVERIFY(writer.flush());
+    }
+}
+
 void BenchmarkQtBinaryJson::toByteArray()
 {
     // Example: send information over a datastream to another process
@@ -1,12 +1,18 @@
 TEMPLATE = subdirs
 SUBDIRS = \
         events \
+        qeventdispatcher \
         qmetaobject \
         qmetatype \
         qobject \
         qvariant \
         qcoreapplication \
-        qtimer_vs_qmetaobject
+        qtimer \
+        qtimer_vs_qmetaobject \
+        queuedconnection
+
+!unix|darwin: SUBDIRS -= \
+    qeventdispatcher
 
 !qtHaveModule(widgets): SUBDIRS -= \
     qmetaobject \
@@ -35,6 +35,41 @@ Q_OBJECT
 private slots:
     void event_posting_benchmark_data();
     void event_posting_benchmark();
+    void event_posting_contention_data();
+    void event_posting_contention();
+};
+
+class EventCounter : public QObject
+{
+    Q_OBJECT
+public:
+    EventCounter(int eventType, int expected)
+        : eventType(eventType), expected(expected)
+    { }
+
+    int eventType;
+    int expected;
+    int received = 0;
+    QSemaphore done;
+
+public slots:
+    void count()
+    {
+        if (++received == expected) {
+            received = 0;
+            done.release();
+        }
+    }
+
+protected:
+    bool event(QEvent *e) override
+    {
+        if (e->type() == eventType) {
+            count();
+            return true;
+        }
+        return QObject::event(e);
+    }
 };
 
 void QCoreApplicationBenchmark::event_posting_benchmark_data()
@@ -64,6 +99,57 @@ void QCoreApplicationBenchmark::event_posting_benchmark()
     }
 }
 
+void QCoreApplicationBenchmark::event_posting_contention_data()
+{
+    QTest::addColumn<int>("producers");
+    QTest::addColumn<bool>("queuedCall");
+
+    const int counts[] = { 1, 2, 4, 8 };
+    for (int producers : counts) {
+        QTest::addRow("%d producers, queued calls", producers) << producers << true;
+        QTest::addRow("%d producers, custom events", producers) << producers << false;
+    }
+}
+
+void QCoreApplicationBenchmark::event_posting_contention()
+{
+    QFETCH(int, producers);
+    QFETCH(bool, queuedCall);
+
+    // queued calls take the lock-free path of postEvent(), custom events
+    // always go through the mutex-protected list
+    const int eventsPerProducer = 20000;
+    const int type = QEvent::registerEventType();
+
+    QThread consumer;
+    EventCounter counter(type, producers * eventsPerProducer);
+    counter.moveToThread(&consumer);
+    consumer.start();
+
+    QBENCHMARK {
+        QVector<QThread *> threads;
+        for (int i = 0; i < producers; ++i) {
+            threads << QThread::create([&counter, queuedCall, type, eventsPerProducer]() {
+                for (int j = 0; j < eventsPerProducer; ++j) {
+                    if (queuedCall)
+                        QMetaObject::invokeMethod(&counter, &EventCounter::count, Qt::QueuedConnection);
+                    else
+                        QCoreApplication::postEvent(&counter, new QEvent(QEvent::Type(type)));
+                }
+            });
+        }
+        for (QThread *thread : qAsConst(threads))
+            thread->start();
+        counter.done.acquire();
+        for (QThread *thread : qAsConst(threads))
+            thread->wait();
+        qDeleteAll(threads);
+    }
+
+    consumer.quit();
+    consumer.wait();
+}
+
 QTEST_MAIN(QCoreApplicationBenchmark)
 
 #include "main.moc"
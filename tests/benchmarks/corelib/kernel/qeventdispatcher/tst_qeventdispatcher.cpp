@@ -0,0 +1,160 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QSemaphore>
+#include <QtCore/QSocketNotifier>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <qtest.h>
+
+#include <private/qeventdispatcher_unix_p.h>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+class NotifierSet : public QObject
+{
+    Q_OBJECT
+
+public:
+    ~NotifierSet() { closeAll(); }
+
+    int writeFd(int i) const { return pipes.at(i).second; }
+
+    QSemaphore activations;
+
+public slots:
+    void setup(int count)
+    {
+        for (int i = 0; i < count; ++i) {
+            int fds[2];
+            if (::pipe(fds) == -1)
+                qFatal("pipe: %s", qPrintable(qt_error_string()));
+            pipes.append(qMakePair(fds[0], fds[1]));
+
+            auto notifier = new QSocketNotifier(fds[0], QSocketNotifier::Read, this);
+            const int fd = fds[0];
+            connect(notifier, &QSocketNotifier::activated, this, [this, fd]() {
+                char c;
+                if (::read(fd, &c, 1) == 1)
+                    activations.release();
+            });
+        }
+    }
+
+    void teardown()
+    {
+        qDeleteAll(findChildren<QSocketNotifier *>());
+        closeAll();
+    }
+
+private:
+    void closeAll()
+    {
+        for (const auto &p : qAsConst(pipes)) {
+            ::close(p.first);
+            ::close(p.second);
+        }
+        pipes.clear();
+    }
+
+    QVector<QPair<int, int>> pipes;
+};
+
+class tst_QEventDispatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void wakeupLatency_data();
+    void wakeupLatency();
+};
+
+static bool ensureFileLimit(rlim_t needed)
+{
+    rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) != 0)
+        return false;
+    if (rl.rlim_cur >= needed)
+        return true;
+    if (rl.rlim_max != RLIM_INFINITY && rl.rlim_max < needed)
+        return false;
+    rl.rlim_cur = needed;
+    return setrlimit(RLIMIT_NOFILE, &rl) == 0;
+}
+
+void tst_QEventDispatcher::wakeupLatency_data()
+{
+    QTest::addColumn<bool>("epoll");
+    QTest::addColumn<int>("notifiers");
+
+    for (int count : { 100, 1000, 10000 }) {
+        QTest::addRow("poll-%d", count) << false << count;
+        QTest::addRow("epoll-%d", count) << true << count;
+    }
+}
+
+// Measures the round trip of waking up a thread that watches \a notifiers
+// idle pipes when exactly one of them becomes readable.
+void tst_QEventDispatcher::wakeupLatency()
+{
+    QFETCH(bool, epoll);
+    QFETCH(int, notifiers);
+
+    if (!ensureFileLimit(2 * notifiers + 64))
+        QSKIP("Not enough file descriptors available");
+
+    // the backend is picked when the dispatcher is constructed
+    QThread thread;
+    qputenv("QT_EVENTDISPATCHER_EPOLL", epoll ? "1" : "0");
+    thread.setEventDispatcher(new QEventDispatcherUNIX);
+    qunsetenv("QT_EVENTDISPATCHER_EPOLL");
+
+    NotifierSet set;
+    set.moveToThread(&thread);
+    thread.start();
+    QMetaObject::invokeMethod(&set, "setup", Qt::BlockingQueuedConnection, Q_ARG(int, notifiers));
+
+    // poke a descriptor in the middle so no backend benefits from ordering
+    const int fd = set.writeFd(notifiers / 2);
+    QBENCHMARK {
+        const char c = 0;
+        if (::write(fd, &c, 1) != 1)
+            QFAIL("write failed");
+        set.activations.acquire();
+    }
+
+    QMetaObject::invokeMethod(&set, "teardown", Qt::BlockingQueuedConnection);
+    thread.quit();
+    thread.wait();
+}
+
+QTEST_MAIN(tst_QEventDispatcher)
+
+#include "tst_qeventdispatcher.moc"
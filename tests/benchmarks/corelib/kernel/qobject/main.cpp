@@ -31,6 +31,11 @@
 #include "object.h"
 #include <qcoreapplication.h>
 #include <qdatetime.h>
+#include <private/qobject_p.h>
+
+#if defined(__GLIBC__)
+#  include <malloc.h>
+#endif
 
 enum {
     CreationDeletionBenckmarkConstant = 34567,
@@ -51,6 +56,10 @@ private slots:
     void connect_disconnect_benchmark_data();
     void connect_disconnect_benchmark();
     void receiver_destroyed_benchmark();
+    void object_tree_benchmark_data();
+    void object_tree_benchmark();
+    void object_tree_memory_data();
+    void object_tree_memory();
 };
 
 struct Functor {
@@ -258,6 +267,84 @@ void QObjectBenchmark::receiver_destroyed_benchmark()
     }
 }
 
+static void createChildren(QObject *parent, int depth)
+{
+    if (depth == 0)
+        return;
+    for (int i = 0; i < 10; ++i)
+        createChildren(new QObject(parent), depth - 1);
+}
+
+static QObject *createTree(int depth, QObjectArena *arena)
+{
+    QObjectArena::Scope scope(arena);
+    QObject *root = new QObject;
+    createChildren(root, depth);
+    return root;
+}
+
+static void objectTreeData()
+{
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<bool>("arena");
+
+    // a fan-out of 10 per level, 1111111 objects at depth 6
+    for (int depth : {4, 6}) {
+        QTest::addRow("heap, depth %d", depth) << depth << false;
+        QTest::addRow("arena, depth %d", depth) << depth << true;
+    }
+}
+
+void QObjectBenchmark::object_tree_benchmark_data()
+{
+    objectTreeData();
+}
+
+void QObjectBenchmark::object_tree_benchmark()
+{
+    QFETCH(int, depth);
+    QFETCH(bool, arena);
+
+    QBENCHMARK {
+        QExplicitlySharedDataPointer<QObjectArena> objectArena(arena ? new QObjectArena : nullptr);
+        delete createTree(depth, objectArena.data());
+    }
+}
+
+void QObjectBenchmark::object_tree_memory_data()
+{
+    objectTreeData();
+}
+
+static qint64 residentSetSize()
+{
+    QFile statm(QStringLiteral("/proc/self/statm"));
+    if (!statm.open(QIODevice::ReadOnly))
+        return -1;
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    return fields.value(1).toLongLong() * 4096;
+}
+
+void QObjectBenchmark::object_tree_memory()
+{
+    QFETCH(int, depth);
+    QFETCH(bool, arena);
+
+    const qint64 before = residentSetSize();
+    if (before < 0)
+        QSKIP("The resident set size can only be measured on Linux");
+
+    QExplicitlySharedDataPointer<QObjectArena> objectArena(arena ? new QObjectArena : nullptr);
+    QObject *root = createTree(depth, objectArena.data());
+    QTest::setBenchmarkResult(residentSetSize() - before, QTest::BytesAllocated);
+    delete root;
+    objectArena.reset();
+#if defined(__GLIBC__)
+    // hand the pages back, the function may run more than once
+    malloc_trim(0);
+#endif
+}
+
 QTEST_MAIN(QObjectBenchmark)
 
 #include "main.moc"
@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+#include <QtTest/QtTest>
+
+#include <memory>
+
+class tst_QTimer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void createAndStart_data() { timerData(); }
+    void createAndStart();
+    void restart_data() { timerData(); }
+    void restart();
+    void stopAndStart_data() { timerData(); }
+    void stopAndStart();
+    void processEventsWithIdleTimers_data() { timerData(); }
+    void processEventsWithIdleTimers();
+    void fireWithIdleTimers_data() { timerData(); }
+    void fireWithIdleTimers();
+
+private:
+    void timerData();
+};
+
+typedef std::vector<std::unique_ptr<QTimer>> Timers;
+
+// Long-running idle/keepalive timers with spread out intervals, as a server
+// keeps per connection. None of them fire while the benchmark runs.
+static void createTimers(Timers &timers, int count, Qt::TimerType type)
+{
+    timers.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        timers.emplace_back(new QTimer);
+        timers.back()->setTimerType(type);
+        timers.back()->setInterval(60000 + (i * 7919) % 60000);
+    }
+}
+
+void tst_QTimer::timerData()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<Qt::TimerType>("type");
+
+    for (int count : {1000, 10000, 100000}) {
+        QTest::addRow("precise-%d", count) << count << Qt::PreciseTimer;
+        QTest::addRow("coarse-%d", count) << count << Qt::CoarseTimer;
+        QTest::addRow("verycoarse-%d", count) << count << Qt::VeryCoarseTimer;
+    }
+}
+
+void tst_QTimer::createAndStart()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, type);
+
+    QBENCHMARK {
+        Timers timers;
+        createTimers(timers, count, type);
+        for (const auto &timer : timers)
+            timer->start();
+    }
+}
+
+void tst_QTimer::restart()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, type);
+
+    Timers timers;
+    createTimers(timers, count, type);
+    for (const auto &timer : timers)
+        timer->start();
+
+    // start() on an active timer unregisters and registers it again
+    QBENCHMARK {
+        for (const auto &timer : timers)
+            timer->start();
+    }
+}
+
+void tst_QTimer::stopAndStart()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, type);
+
+    Timers timers;
+    createTimers(timers, count, type);
+    for (const auto &timer : timers)
+        timer->start();
+
+    // stop every third timer and start them again in reverse order
+    QBENCHMARK {
+        for (int i = 0; i < count; i += 3)
+            timers[i]->stop();
+        for (int i = (count - 1) / 3 * 3; i >= 0; i -= 3)
+            timers[i]->start();
+    }
+}
+
+void tst_QTimer::processEventsWithIdleTimers()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, type);
+
+    Timers timers;
+    createTimers(timers, count, type);
+    for (const auto &timer : timers)
+        timer->start();
+
+    QBENCHMARK {
+        QCoreApplication::processEvents();
+    }
+}
+
+void tst_QTimer::fireWithIdleTimers()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, type);
+
+    Timers timers;
+    createTimers(timers, count, type);
+    for (const auto &timer : timers)
+        timer->start();
+
+    // a single short timer firing repeatedly among the idle ones
+    int fired = 0;
+    QTimer timer;
+    timer.setTimerType(Qt::PreciseTimer);
+    timer.setInterval(0);
+    connect(&timer, &QTimer::timeout, [&fired] { ++fired; });
+    timer.start();
+
+    QBENCHMARK {
+        const int target = fired + 100;
+        while (fired < target)
+            QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    }
+}
+
+QTEST_MAIN(tst_QTimer)
+
+#include "tst_qtimer.moc"
@@ -0,0 +1,181 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEventLoop>
+#include <QtCore/QThread>
+#include <QtTest/QtTest>
+
+class Sender : public QObject
+{
+    Q_OBJECT
+signals:
+    void tick();
+    void value(int value);
+    void quote(const QString &symbol, double price);
+};
+
+class Receiver : public QObject
+{
+    Q_OBJECT
+public:
+    int received = 0;
+    int expected = 0;
+    QEventLoop *loop = nullptr;
+
+public slots:
+    void onTick() { count(); }
+    void onValue(int) { count(); }
+    void onQuote(const QString &, double) { count(); }
+
+private:
+    void count()
+    {
+        if (++received == expected && loop)
+            loop->quit();
+    }
+};
+
+class EmitterThread : public QThread
+{
+public:
+    EmitterThread(Sender *sender, int signal, int count)
+        : sender(sender), signal(signal), count(count)
+    {}
+
+    void run() override
+    {
+        const QString symbol = QStringLiteral("QTCOM");
+        for (int i = 0; i < count; ++i) {
+            switch (signal) {
+            case 0: emit sender->tick(); break;
+            case 1: emit sender->value(i); break;
+            case 2: emit sender->quote(symbol, i * 0.25); break;
+            }
+        }
+    }
+
+private:
+    Sender *sender;
+    int signal;
+    int count;
+};
+
+class tst_QueuedConnection : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void crossThread_data();
+    void crossThread();
+    void sameThread_data() { crossThread_data(); }
+    void sameThread();
+
+private:
+    void connectSignal(Sender *sender, Receiver *receiver, int signal, Qt::ConnectionType type);
+};
+
+void tst_QueuedConnection::crossThread_data()
+{
+    QTest::addColumn<bool>("batched");
+    QTest::addColumn<int>("signal");
+    QTest::addColumn<int>("count");
+
+    static const char *const signalNames[] = { "noargs", "int", "QString+double" };
+    for (int count : {10000, 1000000}) {
+        for (int signal = 0; signal < 3; ++signal) {
+            QTest::addRow("queued-%s-%d", signalNames[signal], count) << false << signal << count;
+            QTest::addRow("batched-%s-%d", signalNames[signal], count) << true << signal << count;
+        }
+    }
+}
+
+void tst_QueuedConnection::connectSignal(Sender *sender, Receiver *receiver, int signal,
+                                         Qt::ConnectionType type)
+{
+    switch (signal) {
+    case 0: connect(sender, &Sender::tick, receiver, &Receiver::onTick, type); break;
+    case 1: connect(sender, &Sender::value, receiver, &Receiver::onValue, type); break;
+    case 2: connect(sender, &Sender::quote, receiver, &Receiver::onQuote, type); break;
+    }
+}
+
+void tst_QueuedConnection::crossThread()
+{
+    QFETCH(bool, batched);
+    QFETCH(int, signal);
+    QFETCH(int, count);
+
+    Sender sender;
+    Receiver receiver;
+    const Qt::ConnectionType type = batched
+            ? Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)
+            : Qt::QueuedConnection;
+    connectSignal(&sender, &receiver, signal, type);
+
+    QBENCHMARK {
+        QEventLoop loop;
+        receiver.received = 0;
+        receiver.expected = count;
+        receiver.loop = &loop;
+
+        // the receiving thread keeps delivering while the sender emits
+        EmitterThread thread(&sender, signal, count);
+        thread.start();
+        loop.exec();
+        QVERIFY(thread.wait());
+        receiver.loop = nullptr;
+    }
+    QCOMPARE(receiver.received, count);
+}
+
+void tst_QueuedConnection::sameThread()
+{
+    QFETCH(bool, batched);
+    QFETCH(int, signal);
+    QFETCH(int, count);
+
+    Sender sender;
+    Receiver receiver;
+    const Qt::ConnectionType type = batched
+            ? Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)
+            : Qt::QueuedConnection;
+    connectSignal(&sender, &receiver, signal, type);
+
+    // emit everything first, then deliver
+    QBENCHMARK {
+        receiver.received = 0;
+        EmitterThread(&sender, signal, count).run();
+        QCoreApplication::processEvents();
+    }
+    QCOMPARE(receiver.received, count);
+}
+
+QTEST_MAIN(tst_QueuedConnection)
+
+#include "main.moc"
@@ -0,0 +1,154 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QBuffer>
+#include <QXmlStreamReader>
+#include <qtest.h>
+
+class tst_QXmlStreamReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void readTextHeavy_data() { documents(); }
+    void readTextHeavy() { read(textHeavy); }
+    void readAttributeHeavy_data() { documents(); }
+    void readAttributeHeavy() { read(attributeHeavy); }
+    void readIndented_data() { documents(); }
+    void readIndented() { read(indented); }
+
+private:
+    void documents();
+    void read(const QByteArray *docs);
+
+    enum { Ascii, NonAscii, DocumentCount };
+    QByteArray textHeavy[DocumentCount];
+    QByteArray attributeHeavy[DocumentCount];
+    QByteArray indented[DocumentCount];
+};
+
+void tst_QXmlStreamReader::initTestCase()
+{
+    static const char *const words[DocumentCount][8] = {
+        { "lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit" },
+        { "gr\xc3\xbc\xc3\x9f", "\xc3\xa9t\xc3\xa9", "stra\xc3\x9f" "e", "caf\xc3\xa9",
+          "\xe2\x82\xac" "uro", "na\xc3\xafve", "\xce\xbb\xce\xbf\xce\xb3\xce\xbf\xcf\x82", "text" }
+    };
+
+    for (int d = 0; d < DocumentCount; ++d) {
+        QByteArray &text = textHeavy[d];
+        text = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<feed>";
+        for (int i = 0; i < 4000; ++i) {
+            text += "<entry><title>";
+            text += words[d][i % 8];
+            text += "</title><content>";
+            for (int j = 0; j < 60; ++j) {
+                text += words[d][(i + j) % 8];
+                text += ' ';
+            }
+            text += "and &amp; more</content></entry>";
+        }
+        text += "</feed>\n";
+
+        QByteArray &attrs = attributeHeavy[d];
+        attrs = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<rows>";
+        for (int i = 0; i < 20000; ++i) {
+            attrs += "<row id=\"" + QByteArray::number(i) + '"';
+            for (int j = 0; j < 8; ++j) {
+                attrs += " a" + QByteArray::number(j) + "=\"";
+                attrs += words[d][(i + j) % 8];
+                attrs += ' ';
+                attrs += words[d][(i + j + 3) % 8];
+                attrs += "\"";
+            }
+            attrs += "/>";
+        }
+        attrs += "</rows>\n";
+
+        QByteArray &tree = indented[d];
+        tree = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<root>\n";
+        for (int i = 0; i < 20000; ++i) {
+            tree += "    <item>\n        <name>";
+            tree += words[d][i % 8];
+            tree += "</name>\n        <value>" + QByteArray::number(i) + "</value>\n    </item>\n";
+        }
+        tree += "</root>\n";
+    }
+}
+
+void tst_QXmlStreamReader::documents()
+{
+    QTest::addColumn<int>("document");
+    QTest::addColumn<bool>("useDevice");
+
+    QTest::newRow("ascii") << int(Ascii) << false;
+    QTest::newRow("ascii-device") << int(Ascii) << true;
+    QTest::newRow("utf8") << int(NonAscii) << false;
+    QTest::newRow("utf8-device") << int(NonAscii) << true;
+}
+
+void tst_QXmlStreamReader::read(const QByteArray *docs)
+{
+    QFETCH(int, document);
+    QFETCH(bool, useDevice);
+    const QByteArray &data = docs[document];
+
+    qint64 total = 0;
+    QBENCHMARK {
+        QBuffer buffer;
+        buffer.setData(data);
+        buffer.open(QIODevice::ReadOnly);
+        QXmlStreamReader reader;
+        if (useDevice)
+            reader.setDevice(&buffer);
+        else
+            reader.addData(data);
+
+        while (!reader.atEnd()) {
+            switch (reader.readNext()) {
+            case QXmlStreamReader::StartElement:
+                for (const QXmlStreamAttribute &attribute : reader.attributes())
+                    total += attribute.value().size();
+                break;
+            case QXmlStreamReader::Characters:
+                total += reader.text().size();
+                break;
+            default:
+                break;
+            }
+        }
+        QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+    }
+    QVERIFY(total > 0);
+}
+
+QTEST_MAIN(tst_QXmlStreamReader)
+
+#include "main.moc"
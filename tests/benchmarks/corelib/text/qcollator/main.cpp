@@ -0,0 +1,108 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QCollator>
+#include <QLocale>
+#include <QStringList>
+#include <QTest>
+
+#include <algorithm>
+
+class tst_QCollator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void sort_data();
+    void sort();
+
+private:
+    QStringList names;
+};
+
+void tst_QCollator::initTestCase()
+{
+    // a locale other than C, so that the collator cannot fall back to
+    // comparing the strings directly
+    QLocale::setDefault(QLocale(QLocale::English, QLocale::UnitedStates));
+
+    static const char *const parts[] = { "report", "Photo", "budget", "draft", "\xc3\xa9t\xc3\xa9",
+                                         "notes", "Invoice", "backup", "archive", "summary" };
+    const int max = 100000;
+    names.reserve(max);
+    for (int i = 0; i < max; ++i) {
+        const uint n = i * 2654435761u;
+        names.append(QString::fromUtf8(parts[n % 10]) + QLatin1Char('_')
+                     + QString::fromUtf8(parts[(n >> 8) % 10]) + QString::number(n % 9973));
+    }
+}
+
+void tst_QCollator::sort_data()
+{
+    QTest::addColumn<bool>("sortKeys");
+    QTest::addColumn<bool>("numeric");
+    QTest::addColumn<int>("size");
+
+    for (int size : { 100, 10000, 100000 }) {
+        for (bool numeric : { false, true }) {
+            const char *mode = numeric ? "numeric" : "plain";
+            QTest::addRow("compare-%s-%d", mode, size) << false << numeric << size;
+            QTest::addRow("sortkeys-%s-%d", mode, size) << true << numeric << size;
+        }
+    }
+}
+
+void tst_QCollator::sort()
+{
+    QFETCH(bool, sortKeys);
+    QFETCH(bool, numeric);
+    QFETCH(int, size);
+
+    QCollator collator;
+    collator.setNumericMode(numeric);
+    collator.setCaseSensitivity(Qt::CaseInsensitive);
+    const QStringList input = names.mid(0, size);
+
+    if (sortKeys) {
+        QBENCHMARK {
+            QStringList strings = input;
+            collator.sort(strings);
+        }
+    } else {
+        QBENCHMARK {
+            QStringList strings = input;
+            std::sort(strings.begin(), strings.end(), collator);
+        }
+    }
+}
+
+QTEST_MAIN(tst_QCollator)
+
+#include "main.moc"
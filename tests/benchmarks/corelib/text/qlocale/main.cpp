@@ -28,6 +28,7 @@
 
 #include <QLocale>
 #include <QTest>
+#include <QVector>
 
 class tst_QLocale : public QObject
 {
@@ -37,6 +38,18 @@ private Q_SLOTS:
     void toUpper_QLocale_1();
     void toUpper_QLocale_2();
     void toUpper_QString();
+
+    void stringToDouble_data();
+    void stringToDouble();
+    void stringToLongLong_data();
+    void stringToLongLong();
+    void doubleToString_data();
+    void doubleToString();
+    void longLongToString_data();
+    void longLongToString();
+
+private:
+    void locales();
 };
 
 static QString data()
@@ -65,6 +78,139 @@ void tst_QLocale::toUpper_QString()
     QBENCHMARK { LOOP(s.toUpper()) }
 }
 
+void tst_QLocale::locales()
+{
+    QTest::addColumn<QLocale>("locale");
+
+    QTest::newRow("C") << QLocale::c();
+    QTest::newRow("en_US") << QLocale(QLocale::English, QLocale::UnitedStates);
+    QTest::newRow("de_DE") << QLocale(QLocale::German, QLocale::Germany);
+    QTest::newRow("ar_EG") << QLocale(QLocale::Arabic, QLocale::Egypt);
+}
+
+// A column of numbers as found in a CSV file, formatted for each locale
+static QVector<QString> doubleColumn(const QLocale &locale)
+{
+    QVector<QString> result;
+    for (int i = 0; i < 1000; ++i)
+        result << locale.toString((i - 500) * 1.0625 + i / 1000.0, 'g', 12);
+    return result;
+}
+
+void tst_QLocale::stringToDouble_data()
+{
+    locales();
+}
+
+void tst_QLocale::stringToDouble()
+{
+    QFETCH(QLocale, locale);
+    const QVector<QString> column = doubleColumn(locale);
+
+    double sum = 0;
+    bool ok = true;
+    if (locale == QLocale::c()) {
+        // the QString API always uses the C locale
+        QBENCHMARK {
+            for (const QString &s : column)
+                sum += s.toDouble(&ok);
+        }
+    } else {
+        QBENCHMARK {
+            for (const QString &s : column)
+                sum += locale.toDouble(s, &ok);
+        }
+    }
+    QVERIFY(ok);
+    QVERIFY(sum != 0);
+}
+
+void tst_QLocale::stringToLongLong_data()
+{
+    locales();
+}
+
+void tst_QLocale::stringToLongLong()
+{
+    QFETCH(QLocale, locale);
+    QVector<QString> column;
+    for (int i = 0; i < 1000; ++i)
+        column << locale.toString(qlonglong(i - 500) * 7919);
+
+    qlonglong sum = 0;
+    bool ok = true;
+    if (locale == QLocale::c()) {
+        QBENCHMARK {
+            for (const QString &s : column)
+                sum += s.toLongLong(&ok);
+        }
+    } else {
+        QBENCHMARK {
+            for (const QString &s : column)
+                sum += locale.toLongLong(s, &ok);
+        }
+    }
+    QVERIFY(ok);
+    QVERIFY(sum != 0);
+}
+
+void tst_QLocale::doubleToString_data()
+{
+    locales();
+}
+
+void tst_QLocale::doubleToString()
+{
+    QFETCH(QLocale, locale);
+    QVector<double> column;
+    for (int i = 0; i < 1000; ++i)
+        column << (i - 500) * 1.0625 + i / 1000.0;
+
+    int size = 0;
+    if (locale == QLocale::c()) {
+        QBENCHMARK {
+            for (double d : column) {
+                size += QString::number(d).size();
+                size += QString::number(d, 'f', 3).size();
+                size += QString::number(d, 'e', 6).size();
+            }
+        }
+    } else {
+        QBENCHMARK {
+            for (double d : column) {
+                size += locale.toString(d).size();
+                size += locale.toString(d, 'f', 3).size();
+                size += locale.toString(d, 'e', 6).size();
+            }
+        }
+    }
+    QVERIFY(size > 0);
+}
+
+void tst_QLocale::longLongToString_data()
+{
+    locales();
+}
+
+void tst_QLocale::longLongToString()
+{
+    QFETCH(QLocale, locale);
+
+    int size = 0;
+    if (locale == QLocale::c()) {
+        QBENCHMARK {
+            for (int i = -500; i < 500; ++i)
+                size += QString::number(qlonglong(i) * 7919).size();
+        }
+    } else {
+        QBENCHMARK {
+            for (int i = -500; i < 500; ++i)
+                size += locale.toString(qlonglong(i) * 7919).size();
+        }
+    }
+    QVERIFY(size > 0);
+}
+
 QTEST_MAIN(tst_QLocale)
 
 #include "main.moc"
@@ -0,0 +1,156 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QRegularExpression>
+#include <QStringList>
+#include <QTest>
+
+class tst_QRegularExpression : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void constructAndMatch_data();
+    void constructAndMatch();
+    void match_data() { constructAndMatch_data(); }
+    void match();
+    void scanSeparately();
+    void scanMatchMany();
+
+private:
+    QString logText;
+    QStringList tokenPatterns;
+};
+
+void tst_QRegularExpression::initTestCase()
+{
+    const QString line = QStringLiteral(
+            "2026-10-16 12:34:56.789 [worker-3] WARN  request 0x7f3a9c00 from 192.168.10.42 "
+            "took 1532 ms (user=alice, path=/api/v2/items?id=12345)\n");
+    logText.reserve(line.size() * 1000);
+    for (int i = 0; i < 1000; ++i)
+        logText += line;
+
+    tokenPatterns = QStringList {
+        QStringLiteral("\\d{4}-\\d\\d-\\d\\d"),
+        QStringLiteral("\\d\\d:\\d\\d:\\d\\d\\.\\d+"),
+        QStringLiteral("\\b(?:DEBUG|INFO|WARN|ERROR)\\b"),
+        QStringLiteral("0x[0-9a-f]+"),
+        QStringLiteral("\\d{1,3}(?:\\.\\d{1,3}){3}"),
+        QStringLiteral("user=(\\w+)"),
+        QStringLiteral("path=(\\S+?)\\)"),
+        QStringLiteral("\\d+ ms"),
+    };
+}
+
+void tst_QRegularExpression::constructAndMatch_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QString>("subject");
+
+    QTest::newRow("literal") << "WARN" << "2026-10-16 12:34:56 [main] WARN disk almost full";
+    QTest::newRow("date") << "(\\d{4})-(\\d\\d)-(\\d\\d)" << "released on 2026-10-16";
+    QTest::newRow("email") << "([\\w.+-]+)@([\\w-]+(?:\\.[\\w-]+)+)" << "contact: someone.else@example.org";
+    QTest::newRow("alternation") << "\\b(?:alpha|beta|gamma|delta|epsilon|zeta|eta|theta)\\b"
+                                 << "the quick brown fox jumps over the lazy theta";
+}
+
+// Builds a new QRegularExpression from the pattern string for every match,
+// as code converting pattern strings on the fly (or in other threads) does.
+void tst_QRegularExpression::constructAndMatch()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QString, subject);
+
+    QBENCHMARK {
+        QRegularExpression re(pattern);
+        if (!re.match(subject).hasMatch())
+            QFAIL("no match");
+    }
+}
+
+void tst_QRegularExpression::match()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QString, subject);
+
+    const QRegularExpression re(pattern);
+    re.optimize();
+    QBENCHMARK {
+        if (!re.match(subject).hasMatch())
+            QFAIL("no match");
+    }
+}
+
+// Finds all the tokens of the log with one global match per pattern.
+void tst_QRegularExpression::scanSeparately()
+{
+    QVector<QRegularExpression> expressions;
+    for (const QString &pattern : qAsConst(tokenPatterns)) {
+        expressions.append(QRegularExpression(pattern));
+        expressions.last().optimize();
+    }
+
+    int count = 0;
+    QBENCHMARK {
+        count = 0;
+        for (const QRegularExpression &re : qAsConst(expressions)) {
+            QRegularExpressionMatchIterator it = re.globalMatch(logText);
+            while (it.hasNext()) {
+                it.next();
+                ++count;
+            }
+        }
+    }
+    QCOMPARE(count, 8000);
+}
+
+// Finds all the tokens of the log in a single pass.
+void tst_QRegularExpression::scanMatchMany()
+{
+    const QRegularExpression re = QRegularExpression::fromPatterns(tokenPatterns);
+    QVERIFY(re.isValid());
+    re.optimize();
+
+    int count = 0;
+    QBENCHMARK {
+        count = 0;
+        QRegularExpressionMatchIterator it = re.globalMatch(logText);
+        while (it.hasNext()) {
+            if (it.next().patternIndex() >= 0)
+                ++count;
+        }
+    }
+    QCOMPARE(count, 8000);
+}
+
+QTEST_MAIN(tst_QRegularExpression)
+
+#include "main.moc"
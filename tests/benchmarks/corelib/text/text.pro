@@ -2,7 +2,9 @@ TEMPLATE = subdirs
 SUBDIRS = \
         qbytearray \
         qchar \
+        qcollator \
         qlocale \
+        qregularexpression \
         qstringbuilder \
         qstringlist
 
@@ -67,6 +67,8 @@ private slots:
     void readOnly();
     void writeOnly_data();
     void writeOnly();
+    void readScaling_data();
+    void readScaling();
     // void readWrite();
 };
 
@@ -256,5 +258,93 @@ void tst_QReadWriteLock::writeOnly()
     holder.value();
 }
 
+struct ScalingFunctionHolder
+{
+    typedef void (*Function)(int threads, int writeEvery);
+    ScalingFunctionHolder(Function value = nullptr)
+        : value(value)
+    {
+    }
+    Function value;
+};
+Q_DECLARE_METATYPE(ScalingFunctionHolder)
+
+static QHash<int, int> global_scaling_hash;
+
+template <typename Mutex, typename ReadLocker, typename WriteLocker>
+void testReadScaling(int threads, int writeEvery)
+{
+    struct Thread : QThread
+    {
+        Mutex *lock;
+        int writeEvery;
+        void run() override
+        {
+            for (int i = 0; i < Iterations; ++i) {
+                if (writeEvery && i % writeEvery == 0) {
+                    WriteLocker locker(lock);
+                    global_scaling_hash[i & 0xff] = i;
+                } else {
+                    ReadLocker locker(lock);
+                    global_scaling_hash.value(i & 0xff);
+                }
+            }
+        }
+    };
+    for (int i = 0; i < 0x100; ++i)
+        global_scaling_hash.insert(i, i);
+
+    Mutex lock;
+    std::vector<std::unique_ptr<Thread>> workers;
+    for (int i = 0; i < threads; ++i) {
+        auto t = qt_make_unique<Thread>();
+        t->lock = &lock;
+        t->writeEvery = writeEvery;
+        workers.push_back(std::move(t));
+    }
+    QBENCHMARK {
+        for (auto &t : workers)
+            t->start();
+        for (auto &t : workers)
+            t->wait();
+    }
+}
+
+void tst_QReadWriteLock::readScaling_data()
+{
+    QTest::addColumn<ScalingFunctionHolder>("holder");
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<int>("writeEvery");
+
+    const int maxThreads = qMax(8, QThread::idealThreadCount());
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        // 0: read only; 1000: one write per thousand reads
+        for (int writeEvery : {0, 1000}) {
+            QTest::addRow("QMutex, %d threads, write every %d", threads, writeEvery)
+                << ScalingFunctionHolder(testReadScaling<QMutex, QMutexLocker, QMutexLocker>)
+                << threads << writeEvery;
+            QTest::addRow("QReadWriteLock, %d threads, write every %d", threads, writeEvery)
+                << ScalingFunctionHolder(testReadScaling<QReadWriteLock, QReadLocker, QWriteLocker>)
+                << threads << writeEvery;
+#ifdef __cpp_lib_shared_mutex
+            QTest::addRow("std::shared_mutex, %d threads, write every %d", threads, writeEvery)
+                << ScalingFunctionHolder(
+                       testReadScaling<std::shared_mutex,
+                                       LockerWrapper<std::shared_lock<std::shared_mutex>>,
+                                       LockerWrapper<std::unique_lock<std::shared_mutex>>>)
+                << threads << writeEvery;
+#endif
+        }
+    }
+}
+
+void tst_QReadWriteLock::readScaling()
+{
+    QFETCH(ScalingFunctionHolder, holder);
+    QFETCH(int, threads);
+    QFETCH(int, writeEvery);
+    holder.value(threads, writeEvery);
+}
+
 QTEST_MAIN(tst_QReadWriteLock)
 #include "tst_qreadwritelock.moc"
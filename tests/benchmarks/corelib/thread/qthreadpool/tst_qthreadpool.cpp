@@ -40,6 +40,10 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void fineGrainedTasks_data();
+    void fineGrainedTasks();
+    void nestedTasks_data();
+    void nestedTasks();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -75,5 +79,60 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+static void addThreadCountRows()
+{
+    QTest::addColumn<int>("threads");
+    const int counts[] = { 1, 2, 4, 8, 16, 32 };
+    for (int threads : counts)
+        QTest::addRow("%d threads", threads) << threads;
+}
+
+void tst_QThreadPool::fineGrainedTasks_data()
+{
+    addThreadCountRows();
+}
+
+void tst_QThreadPool::fineGrainedTasks()
+{
+    QFETCH(int, threads);
+    const int tasks = 10000;
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threads);
+    QSemaphore done;
+    QBENCHMARK {
+        for (int i = 0; i < tasks; ++i)
+            threadPool.start([&done]() { done.release(); });
+        done.acquire(tasks);
+    }
+}
+
+void tst_QThreadPool::nestedTasks_data()
+{
+    addThreadCountRows();
+}
+
+void tst_QThreadPool::nestedTasks()
+{
+    QFETCH(int, threads);
+    const int parents = 100;
+    const int children = 100;
+
+    // every task spawns its work from inside the pool, like recursive
+    // divide and conquer algorithms do
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threads);
+    QSemaphore done;
+    QBENCHMARK {
+        for (int i = 0; i < parents; ++i) {
+            threadPool.start([&threadPool, &done]() {
+                for (int j = 0; j < children; ++j)
+                    threadPool.start([&done]() { done.release(); });
+            });
+        }
+        done.acquire(parents * children);
+    }
+}
+
 QTEST_MAIN(tst_QThreadPool)
 #include "tst_qthreadpool.moc"
@@ -0,0 +1,243 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QFlatHash>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <QTest>
+
+#if defined(__GLIBC__)
+#  include <malloc.h>
+#endif
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void insert_int_data() { sizes(); }
+    void insert_int();
+    void insert_string_data() { sizes(); }
+    void insert_string();
+    void lookupHit_int_data() { sizes(); }
+    void lookupHit_int();
+    void lookupHit_string_data() { sizes(); }
+    void lookupHit_string();
+    void lookupMiss_string_data() { sizes(); }
+    void lookupMiss_string();
+    void iterate_data() { sizes(); }
+    void iterate();
+    void memoryPerEntry_data() { sizes(); }
+    void memoryPerEntry();
+
+private:
+    void sizes();
+    template <typename Hash, typename Key> void insert_template(const QVector<Key> &keys);
+    template <typename Hash, typename Key> void lookup_template(const QVector<Key> &keys,
+                                                               const QVector<Key> &queries);
+    template <typename Hash> qint64 bytesPerEntry(int size);
+
+    QVector<int> ints;
+    QVector<QString> strings;
+    QVector<QString> missingStrings;
+};
+
+void tst_QFlatHash::initTestCase()
+{
+    const int max = 1000000;
+    ints.reserve(max);
+    strings.reserve(max);
+    missingStrings.reserve(max);
+    for (int i = 0; i < max; ++i) {
+        ints.append(i * 7);
+        strings.append(QStringLiteral("/usr/share/item/%1").arg(i));
+        missingStrings.append(QStringLiteral("/usr/share/none/%1").arg(i));
+    }
+}
+
+void tst_QFlatHash::sizes()
+{
+    QTest::addColumn<bool>("flat");
+    QTest::addColumn<int>("size");
+
+    for (int size : {100, 10000, 1000000}) {
+        QTest::addRow("QHash-%d", size) << false << size;
+        QTest::addRow("QFlatHash-%d", size) << true << size;
+    }
+}
+
+template <typename Hash, typename Key>
+void tst_QFlatHash::insert_template(const QVector<Key> &keys)
+{
+    QFETCH(int, size);
+
+    QBENCHMARK {
+        Hash hash;
+        for (int i = 0; i < size; ++i)
+            hash.insert(keys.at(i), i);
+    }
+}
+
+void tst_QFlatHash::insert_int()
+{
+    QFETCH(bool, flat);
+    if (flat)
+        insert_template<QFlatHash<int, int> >(ints);
+    else
+        insert_template<QHash<int, int> >(ints);
+}
+
+void tst_QFlatHash::insert_string()
+{
+    QFETCH(bool, flat);
+    if (flat)
+        insert_template<QFlatHash<QString, int> >(strings);
+    else
+        insert_template<QHash<QString, int> >(strings);
+}
+
+template <typename Hash, typename Key>
+void tst_QFlatHash::lookup_template(const QVector<Key> &keys, const QVector<Key> &queries)
+{
+    QFETCH(int, size);
+
+    Hash hash;
+    for (int i = 0; i < size; ++i)
+        hash.insert(keys.at(i), i);
+
+    const Hash &constHash = hash;
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < size; ++i)
+            sum += constHash.value(queries.at(i), -1);
+    }
+    QVERIFY(sum != 0);
+}
+
+void tst_QFlatHash::lookupHit_int()
+{
+    QFETCH(bool, flat);
+    if (flat)
+        lookup_template<QFlatHash<int, int> >(ints, ints);
+    else
+        lookup_template<QHash<int, int> >(ints, ints);
+}
+
+void tst_QFlatHash::lookupHit_string()
+{
+    QFETCH(bool, flat);
+    if (flat)
+        lookup_template<QFlatHash<QString, int> >(strings, strings);
+    else
+        lookup_template<QHash<QString, int> >(strings, strings);
+}
+
+void tst_QFlatHash::lookupMiss_string()
+{
+    QFETCH(bool, flat);
+    if (flat)
+        lookup_template<QFlatHash<QString, int> >(strings, missingStrings);
+    else
+        lookup_template<QHash<QString, int> >(strings, missingStrings);
+}
+
+void tst_QFlatHash::iterate()
+{
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+
+    QHash<QString, int> hash;
+    QFlatHash<QString, int> flatHash;
+    for (int i = 0; i < size; ++i) {
+        if (flat)
+            flatHash.insert(strings.at(i), i);
+        else
+            hash.insert(strings.at(i), i);
+    }
+
+    qint64 sum = 0;
+    if (flat) {
+        QBENCHMARK {
+            for (int value : qAsConst(flatHash))
+                sum += value;
+        }
+    } else {
+        QBENCHMARK {
+            for (int value : qAsConst(hash))
+                sum += value;
+        }
+    }
+    QVERIFY(sum != 0);
+}
+
+static qint64 heapInUse()
+{
+    // large blocks are mmap()ed and accounted for separately
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    const struct mallinfo2 info = mallinfo2();
+    return qint64(info.uordblks) + qint64(info.hblkhd);
+#elif defined(__GLIBC__)
+    const struct mallinfo info = mallinfo();
+    return qint64(info.uordblks) + qint64(info.hblkhd);
+#else
+    return 0;
+#endif
+}
+
+template <typename Hash>
+qint64 tst_QFlatHash::bytesPerEntry(int size)
+{
+    // the keys share their data with the source strings, so only the
+    // container's own allocations are accounted for
+    const qint64 before = heapInUse();
+    Hash hash;
+    for (int i = 0; i < size; ++i)
+        hash.insert(strings.at(i), i);
+    return (heapInUse() - before) / size;
+}
+
+void tst_QFlatHash::memoryPerEntry()
+{
+#if defined(__GLIBC__)
+    QFETCH(bool, flat);
+    QFETCH(int, size);
+
+    const qint64 bytes = flat ? bytesPerEntry<QFlatHash<QString, int> >(size)
+                              : bytesPerEntry<QHash<QString, int> >(size);
+    QTest::setBenchmarkResult(bytes, QTest::BytesAllocated);
+#else
+    QSKIP("Heap usage can only be measured with glibc");
+#endif
+}
+
+QTEST_MAIN(tst_QFlatHash)
+
+#include "main.moc"